@@ -42,7 +42,7 @@
 ///////////////////////////////////////////////// GLOBAL OBJECTS /////////////////////////////////////////////////
 // Serial interfaces
 HardwareSerial mySerial(DEBUG_RX_PIN, DEBUG_TX_PIN);    // Debug UART - 115200 baud
-HardwareSerial mySerial2(BLE_RX_PIN, BLE_TX_PIN);       // BLE UART - 9600 baud
+HardwareSerial mySerial2(BLE_RX_PIN, BLE_TX_PIN);       // BLE UART - 9600 baud, raised by Hm10Manager
 
 // Main massage controller instance
 MassageController* massageController = nullptr;
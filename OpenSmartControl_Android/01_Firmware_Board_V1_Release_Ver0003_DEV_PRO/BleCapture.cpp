@@ -0,0 +1,94 @@
+#include "BleCapture.h"
+
+/**
+ * Constructor
+ */
+BleCapture::BleCapture()
+  : head(0), count(0), baseTick(0), lastTick(0), started(false), paused(false), overwritten(0), missed(0) {
+  memset(entries, 0, sizeof(entries));
+}
+
+/**
+ * Append one entry, dropping the oldest when the ring is full
+ * The dropped entry's ticks move into baseTick so the journal start stays exact.
+ */
+void BleCapture::push(uint16_t entry) {
+  if (count == ENTRIES) {
+    baseTick += entryTicks(entries[head]);  // head is the oldest entry when full
+    overwritten++;
+  } else {
+    count++;
+  }
+  entries[head] = entry;
+  head = (head + 1) & MASK;
+}
+
+/**
+ * Record one received byte at the given TimerManager tick
+ */
+void BleCapture::record(uint8_t value, uint32_t tick) {
+  if (paused) {
+    missed++;
+    return;
+  }
+  if (!started) {
+    baseTick = tick;
+    lastTick = tick;
+    started = true;
+  }
+
+  uint32_t delta = tick - lastTick;
+  while (delta > MAX_DELTA) {
+    uint16_t gap = (delta > MAX_GAP) ? MAX_GAP : (uint16_t)delta;
+    push(GAP_FLAG | gap);
+    delta -= gap;
+  }
+  push((uint16_t)((delta << 8) | value));
+  lastTick = tick;
+}
+
+/**
+ * Forget the journal (the next byte starts a new one)
+ */
+void BleCapture::clear() {
+  head = 0;
+  count = 0;
+  baseTick = 0;
+  lastTick = 0;
+  started = false;
+  overwritten = 0;
+  missed = 0;
+}
+
+/**
+ * Dump header: format version, start tick, entry count and loss counters
+ */
+int BleCapture::formatHeader(char* line) const {
+  int len = snprintf(line, LINE_SIZE, "=== BLE CAPTURE v1 base=%lu entries=%u overwritten=%lu missed=%lu ===\r\n",
+                     (unsigned long)baseTick,
+                     (unsigned)count,
+                     overwritten,
+                     missed);
+  if (len < 0) return 0;
+  return (len < LINE_SIZE) ? len : LINE_SIZE - 1;
+}
+
+/**
+ * Dump line: "CAP " and up to ENTRIES_PER_LINE entries as 4 hex digits
+ */
+int BleCapture::formatLine(char* line, uint16_t firstEntry) const {
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+  memcpy(line, "CAP ", 4);
+  int len = 4;
+  for (uint16_t i = firstEntry; i < count && i < firstEntry + ENTRIES_PER_LINE; i++) {
+    uint16_t entry = entryAt(i);
+    line[len++] = HEX_DIGITS[(entry >> 12) & 0x0F];
+    line[len++] = HEX_DIGITS[(entry >> 8) & 0x0F];
+    line[len++] = HEX_DIGITS[(entry >> 4) & 0x0F];
+    line[len++] = HEX_DIGITS[entry & 0x0F];
+  }
+  line[len++] = '\r';
+  line[len++] = '\n';
+  return len;
+}
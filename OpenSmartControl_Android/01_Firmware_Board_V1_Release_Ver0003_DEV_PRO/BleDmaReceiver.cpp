@@ -0,0 +1,318 @@
+#include "BleDmaReceiver.h"
+
+// Static instance for ISR access
+BleDmaReceiver* BleDmaReceiver::instance = nullptr;
+
+/**
+ * Constructor
+ */
+BleDmaReceiver::BleDmaReceiver(HardwareSerial* bleSerial)
+  : serial(bleSerial), lastDmaPos(0), writeTotal(0), readTotal(0), scanTotal(0), overrunErrors(0), framingErrors(0), noiseErrors(0), ringOverruns(0), droppedBytes(0), framesFound(0), restarts(0), active(false) {
+  memset(dmaBuffer, 0, sizeof(dmaBuffer));
+  instance = this;
+}
+
+/**
+ * Destructor
+ */
+BleDmaReceiver::~BleDmaReceiver() {
+  end();
+  instance = nullptr;
+}
+
+#if BLE_DMA_HW_AVAILABLE
+namespace {
+// HardwareSerial keeps its HAL handle in a protected member
+struct SerialHandleAccess : public HardwareSerial {
+  static serial_t HardwareSerial::*member() {
+    return &SerialHandleAccess::_serial;
+  }
+};
+}
+
+/**
+ * HAL UART handle of the BLE serial port
+ */
+UART_HandleTypeDef* BleDmaReceiver::uartHandle() const {
+  return &((serial->*SerialHandleAccess::member()).handle);
+}
+
+/**
+ * Check if a HAL callback belongs to this receiver
+ */
+bool BleDmaReceiver::ownsUart(UART_HandleTypeDef* huart) const {
+  return active && huart == uartHandle();
+}
+
+/**
+ * DMA channel interrupt (half / full transfer events)
+ */
+void BleDmaReceiver::onDmaIRQ() {
+  HAL_DMA_IRQHandler(&hdmaRx);
+}
+
+/**
+ * Start (or restart) circular reception-to-idle
+ * The DMA always restarts at the buffer start, so the free-running write
+ * counter is aligned to a buffer boundary and any partial frame is dropped.
+ */
+bool BleDmaReceiver::startTransfer() {
+  UART_HandleTypeDef* huart = uartHandle();
+
+  HAL_UART_AbortReceive(huart);
+
+  uint32_t pending = writeTotal - readTotal;
+  if (pending <= DMA_BUFFER_SIZE) droppedBytes += pending;
+
+  uint32_t aligned = (writeTotal + MASK) & ~(uint32_t)MASK;
+  writeTotal = aligned;
+  readTotal = aligned;
+  scanTotal = aligned;
+  lastDmaPos = 0;
+
+  if (HAL_UARTEx_ReceiveToIdle_DMA(huart, dmaBuffer, DMA_BUFFER_SIZE) != HAL_OK) {
+    return false;
+  }
+
+  // Line errors are sampled in poll(); an error interrupt would abort the circular transfer
+  CLEAR_BIT(huart->Instance->CR3, USART_CR3_EIE);
+  CLEAR_BIT(huart->Instance->CR1, USART_CR1_PEIE);
+  return true;
+}
+#endif
+
+/**
+ * Switch the BLE UART to DMA reception
+ * Must be called after the HardwareSerial has been started.
+ * Returns false (HardwareSerial reception left running) if DMA is unavailable.
+ */
+bool BleDmaReceiver::begin() {
+#if BLE_DMA_HW_AVAILABLE
+  if (!serial || active) return active;
+
+  UART_HandleTypeDef* huart = uartHandle();
+  if (huart->Instance != USART2) return false;  // DMA1 Channel 6 is USART2_RX on STM32F1
+
+  __HAL_RCC_DMA1_CLK_ENABLE();
+  hdmaRx.Instance = DMA1_Channel6;
+  hdmaRx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+  hdmaRx.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdmaRx.Init.MemInc = DMA_MINC_ENABLE;
+  hdmaRx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdmaRx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  hdmaRx.Init.Mode = DMA_CIRCULAR;
+  hdmaRx.Init.Priority = DMA_PRIORITY_MEDIUM;
+  if (HAL_DMA_Init(&hdmaRx) != HAL_OK) return false;
+  __HAL_LINKDMA(huart, hdmarx, hdmaRx);
+
+  HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 1, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+
+  reset();
+  active = true;
+  if (!startTransfer()) {
+    end();
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Stop DMA reception and hand the UART back to HardwareSerial
+ */
+void BleDmaReceiver::end() {
+#if BLE_DMA_HW_AVAILABLE
+  if (!active) return;
+  active = false;
+
+  UART_HandleTypeDef* huart = uartHandle();
+  HAL_UART_AbortReceive(huart);
+  HAL_NVIC_DisableIRQ(DMA1_Channel6_IRQn);
+  HAL_DMA_DeInit(&hdmaRx);
+  huart->hdmarx = nullptr;
+
+  // Restart per-byte interrupt reception
+  serial->begin(huart->Init.BaudRate);
+#endif
+  active = false;
+}
+
+/**
+ * Check if DMA reception is running
+ */
+bool BleDmaReceiver::isActive() const {
+  return active;
+}
+
+/**
+ * Publish a new DMA write position (0..DMA_BUFFER_SIZE)
+ * Called from the HAL RX event callback on IDLE, half and full transfer.
+ */
+void BleDmaReceiver::onReceiveEvent(uint16_t dmaPos) {
+  if (dmaPos > DMA_BUFFER_SIZE) return;
+
+  uint16_t last = lastDmaPos;
+  uint16_t delta = (dmaPos >= last) ? (dmaPos - last) : (DMA_BUFFER_SIZE - last + dmaPos);
+  lastDmaPos = (dmaPos == DMA_BUFFER_SIZE) ? 0 : dmaPos;
+  writeTotal += delta;
+}
+
+/**
+ * Sample USART error flags and restart the transfer if the HAL aborted it
+ */
+void BleDmaReceiver::poll() {
+#if BLE_DMA_HW_AVAILABLE
+  if (!active) return;
+
+  UART_HandleTypeDef* huart = uartHandle();
+  uint32_t sr = huart->Instance->SR;
+  if (sr & (USART_SR_ORE | USART_SR_FE | USART_SR_NE)) {
+    if (sr & USART_SR_ORE) overrunErrors++;
+    if (sr & USART_SR_FE) framingErrors++;
+    if (sr & USART_SR_NE) noiseErrors++;
+    // SR read followed by DR read clears the flags (DMA has normally taken DR already)
+    (void)huart->Instance->DR;
+  }
+
+  if (huart->RxState != HAL_UART_STATE_BUSY_RX || huart->ReceptionType != HAL_UART_RECEPTION_TOIDLE) {
+    restarts++;
+    startTransfer();
+  }
+#endif
+}
+
+/**
+ * Find the next complete STX..ETX (hex) or SOH..ETX (binary) span
+ * Bytes before a frame start, spans restarted by a new start and spans longer than
+ * MAX_FRAME_SIZE are dropped. The slice stays valid until release().
+ */
+bool BleDmaReceiver::nextFrame(BleRxSlice& slice) {
+  uint32_t head = writeTotal;
+
+  // DMA has already overwritten bytes that were not consumed
+  if ((uint32_t)(head - readTotal) > DMA_BUFFER_SIZE) {
+    ringOverruns++;
+    droppedBytes += head - readTotal;
+    readTotal = head;
+    scanTotal = head;
+    return false;
+  }
+
+  while (readTotal != head) {
+    // Skip noise up to the next frame start
+    if (!isFrameStart(dmaBuffer[readTotal & MASK])) {
+      readTotal++;
+      droppedBytes++;
+      continue;
+    }
+
+    if ((int32_t)(scanTotal - readTotal) <= 0) {
+      scanTotal = readTotal + 1;
+    }
+
+    while (scanTotal != head) {
+      if (scanTotal - readTotal >= MAX_FRAME_SIZE) break;
+
+      uint8_t b = dmaBuffer[scanTotal & MASK];
+      if (b == ETX) {
+        fillSlice(slice, readTotal, scanTotal + 1);
+        scanTotal++;
+        framesFound++;
+        return true;
+      }
+      if (isFrameStart(b)) break;
+      scanTotal++;
+    }
+
+    if (scanTotal == head) return false;  // Frame still arriving
+
+    // New frame start inside the span or span too long: drop what we have
+    droppedBytes += scanTotal - readTotal;
+    readTotal = scanTotal;
+  }
+  return false;
+}
+
+/**
+ * Release a slice returned by nextFrame()
+ */
+void BleDmaReceiver::release(const BleRxSlice& slice) {
+  readTotal += slice.length();
+  if ((int32_t)(scanTotal - readTotal) < 0) {
+    scanTotal = readTotal;
+  }
+
+  // Slice was overwritten while it was being processed
+  if ((uint32_t)(writeTotal - readTotal) > DMA_BUFFER_SIZE) {
+    ringOverruns++;
+  }
+}
+
+/**
+ * Drop everything received so far
+ */
+void BleDmaReceiver::reset() {
+  uint32_t head = writeTotal;
+  readTotal = head;
+  scanTotal = head;
+}
+
+/**
+ * Bytes received but not yet released
+ */
+uint16_t BleDmaReceiver::getPendingBytes() const {
+  uint32_t pending = writeTotal - readTotal;
+  return (pending > DMA_BUFFER_SIZE) ? DMA_BUFFER_SIZE : (uint16_t)pending;
+}
+
+/**
+ * Reset error counters
+ */
+void BleDmaReceiver::resetStatistics() {
+  overrunErrors = 0;
+  framingErrors = 0;
+  noiseErrors = 0;
+  ringOverruns = 0;
+  droppedBytes = 0;
+  framesFound = 0;
+  restarts = 0;
+}
+
+/**
+ * Build a (possibly wrapped) slice for [start, end)
+ */
+void BleDmaReceiver::fillSlice(BleRxSlice& slice, uint32_t start, uint32_t end) const {
+  uint16_t offset = start & MASK;
+  uint16_t len = (uint16_t)(end - start);
+  uint16_t firstLen = DMA_BUFFER_SIZE - offset;
+  if (firstLen > len) firstLen = len;
+
+  slice.first = &dmaBuffer[offset];
+  slice.firstLen = firstLen;
+  slice.second = (len > firstLen) ? dmaBuffer : nullptr;
+  slice.secondLen = len - firstLen;
+}
+
+#if BLE_DMA_HW_AVAILABLE
+/**
+ * HAL reception-to-idle event (IDLE line, half and full transfer)
+ */
+extern "C" void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size) {
+  BleDmaReceiver* rx = BleDmaReceiver::instance;
+  if (rx && rx->ownsUart(huart)) {
+    rx->onReceiveEvent(Size);
+  }
+}
+
+/**
+ * USART2 RX DMA channel interrupt
+ */
+extern "C" void DMA1_Channel6_IRQHandler(void) {
+  if (BleDmaReceiver::instance) {
+    BleDmaReceiver::instance->onDmaIRQ();
+  }
+}
+#endif
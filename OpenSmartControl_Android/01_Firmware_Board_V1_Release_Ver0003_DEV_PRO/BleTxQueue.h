@@ -0,0 +1,85 @@
+#ifndef BLE_TX_QUEUE_H
+#define BLE_TX_QUEUE_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include "PacketCodec.h"
+#include "RingBuffer.h"
+
+/**
+ * Encoded frame waiting to be transmitted
+ */
+struct TxFrame {
+  uint8_t length;
+  uint8_t bytes[PacketCodec::MAX_FRAME_SIZE];
+};
+
+/**
+ * BleTxQueue Class
+ *
+ * Transmit queue for frames to the app. Frames are encoded once into a fixed
+ * pool and handed to the UART only as far as its interrupt-driven TX buffer
+ * has room, so sending never waits for the 9600/115200 baud line.
+ *
+ * Features:
+ * - Two lanes: control replies (ACK/NACK, config replies) go out before bulk
+ *   data (state telemetry); a frame already started is always finished first
+ * - O(1) enqueue, no dynamic allocation
+ * - Frames refused under back-pressure are counted per lane
+ * - High-water marks for sizing
+ */
+class BleTxQueue {
+public:
+  enum Lane : uint8_t {
+    LANE_CONTROL,
+    LANE_BULK,
+    LANE_COUNT
+  };
+
+  static const uint16_t CONTROL_FRAMES = 8;
+  static const uint16_t BULK_FRAMES = 4;
+
+private:
+  Print* serial;
+
+  RingBuffer<TxFrame, CONTROL_FRAMES> control;
+  RingBuffer<TxFrame, BULK_FRAMES> bulk;
+
+  // Frame being written to the UART
+  TxFrame current;
+  uint8_t currentOffset;
+  bool sending;
+
+  unsigned long drops[LANE_COUNT];
+  unsigned long framesSent;
+
+  bool takeNext();
+
+public:
+  // Constructor
+  BleTxQueue(Print* output);
+
+  // Producer (main loop)
+  bool enqueue(Lane lane, const uint8_t* frame, uint8_t length);
+
+  // Hand queued bytes to the UART while its TX buffer has room (never waits)
+  void pump();
+  void clear();
+  bool isIdle() const {
+    return !sending && control.isEmpty() && bulk.isEmpty();
+  }
+
+  // Statistics
+  unsigned long getDrops(Lane lane) const {
+    return drops[lane];
+  }
+  unsigned long getFramesSent() const {
+    return framesSent;
+  }
+  uint16_t getHighWater(Lane lane) const {
+    return (lane == LANE_CONTROL) ? control.getHighWater() : bulk.getHighWater();
+  }
+  void resetStatistics();
+};
+
+#endif  // BLE_TX_QUEUE_H
@@ -0,0 +1,86 @@
+#ifndef BOARD_ADDRESS_H
+#define BOARD_ADDRESS_H
+
+#include <Arduino.h>
+#include <cstdint>
+
+/**
+ * BoardAddress Class
+ *
+ * Protocol address of this board (the DeviceID byte of every frame), so
+ * several chairs can listen to one controller. Kept in emulated EEPROM and
+ * restored at startup.
+ *
+ * Address space:
+ * - 0x01..0xDF: unit address, one per board (factory default 0x70)
+ * - 0xE0..0xEF: groups 0..15; a board may belong to any of them
+ * - 0xFF:       broadcast, every board
+ * - 0x00, 0xF0..0xFE: reserved, never accepted
+ *
+ * Features:
+ * - O(1) match of a received DeviceID (unit / group bitmask / broadcast)
+ * - Checked record in EEPROM; a blank or damaged record gives the defaults
+ * - Saves only when the settings changed (one flash page write)
+ */
+class BoardAddress {
+public:
+  enum Match : uint8_t {
+    MATCH_NONE,       // Frame for another board
+    MATCH_UNIT,       // This board's own address
+    MATCH_GROUP,      // A group this board belongs to
+    MATCH_BROADCAST   // Every board
+  };
+
+  static const uint8_t DEFAULT_UNIT = 0x70;   // Legacy fixed DEVICE_ID
+  static const uint8_t GROUP_BASE = 0xE0;
+  static const uint8_t GROUP_COUNT = 16;
+  static const uint8_t BROADCAST = 0xFF;
+  static const uint16_t EEPROM_OFFSET = 0;    // Record position in the emulated EEPROM
+
+private:
+  static const uint8_t RECORD_MAGIC = 0xA7;
+  static const uint8_t RECORD_SIZE = 5;       // Magic, unit, groups (LE16), check
+
+  uint8_t unit;
+  uint16_t groups;      // Bit n set = member of group n
+  uint8_t savedUnit;
+  uint16_t savedGroups;
+
+  static uint8_t recordCheck(uint8_t unitAddress, uint16_t groupMask);
+
+public:
+  // Constructor
+  BoardAddress();
+
+  // Persistence
+  void load();
+  bool save();
+  bool isDirty() const {
+    return unit != savedUnit || groups != savedGroups;
+  }
+
+  // Matching
+  Match match(uint8_t address) const {
+    if (address == unit) return MATCH_UNIT;
+    if (address == BROADCAST) return MATCH_BROADCAST;
+    if (address >= GROUP_BASE && address < GROUP_BASE + GROUP_COUNT && (groups & (1u << (address - GROUP_BASE)))) {
+      return MATCH_GROUP;
+    }
+    return MATCH_NONE;
+  }
+  static bool isUnitAddress(uint8_t address) {
+    return address != 0 && address < GROUP_BASE;
+  }
+
+  // Settings (RAM only until save())
+  uint8_t getUnit() const {
+    return unit;
+  }
+  uint16_t getGroups() const {
+    return groups;
+  }
+  bool setUnit(uint8_t address);
+  bool setGroup(uint8_t group, bool member);
+};
+
+#endif  // BOARD_ADDRESS_H
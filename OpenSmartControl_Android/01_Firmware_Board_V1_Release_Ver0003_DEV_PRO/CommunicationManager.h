@@ -7,6 +7,34 @@
 #include <cstring>
 #include "TimerManager.h"
 #include "PinDefinitions.h"
+#include "RingBuffer.h"
+#include "FeatureConfig.h"
+#include "BleCapture.h"
+#include "BleDmaReceiver.h"
+#include "BleTxQueue.h"
+#include "BoardAddress.h"
+#include "FirmwareUpdater.h"
+#include "Hm10Manager.h"
+#include "LatencyProbe.h"
+#include "PacketCodec.h"
+#include "SequenceWindow.h"
+
+// Controllers driven by commands (full headers are included by the .cpp)
+class MotorController;
+class SequenceController;
+class SensorManager;
+class SafetyManager;
+
+/**
+ * Decoded command waiting in the command queue
+ */
+struct CommandRecord {
+  Frame frame;           // Plain command or extended frame
+  unsigned long rxTick;  // Master tick when the frame was decoded
+#if LATENCY_PROBES
+  LatencyProbe::Stamps stamps;  // First byte / ETX / validated times
+#endif
+};
 
 /**
  * CommunicationManager Class
@@ -16,29 +44,36 @@
  * 
  * Features:
  * - BLE communication via HM10 module
+ * - Per-board address with groups and broadcast (BoardAddress, kept in EEPROM)
+ * - Non-blocking HM10 reset and UART baud-rate negotiation (Hm10Manager)
+ * - Burst UART ingest into a fixed-size ring buffer (all pending bytes per loop)
+ * - Optional circular DMA + IDLE-line receive path (BLE_UART_DMA_RX)
  * - Serial communication for debugging
- * - Packet parsing and validation
- * - Command processing
+ * - Single-pass packet decoding and validation (no intermediate copies)
+ * - Negotiated binary framing (DLE-stuffed) alongside legacy hex framing
+ * - Command processing through a compile-time checked dispatch table
+ * - Batch frames (several commands applied as one transaction)
+ * - Decoded commands queued (SPSC) and executed outside the receive path
+ * - State telemetry frames pushed to the app (coalesced, rate-limited)
+ * - BLE link supervision (heartbeat liveness, safe stop of manual motion on loss)
+ * - Hold-to-run leases for manual motion (PUSH data2)
+ * - Non-blocking transmit queue, replies ahead of telemetry
  * - Checksum calculation and verification
- * - Command deduplication
+ * - Command deduplication (legacy time window or per-link sequence window)
+ * - Optional ACK/NACK replies with result codes (reliable delivery)
+ * - Link quality counters (errors by cause, traffic) readable by the app
+ * - Optional end-to-end command latency histograms (LATENCY_PROBES)
+ * - Optional journal of received BLE bytes for host replay (BLE_CAPTURE)
+ * - Optional firmware update over the link, staged for the bootloader (FIRMWARE_UPDATE)
  */
 class CommunicationManager {
 public:
-  // Parse states
-  enum ParseState {
-    WAIT_START,
-    READ_HEX_STRING,
-    FIRST_END
-  };
-
   // Command definitions
-  static const uint8_t DEVICE_ID = 0x70;
+  static const uint8_t DEVICE_ID = BoardAddress::DEFAULT_UNIT;  // Factory unit address
   static const uint8_t STX = 0x02;
   static const uint8_t ETX = 0x03;
-  static const int PACKET_SIZE = 9;
-  static const int PAYLOAD_SIZE = 6;
-  static const int MAX_DATA_SIZE = 20;
-  static const int MAX_HEX_STRING_SIZE = 40;
+  static const uint16_t BLE_RX_RING_SIZE = 128;  // ~130ms at 9600 baud, ~11ms at 115200
+  static const uint16_t COMMAND_QUEUE_SIZE = 16;  // Decoded commands awaiting execution
 
   // Commands
   static const uint8_t CMD_AUTO = 0x10;
@@ -52,12 +87,145 @@ public:
   static const uint8_t CMD_RECLINE = 0x90;
   static const uint8_t CMD_FORWARD = 0xA0;
   static const uint8_t CMD_BACKWARD = 0xB0;
+  static const uint8_t CMD_STATE = 0xC0;  // Firmware -> app state telemetry (extended frame)
+  static const uint8_t CMD_BATCH = 0xD0;  // Command/data1 tuples applied as one transaction (extended frame)
+  static const uint8_t CMD_LINK_CONFIG = 0xE0;
+  static const uint8_t CMD_ACK = 0xE1;   // Firmware -> app: data1 = acked command, data2 = RESULT_*
+  static const uint8_t CMD_NACK = 0xE2;  // Firmware -> app: data1 = NACK_* (sequence is a hint only)
+  static const uint8_t CMD_LATENCY_REPORT = 0xE3;  // data1: DATA_ON = print latency report, DATA_OFF = reset it
+  static const uint8_t CMD_ADDRESS_CONFIG = 0xE4;  // data1 = ADDR_OPT_*, data2 = value; replies with the address
+  static const uint8_t CMD_BLE_CAPTURE = 0xE5;     // data1: DATA_ON = dump capture journal, DATA_OFF = clear it
+  static const uint8_t CMD_LINK_STATS = 0xE6;      // data1: DATA_ON = reply with link counters, DATA_OFF = reply and reset
+  static const uint8_t CMD_FW_UPDATE = 0xE7;       // data1 = FirmwareUpdater::OP_*; BEGIN / DATA need an extended frame
+  static const uint8_t CMD_HEARTBEAT = 0xEE;  // App liveness (data1: DATA_ON = alive, DATA_OFF = closing)
   static const uint8_t CMD_DISCONNECT = 0xFF;
 
+  // Link options (CMD_LINK_CONFIG data1 = option, data2 = value)
+  static const uint8_t LINK_OPT_FRAMING = 0x01;
+  static const uint8_t FRAMING_HEX = 0x00;
+  static const uint8_t FRAMING_BINARY = 0x01;
+  static const uint8_t LINK_OPT_SEQUENCE = 0x02;
+  static const uint8_t SEQUENCE_LEGACY = 0x00;  // Fixed per-command sequences, 2s (seq, cmd, data1) window
+  static const uint8_t SEQUENCE_WINDOW = 0x01;  // Incrementing sequences, SequenceWindow bitmap
+  static const uint8_t LINK_OPT_ACK = 0x03;     // data2: 0x00 = off, 0x01 = ACK/NACK replies
+  static const uint8_t LINK_OPT_TELEMETRY = 0x04;  // data2: 0x00 = off, 0x01 = CMD_STATE frames
+
+  // Address options (CMD_ADDRESS_CONFIG data1 = option, data2 = value)
+  static const uint8_t ADDR_OPT_QUERY = 0x00;        // Reply only
+  static const uint8_t ADDR_OPT_UNIT = 0x01;         // data2 = new unit address (0x01..0xDF)
+  static const uint8_t ADDR_OPT_GROUP_JOIN = 0x02;   // data2 = group 0..15 (address 0xE0 + group)
+  static const uint8_t ADDR_OPT_GROUP_LEAVE = 0x03;  // data2 = group 0..15
+
+  // Command results (CMD_ACK data2)
+  static const uint8_t RESULT_OK = 0x00;
+  static const uint8_t RESULT_DUPLICATE = 0x01;  // Already applied (retransmit) - do not resend
+  static const uint8_t RESULT_REJECTED = 0x02;   // Not allowed in the current state (e.g. not homed)
+  static const uint8_t RESULT_INVALID = 0x03;    // Malformed frame or option
+  static const uint8_t RESULT_UNKNOWN = 0x04;    // Unknown command
+
+  // NACK reasons (CMD_NACK data1)
+  static const uint8_t NACK_CORRUPT = 0x01;      // Checksum, length or escape error
+  static const uint8_t NACK_QUEUE_FULL = 0x02;   // Valid frame dropped, resend later
+
+  // CMD_STATE mode flags (data byte 1)
+  static const uint8_t STATE_MODE_AUTO_DEFAULT = 0x01;
+  static const uint8_t STATE_MODE_KNEADING = 0x02;
+  static const uint8_t STATE_MODE_COMPRESSION = 0x04;
+  static const uint8_t STATE_MODE_PERCUSSION = 0x08;
+  static const uint8_t STATE_MODE_COMBINE = 0x10;
+  static const uint8_t STATE_MODE_ROLL_SPOT = 0x20;
+  static const uint8_t STATE_MODE_ROLL_DISABLED = 0x40;
+
+  // CMD_STATE status flags (data byte 2)
+  static const uint8_t STATE_STATUS_HOME_RUN = 0x01;
+  static const uint8_t STATE_STATUS_MODE_AUTO = 0x02;
+  static const uint8_t STATE_STATUS_MANUAL_PRIORITY = 0x04;
+  static const uint8_t STATE_STATUS_HOMING = 0x08;
+  static const uint8_t STATE_STATUS_LIMIT_UP = 0x10;
+  static const uint8_t STATE_STATUS_LIMIT_DOWN = 0x20;
+  static const uint8_t STATE_STATUS_BLE_RECOVERING = 0x40;  // HM10 did not come back after a reset
+
+  // CMD_LINK_STATS reply pages (data byte 1; counters big-endian)
+  static const uint8_t LINK_STATS_PAGE_TRAFFIC = 0x00;  // frames in, bytes in, frames out, bytes out (24 bit, wrap)
+  static const uint8_t LINK_STATS_PAGE_ERRORS = 0x01;   // checksum .. UART overrun (16 bit, saturate)
+
+  // Batch frame: DeviceID, Seq, CMD_BATCH, (Command, Data1) x N, Checksum (N = 2..MAX_BATCH_COMMANDS)
+  static const int BATCH_HEADER_SIZE = 3;
+  static const int MAX_BATCH_COMMANDS = (PacketCodec::MAX_BODY_SIZE - BATCH_HEADER_SIZE - 1) / 2;
+
   // Data values
   static const uint8_t DATA_ON = 0xF0;
   static const uint8_t DATA_OFF = 0x00;
 
+  // Link supervision
+  static const unsigned long LINK_TIMEOUT_TICKS = 1200;  // 12s - two missed 5s heartbeats plus margin
+  static const unsigned long LINK_TIMEOUT_MIN_TICKS = 100;  // 1s
+
+  // Hold-to-run lease (RECLINE/INCLINE/FORWARD/BACKWARD PUSH data2, in 10ms ticks; 0 = legacy repeat)
+  static const uint8_t HOLD_LEASE_MIN_TICKS = 10;  // 100ms - shorter leases are raised to this
+
+  // Command dispatch (COMMAND_TABLE in CommunicationManager.cpp)
+  typedef uint8_t (CommunicationManager::*CommandHandler)(const Packet& packet);
+
+  // Data1 values a command accepts (anything else is answered with RESULT_INVALID)
+  enum CommandData : uint8_t {
+    DATA_ANY,      // Handler interprets data1 (level, option)
+    DATA_ON_OFF    // DATA_ON or DATA_OFF only
+  };
+
+  // Relative urgency of a command
+  enum CommandPriority : uint8_t {
+    PRIORITY_LOW,     // Link housekeeping
+    PRIORITY_NORMAL,  // Mode and setting selection
+    PRIORITY_HIGH     // Motion and stop (button release, disconnect)
+  };
+
+  // Command flags
+  static const uint8_t CMD_FLAG_REPEAT_ON = 0x01;  // PUSH (DATA_ON) may repeat inside the legacy duplicate window
+  static const uint8_t CMD_FLAG_BATCH = 0x02;      // Allowed inside CMD_BATCH
+  static const uint8_t CMD_FLAG_NO_DEDUP = 0x04;   // Never treated as a duplicate
+  static const uint8_t CMD_FLAG_NO_ACK = 0x08;     // No CMD_ACK (replies itself or carries liveness only)
+  static const uint8_t CMD_FLAG_QUIET = 0x10;      // Kept out of the command log
+  static const uint8_t CMD_FLAG_UNICAST = 0x20;    // Ignored when sent to a group or broadcast address
+  static const uint8_t CMD_FLAG_STOP = 0x40;       // DATA_OFF also stops its motors from the receive path (stopFast())
+  static const uint8_t CMD_FLAG_HOMED = 0x80;      // DATA_ON is refused until GO HOME has completed
+
+  struct CommandSpec {
+    uint8_t command;
+    CommandHandler handler;
+    uint8_t data;       // CommandData
+    uint8_t flags;      // CMD_FLAG_*
+    uint8_t priority;   // CommandPriority
+    const char* name;   // Command log name
+  };
+
+  // Command byte -> COMMAND_TABLE slot (NO_COMMAND if unknown)
+  struct CommandIndex {
+    uint8_t slot[256];
+  };
+
+  // Link quality counters (CMD_LINK_STATS, service console)
+  struct LinkStats {
+    uint32_t framesIn;           // Valid frames received (hex and binary)
+    uint32_t bytesIn;            // Bytes received from the module
+    uint32_t framesOut;          // Frames queued for the app
+    uint32_t bytesOut;
+    uint32_t checksumErrors;
+    uint32_t lengthErrors;       // Too short, odd digit count, lost ETX
+    uint32_t formatErrors;       // Non-hex character, bad escape, marker inside a frame
+    uint32_t overflowErrors;     // Longer than the receive buffer
+    uint32_t addressMismatches;  // Frames for another board
+    uint32_t duplicates;         // Dropped by deduplication (either mode)
+    uint32_t uartOverruns;       // UART receive buffer full or USART overrun (bytes lost)
+    uint32_t binaryFramesIn;     // Part of framesIn that used binary framing
+    uint32_t binaryErrors;       // Binary frames dropped (also counted under their cause)
+  };
+
+  static const uint8_t NO_COMMAND = 0xFF;
+  static const CommandSpec COMMAND_TABLE[];
+  static const uint8_t COMMAND_COUNT;
+  static const CommandIndex COMMAND_INDEX;
+
   // Intensity levels
   // HIGH (0x20) -> PWM = 254, LOW (0x00) -> PWM = 160, OFF (0x00) -> PWM = 0
   static const uint8_t INTENSITY_LOW = 0x00;
@@ -65,22 +233,93 @@ public:
 
 private:
   // Serial interfaces
-  HardwareSerial* debugSerial;  // Debug UART - 115200 baud
-  HardwareSerial* bleSerial;    // BLE UART - 9600 baud
+  Print* debugSerial;           // Debug log channel (Debug UART - 115200 baud)
+  HardwareSerial* bleSerial;    // BLE UART - 9600 baud until Hm10Manager raises it
+
+  // Protocol address (DeviceID byte of received and sent frames)
+  BoardAddress boardAddress;
+  bool groupFrame;                // Frame being processed was sent to a group / broadcast (no replies)
+  bool repliesMuted;              // Handler runs for a local command: nothing is sent to the app
 
   // BLE module control
   static const int HM10_BREAK = HM10_BREAK_PIN;
-
-  // Data storage
-  byte data1[MAX_DATA_SIZE], data2[MAX_DATA_SIZE];
-  char hexString1[MAX_HEX_STRING_SIZE], hexString2[MAX_HEX_STRING_SIZE];
-  int dataLen1, dataLen2, hexIdx1, hexIdx2;
-  bool dataReady1, dataReady2;
-  ParseState state1, state2;
-
-  // Raw buffer
-  byte rawBuffer[50];
-  int rawBufferIndex;
+  Hm10Manager* hm10;              // Owns the UART while it resets or negotiates
+
+  // BLE frame decoders (decode straight into a Packet, no intermediate buffers)
+  HexFrameDecoder hexDecoder;
+
+  // BLE receive ring (drained from bleSerial once per loop pass)
+  RingBuffer<byte, BLE_RX_RING_SIZE> bleRxRing;
+  uint16_t bleFramesLastPass;     // Frames completed during the last pass
+  uint16_t bleMaxBytesInFlight;   // Worst-case bytes drained but not yet parsed
+
+  BinaryFrameDecoder binDecoder;
+  uint8_t txFraming;              // Framing used for replies (FRAMING_HEX / FRAMING_BINARY)
+  BleTxQueue txQueue;             // Encoded frames waiting for UART TX buffer room
+  bool ackEnabled;                // Reply CMD_ACK / CMD_NACK (LINK_OPT_ACK)
+  unsigned long acksSent;
+  unsigned long nacksSent;
+
+  LinkStats linkStats;
+
+  // Command queue (filled by ingest, drained by executePendingCommands())
+  RingBuffer<CommandRecord, COMMAND_QUEUE_SIZE> commandQueue;
+  unsigned long commandQueueDrops;  // Commands lost because the queue was full
+  unsigned long fastStops;          // Stop frames applied by stopFast() before queueing
+  unsigned long maxCommandLatencyTicks;
+
+  // State telemetry
+  struct StateSnapshot {
+    uint8_t program;            // SequenceController::AutoProgram
+    uint8_t modeFlags;          // STATE_MODE_*
+    uint8_t statusFlags;        // STATE_STATUS_*
+    uint8_t intensity;          // PWM level
+    uint16_t remainingSeconds;  // Auto session time left
+  } lastState;
+  bool telemetryEnabled;        // Off until the app asks (LINK_OPT_TELEMETRY)
+  bool telemetryPending;        // State changed since the last frame
+  uint8_t telemetrySequence;
+  unsigned long lastTelemetryTick;
+  unsigned long telemetryFramesSent;
+
+  static const unsigned long TELEMETRY_MIN_INTERVAL_TICKS = 20;  // 200ms - changes inside share one frame
+  static const unsigned long TELEMETRY_REFRESH_TICKS = 1000;     // 10s - resend unchanged state
+
+  // Batch transaction state
+  bool batchActive;               // Applying a batch frame
+  bool batchAutoSyncPending;      // Auto mode start/stop deferred to the end of the batch
+  uint8_t batchProgram;           // SequenceController::AutoProgram the tuples so far select
+  unsigned long batchFramesTotal;
+  unsigned long batchRejects;     // Batch frames refused (malformed, non-batchable or refused command)
+
+  // Link supervision
+  bool linkUp;
+  bool linkActivityPending;       // Valid frame received since the last supervision pass
+  bool linkSupervised;            // App heartbeats, so silence means loss
+  bool linkLossPausesAuto;        // Hold auto programs (manual priority) on link loss
+  bool linkPausedAuto;            // Auto currently held because of a link loss
+  unsigned long lastLinkActivityTick;
+  unsigned long linkTimeoutTicks;
+
+  // DMA receive driver (nullptr when the HardwareSerial path is used; stopped
+  // while Hm10Manager may reset the module or exchange AT commands)
+  BleDmaReceiver* bleDma;
+  unsigned long dmaOverrunsSeen;  // Receiver overruns already added to linkStats
+
+  // Command latency probes (nullptr unless LATENCY_PROBES)
+  LatencyProbe* latencyProbe;
+  uint8_t latencyReportLine;      // Next report line to print (0 = no report pending)
+#if LATENCY_PROBES
+  LatencyProbe::Stamps rxStamps;  // Frame being received
+#endif
+
+  // Received byte journal (nullptr unless BLE_CAPTURE)
+  BleCapture* bleCapture;
+  uint16_t captureDumpLine;       // Next dump line to print (0 = no dump pending)
+
+  // Firmware update session (nullptr unless FIRMWARE_UPDATE on a board with the flash driver)
+  FirmwareUpdater* firmwareUpdater;
+  uint8_t updateSequence;         // Sequence of the last request, echoed by unsolicited status frames
 
   // Command counter timers
   unsigned long autoCmdTimerTick;
@@ -98,23 +337,36 @@ private:
 
   static const unsigned long COMMAND_DUPLICATE_WINDOW_TICKS = 200;  // 2000ms (2 seconds)
 
+  // Sequence-window deduplication (SEQUENCE_WINDOW mode, reset for every link)
+  uint8_t sequenceMode;
+  SequenceWindow sequenceWindow;
+  unsigned long sequenceDuplicates;  // Retransmitted frames dropped
+  unsigned long sequenceStale;       // Frames older than the window dropped
+
   // Timer manager reference
   TimerManager* timerManager;
 
-  // Controller references for command execution (void pointers to avoid circular includes)
-  void* motorController;
-  void* sequenceController;
-  void* sensorManager;
+  // Controller references for command execution
+  MotorController* motorController;
+  SequenceController* sequenceController;
+  SensorManager* sensorManager;
+  SafetyManager* safetyManager;
 
   // Manual priority state management
   bool manualPriority;
 
+  // PWM applied for CMD_INTENSITY_LEVEL HIGH / LOW (service console tunables)
+  uint8_t intensityHighPWM;
+  uint8_t intensityLowPWM;
+  static const uint8_t INTENSITY_HIGH_PWM = 254;
+  static const uint8_t INTENSITY_LOW_PWM = 160;
+
   // Command counter timeout
   static const unsigned long COMMAND_COUNTER_TIMEOUT_TICKS = 1000;  // 10s
 
 public:
   // Constructor
-  CommunicationManager(TimerManager* timerMgr, HardwareSerial* debug, HardwareSerial* ble);
+  CommunicationManager(TimerManager* timerMgr, Print* debug, HardwareSerial* ble);
 
   // Destructor
   ~CommunicationManager();
@@ -124,7 +376,8 @@ public:
   void resetHM10();
 
   // Controller setup
-  void setControllers(void* motorCtrl, void* seqCtrl, void* sensorCtrl);
+  void setControllers(MotorController* motorCtrl, SequenceController* seqCtrl, SensorManager* sensorCtrl);
+  void setSafetyManager(SafetyManager* safetyMgr);
 
   // Manual priority management
   bool getManualPriority() const;
@@ -136,36 +389,154 @@ public:
 
   // BLE Communication
   void serial2DataIncome();
-  void drawDataProcess();
-  void processAndPrintResult();
 
   // Packet Processing
-  void parsePacket(byte receivedByte, ParseState& currentState,
-                   char hexString[], int& hexIndex, bool& dataReady);
-  void processFrame(byte* buf, int len);
-  void processCompleteFrame(byte* buf, int len);
-  void processCommand(byte* buf, int len);
+  void processPacket(const Packet& packet);
+  void processExtendedFrame(const Frame& frame);
+  static const CommandSpec* findCommand(uint8_t command);
+
+  // Local Commands (service console, no deduplication, no replies)
+  uint8_t runLocalCommand(uint8_t command, uint8_t data1, uint8_t data2 = 0x00);
+
+  // Command Queue
+  bool enqueueCommand(const Frame& frame);
+  void stopFast(const Frame& frame);
+  bool isStopDuplicate(const Packet& packet);
+  int executePendingCommands();
+  uint16_t getCommandQueueDepth() const {
+    return commandQueue.count();
+  }
+  uint16_t getCommandQueueHighWater() const {
+    return commandQueue.getHighWater();
+  }
+  unsigned long getCommandQueueDrops() const {
+    return commandQueueDrops;
+  }
+  unsigned long getFastStops() const {
+    return fastStops;
+  }
+  unsigned long getMaxCommandLatencyTicks() const {
+    return maxCommandLatencyTicks;
+  }
+  unsigned long getBatchFramesTotal() const {
+    return batchFramesTotal;
+  }
+  unsigned long getBatchRejects() const {
+    return batchRejects;
+  }
 
   // Packet Creation
   void createPacket(uint8_t deviceId, uint8_t sequence, uint8_t command,
                     uint8_t data1, uint8_t data2, uint8_t data3);
-  void buildFrameWithChecksum(const char* hexStr);
+  bool sendFrame(const uint8_t* body, int len, BleTxQueue::Lane lane = BleTxQueue::LANE_CONTROL);
+  void processTransmit();
+  const BleTxQueue& getTxQueue() const {
+    return txQueue;
+  }
+  uint8_t getTxFraming() const {
+    return txFraming;
+  }
+  void setTxFraming(uint8_t framing);
+  bool isAckEnabled() const {
+    return ackEnabled;
+  }
+  void setAckEnabled(bool enabled);
+  void sendAck(uint8_t sequence, uint8_t command, uint8_t result);
+  void sendNack(uint8_t sequence, uint8_t reason);
+  unsigned long getAcksSent() const {
+    return acksSent;
+  }
+  unsigned long getNacksSent() const {
+    return nacksSent;
+  }
+  void resetTxStats();
+
+  // State Telemetry
+  void processTelemetry();
+  void requestTelemetry();
+  void setTelemetryEnabled(bool enabled);
+  bool isTelemetryEnabled() const {
+    return telemetryEnabled;
+  }
+  unsigned long getTelemetryFramesSent() const {
+    return telemetryFramesSent;
+  }
+
+  // Latency Report (debug UART, a few lines per pass)
+  bool requestLatencyReport(bool reset);
+  void processLatencyReport();
+  LatencyProbe* getLatencyProbe() {
+    return latencyProbe;
+  }
+
+  // BLE Capture Dump (debug UART, a few lines per pass)
+  void processCaptureDump();
+  BleCapture* getBleCapture() {
+    return bleCapture;
+  }
+
+  // Link Statistics
+  const LinkStats& getLinkStats() const {
+    return linkStats;
+  }
+  void resetLinkStats();
+  void sendLinkStats(uint8_t sequence);
+
+  // Firmware Update (erase / verify steps and status replies, once per pass)
+  void processFirmwareUpdate();
+  FirmwareUpdater* getFirmwareUpdater() {
+    return firmwareUpdater;
+  }
 
-  // Checksum Functions
-  uint8_t calculate_checksum1(const uint8_t* data, int len);
-  bool verifyCompletePacket(uint8_t* packet, int length);
-  void debugChecksum(const byte* data, int len);
+  // Intensity Levels
+  uint8_t getIntensityHighPWM() const {
+    return intensityHighPWM;
+  }
+  void setIntensityHighPWM(uint8_t pwm) {
+    intensityHighPWM = pwm;
+  }
+  uint8_t getIntensityLowPWM() const {
+    return intensityLowPWM;
+  }
+  void setIntensityLowPWM(uint8_t pwm) {
+    intensityLowPWM = pwm;
+  }
 
-  // Utility Functions
-  int hexStringToBytes(const char* hexStr, byte* outBytes);
-  byte hexCharToByte(char c);
-  void processHexString(char hexString[], byte data[], int& dataLength);
-  void printProcessedData(byte data[], int length);
+  // Manual motion stopped by MotorController (lease lapsed / hard timeout)
+  void onManualMotionTimeout();
+
+  // Link Supervision
+  void superviseLink();
+  bool isLinkUp() const {
+    return linkUp;
+  }
+  bool isLinkSupervised() const {
+    return linkSupervised;
+  }
+  void setLinkTimeout(unsigned long timeoutTicks);
+  unsigned long getLinkTimeout() const {
+    return linkTimeoutTicks;
+  }
+  void setLinkLossPausesAuto(bool pause);
+  bool getLinkLossPausesAuto() const {
+    return linkLossPausesAuto;
+  }
 
   // Command Processing
   void checkCommandCounters();
   bool isCommandDuplicate(uint8_t sequence, uint8_t command, uint8_t data1);
   void updateLastCommand(uint8_t sequence, uint8_t command, uint8_t data1);
+  bool isSequenceRejected(uint8_t sequence);
+  uint8_t getSequenceMode() const {
+    return sequenceMode;
+  }
+  void setSequenceMode(uint8_t mode);
+  unsigned long getSequenceDuplicates() const {
+    return sequenceDuplicates;
+  }
+  unsigned long getSequenceStale() const {
+    return sequenceStale;
+  }
 
   // Command Counter Management
   void startAutoCmdTimer();
@@ -176,27 +547,28 @@ public:
   bool isOffCmdTimerActive() const;
 
   // Data Access
-  byte* getData1() {
-    return data1;
+  uint16_t getBleFramesLastPass() const {
+    return bleFramesLastPass;
   }
-  byte* getData2() {
-    return data2;
+  uint16_t getBleMaxBytesInFlight() const {
+    return bleMaxBytesInFlight;
   }
-  int getDataLen1() const {
-    return dataLen1;
+  void resetBleRxStats();
+  BleDmaReceiver* getBleDmaReceiver() {
+    return bleDma;
   }
-  int getDataLen2() const {
-    return dataLen2;
+  Hm10Manager* getHm10Manager() {
+    return hm10;
   }
-  bool isDataReady1() const {
-    return dataReady1;
+  const BoardAddress& getBoardAddress() const {
+    return boardAddress;
   }
-  bool isDataReady2() const {
-    return dataReady2;
+  bool isBleRecovering() const {
+    return hm10 && hm10->isRecovering();
   }
 
   // Serial Access
-  HardwareSerial* getDebugSerial() {
+  Print* getDebugSerial() {
     return debugSerial;
   }
   HardwareSerial* getBleSerial() {
@@ -207,27 +579,64 @@ private:
   // Helper functions
   void resetDataBuffers();
   void resetParseStates();
-  void processRawHexData();
+  int drainBleSerial();
+  void onBleUartReady();
+  void stopBleDma();
+  void processBleDmaFrames();
+  void ingestBleByte(byte receivedByte);
   void handleCommandTimeout();
 
-  // Command processing helpers
-  void processAutoCommand(uint8_t data1);
-  void processRollMotorCommand(uint8_t data1);
-  void processKneadingCommand(uint8_t data1);
-  void processPercussionCommand(uint8_t data1);
-  void processCompressionCommand(uint8_t data1);
-  void processCombineCommand(uint8_t data1);
-  void processIntensityCommand(uint8_t data1);
-  void processInclineCommand(uint8_t data1);
-  void processReclineCommand(uint8_t data1);
-  void processForwardCommand(uint8_t data1);
-  void processBackwardCommand(uint8_t data1);
-  void processDisconnectCommand(uint8_t data1);
-
-  // Validation helpers
-  bool isValidCommand(uint8_t command);
-  bool isValidData(uint8_t data);
-  bool isPacketComplete(const byte* buffer, int length);
+  // Command processing helpers (COMMAND_TABLE handlers)
+  uint8_t checkCommand(const CommandSpec& spec, uint8_t data1) const;
+  uint8_t dispatchCommand(const CommandSpec& spec, const Packet& packet, bool replies = true);
+  uint8_t processAutoCommand(const Packet& packet);
+  uint8_t processRollMotorCommand(const Packet& packet);
+  uint8_t processKneadingCommand(const Packet& packet);
+  uint8_t processPercussionCommand(const Packet& packet);
+  uint8_t processCompressionCommand(const Packet& packet);
+  uint8_t processCombineCommand(const Packet& packet);
+  uint8_t processIntensityCommand(const Packet& packet);
+  uint8_t processInclineCommand(const Packet& packet);
+  uint8_t processReclineCommand(const Packet& packet);
+  uint8_t processForwardCommand(const Packet& packet);
+  uint8_t processBackwardCommand(const Packet& packet);
+  uint8_t processDisconnectCommand(const Packet& packet);
+  uint8_t processLinkConfigCommand(const Packet& packet);
+  uint8_t processHeartbeatCommand(const Packet& packet);
+  uint8_t processLatencyReportCommand(const Packet& packet);
+  uint8_t processAddressConfigCommand(const Packet& packet);
+  uint8_t processBleCaptureCommand(const Packet& packet);
+  uint8_t processLinkStatsCommand(const Packet& packet);
+  uint8_t processFirmwareUpdateCommand(const Packet& packet);
+  uint8_t processBatchCommand(const Frame& frame);
+
+  // Batch helpers
+  bool isBatchableCommand(uint8_t command) const;
+  void trackBatchProgram(uint8_t command, uint8_t data1);
+  bool isIntensityChangeAllowed() const;
+  uint8_t applyBatchCommand(uint8_t sequence, uint8_t command, uint8_t data1);
+  void startAutoMode();
+  void stopAutoMode();
+  void finishBatch();
+
+  // Link supervision helpers
+  void noteLinkActivity();
+  void setLinkUp();
+  void setLinkDown(bool lost);
+  void performLinkSafeStop(bool lost);
+  void resetLinkOptions();
+
+  // Telemetry helpers
+  void captureState(StateSnapshot& state);
+  bool sendStateFrame(const StateSnapshot& state);
+
+  // Link statistics helpers
+  void countFrameError(PacketCodec::FrameError error);
+  static void putCounter(uint8_t* out, uint32_t value, uint8_t width);
+
+  // Firmware update helpers
+  void handleFirmwareUpdate(uint8_t sequence, const uint8_t* data, uint8_t length);
+  void sendUpdateStatus(FirmwareUpdater::Code code);
 };
 
 #endif  // COMMUNICATION_MANAGER_H
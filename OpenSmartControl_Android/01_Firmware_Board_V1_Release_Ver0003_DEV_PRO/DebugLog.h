@@ -0,0 +1,217 @@
+#ifndef DEBUG_LOG_H
+#define DEBUG_LOG_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <cstdint>
+#include <type_traits>
+#include "FeatureConfig.h"
+
+/**
+ * DebugLog Class
+ *
+ * Non-blocking debug output for the debug UART. Text printed through a
+ * module channel is copied into a RAM ring buffer and the call returns at
+ * once; drain() hands the UART only as many bytes as its TX buffer can take,
+ * and the UART TX-empty interrupt sends them from there. Debug output
+ * therefore never stalls the loop, and enabling it does not change timing.
+ *
+ * Features:
+ * - One Print channel per module, so existing print()/println() call sites work unchanged
+ * - Writable from ISR context (space is reserved under a short PRIMASK section)
+ * - Non-blocking drain (availableForWrite(), never waits for the UART)
+ * - Lines that do not fit are dropped whole, never cut, and counted; a marker line reports the loss
+ * - Per-module levels, changeable at runtime
+ *
+ * Channel print()/println() output is logged at LEVEL_INFO; log() takes an
+ * explicit level and writes the message and line end as one record. A
+ * channel line usually takes several write() calls (print(), print(value),
+ * println()); each channel tracks its open line so a line is kept or
+ * dropped as a whole.
+ *
+ * TRACE() records are binary and interleaved with the text:
+ *   0x1E | module << 4 | argc | token (LE16) | argc x argument (LE32)
+ * The token is the offset of the format string in the .trace_fmt section,
+ * which is not part of the flashed image; tools/trace_decode reads it from
+ * the .elf to print the line.
+ */
+class DebugLog {
+public:
+  enum Module : uint8_t {
+    MODULE_SYSTEM,
+    MODULE_TIMER,
+    MODULE_MOTOR,
+    MODULE_SENSOR,
+    MODULE_COMM,
+    MODULE_SAFETY,
+    MODULE_SEQUENCE,
+    MODULE_COUNT
+  };
+
+  enum Level : uint8_t {
+    LEVEL_OFF,
+    LEVEL_ERROR,
+    LEVEL_INFO,
+    LEVEL_DEBUG
+  };
+
+  static const uint16_t BUFFER_SIZE = DEBUG_LOG_BUFFER_SIZE;
+  static const uint8_t TRACE_MARKER = 0x1E;  // ASCII RS, never part of log text
+  static const uint8_t TRACE_MAX_ARGS = 4;
+
+  /**
+   * Line being written through a channel in several write() calls
+   */
+  struct LineState {
+    uint16_t start;  // head before the line's first stored byte
+    uint16_t end;    // head after its last stored write
+    bool open;       // Stored part does not end with '\n' yet
+    bool dropping;   // Line lost: discard writes up to its '\n'
+  };
+
+  /**
+   * Print adapter for one module
+   */
+  class Channel : public Print {
+  private:
+    DebugLog* owner;
+    Module module;
+    LineState line;
+
+  public:
+    Channel()
+      : owner(nullptr), module(MODULE_SYSTEM), line({ 0, 0, false, false }) {
+    }
+
+    void attach(DebugLog* log, Module mod) {
+      owner = log;
+      module = mod;
+    }
+
+    using Print::write;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int availableForWrite() override;
+  };
+
+private:
+  static_assert(BUFFER_SIZE > 0 && (BUFFER_SIZE & (BUFFER_SIZE - 1)) == 0, "DEBUG_LOG_BUFFER_SIZE must be a power of two");
+  static const uint16_t MASK = BUFFER_SIZE - 1;
+  static const int DROP_MARKER_ROOM = 32;  // UART TX space needed for the drop marker line
+
+  HardwareSerial* serial;
+
+  uint8_t buffer[BUFFER_SIZE];
+  volatile uint16_t head;  // Next write position (producers, under PRIMASK)
+  volatile uint16_t tail;  // Next read position (drain() only)
+  volatile bool draining;  // drain() / flush() is moving bytes out (no line take-back)
+  uint16_t highWater;
+
+  volatile unsigned long droppedBytes;
+  volatile unsigned long droppedLines;
+  unsigned long reportedDrops;   // droppedLines already announced by a marker line
+
+  Level levels[MODULE_COUNT];
+  Channel channels[MODULE_COUNT];
+
+  // Static instance for TRACE() call sites
+  static DebugLog* instance;
+
+  template <typename T>
+  static uint32_t traceArg(T value) {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "TRACE arguments must be integers");
+    return (uint32_t)value;
+  }
+
+  void traceRecord(Module module, uint16_t token, const uint32_t* args, uint8_t argc);
+  bool store(const uint8_t* data, size_t size);
+  size_t enqueueLinePart(LineState& line, const uint8_t* data, size_t size);
+
+public:
+  // Constructor
+  DebugLog(HardwareSerial* debugSerial);
+
+  // Output
+  Print* getChannel(Module module) {
+    return &channels[module];
+  }
+  bool isEnabled(Module module, Level level) const {
+    return module < MODULE_COUNT && level != LEVEL_OFF && level <= levels[module];
+  }
+  void log(Module module, Level level, const char* message);
+  size_t enqueue(const uint8_t* data, size_t size);
+
+  // Tokenized output (use the TRACE macro), logged at LEVEL_INFO
+  template <typename... Args>
+  static void trace(Module module, uint16_t token, Args... args) {
+    static_assert(sizeof...(Args) <= TRACE_MAX_ARGS, "TRACE takes at most 4 arguments");
+    DebugLog* log = instance;
+    if (!log || !log->isEnabled(module, LEVEL_INFO)) return;
+    const uint32_t values[] = { traceArg(args)..., 0 };
+    log->traceRecord(module, token, values, sizeof...(Args));
+  }
+
+  // Background transmission (main loop)
+  void drain();
+  void flush();
+
+  // Levels
+  void setLevel(Module module, Level level);
+  void setAllLevels(Level level);
+  Level getLevel(Module module) const {
+    return (module < MODULE_COUNT) ? levels[module] : LEVEL_OFF;
+  }
+
+  // Statistics
+  uint16_t getPendingBytes() const {
+    return (uint16_t)(head - tail);
+  }
+  uint16_t getFreeBytes() const {
+    return (uint16_t)(BUFFER_SIZE - (uint16_t)(head - tail));
+  }
+  uint16_t getHighWater() const {
+    return highWater;
+  }
+  unsigned long getDroppedBytes() const {
+    return droppedBytes;
+  }
+  unsigned long getDroppedLines() const {
+    return droppedLines;
+  }
+  void resetStatistics();
+};
+
+/**
+ * Trace format string section
+ * Non-allocated, so the strings are kept in the .elf but never flashed. GCC
+ * appends its own flags after the section name; the trailing assembler
+ * comment character discards them.
+ */
+#ifndef TRACE_FORMAT_SECTION
+#if defined(__arm__)
+#define TRACE_FORMAT_SECTION ".trace_fmt,\"\",%progbits @"
+#else
+#define TRACE_FORMAT_SECTION ".trace_fmt,\"\",@progbits #"
+#endif
+#endif
+
+/**
+ * TRACE(MODULE_x, "format", args...)
+ * Logs one line as a format token plus up to 4 integer arguments.
+ * Supported conversions: %d %i %u %x %X %c %% (flags, width and l allowed).
+ */
+#if DEBUG_TRACE
+#define TRACE(module, format, ...) \
+  do { \
+    static const char traceFormat[] __attribute__((section(TRACE_FORMAT_SECTION), used)) = format; \
+    DebugLog::trace(DebugLog::module, (uint16_t)(uintptr_t)traceFormat, ##__VA_ARGS__); \
+  } while (0)
+#else
+// Arguments still type-checked and counted as used, but never evaluated
+#define TRACE(module, format, ...) \
+  do { \
+    if (false) DebugLog::trace(DebugLog::module, 0, ##__VA_ARGS__); \
+  } while (0)
+#endif
+
+#endif  // DEBUG_LOG_H
@@ -0,0 +1,257 @@
+#ifndef FIRMWARE_UPDATER_H
+#define FIRMWARE_UPDATER_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include "FeatureConfig.h"
+#include "TimerManager.h"
+
+/**
+ * FlashBank Class
+ *
+ * Page-erase / halfword-program flash as the updater sees it. The MCU
+ * implementation drives the STM32 HAL; a host model can enforce the same
+ * rules (erase to 0xFF, program erased halfwords only) for testing.
+ */
+class FlashBank {
+public:
+  static const uint32_t PAGE_SIZE = 1024;  // STM32F103 medium / low density
+
+  virtual ~FlashBank() {}
+
+  // Erase the page starting at address (PAGE_SIZE aligned)
+  virtual bool erasePage(uint32_t address) = 0;
+
+  // Program erased flash (even address and length), read back to check
+  virtual bool program(uint32_t address, const uint8_t* data, uint16_t length) = 0;
+
+  // Memory-mapped read access
+  virtual const uint8_t* map(uint32_t address) const = 0;
+};
+
+/**
+ * FirmwareUpdater Class
+ *
+ * Receives an update package over the BLE link and stages it for the
+ * bootloader. The running application is never written: the new image is
+ * decoded into the staging region, verified, and a boot control record asks
+ * the bootloader to copy it over the application on the next reset.
+ *
+ * Flash layout (128 KB STM32F103, 1 KB pages):
+ *   0x08000000  bootloader             4 KB
+ *   0x08001000  application           61 KB  (APP_ADDRESS)
+ *   0x08010400  staging               61 KB  (STAGING_ADDRESS)
+ *   0x0801F800  boot control record    1 KB  (CONTROL_ADDRESS)
+ *   0x0801FC00  emulated EEPROM        1 KB  (BoardAddress)
+ *
+ * Package (built by tools/fw_package, big-endian):
+ *   "OSFW", version 1, format, 2 reserved bytes, image size, image CRC32,
+ *   base size, base CRC32, then the payload. Formats:
+ *   - FORMAT_RAW:   payload is the image
+ *   - FORMAT_LZ:    payload is a list of ops (below), back references only
+ *   - FORMAT_DELTA: ops may also copy blocks of the running image (base);
+ *                   refused unless the running image matches base size/CRC32
+ *   Op byte: kind in bits 7..6, length in bits 5..0 (63 = add a LEB128 value)
+ *   - OP_LITERAL (0): length + 1 literal bytes follow
+ *   - OP_MATCH (1):   copy length + 3 bytes from LEB128 (distance - 1) back in the output
+ *   - OP_BASE (2):    copy length + 3 bytes from the base at cursor + zigzag
+ *                     LEB128 delta; the cursor then moves past the block
+ *   Copies are at most MAX_COPY bytes.
+ *
+ * Accepted chunks wait in a small input buffer and are decoded by poll(),
+ * at most DECODE_BUDGET image bytes (~13ms of programming) per loop pass,
+ * so a chunk made of long copies is written over several passes. While the
+ * buffer is full the next chunk is refused (CODE_CHUNK_REFUSED) and resent.
+ *
+ * Features:
+ * - Package streamed in chunks with a CRC-16 each, accepted strictly in order
+ * - Resume after a disconnect: BEGIN with the same package continues at the
+ *   next missing offset
+ * - Staging erased a page per loop pass before the first chunk
+ * - Whole image CRC32 verified from flash before commit
+ * - Only compiled in with FIRMWARE_UPDATE (FeatureConfig.h)
+ */
+class FirmwareUpdater {
+public:
+  // CMD_FW_UPDATE operations (first data byte)
+  static const uint8_t OP_BEGIN = 0x01;   // Stream size (3), stream CRC32 (4)
+  static const uint8_t OP_DATA = 0x02;    // Offset (3), 1..MAX_CHUNK bytes, CRC-16 (2) of offset + bytes
+  static const uint8_t OP_COMMIT = 0x03;  // Install the verified image (board restarts)
+  static const uint8_t OP_ABORT = 0x04;
+  static const uint8_t OP_QUERY = 0x05;
+  static const uint8_t OP_STATUS = 0x80;  // Firmware -> app: state, code, next offset (3), stream size (3)
+
+  enum State : uint8_t {
+    STATE_IDLE,
+    STATE_ERASING,     // Staging being erased, chunks not accepted yet
+    STATE_RECEIVING,
+    STATE_VERIFYING,   // Stream complete, image CRC being checked
+    STATE_VERIFIED,    // Ready for OP_COMMIT
+    STATE_INSTALLING,  // Boot control record written, restart pending
+    STATE_FAILED
+  };
+
+  enum Code : uint8_t {
+    CODE_OK,
+    CODE_UNSUPPORTED,    // Built without FIRMWARE_UPDATE
+    CODE_BUSY,           // Motors running
+    CODE_BAD_REQUEST,    // Malformed frame or operation not valid in this state
+    CODE_BAD_HEADER,     // Package magic, version or format
+    CODE_TOO_LARGE,      // Image does not fit the staging region
+    CODE_BASE_MISMATCH,  // Delta package built against another image
+    CODE_DECODE_ERROR,
+    CODE_FLASH_ERROR,
+    CODE_CRC_MISMATCH,   // Stream or image CRC32
+    CODE_CHUNK_REFUSED   // DATA out of order or failed its CRC-16: resend from the next offset
+  };
+
+  static const uint8_t FORMAT_RAW = 0;
+  static const uint8_t FORMAT_LZ = 1;
+  static const uint8_t FORMAT_DELTA = 2;
+
+  // Flash layout
+  static const uint32_t APP_ADDRESS = 0x08001000;
+  static const uint32_t REGION_SIZE = 61 * FlashBank::PAGE_SIZE;
+  static const uint32_t STAGING_ADDRESS = APP_ADDRESS + REGION_SIZE;
+  static const uint32_t CONTROL_ADDRESS = STAGING_ADDRESS + REGION_SIZE;
+
+  // Boot control record (CONTROL_ADDRESS), read by the bootloader (bootloader/BootInstaller.h)
+  static const uint32_t BOOT_MAGIC = 0x4342534F;  // "OSBC"
+  struct BootControl {
+    uint32_t magic;
+    uint32_t imageSize;
+    uint32_t imageCrc;
+    uint32_t check;  // ~(magic ^ imageSize ^ imageCrc)
+  };
+
+  static const uint8_t HEADER_SIZE = 24;
+  static const uint8_t MAX_CHUNK = 9;             // Fills a 19-byte extended frame
+  static const uint8_t STATUS_INTERVAL = 8;       // Chunks per progress status
+  static const uint16_t MAX_COPY = 512;           // Longest match / base copy
+  static const uint16_t DECODE_BUDGET = MAX_COPY; // Image bytes written per poll() (~13ms of programming)
+  static const uint8_t INPUT_SIZE = 4 * MAX_CHUNK; // Accepted package bytes not decoded yet
+  static const uint8_t MIN_MATCH = 3;
+  static const uint8_t ROW_SIZE = 64;             // Output bytes buffered per program call
+  static const uint16_t VERIFY_BYTES_PER_PASS = 4096;
+  static const unsigned long RESTART_DELAY_TICKS = 50;  // 500ms - last status frame goes out first
+
+private:
+  enum DecodeState : uint8_t {
+    DECODE_HEADER,
+    DECODE_OP,
+    DECODE_LENGTH,     // LEB128 length extension
+    DECODE_LITERAL,
+    DECODE_DISTANCE,   // LEB128 match distance
+    DECODE_BASE,       // LEB128 zigzag base delta
+    DECODE_COPY,       // Match / base copy being written
+    DECODE_RAW
+  };
+
+  FlashBank* flash;
+  TimerManager* timerManager;
+
+  State state;
+  Code error;                // Why the session failed (CODE_OK otherwise)
+
+  // Package transfer
+  uint32_t streamSize;
+  uint32_t streamCrc;        // Expected (BEGIN)
+  uint32_t receivedCrc;      // Running CRC32 of accepted bytes
+  uint32_t nextOffset;
+  uint8_t chunksSinceStatus;
+  bool gapReported;          // Status already sent for the current gap
+  uint16_t erasePage;        // Next staging page to erase
+  uint32_t verifyOffset;
+  uint32_t verifyCrc;
+  unsigned long restartTick;
+  unsigned long chunkErrors; // Chunks refused (CRC) or out of order
+
+  // Package header
+  uint8_t header[HEADER_SIZE];
+  uint8_t format;
+  uint32_t imageSize;
+  uint32_t imageCrc;
+  uint32_t baseSize;
+
+  // Payload decoder
+  DecodeState decodeState;
+  uint8_t opKind;
+  uint32_t opLength;
+  uint32_t varint;
+  uint8_t varintShift;
+  uint32_t outPos;           // Image bytes produced
+  uint32_t basePos;          // Base cursor (FORMAT_DELTA)
+  uint32_t copySource;       // Next byte of the copy (output or base position)
+  bool copyFromBase;
+
+  // Accepted package bytes, decoded by poll()
+  uint8_t input[INPUT_SIZE];
+  uint8_t inputHead;
+  uint8_t inputFill;
+  uint32_t decodeOffset;     // Package offset of input[inputHead]
+
+  // Output row not yet programmed
+  uint8_t row[ROW_SIZE];
+  uint8_t rowFill;
+  uint32_t rowBase;          // Image offset of row[0]
+
+  void startSession();
+  void fail(Code code);
+  bool runDecoder();
+  bool isDecoderIdle() const {
+    return inputHead == inputFill && decodeState != DECODE_COPY;
+  }
+  bool decode(uint8_t b);
+  bool parseHeader();
+  bool readVarint(uint8_t b, bool& done);
+  bool startOp(uint8_t b);
+  bool runOp();
+  bool copyMatch(uint32_t distance);
+  bool copyBase(int32_t delta);
+  bool continueCopy(uint32_t limit);
+  bool putByte(uint8_t b);
+  uint8_t readOutput(uint32_t position) const;
+  bool flushRow();
+  bool finishStream();
+  bool writeBootControl();
+
+public:
+  // Constructor (takes ownership of the flash driver)
+  FirmwareUpdater(FlashBank* bank, TimerManager* timer);
+  ~FirmwareUpdater();
+
+  // Requests (CMD_FW_UPDATE)
+  Code begin(uint32_t size, uint32_t crc);
+  bool writeChunk(uint32_t offset, const uint8_t* data, uint8_t length, uint16_t crc);
+  Code commit();
+  void abort();
+
+  // Main loop: erase / decode / verify / restart steps (true when a status is due)
+  bool poll();
+
+  // Status
+  State getState() const {
+    return state;
+  }
+  Code getError() const {
+    return error;
+  }
+  uint32_t getNextOffset() const {
+    return nextOffset;
+  }
+  uint32_t getStreamSize() const {
+    return streamSize;
+  }
+  unsigned long getChunkErrors() const {
+    return chunkErrors;
+  }
+
+  // Checksums shared with tools/fw_package
+  static uint32_t crc32(uint32_t crc, const uint8_t* data, uint32_t length);
+  static uint16_t crc16(uint16_t crc, const uint8_t* data, uint8_t length);
+
+  // MCU flash driver (nullptr where the HAL flash driver is not available)
+  static FlashBank* createMcuFlash();
+};
+
+#endif  // FIRMWARE_UPDATER_H
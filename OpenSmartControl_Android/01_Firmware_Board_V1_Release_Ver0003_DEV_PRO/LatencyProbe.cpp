@@ -0,0 +1,188 @@
+#include "LatencyProbe.h"
+
+// Static instance for MotorController pin marks
+LatencyProbe* LatencyProbe::instance = nullptr;
+
+/**
+ * Histogram helpers
+ */
+void LatencyProbe::Histogram::clear() {
+  memset(this, 0, sizeof(*this));
+}
+
+void LatencyProbe::Histogram::add(uint32_t us) {
+  uint8_t bucket = (us == 0) ? 0 : (uint8_t)(32 - __builtin_clz(us));
+  if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+
+  if (buckets[bucket] == 0xFFFF) {
+    // Keep the distribution, lose resolution on very long runs
+    for (uint8_t i = 0; i < BUCKETS; i++) {
+      buckets[i] >>= 1;
+    }
+  }
+  buckets[bucket]++;
+
+  if (count == 0 || us < minUs) minUs = us;
+  if (us > maxUs) maxUs = us;
+  sumUs += us;
+  count++;
+}
+
+uint32_t LatencyProbe::Histogram::averageUs() const {
+  return count ? (uint32_t)(sumUs / count) : 0;
+}
+
+/**
+ * Upper bound of the bucket holding the given percentile (at most maxUs)
+ */
+uint32_t LatencyProbe::Histogram::percentileUs(uint8_t percent) const {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    total += buckets[i];
+  }
+  if (total == 0) return 0;
+
+  uint32_t target = (total * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    seen += buckets[i];
+    if (seen >= target) {
+      uint32_t upper = (i == BUCKETS - 1) ? maxUs : (1UL << i) - 1;
+      return (upper < maxUs) ? upper : maxUs;
+    }
+  }
+  return maxUs;
+}
+
+/**
+ * Constructor
+ */
+LatencyProbe::LatencyProbe()
+  : cyclesPerMicrosecond(1), commandActive(false), commandSlot(0), dispatchStamp(0), handlerEndStamp(0), pinStamp(0), dispatched(false), handled(false), pinWritten(false), stopActive(false) {
+  memset(&commandStamps, 0, sizeof(commandStamps));
+  reset();
+  instance = this;
+}
+
+/**
+ * Destructor
+ */
+LatencyProbe::~LatencyProbe() {
+  if (instance == this) {
+    instance = nullptr;
+  }
+}
+
+/**
+ * Start the time source
+ */
+void LatencyProbe::begin() {
+#if LATENCY_CYCLE_COUNTER
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  cyclesPerMicrosecond = SystemCoreClock / 1000000UL;
+  if (cyclesPerMicrosecond == 0) cyclesPerMicrosecond = 1;
+#else
+  cyclesPerMicrosecond = 1;
+#endif
+}
+
+/**
+ * Command taken from the queue (slot: COMMAND_TABLE entry or extended frame)
+ */
+void LatencyProbe::beginCommand(uint8_t slot, const Stamps& stamps) {
+  commandSlot = slot;
+  commandStamps = stamps;
+  dispatched = false;
+  handled = false;
+  pinWritten = false;
+  commandActive = true;
+}
+
+/**
+ * Command finished: file its stage durations
+ */
+void LatencyProbe::endCommand() {
+  if (!commandActive) return;
+  commandActive = false;
+  if (!dispatched || !handled) return;
+
+  uint32_t output = pinWritten ? pinStamp : handlerEndStamp;
+  uint32_t total = toMicroseconds(output - commandStamps.stx);
+
+  stages[STAGE_FRAME].add(toMicroseconds(commandStamps.etx - commandStamps.stx));
+  stages[STAGE_DECODE].add(toMicroseconds(commandStamps.valid - commandStamps.etx));
+  stages[STAGE_QUEUE].add(toMicroseconds(dispatchStamp - commandStamps.valid));
+  stages[STAGE_HANDLER].add(toMicroseconds(output - dispatchStamp));
+  stages[STAGE_TOTAL].add(total);
+
+  if (commandSlot < MAX_SLOTS) {
+    commands[commandSlot].add(total);
+  }
+}
+
+/**
+ * Stop fast path started: catch the first motor pin it writes
+ */
+void LatencyProbe::beginStop() {
+  pinWritten = false;
+  stopActive = true;
+}
+
+/**
+ * Stop fast path done: file STX/SOH -> pin write (nothing if no motor ran)
+ */
+void LatencyProbe::endStop(const Stamps& stamps) {
+  if (!stopActive) return;
+  stopActive = false;
+  if (pinWritten) {
+    stages[STAGE_STOP].add(toMicroseconds(pinStamp - stamps.stx));
+  }
+  pinWritten = false;
+}
+
+/**
+ * Stage name for reports
+ */
+const char* LatencyProbe::getStageName(Stage stage) {
+  switch (stage) {
+    case STAGE_FRAME: return "FRAME";
+    case STAGE_DECODE: return "DECODE";
+    case STAGE_QUEUE: return "QUEUE";
+    case STAGE_HANDLER: return "HANDLER";
+    case STAGE_TOTAL: return "TOTAL";
+    case STAGE_STOP: return "STOP (fast path)";
+    default: return "?";
+  }
+}
+
+/**
+ * Format one report line (line must hold LINE_SIZE bytes)
+ * Returns the line length.
+ */
+int LatencyProbe::formatLine(char* line, const char* name, const Histogram& histogram) {
+  int len = snprintf(line, LINE_SIZE, "%-16s n=%lu min=%lu avg=%lu p99=%lu max=%lu\r\n",
+                     name,
+                     (unsigned long)histogram.count,
+                     (unsigned long)histogram.minUs,
+                     (unsigned long)histogram.averageUs(),
+                     (unsigned long)histogram.percentileUs(99),
+                     (unsigned long)histogram.maxUs);
+  if (len < 0) return 0;
+  return (len < LINE_SIZE) ? len : LINE_SIZE - 1;
+}
+
+/**
+ * Clear every histogram (the command running now is not filed either)
+ */
+void LatencyProbe::reset() {
+  commandActive = false;
+  stopActive = false;
+  for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+    stages[i].clear();
+  }
+  for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+    commands[i].clear();
+  }
+}
@@ -0,0 +1,202 @@
+#ifndef PACKET_CODEC_H
+#define PACKET_CODEC_H
+
+#include <Arduino.h>
+#include <cstdint>
+
+/**
+ * Decoded 9-byte logical packet (STX/ETX not stored)
+ * Field order matches the wire order, so the struct can be filled byte by byte.
+ */
+struct Packet {
+  uint8_t deviceId;
+  uint8_t sequence;
+  uint8_t command;
+  uint8_t data1;
+  uint8_t data2;
+  uint8_t data3;
+  uint8_t checksum;
+};
+
+static_assert(sizeof(Packet) == 7, "Packet must have no padding");
+
+/**
+ * PacketCodec Class
+ *
+ * Stateless helpers shared by the frame decoders and the transmit path.
+ *
+ * Wire formats:
+ * - Hex (legacy):  STX + 14 ASCII hex chars + ETX                (16 bytes)
+ * - Binary:        SOH + 7 raw bytes, DLE-stuffed + ETX        (9..16 bytes)
+ *   SOH, STX, ETX and DLE inside the body are sent as DLE, byte ^ 0x20,
+ *   so a frame marker can never appear inside a binary body.
+ *
+ * Extended frames use the same envelopes with a longer body
+ * (DeviceID, Sequence, Command, N data bytes, Checksum over all but the
+ * checksum), up to MAX_BODY_SIZE bytes so the hex form still fits the
+ * legacy 39-character receive buffer.
+ */
+class PacketCodec {
+public:
+  static const uint8_t SOH = 0x01;  // Start of binary frame
+  static const uint8_t STX = 0x02;  // Start of hex frame
+  static const uint8_t ETX = 0x03;  // End of either frame
+  static const uint8_t DLE = 0x10;  // Escape marker (binary frames)
+  static const uint8_t ESCAPE_XOR = 0x20;
+
+  static const int PAYLOAD_SIZE = 6;                                // deviceId..data3
+  static const int BODY_SIZE = 7;                                   // payload + checksum
+  static const int MAX_BINARY_FRAME_SIZE = 2 + (2 * BODY_SIZE);    // every byte escaped
+  static const int MAX_BODY_SIZE = 19;                              // extended frames
+  static const int MAX_FRAME_SIZE = 2 + (2 * MAX_BODY_SIZE);       // hex or fully escaped binary
+  static const uint8_t NOT_HEX = 0xFF;                              // hexNibble() of a non-hex character
+
+  // Why a decoder dropped a frame (link statistics)
+  enum FrameError : uint8_t {
+    ERROR_NONE,
+    ERROR_CHECKSUM,
+    ERROR_LENGTH,    // Too short, odd hex digit count, or cut off by a new frame start
+    ERROR_FORMAT,    // Non-hex character, bad escape, or frame marker inside the body
+    ERROR_OVERFLOW   // Longer than MAX_BODY_SIZE (receive buffer)
+  };
+
+  // Checksum (sum with end-around carry, one's complement + 0x10)
+  static uint8_t checksum(const uint8_t* data, int len);
+  static uint8_t foldChecksum(uint16_t sum);
+  static uint8_t checksum(const Packet& packet);
+  static void seal(Packet& packet);
+  static bool isValid(const Packet& packet);
+  static bool isValid(const uint8_t* body, int len);
+
+  // Binary framing
+  static bool needsEscape(uint8_t b);
+  static int encodeBinary(const Packet& packet, uint8_t* out);
+  static int encodeBinary(const uint8_t* body, int len, uint8_t* out);
+
+  // Hex framing
+  static uint8_t hexNibble(uint8_t c);
+  static int encodeHex(const uint8_t* body, int len, uint8_t* out);
+};
+
+/**
+ * Decoded frame body of BODY_SIZE..MAX_BODY_SIZE bytes (checksum last)
+ * A plain command (length == BODY_SIZE) can be read through packet().
+ */
+struct Frame {
+  uint8_t length;
+  uint8_t body[PacketCodec::MAX_BODY_SIZE];
+
+  bool isExtended() const {
+    return length > PacketCodec::BODY_SIZE;
+  }
+  const Packet& packet() const {
+    return *reinterpret_cast<const Packet*>(body);
+  }
+};
+
+/**
+ * BinaryFrameDecoder Class
+ *
+ * Byte-at-a-time decoder for binary frames. Unstuffed bytes are written
+ * straight into the Frame, and the checksum is verified on ETX.
+ */
+class BinaryFrameDecoder {
+public:
+  enum Result {
+    NONE,   // Byte consumed, no frame yet
+    FRAME,  // Valid frame available via getPacket()
+    ERROR   // Frame dropped (length, escape or checksum error)
+  };
+
+private:
+  enum State {
+    WAIT_SOH,
+    READ_BODY,
+    READ_ESCAPED
+  };
+
+  Frame frame;
+  uint8_t index;
+  State state;
+  PacketCodec::FrameError error;  // Reason for the last ERROR
+
+  Result fail(PacketCodec::FrameError reason);
+
+public:
+  BinaryFrameDecoder();
+
+  Result feed(uint8_t b);
+  void reset();
+
+  bool isReceiving() const {
+    return state != WAIT_SOH;
+  }
+  PacketCodec::FrameError getError() const {
+    return error;
+  }
+  const Frame& getFrame() const {
+    return frame;
+  }
+  const Packet& getPacket() const {
+    return frame.packet();
+  }
+};
+
+/**
+ * HexFrameDecoder Class
+ *
+ * Single-pass decoder for legacy hex frames. Nibble pairs are converted as
+ * they arrive and the byte sum is kept running, so a validated Frame is
+ * ready on ETX without the hex string / byte array / 9-byte packet copies.
+ *
+ * A frame is refused (ERROR on ETX, NACK_CORRUPT) unless it is exactly an
+ * even number of hex digits, BODY_SIZE..MAX_BODY_SIZE bytes, with a
+ * matching checksum. Non-hex characters (NUL included), an odd digit count
+ * or an overlong body are never truncated or decoded as 0, so line noise
+ * cannot turn into a valid command. An STX inside a frame starts a new one.
+ * Longer strings (up to MAX_BODY_SIZE bytes) are extended frames.
+ */
+class HexFrameDecoder {
+public:
+  enum Result {
+    NONE,   // Byte consumed, no frame yet
+    FRAME,  // Valid frame available via getPacket()
+    ERROR   // Frame dropped (length or checksum error)
+  };
+
+  static const uint8_t MAX_HEX_CHARS = 2 * PacketCodec::MAX_BODY_SIZE;
+
+private:
+  enum State {
+    WAIT_STX,
+    READ_HEX
+  };
+
+  Frame frame;
+  uint16_t sum;        // Running sum of all decoded bytes (before carry fold)
+  uint8_t length;      // Hex digits received
+  uint8_t highNibble;
+  PacketCodec::FrameError error;  // Frame being received is malformed / reason for the last ERROR
+  State state;
+
+public:
+  HexFrameDecoder();
+
+  Result feed(uint8_t b);
+  void reset();
+
+  bool isReceiving() const {
+    return state != WAIT_STX;
+  }
+  PacketCodec::FrameError getError() const {
+    return error;
+  }
+  const Frame& getFrame() const {
+    return frame;
+  }
+  const Packet& getPacket() const {
+    return frame.packet();
+  }
+};
+
+#endif  // PACKET_CODEC_H
@@ -0,0 +1,95 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <Arduino.h>
+#include <cstdint>
+
+/**
+ * RingBuffer Template
+ *
+ * Fixed-size single-producer/single-consumer ring buffer.
+ * One side may run in ISR context while the other runs in the main loop.
+ *
+ * Features:
+ * - No dynamic allocation (storage is part of the object)
+ * - Power-of-two capacity with free-running indices (no wasted slot)
+ * - O(1) push/pop, never blocks
+ * - High-water mark for sizing and diagnostics
+ */
+template <typename T, uint16_t SIZE>
+class RingBuffer {
+  static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "RingBuffer SIZE must be a power of two");
+
+private:
+  static const uint16_t MASK = SIZE - 1;
+
+  T buffer[SIZE];
+  volatile uint16_t head;  // Next write position (producer only)
+  volatile uint16_t tail;  // Next read position (consumer only)
+  volatile uint16_t highWater;
+
+public:
+  RingBuffer()
+    : head(0), tail(0), highWater(0) {
+  }
+
+  // Producer side
+  bool push(const T& item) {
+    uint16_t h = head;
+    if ((uint16_t)(h - tail) >= SIZE) return false;  // Full
+    buffer[h & MASK] = item;
+    __sync_synchronize();  // Publish data before index
+    head = h + 1;
+
+    uint16_t used = (uint16_t)(h + 1 - tail);
+    if (used > highWater) highWater = used;
+    return true;
+  }
+
+  // Consumer side
+  bool pop(T& item) {
+    uint16_t t = tail;
+    if (t == head) return false;  // Empty
+    item = buffer[t & MASK];
+    __sync_synchronize();  // Finish reading before releasing the slot
+    tail = t + 1;
+    return true;
+  }
+
+  bool peek(T& item) const {
+    uint16_t t = tail;
+    if (t == head) return false;
+    item = buffer[t & MASK];
+    return true;
+  }
+
+  // Drop everything currently queued (consumer side)
+  void clear() {
+    tail = head;
+  }
+
+  // Status
+  uint16_t count() const {
+    return (uint16_t)(head - tail);
+  }
+  uint16_t space() const {
+    return SIZE - count();
+  }
+  bool isEmpty() const {
+    return head == tail;
+  }
+  bool isFull() const {
+    return count() >= SIZE;
+  }
+  uint16_t capacity() const {
+    return SIZE;
+  }
+  uint16_t getHighWater() const {
+    return highWater;
+  }
+  void resetHighWater() {
+    highWater = count();
+  }
+};
+
+#endif  // RING_BUFFER_H
@@ -1,10 +1,11 @@
 #include "SafetyManager.h"
+#include "DebugLog.h"
 
 /**
  * Constructor
  */
-SafetyManager::SafetyManager(TimerManager* timerMgr, HardwareSerial* debugSer)
-  : timerManager(timerMgr), debugSerial(debugSer), systemStuck(false), emergencyStopActive(false), lastSystemActivityTick(0), systemStuckStartTick(0), lastWatchdogFeedTick(0), systemHealthCheckActive(false), lastHealthCheckTick(0) {
+SafetyManager::SafetyManager(TimerManager* timerMgr, Print* debugSer)
+  : timerManager(timerMgr), debugSerial(debugSer), systemStuck(false), emergencyStopActive(false), lastSystemActivityTick(0), systemStuckStartTick(0), lastWatchdogFeedTick(0), systemHealthCheckActive(false), lastHealthCheckTick(0), linkUp(false), linkChangeTick(0), linkDropCount(0) {
 }
 
 /**
@@ -205,14 +206,16 @@ bool SafetyManager::isSystemRecovering() const {
  * Print safety status
  */
 void SafetyManager::printSafetyStatus() const {
-  // Safety Status debug disabled to save Flash memory
+  TRACE(MODULE_SAFETY, "SAFETY: emergencyStop=%u stuck=%u recovering=%u", emergencyStopActive, systemStuck, isSystemRecovering());
+  TRACE(MODULE_SAFETY, "SAFETY: link=%u changed@%lu drops=%lu", linkUp, linkChangeTick, linkDropCount);
 }
 
 /**
  * Print system health status
  */
 void SafetyManager::printSystemHealthStatus() const {
-  // System Health debug disabled to save Flash memory
+  TRACE(MODULE_SAFETY, "HEALTH: check=%u lastCheck@%lu idle=%lu ticks", systemHealthCheckActive, lastHealthCheckTick, getTimeSinceLastActivity());
+  TRACE(MODULE_SAFETY, "HEALTH: watchdog fed@%lu now=%lu", lastWatchdogFeedTick, timerManager->getMasterTicks());
 }
 
 /**
@@ -243,6 +246,39 @@ void SafetyManager::recordSequenceActivity() {
   lastSystemActivityTick = timerManager->getMasterTicks();
 }
 
+/**
+ * BLE link came up (first valid frame after a link-down)
+ */
+void SafetyManager::onLinkUp() {
+  linkUp = true;
+  linkChangeTick = timerManager->getMasterTicks();
+  recordCommunicationActivity();
+  if (debugSerial) debugSerial->println("SAFETY: BLE link up");
+}
+
+/**
+ * BLE link went down
+ * lost = true when supervision timed out, false when the app closed the link.
+ */
+void SafetyManager::onLinkDown(bool lost) {
+  linkUp = false;
+  linkChangeTick = timerManager->getMasterTicks();
+  if (lost) linkDropCount++;
+  if (debugSerial) debugSerial->println(lost ? "SAFETY: BLE link lost" : "SAFETY: BLE link closed");
+}
+
+bool SafetyManager::isLinkUp() const {
+  return linkUp;
+}
+
+unsigned long SafetyManager::getLinkChangeTick() const {
+  return linkChangeTick;
+}
+
+unsigned long SafetyManager::getLinkDropCount() const {
+  return linkDropCount;
+}
+
 /**
  * Set system stuck timeout
  */
@@ -336,7 +372,7 @@ void SafetyManager::handleSystemStuck() {
   systemStuck = true;
   systemStuckStartTick = timerManager->getMasterTicks();
 
-  // WARNING: System stuck detected! debug disabled
+  TRACE(MODULE_SAFETY, "WARNING: System stuck detected! (no activity for %lu ticks)", getTimeSinceLastActivity());
 
   // Perform emergency shutdown
   performEmergencyShutdown();
@@ -347,7 +383,7 @@ void SafetyManager::performHealthCheck() {
   bool systemHealthy = validateSystemState();
 
   if (!systemHealthy) {
-    // WARNING: System health check failed! debug disabled
+    TRACE(MODULE_SAFETY, "WARNING: System health check failed!");
     // Take appropriate action
   }
 }
@@ -380,7 +416,7 @@ bool SafetyManager::isSystemInSafeState() const {
 }
 
 void SafetyManager::performEmergencyShutdown() {
-  // EMERGENCY SHUTDOWN INITIATED! debug disabled
+  TRACE(MODULE_SAFETY, "EMERGENCY SHUTDOWN INITIATED!");
 
   // Stop all motors
   performMotorShutdown();
@@ -393,7 +429,7 @@ void SafetyManager::performEmergencyShutdown() {
 }
 
 void SafetyManager::performSystemReset() {
-  // SYSTEM RESET INITIATED! debug disabled
+  TRACE(MODULE_SAFETY, "SYSTEM RESET INITIATED! (stuck for %lu ticks)", timerManager->getMasterTicks() - systemStuckStartTick);
 
   // Perform system reset procedures
   // This would reset various system components
@@ -403,14 +439,14 @@ void SafetyManager::performSystemReset() {
 }
 
 void SafetyManager::performMotorShutdown() {
-  // MOTOR SHUTDOWN INITIATED! debug disabled
+  TRACE(MODULE_SAFETY, "MOTOR SHUTDOWN INITIATED!");
 
   // This would call motor controller to stop all motors
   // Implementation depends on motor controller integration
 }
 
 void SafetyManager::performSensorReset() {
-  // SENSOR RESET INITIATED! debug disabled
+  TRACE(MODULE_SAFETY, "SENSOR RESET INITIATED!");
 
   // This would reset sensor states
   // Implementation depends on sensor manager integration
@@ -16,6 +16,7 @@
  * - Emergency stop functionality
  * - System stuck detection
  * - Safety timeout management
+ * - BLE link state tracking (reported by the link supervisor)
  */
 class SafetyManager {
 private:
@@ -35,16 +36,21 @@ private:
 
   // Component references
   TimerManager* timerManager;
-  HardwareSerial* debugSerial;
+  Print* debugSerial;
 
   // System health monitoring
   bool systemHealthCheckActive;
   unsigned long lastHealthCheckTick;
   static const unsigned long HEALTH_CHECK_INTERVAL_TICKS = 100;  // 1 second
 
+  // BLE link state (reported by CommunicationManager)
+  bool linkUp;
+  unsigned long linkChangeTick;   // Tick of the last link-up/link-down transition
+  unsigned long linkDropCount;    // Link losses detected by supervision (not graceful closes)
+
 public:
   // Constructor
-  SafetyManager(TimerManager* timerMgr, HardwareSerial* debugSer = nullptr);
+  SafetyManager(TimerManager* timerMgr, Print* debugSer = nullptr);
 
   // Destructor
   ~SafetyManager();
@@ -86,6 +92,13 @@ public:
   void recordCommunicationActivity();
   void recordSequenceActivity();
 
+  // BLE Link State
+  void onLinkUp();
+  void onLinkDown(bool lost);
+  bool isLinkUp() const;
+  unsigned long getLinkChangeTick() const;
+  unsigned long getLinkDropCount() const;
+
   // Safety Configuration
   void setSystemStuckTimeout(unsigned long timeoutTicks);
   void setRecoveryTimeout(unsigned long timeoutTicks);
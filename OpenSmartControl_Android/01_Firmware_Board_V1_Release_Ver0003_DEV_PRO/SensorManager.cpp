@@ -1,5 +1,6 @@
 #include "SensorManager.h"
 #include "MotorController.h"
+#include "DebugLog.h"
 
 // Static instance for ISR access
 SensorManager* SensorManager::instance = nullptr;
@@ -7,8 +8,8 @@ SensorManager* SensorManager::instance = nullptr;
 /**
  * Constructor
  */
-SensorManager::SensorManager(TimerManager* timerMgr, MotorController* motorCtrl, HardwareSerial* debugSer)
-  : timerManager(timerMgr), motorController(motorCtrl), debugSerial(debugSer), sensorUpLimit(false), sensorDownLimit(false), lastUpState(false), lastDownState(false), buttonUpSamples(0), buttonDownSamples(0), sensorUpPending(false), sensorDownPending(false), sensorConfirmStartTick(0), sensorConfirmInProgress(false), confirmState(IDLE), globalSensorUpLimit(false), globalSensorDownLimit(false), globalSensorConfirmInProgress(false), lastPendingDebugTick(0), lastFunctionDebugTick(0), lastIdleDebugTick(0), lastWaitingDebugTick(0), lastConfirmDebugTick(0), lastConfirmedDebugTick(0) {
+SensorManager::SensorManager(TimerManager* timerMgr, MotorController* motorCtrl, Print* debugSer)
+  : timerManager(timerMgr), motorController(motorCtrl), debugSerial(debugSer), sensorUpLimit(false), sensorDownLimit(false), lastUpState(false), lastDownState(false), buttonUpSamples(0), buttonDownSamples(0), sensorUpPending(false), sensorDownPending(false), sensorConfirmStartTick(0), confirmDelayTicks(SENSOR_CONFIRM_DELAY_TICKS), sensorConfirmInProgress(false), confirmState(IDLE), globalSensorUpLimit(false), globalSensorDownLimit(false), globalSensorConfirmInProgress(false), lastPendingDebugTick(0), lastFunctionDebugTick(0), lastIdleDebugTick(0), lastWaitingDebugTick(0), lastConfirmDebugTick(0), lastConfirmedDebugTick(0) {
   instance = this;
 }
 
@@ -197,7 +198,7 @@ void SensorManager::processSensorConfirmation() {
 
     case WAITING_CONFIRM:
       debugSensorWaiting();
-      if (currentTick - sensorConfirmStartTick >= SENSOR_CONFIRM_DELAY_TICKS) {
+      if (currentTick - sensorConfirmStartTick >= confirmDelayTicks) {
         // Confirmation delay completed
         completeSensorConfirmation(sensorUpPending);
       }
@@ -433,7 +434,8 @@ void SensorManager::resetSensorConfirmation() {
  */
 void SensorManager::debugSensorPending() {
   if (isTimeForDebug(lastPendingDebugTick, 100)) {  // 1 second
-    // Sensor: Pending confirmation started debug disabled
+    // Runs from the sensor ISR: the debug log channel is ISR-safe
+    if (debugSerial) debugSerial->println("Sensor: Pending confirmation started");
     updateDebugTick(lastPendingDebugTick);
   }
 }
@@ -447,14 +449,14 @@ void SensorManager::debugSensorFunction() {
 
 void SensorManager::debugSensorIdle() {
   if (isTimeForDebug(lastIdleDebugTick, 1000)) {  // 10 seconds
-    // Sensor: IDLE state debug disabled to save Flash memory
+    TRACE(MODULE_SENSOR, "Sensor: IDLE (up=%u down=%u)", globalSensorUpLimit, globalSensorDownLimit);
     updateDebugTick(lastIdleDebugTick);
   }
 }
 
 void SensorManager::debugSensorWaiting() {
   if (isTimeForDebug(lastWaitingDebugTick, 100)) {  // 1 second
-    // Sensor: WAITING_CONFIRM state debug disabled
+    TRACE(MODULE_SENSOR, "Sensor: WAITING_CONFIRM up=%u for %lu ticks", sensorUpPending, timerManager->getMasterTicks() - sensorConfirmStartTick);
     updateDebugTick(lastWaitingDebugTick);
   }
 }
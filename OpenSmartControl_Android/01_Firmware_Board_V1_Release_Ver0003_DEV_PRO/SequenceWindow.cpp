@@ -0,0 +1,62 @@
+#include "SequenceWindow.h"
+
+/**
+ * Constructor
+ */
+SequenceWindow::SequenceWindow()
+  : bitmap(0), highest(0), started(false) {
+}
+
+/**
+ * Check a received sequence and record it if it is new
+ * The signed 8-bit distance to the newest sequence handles the wrap at 256.
+ */
+SequenceWindow::Result SequenceWindow::check(uint8_t sequence) {
+  if (!started) {
+    started = true;
+    highest = sequence;
+    bitmap = 1;
+    return ACCEPTED;
+  }
+
+  int8_t ahead = (int8_t)(uint8_t)(sequence - highest);
+
+  if (ahead > 0) {
+    bitmap = (ahead >= WINDOW_SIZE) ? 0 : (bitmap << ahead);
+    bitmap |= 1;
+    highest = sequence;
+    return ACCEPTED;
+  }
+
+  uint8_t behind = (uint8_t)(-ahead);
+  if (behind >= WINDOW_SIZE) return STALE;
+
+  uint32_t mask = (uint32_t)1 << behind;
+  if (bitmap & mask) return DUPLICATE;
+
+  bitmap |= mask;
+  return ACCEPTED;
+}
+
+/**
+ * What check() would answer, without recording the sequence
+ */
+SequenceWindow::Result SequenceWindow::peek(uint8_t sequence) const {
+  if (!started) return ACCEPTED;
+
+  int8_t ahead = (int8_t)(uint8_t)(sequence - highest);
+  if (ahead > 0) return ACCEPTED;
+
+  uint8_t behind = (uint8_t)(-ahead);
+  if (behind >= WINDOW_SIZE) return STALE;
+  return (bitmap & ((uint32_t)1 << behind)) ? DUPLICATE : ACCEPTED;
+}
+
+/**
+ * Forget all sequences (new link)
+ */
+void SequenceWindow::reset() {
+  bitmap = 0;
+  highest = 0;
+  started = false;
+}
@@ -0,0 +1,160 @@
+#ifndef SERVICE_CONSOLE_H
+#define SERVICE_CONSOLE_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <cstdint>
+#include "DebugLog.h"
+#include "LatencyProbe.h"
+
+class MassageController;
+
+/**
+ * ServiceConsole Class
+ *
+ * Line-oriented service console on the debug UART (115200 baud) for bench
+ * and field technicians. Commands are read a few bytes per loop pass and run
+ * once their line ends; replies go through the debug log ring, so the console
+ * never waits for the UART and never delays the control loop.
+ *
+ * Features:
+ * - Read / write timing and PWM tunables at runtime (not persisted)
+ * - Counter dump (BLE receive / transmit, command queue, link, debug log)
+ * - Latency histograms (LATENCY_PROBES builds)
+ * - Programs and other app commands run through the normal command handlers
+ * - Main loop profiling capture (per-phase microsecond histograms)
+ *
+ * Multi-line replies are printed a few lines per pass while the debug log has
+ * room; the next command line is read once the reply is out. Type "help" for
+ * the command list.
+ */
+class ServiceConsole {
+public:
+  // Main loop phases timed by the profiling capture (MassageController::processMainLoop)
+  enum Phase : uint8_t {
+    PHASE_COMMUNICATION,
+    PHASE_COMMANDS,
+    PHASE_SENSORS,
+    PHASE_SEQUENCES,
+    PHASE_SAFETY,
+    PHASE_MOTORS,
+    PHASE_TELEMETRY,
+    PHASE_PASS,  // Whole pass
+    PHASE_COUNT
+  };
+
+  static const uint8_t LINE_SIZE = 64;       // Command line, terminator included
+  static const uint8_t REPLY_SIZE = 96;      // Reply line, CR LF included
+  static const uint8_t MAX_TOKENS = 4;
+  static const uint16_t PROFILE_PASSES = 1000;
+
+private:
+  enum Listing : uint8_t {
+    LIST_NONE,
+    LIST_HELP,
+    LIST_TUNABLES,
+    LIST_STATS,
+    LIST_PROFILE
+  };
+
+  // Tunables (get / set)
+  enum Tunable : uint8_t {
+    TUNE_STEP_SCALE,
+    TUNE_LIMIT_DELAY,
+    TUNE_SENSOR_CONFIRM,
+    TUNE_PWM_HIGH,
+    TUNE_PWM_LOW,
+    TUNE_PWM_FULL,
+    TUNE_LINK_TIMEOUT,
+    TUNE_LOG_LEVEL,
+    TUNE_COUNT
+  };
+
+  struct TunableSpec {
+    const char* name;
+    long minValue;
+    long maxValue;
+    const char* unit;
+  };
+
+  static const TunableSpec TUNABLES[TUNE_COUNT];
+
+  MassageController* controller;
+  HardwareSerial* serial;  // Input
+  DebugLog* log;           // Output
+
+  // Line being typed
+  char line[LINE_SIZE];
+  uint8_t lineLength;
+  bool lineOverflow;
+
+  // Multi-line reply being printed
+  Listing listing;
+  uint16_t listLine;
+
+  // Profiling capture
+  uint16_t profileRemaining;  // Passes still to time (0 = not profiling)
+  bool profileReady;          // Capture finished, report not printed yet
+  bool passOpen;              // Current pass started while profiling
+  uint32_t passStamp;
+  uint32_t phaseStamp;
+  LatencyProbe::Histogram profile[PHASE_COUNT];
+
+  // Command execution
+  void execute();
+  void commandGet(char** tokens, uint8_t count);
+  void commandSet(char** tokens, uint8_t count);
+  void commandStats(char** tokens, uint8_t count);
+  void commandLatency(char** tokens, uint8_t count);
+  void commandRun(char** tokens, uint8_t count);
+  void commandRaw(char** tokens, uint8_t count);
+  void commandProfile(char** tokens, uint8_t count);
+  void reportResult(uint8_t result);
+
+  // Tunables
+  int findTunable(const char* name) const;
+  bool parseStep(const char* name, uint8_t& step) const;
+  long readTunable(Tunable id) const;
+  void writeTunable(Tunable id, long value);
+
+  // Output
+  void reply(const char* format, ...);
+  void printListing();
+  int formatListLine(char* text, uint16_t index);
+  int formatHelpLine(char* text, uint16_t index) const;
+  int formatTunableLine(char* text, uint16_t index) const;
+  int formatStatsLine(char* text, uint16_t index) const;
+  int formatProfileLine(char* text, uint16_t index) const;
+  void startListing(Listing kind);
+
+  // Profiling capture
+  void startPass();
+  void recordPhase(Phase phase);
+  void finishPass();
+
+  static bool parseNumber(const char* text, long& value);
+  static const char* getPhaseName(Phase phase);
+
+public:
+  // Constructor
+  ServiceConsole(MassageController* owner, HardwareSerial* input, DebugLog* output);
+
+  // Main loop
+  void poll();
+
+  // Profiling capture (cheap no-ops unless a capture is running)
+  bool isProfiling() const {
+    return profileRemaining != 0;
+  }
+  void beginPass() {
+    if (profileRemaining) startPass();
+  }
+  void markPhase(Phase phase) {
+    if (profileRemaining) recordPhase(phase);
+  }
+  void endPass() {
+    if (profileRemaining) finishPass();
+  }
+};
+
+#endif  // SERVICE_CONSOLE_H
@@ -6,7 +6,7 @@ TimerManager* TimerManager::instance = nullptr;
 /**
  * Constructor
  */
-TimerManager::TimerManager(HardwareSerial* debugSer)
+TimerManager::TimerManager(Print* debugSer)
   : mainTimer(nullptr), precisionTimer(nullptr), debugSerial(debugSer), masterTicks(0), precisionTicks(0), stepTicks(0), mainTimerActive(false), precisionTimerActive(false) {
   instance = this;
 }
@@ -37,11 +37,11 @@ private:
   bool precisionTimerActive;
 
   // Debug serial reference
-  HardwareSerial* debugSerial;
+  Print* debugSerial;
 
 public:
   // Constructor
-  TimerManager(HardwareSerial* debugSer = nullptr);
+  TimerManager(Print* debugSer = nullptr);
 
   // Destructor
   ~TimerManager();
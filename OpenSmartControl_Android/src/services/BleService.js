@@ -2631,15 +2631,16 @@ class BleService {
 
   /**
    * Start heartbeat to maintain BLE connection
-   * Sends Command: 0xEE, Data1: 0xF0 once after 5 seconds
+   * Sends Command: 0xEE, Data1: 0xF0 every 5 seconds; the board treats
+   * silence after the first heartbeat as a lost link and stops manual motion
    */
   startHeartbeat() {
     // Clear existing heartbeat if any
     this.stopHeartbeat();
     
-    console.log(`Starting heartbeat after ${this.heartbeatIntervalMs}ms`);
+    console.log(`Starting heartbeat every ${this.heartbeatIntervalMs}ms`);
     
-    this.heartbeatInterval = setTimeout(async () => {
+    this.heartbeatInterval = setInterval(async () => {
       try {
         if (this.connectedDevice && this.txCharacteristic) {
           console.log('Sending heartbeat...');
@@ -2660,7 +2661,7 @@ class BleService {
   stopHeartbeat() {
     if (this.heartbeatInterval) {
       console.log('Stopping heartbeat...');
-      clearTimeout(this.heartbeatInterval);
+      clearInterval(this.heartbeatInterval);
       this.heartbeatInterval = null;
       
       // Send stop heartbeat command
@@ -0,0 +1,105 @@
+#include "BootInstaller.h"
+
+/**
+ * Constructor
+ */
+BootInstaller::BootInstaller(BootFlash& bank)
+  : flash(bank) {
+}
+
+/**
+ * Install a pending update
+ * Called on every boot; without a record it only reads one word.
+ */
+BootInstaller::Result BootInstaller::run() {
+  const BootControl* record = reinterpret_cast<const BootControl*>(flash.map(CONTROL_ADDRESS));
+  if (record->magic != BOOT_MAGIC) return RESULT_NO_UPDATE;
+
+  // Written by the application, but maybe not completely (power loss during commit)
+  uint32_t size = record->imageSize;
+  uint32_t crc = record->imageCrc;
+  if (record->check != ~(record->magic ^ size ^ crc) || size == 0 || size > REGION_SIZE) {
+    dropRecord();
+    return RESULT_NO_UPDATE;
+  }
+
+  // Copied and verified before, power lost before the record was erased
+  if (appMatches(size, crc)) {
+    return dropRecord() ? RESULT_INSTALLED : RESULT_FLASH_ERROR;
+  }
+
+  // The application is only erased for an image known to be good
+  if (crc32(0, flash.map(STAGING_ADDRESS), size) != crc) {
+    dropRecord();
+    return RESULT_BAD_STAGING;
+  }
+
+  for (uint8_t attempt = 0; attempt < COPY_ATTEMPTS; attempt++) {
+    if (copyImage(size) && appMatches(size, crc)) {
+      return dropRecord() ? RESULT_INSTALLED : RESULT_FLASH_ERROR;
+    }
+  }
+  return RESULT_FLASH_ERROR;
+}
+
+/**
+ * Staging -> application, a page at a time (an odd last byte is copied
+ * with the 0xFF pad FirmwareUpdater programmed after it)
+ */
+bool BootInstaller::copyImage(uint32_t size) {
+  for (uint32_t offset = 0; offset < size; offset += BootFlash::PAGE_SIZE) {
+    uint32_t length = size - offset;
+    if (length > BootFlash::PAGE_SIZE) length = BootFlash::PAGE_SIZE;
+    length = (length + 1) & ~1UL;
+
+    if (!flash.erasePage(APP_ADDRESS + offset)) return false;
+    if (!flash.program(APP_ADDRESS + offset, flash.map(STAGING_ADDRESS + offset), (uint16_t)length)) return false;
+  }
+  return true;
+}
+
+/**
+ * Application region holds the recorded image
+ */
+bool BootInstaller::appMatches(uint32_t size, uint32_t crc) const {
+  return crc32(0, flash.map(APP_ADDRESS), size) == crc;
+}
+
+/**
+ * Erase the boot control record (the update is finished or abandoned)
+ */
+bool BootInstaller::dropRecord() {
+  return flash.erasePage(CONTROL_ADDRESS);
+}
+
+/**
+ * Vector table at APP_ADDRESS looks like a linked application
+ * Catches an erased or half-copied region, not a wrong build offset.
+ */
+bool BootInstaller::appBootable() const {
+  const uint8_t* vectors = flash.map(APP_ADDRESS);
+  uint32_t stack = vectors[0] | ((uint32_t)vectors[1] << 8) | ((uint32_t)vectors[2] << 16) | ((uint32_t)vectors[3] << 24);
+  uint32_t reset = vectors[4] | ((uint32_t)vectors[5] << 8) | ((uint32_t)vectors[6] << 16) | ((uint32_t)vectors[7] << 24);
+
+  bool stackInRam = stack > RAM_ADDRESS && stack <= RAM_ADDRESS + RAM_SIZE && (stack & 3) == 0;
+  bool resetInApp = (reset & 1) && reset >= APP_ADDRESS && reset < APP_ADDRESS + REGION_SIZE;
+  return stackInRam && resetInApp;
+}
+
+/**
+ * CRC-32 (IEEE 802.3, as zlib): crc32(0, data, n), chainable
+ * Nibble table: 64 bytes of flash, ~0.15s for a 60 KB image at the 8 MHz reset clock.
+ */
+uint32_t BootInstaller::crc32(uint32_t crc, const uint8_t* data, uint32_t length) {
+  static const uint32_t TABLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  crc = ~crc;
+  for (uint32_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+  }
+  return ~crc;
+}
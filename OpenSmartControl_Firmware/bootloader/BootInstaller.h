@@ -0,0 +1,100 @@
+#ifndef BOOT_INSTALLER_H
+#define BOOT_INSTALLER_H
+
+#include <stdint.h>
+
+/**
+ * BootFlash Class
+ *
+ * Flash as the installer sees it, same rules as FirmwareUpdater's
+ * FlashBank (page erase to 0xFF, program erased halfwords only). The
+ * bootloader drives the flash registers directly (main.cpp); the host test
+ * runs the installer on the HAL flash model.
+ */
+class BootFlash {
+public:
+  static const uint32_t PAGE_SIZE = 1024;  // STM32F103 medium / low density
+
+  // Erase the page starting at address (PAGE_SIZE aligned)
+  virtual bool erasePage(uint32_t address) = 0;
+
+  // Program erased flash (even address and length), read back to check
+  virtual bool program(uint32_t address, const uint8_t* data, uint16_t length) = 0;
+
+  // Memory-mapped read access
+  virtual const uint8_t* map(uint32_t address) const = 0;
+
+protected:
+  ~BootFlash() {}  // Not deleted through the interface (no heap in the bootloader)
+};
+
+/**
+ * BootInstaller Class
+ *
+ * Bootloader half of the BLE firmware update: when the application left a
+ * boot control record (FirmwareUpdater::commit()), the staged image is
+ * copied over the application, checked, and the record erased. Layout and
+ * record format must stay in step with FirmwareUpdater.h.
+ *
+ * A power loss at any point is repaired by the next boot:
+ * - the staging region is only read, so the copy can always start over
+ * - the record is erased last, once the application CRC32 matches it
+ * - an application that already matches the record is not copied again
+ *
+ * Features:
+ * - Damaged record (check word, size) dropped without touching the application
+ * - Staged image CRC32 checked before the application is erased
+ * - Copy retried COPY_ATTEMPTS times when the application CRC32 is wrong
+ * - Vector table sanity check before the jump (appBootable())
+ */
+class BootInstaller {
+public:
+  enum Result : uint8_t {
+    RESULT_NO_UPDATE,    // No record, or a damaged one (dropped)
+    RESULT_INSTALLED,    // Application replaced and verified, record erased
+    RESULT_BAD_STAGING,  // Staged image does not match the record: record dropped, application kept
+    RESULT_FLASH_ERROR   // Copy failed COPY_ATTEMPTS times; the record stays for the next boot
+  };
+
+  // Flash layout (FirmwareUpdater.h)
+  static const uint32_t APP_ADDRESS = 0x08001000;
+  static const uint32_t REGION_SIZE = 61 * BootFlash::PAGE_SIZE;
+  static const uint32_t STAGING_ADDRESS = APP_ADDRESS + REGION_SIZE;
+  static const uint32_t CONTROL_ADDRESS = STAGING_ADDRESS + REGION_SIZE;
+
+  // Boot control record (FirmwareUpdater::BootControl)
+  static const uint32_t BOOT_MAGIC = 0x4342534F;  // "OSBC"
+  struct BootControl {
+    uint32_t magic;
+    uint32_t imageSize;
+    uint32_t imageCrc;
+    uint32_t check;  // ~(magic ^ imageSize ^ imageCrc)
+  };
+
+  // STM32F103C8 / CB SRAM (initial stack pointer of the application)
+  static const uint32_t RAM_ADDRESS = 0x20000000;
+  static const uint32_t RAM_SIZE = 20 * 1024;
+
+  static const uint8_t COPY_ATTEMPTS = 3;
+
+private:
+  BootFlash& flash;
+
+  bool copyImage(uint32_t size);
+  bool appMatches(uint32_t size, uint32_t crc) const;
+  bool dropRecord();
+
+public:
+  explicit BootInstaller(BootFlash& bank);
+
+  // Install a pending update (once per boot, before the jump)
+  Result run();
+
+  // Application vector table: stack pointer in SRAM, reset handler (Thumb) in the application region
+  bool appBootable() const;
+
+  // CRC-32 (IEEE 802.3), as FirmwareUpdater::crc32()
+  static uint32_t crc32(uint32_t crc, const uint8_t* data, uint32_t length);
+};
+
+#endif  // BOOT_INSTALLER_H
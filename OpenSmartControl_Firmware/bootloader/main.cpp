@@ -0,0 +1,135 @@
+/**
+ * OpenSmartControl update bootloader (STM32F103, 0x08000000, 4 KB)
+ *
+ * Installs an image staged by the application's FirmwareUpdater, then
+ * starts the application at BootInstaller::APP_ADDRESS. Runs on the 8 MHz
+ * reset clock with no interrupts enabled and leaves RCC, GPIO and NVIC
+ * untouched, so the application starts as it would from reset (except
+ * VTOR and MSP, set for it).
+ *
+ * The flash is driven through its registers (RM0008 section 3.3): no HAL,
+ * so the whole bootloader fits its 4 KB with room to spare.
+ */
+#include "BootInstaller.h"
+
+namespace {
+
+struct FlashRegisters {
+  volatile uint32_t ACR;
+  volatile uint32_t KEYR;
+  volatile uint32_t OPTKEYR;
+  volatile uint32_t SR;
+  volatile uint32_t CR;
+  volatile uint32_t AR;
+};
+
+FlashRegisters* const FLASH_REGS = reinterpret_cast<FlashRegisters*>(0x40022000);
+volatile uint32_t* const SCB_VTOR = reinterpret_cast<volatile uint32_t*>(0xE000ED08);
+volatile uint32_t* const SYSTICK_CTRL = reinterpret_cast<volatile uint32_t*>(0xE000E010);
+
+const uint32_t FLASH_KEY1 = 0x45670123;
+const uint32_t FLASH_KEY2 = 0xCDEF89AB;
+const uint32_t SR_BSY = 1UL << 0;
+const uint32_t SR_PGERR = 1UL << 2;
+const uint32_t SR_WRPRTERR = 1UL << 4;
+const uint32_t SR_EOP = 1UL << 5;
+const uint32_t CR_PG = 1UL << 0;
+const uint32_t CR_PER = 1UL << 1;
+const uint32_t CR_STRT = 1UL << 6;
+const uint32_t CR_LOCK = 1UL << 7;
+
+/**
+ * STM32F1 flash through the FPEC registers
+ * The CPU stalls while the flash is busy: ~20ms per page erase, ~50us per halfword.
+ */
+class Stm32BootFlash : public BootFlash {
+public:
+  bool erasePage(uint32_t address) override {
+    unlock();
+    FLASH_REGS->CR |= CR_PER;
+    FLASH_REGS->AR = address;
+    FLASH_REGS->CR |= CR_STRT;
+    bool ok = finish();
+    FLASH_REGS->CR &= ~CR_PER;
+    lock();
+
+    const uint32_t* words = reinterpret_cast<const uint32_t*>(address);
+    for (uint32_t i = 0; ok && i < PAGE_SIZE / 4; i++) {
+      ok = words[i] == 0xFFFFFFFF;
+    }
+    return ok;
+  }
+
+  bool program(uint32_t address, const uint8_t* data, uint16_t length) override {
+    bool ok = true;
+    unlock();
+    FLASH_REGS->CR |= CR_PG;
+    for (uint16_t i = 0; ok && i < length; i += 2) {
+      uint16_t halfword = data[i] | ((uint16_t)data[i + 1] << 8);
+      *reinterpret_cast<volatile uint16_t*>(address + i) = halfword;
+      ok = finish() && *reinterpret_cast<const volatile uint16_t*>(address + i) == halfword;
+    }
+    FLASH_REGS->CR &= ~CR_PG;
+    lock();
+    return ok;
+  }
+
+  const uint8_t* map(uint32_t address) const override {
+    return reinterpret_cast<const uint8_t*>(address);
+  }
+
+private:
+  void unlock() {
+    if (FLASH_REGS->CR & CR_LOCK) {
+      FLASH_REGS->KEYR = FLASH_KEY1;
+      FLASH_REGS->KEYR = FLASH_KEY2;
+    }
+  }
+
+  void lock() {
+    FLASH_REGS->CR |= CR_LOCK;
+  }
+
+  // Wait for the operation, then clear its status flags (write 1 to clear)
+  bool finish() {
+    while (FLASH_REGS->SR & SR_BSY) {
+    }
+    uint32_t status = FLASH_REGS->SR;
+    FLASH_REGS->SR = SR_EOP | SR_PGERR | SR_WRPRTERR;
+    return (status & (SR_PGERR | SR_WRPRTERR)) == 0;
+  }
+};
+
+/**
+ * Start the application: its vector table, its stack, its reset handler
+ * The STM32duino SystemInit() may set VTOR again: the application must be
+ * built with VECT_TAB_OFFSET=0x1000 (build.flash_offset=0x1000).
+ */
+[[noreturn]] void startApplication() {
+  const uint32_t* vectors = reinterpret_cast<const uint32_t*>(BootInstaller::APP_ADDRESS);
+  *SYSTICK_CTRL = 0;
+  *SCB_VTOR = BootInstaller::APP_ADDRESS;
+  __asm__ volatile(
+    "msr msp, %0\n"
+    "bx %1\n"
+    :
+    : "r"(vectors[0]), "r"(vectors[1]));
+  __builtin_unreachable();
+}
+
+}  // namespace
+
+int main() {
+  Stm32BootFlash flash;
+  BootInstaller installer(flash);
+
+  // FLASH_ERROR: the application is half written and the record still
+  // there - stop here, the next power-up tries again
+  if (installer.run() != BootInstaller::RESULT_FLASH_ERROR && installer.appBootable()) {
+    startApplication();
+  }
+
+  // Nothing runnable: wait for SWD / the ROM serial bootloader
+  for (;;) {
+  }
+}
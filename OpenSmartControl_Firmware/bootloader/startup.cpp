@@ -0,0 +1,52 @@
+/**
+ * Cortex-M3 startup for the bootloader
+ *
+ * Vector table (core exceptions only: the bootloader enables no
+ * interrupts), .data / .bss setup and main(). No static constructors.
+ */
+#include <stdint.h>
+
+extern uint32_t _sidata;
+extern uint32_t _sdata;
+extern uint32_t _edata;
+extern uint32_t _sbss;
+extern uint32_t _ebss;
+extern uint32_t _estack;
+
+int main();
+
+extern "C" void Reset_Handler() {
+  const uint32_t* source = &_sidata;
+  for (uint32_t* word = &_sdata; word < &_edata; word++) {
+    *word = *source++;
+  }
+  for (uint32_t* word = &_sbss; word < &_ebss; word++) {
+    *word = 0;
+  }
+  main();
+  for (;;) {
+  }
+}
+
+extern "C" void Default_Handler() {
+  for (;;) {
+  }
+}
+
+// Pure virtual call (BootFlash): nothing to report it to
+extern "C" void __cxa_pure_virtual() {
+  for (;;) {
+  }
+}
+
+typedef void (*Vector)();
+
+__attribute__((section(".isr_vector"), used)) const Vector vectorTable[] = {
+  reinterpret_cast<Vector>(&_estack),
+  Reset_Handler,
+  Default_Handler,  // NMI
+  Default_Handler,  // HardFault
+  Default_Handler,  // MemManage
+  Default_Handler,  // BusFault
+  Default_Handler,  // UsageFault
+};
@@ -0,0 +1,4 @@
+// The Arduino builder compiles the .ino as C++ with Arduino.h in front;
+// doing the same here keeps the host build on the real setup() / loop()
+#include <Arduino.h>
+#include "01_Firmware_Board_V1_Release_Ver0003_DEV_PRO.ino"
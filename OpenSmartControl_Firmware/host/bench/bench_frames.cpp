@@ -0,0 +1,137 @@
+/**
+ * Receive path throughput benchmark
+ *
+ * Reports frames/sec and cycles/frame (TSC on x86, otherwise ns only) for:
+ * - HexFrameDecoder / BinaryFrameDecoder on a stream of app command frames
+ * - the receive path HexFrameDecoder replaced (tests/LegacyHexParser.h)
+ * - the reference decoder (tests/ReferenceFrames.h), as a yardstick
+ * - the whole firmware: frames on USART2, drained, decoded, queued and
+ *   executed by loop()
+ *
+ * and the receive state RAM of the old and new hex paths.
+ *
+ *   bench_frames [--quick]
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "LegacyHexParser.h"
+#include "MassageController.h"
+#include "PacketCodec.h"
+#include <chrono>
+#include <cstring>
+#include <functional>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#else
+#define BENCH_HAVE_TSC 0
+#endif
+
+namespace {
+
+uint64_t cycles() {
+#if BENCH_HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Time fn() (which returns the number of frames it handled) and print one line
+ */
+void report(const char* name, const std::function<long()>& fn) {
+  auto start = std::chrono::steady_clock::now();
+  uint64_t c0 = cycles();
+  long frames = fn();
+  uint64_t c1 = cycles();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (frames <= 0) {
+    printf("%-28s no frames\n", name);
+    return;
+  }
+  printf("%-28s %10.0f frames/s %9.1f ns/frame", name, frames / seconds, seconds * 1e9 / frames);
+  if (BENCH_HAVE_TSC) {
+    printf(" %9.0f cycles/frame", (double)(c1 - c0) / frames);
+  }
+  printf("  (%ld frames)\n", frames);
+}
+
+// App-style frames with varying sequence / data so the checksums differ
+reference::Bytes commandStream(int count, bool binary) {
+  static const uint8_t COMMANDS[] = { 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80, 0x90, 0xA0, 0xB0 };
+  reference::Bytes stream;
+  for (int i = 0; i < count; i++) {
+    reference::Bytes body = reference::command(0x70, (uint8_t)i, COMMANDS[i % sizeof(COMMANDS)], (i & 1) ? 0xF0 : 0x00);
+    reference::Bytes frame = binary ? reference::binaryFrame(body) : reference::hexFrame(body);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  }
+  return stream;
+}
+
+template <typename Decoder>
+long decodeRepeated(const reference::Bytes& stream, int repeats) {
+  Decoder decoder;
+  long frames = 0;
+  for (int r = 0; r < repeats; r++) {
+    for (uint8_t b : stream) {
+      frames += (decoder.feed(b) == Decoder::FRAME);
+    }
+  }
+  return frames;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool quick = (argc > 1 && strcmp(argv[1], "--quick") == 0);
+  int repeats = quick ? 20 : 2000;
+
+  reference::Bytes hexStream = commandStream(1000, false);
+  reference::Bytes binStream = commandStream(1000, true);
+
+  report("HexFrameDecoder", [&] { return decodeRepeated<HexFrameDecoder>(hexStream, repeats); });
+  report("BinaryFrameDecoder", [&] { return decodeRepeated<BinaryFrameDecoder>(binStream, repeats); });
+  report("old hex path (legacy)", [&] {
+    LegacyHexParser legacy;
+    long frames = 0;
+    uint8_t packet[7];
+    for (int r = 0; r < repeats; r++) {
+      for (uint8_t b : hexStream) {
+        frames += legacy.feed(b, packet);
+      }
+    }
+    return frames;
+  });
+  report("reference hex decoder", [&] {
+    long frames = 0;
+    for (int r = 0; r < repeats / 10 + 1; r++) frames += (long)reference::decodeHexStream(hexStream).size();
+    return frames;
+  });
+
+  printf("hex receive state: old path %zu bytes, HexFrameDecoder %zu bytes (%zd saved)\n",
+         LegacyHexParser::RAM_BYTES, sizeof(HexFrameDecoder),
+         (ssize_t)LegacyHexParser::RAM_BYTES - (ssize_t)sizeof(HexFrameDecoder));
+
+  // Whole firmware: one frame per loop pass, as fast as loop() runs
+  host_test::bootToReady();
+  CommunicationManager* comm = massageController->getCommunicationManager();
+  report("firmware loop() per frame", [&] {
+    int count = quick ? 2000 : 100000;
+    unsigned long before = comm->getLinkStats().framesIn;
+    for (int i = 0; i < count; i++) {
+      // RELEASE frames for manual motions keep the chair state steady
+      reference::Bytes frame = reference::hexFrame(reference::command(0x70, (uint8_t)i, 0x90, 0x00));
+      mySerial2.hostInject(frame.data(), frame.size());
+      loop();
+      host::advanceMicros(host_test::LOOP_PASS_MICROS);
+      if ((i & 255) == 0) {
+        mySerial.hostTakeOutput();
+        mySerial2.hostTakeOutput();
+        host::clearPinEvents();
+      }
+    }
+    return (long)(comm->getLinkStats().framesIn - before);
+  });
+  return 0;
+}
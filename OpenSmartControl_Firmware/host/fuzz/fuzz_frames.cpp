@@ -0,0 +1,177 @@
+/**
+ * Fuzz harness for the BLE receive path
+ *
+ * Each input is a raw byte stream as it would arrive on USART2:
+ * 1. Differential check: HexFrameDecoder and BinaryFrameDecoder must accept
+ *    exactly the frames the reference decoder (tests/ReferenceFrames.h)
+ *    accepts, byte for byte. Anything else aborts.
+ * 2. Whole firmware: the stream is sent to the booted sketch at line rate
+ *    and loop() runs until it is consumed (crashes / sanitizer reports).
+ *
+ * Builds:
+ * - clang: libFuzzer target (fuzz_frames corpus/ -max_len=512)
+ * - gcc (FUZZ_STANDALONE): fuzz_frames [--mutate N] <file|dir>...
+ *   replays the inputs, optionally followed by N seeded random mutations;
+ *   with no paths one input is read from stdin (afl-fuzz -- fuzz_frames @@
+ *   also works, the path is then a file)
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+#include "PacketCodec.h"
+#include <cstdlib>
+
+namespace {
+
+const size_t MAX_INPUT = 512;
+
+template <typename Decoder>
+std::vector<reference::Bytes> decodeAll(const uint8_t* data, size_t size) {
+  Decoder decoder;
+  std::vector<reference::Bytes> frames;
+  for (size_t i = 0; i < size; i++) {
+    if (decoder.feed(data[i]) == Decoder::FRAME) {
+      const Frame& frame = decoder.getFrame();
+      frames.push_back(reference::Bytes(frame.body, frame.body + frame.length));
+    }
+  }
+  return frames;
+}
+
+void differential(const uint8_t* data, size_t size) {
+  reference::Bytes stream(data, data + size);
+  if (decodeAll<HexFrameDecoder>(data, size) != reference::decodeHexStream(stream)) {
+    fprintf(stderr, "HexFrameDecoder disagrees with the reference decoder\n");
+    abort();
+  }
+  if (decodeAll<BinaryFrameDecoder>(data, size) != reference::decodeBinaryStream(stream)) {
+    fprintf(stderr, "BinaryFrameDecoder disagrees with the reference decoder\n");
+    abort();
+  }
+}
+
+void wholeFirmware(const uint8_t* data, size_t size) {
+  static bool booted = false;
+  if (!booted) {
+    host_test::bootToReady();
+    booted = true;
+  }
+  mySerial2.hostTransmit(data, size);
+  uint64_t idle = mySerial2.hostLineIdleAt();
+  while (host::nowMicros() <= idle) {
+    host_test::runFor(5);
+  }
+  host_test::runFor(20);
+  mySerial.hostTakeOutput();
+  mySerial2.hostTakeOutput();
+  host::clearPinEvents();
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size > MAX_INPUT) {
+    return 0;
+  }
+  differential(data, size);
+  wholeFirmware(data, size);
+  return 0;
+}
+
+#if FUZZ_STANDALONE
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+
+namespace {
+
+reference::Bytes readFile(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  return reference::Bytes(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Byte-level mutations biased towards the frame markers and hex digits
+reference::Bytes mutate(const std::vector<reference::Bytes>& corpus, std::mt19937& rng) {
+  static const uint8_t INTERESTING[] = { 0x00, 0x01, 0x02, 0x03, 0x10, 0x23, '0', '9', 'A', 'F', 'a', 'f', 'G', 0x7F, 0xFF };
+  reference::Bytes input = corpus[rng() % corpus.size()];
+  int edits = 1 + rng() % 4;
+  for (int e = 0; e < edits; e++) {
+    size_t pos = input.empty() ? 0 : rng() % input.size();
+    uint8_t value = (rng() % 2) ? INTERESTING[rng() % sizeof(INTERESTING)] : (uint8_t)rng();
+    switch (rng() % 6) {
+      case 0:
+        if (!input.empty()) input[pos] = value;
+        break;
+      case 1:
+        if (!input.empty()) input[pos] ^= (uint8_t)(1u << (rng() % 8));
+        break;
+      case 2:
+        input.insert(input.begin() + pos, value);
+        break;
+      case 3:
+        if (!input.empty()) input.erase(input.begin() + pos);
+        break;
+      case 4: {
+        const reference::Bytes& other = corpus[rng() % corpus.size()];
+        input.insert(input.begin() + pos, other.begin(), other.end());
+        break;
+      }
+      default:
+        if (input.size() > pos + 1) {
+          size_t len = 1 + rng() % (input.size() - pos - 1);
+          reference::Bytes chunk(input.begin() + pos, input.begin() + pos + len);
+          input.insert(input.begin() + pos, chunk.begin(), chunk.end());
+        }
+        break;
+    }
+  }
+  if (input.size() > MAX_INPUT) {
+    input.resize(MAX_INPUT);
+  }
+  return input;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long mutations = 0;
+  std::vector<reference::Bytes> corpus;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--mutate" && i + 1 < argc) {
+      mutations = atol(argv[++i]);
+    } else if (std::filesystem::is_directory(arg)) {
+      std::vector<std::filesystem::path> files;
+      for (const auto& entry : std::filesystem::directory_iterator(arg)) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+      }
+      std::sort(files.begin(), files.end());  // Same mutation sequence on every run
+      for (const auto& file : files) {
+        corpus.push_back(readFile(file));
+      }
+    } else {
+      corpus.push_back(readFile(arg));
+    }
+  }
+  if (corpus.empty()) {
+    corpus.push_back(reference::Bytes(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>()));
+  }
+
+  for (const reference::Bytes& input : corpus) {
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  std::mt19937 rng(1);
+  for (long n = 0; n < mutations; n++) {
+    reference::Bytes input = mutate(corpus, rng);
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  const CommunicationManager::LinkStats& stats = massageController->getCommunicationManager()->getLinkStats();
+  printf("fuzz_frames: %zu corpus inputs, %ld mutations, no mismatch (firmware: %lu bytes, %lu frames)\n",
+         corpus.size(), mutations, (unsigned long)stats.bytesIn, (unsigned long)stats.framesIn);
+  return 0;
+}
+#endif
@@ -0,0 +1,237 @@
+/**
+ * replay_session - run a captured BLE session through the firmware
+ *
+ * Boots the host build of the firmware, feeds the capture journal written
+ * by tools/ble_capture (-j) into the BLE UART at the ticks the board
+ * received each byte, and prints the motor timeline: one line per change
+ * of a motor output (relay / FET PWM and direction), in ms since power-on.
+ * The virtual clock makes a 20-minute session a sub-second run.
+ *
+ *   replay_session [--limit up|down|none] [--tail ms] [--expect file] [--write file] journal.bin
+ *
+ * --expect  compare with a committed timeline, fail on the first difference
+ * --write   store the timeline (review it before committing it as expected)
+ * --limit   limit switches are not in the journal: the roller stays where
+ *           this puts it (default up, parked as after GO HOME)
+ * --tail    time to keep running after the last byte (default 2000 ms)
+ *
+ * Bytes journalled in one tick reach the RX buffer at the start of that
+ * tick (in RX-buffer sized parts), like the drain the journal recorded.
+ */
+#include "HostTest.h"
+#include "MassageController.h"
+#include "PinDefinitions.h"
+#include <chrono>
+#include <cstring>
+#include <string>
+
+namespace {
+
+const uint16_t GAP_FLAG = 0x8000;
+const uint16_t MAX_GAP = 0x7FFF;
+const uint8_t MAX_DELTA = 0x7F;
+const uint64_t MICROS_PER_TICK = 10000;
+
+struct TimedByte {
+  uint32_t tick;
+  uint8_t value;
+};
+
+struct MotorPin {
+  uint32_t pin;
+  const char* name;
+};
+
+const MotorPin MOTOR_PINS[] = {
+  { RL1_PWM_PIN, "RL1_PWM" }, { RL1_DIR_PIN, "RL1_DIR" },
+  { RL2_PWM_PIN, "RL2_PWM" }, { RL2_DIR_PIN, "RL2_DIR" },
+  { RL3_PWM_PIN, "RL3_PWM" }, { RL3_DIR_PIN, "RL3_DIR" },
+  { FETT_PWM_PIN, "FETT_PWM" }, { FETK_PWM_PIN, "FETK_PWM" },
+};
+
+const char* motorPinName(uint32_t pin) {
+  for (const MotorPin& motor : MOTOR_PINS) {
+    if (motor.pin == pin) return motor.name;
+  }
+  return nullptr;
+}
+
+uint32_t readLe(const uint8_t* p, int bytes) {
+  uint32_t value = 0;
+  for (int i = bytes - 1; i >= 0; i--) {
+    value = (value << 8) | p[i];
+  }
+  return value;
+}
+
+/**
+ * Binary journal ("BLEC", version 1, base tick LE32, entry count LE32,
+ * entries LE16) expanded to bytes with absolute ticks
+ */
+bool loadJournal(const char* path, std::vector<TimedByte>& bytes) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "replay_session: cannot open %s\n", path);
+    return false;
+  }
+  std::vector<uint8_t> data;
+  int c;
+  while ((c = fgetc(file)) != EOF) {
+    data.push_back((uint8_t)c);
+  }
+  fclose(file);
+
+  if (data.size() < 13 || memcmp(data.data(), "BLEC", 4) != 0 || data[4] != 1) {
+    fprintf(stderr, "replay_session: %s is not a v1 capture journal\n", path);
+    return false;
+  }
+  uint32_t tick = readLe(&data[5], 4);
+  uint32_t count = readLe(&data[9], 4);
+  if (data.size() != 13 + 2 * (size_t)count) {
+    fprintf(stderr, "replay_session: %s holds %zu of %lu entries\n", path, (data.size() - 13) / 2, (unsigned long)count);
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    uint16_t entry = (uint16_t)readLe(&data[13 + 2 * i], 2);
+    if (entry & GAP_FLAG) {
+      tick += entry & MAX_GAP;
+    } else {
+      tick += (entry >> 8) & MAX_DELTA;
+      bytes.push_back({ tick, (uint8_t)(entry & 0xFF) });
+    }
+  }
+  return true;
+}
+
+std::vector<std::string> motorTimeline() {
+  std::vector<std::string> lines;
+  for (const host::PinEvent& event : host::pinEvents()) {
+    const char* name = motorPinName(event.pin);
+    if (!name) continue;
+    char line[64];
+    snprintf(line, sizeof(line), "%10llu %-8s %d", (unsigned long long)(event.micros / 1000), name, event.value);
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+bool readLines(const char* path, std::vector<std::string>& lines) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    fprintf(stderr, "replay_session: cannot open %s\n", path);
+    return false;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), file)) {
+    std::string text(line);
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.pop_back();
+    if (!text.empty() && text[0] != '#') lines.push_back(text);
+  }
+  fclose(file);
+  return true;
+}
+
+int usage() {
+  fprintf(stderr, "usage: replay_session [--limit up|down|none] [--tail ms] [--expect file] [--write file] journal.bin\n");
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* journalPath = nullptr;
+  const char* expectPath = nullptr;
+  const char* writePath = nullptr;
+  std::string limit = "up";
+  uint64_t tailMs = 2000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+      limit = argv[++i];
+    } else if (strcmp(argv[i], "--tail") == 0 && i + 1 < argc) {
+      tailMs = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) {
+      expectPath = argv[++i];
+    } else if (strcmp(argv[i], "--write") == 0 && i + 1 < argc) {
+      writePath = argv[++i];
+    } else if (argv[i][0] != '-' && !journalPath) {
+      journalPath = argv[i];
+    } else {
+      return usage();
+    }
+  }
+  if (!journalPath || (limit != "up" && limit != "down" && limit != "none")) return usage();
+
+  std::vector<TimedByte> bytes;
+  if (!loadJournal(journalPath, bytes)) return 1;
+  if (bytes.empty()) {
+    fprintf(stderr, "replay_session: %s holds no bytes\n", journalPath);
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  host_test::boot();
+  host::setInput(LMT_UP_PIN, limit == "up" ? HIGH : LOW);
+  host::setInput(LMT_DOWN_PIN, limit == "down" ? HIGH : LOW);
+  TimerManager* timer = massageController->getTimerManager();
+
+  size_t next = 0;
+  while (next < bytes.size()) {
+    // This tick's bytes, as much as the RX buffer takes
+    uint32_t tick = timer->getMasterTicks();
+    size_t room = HardwareSerial::RX_BUFFER_SIZE - mySerial2.available();
+    while (next < bytes.size() && bytes[next].tick <= tick && room > 0) {
+      mySerial2.hostInject(&bytes[next].value, 1);
+      next++;
+      room--;
+    }
+    loop();
+    host::advanceMicros(host_test::LOOP_PASS_MICROS);
+  }
+  host_test::runFor(tailMs);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<std::string> timeline = motorTimeline();
+  uint64_t sessionMs = (uint64_t)(bytes.back().tick - bytes.front().tick) * MICROS_PER_TICK / 1000;
+  printf("# %s: %zu bytes over %.1f s, %zu motor events, replayed in %.2f s\n", journalPath, bytes.size(),
+         sessionMs / 1000.0, timeline.size(), seconds);
+  if (mySerial2.hostRxOverruns() || mySerial2.hostRxLost()) {
+    printf("# %lu bytes overran the RX buffer, %lu arrived while the UART was closed\n",
+           mySerial2.hostRxOverruns(), mySerial2.hostRxLost());
+  }
+
+  if (writePath) {
+    FILE* file = fopen(writePath, "w");
+    if (!file) {
+      fprintf(stderr, "replay_session: cannot write %s\n", writePath);
+      return 1;
+    }
+    fprintf(file, "# replay_session motor timeline: ms since power-on, output, level / PWM\n");
+    fprintf(file, "# journal %s, limit %s, tail %llu ms\n", journalPath, limit.c_str(), (unsigned long long)tailMs);
+    for (const std::string& line : timeline) {
+      fprintf(file, "%s\n", line.c_str());
+    }
+    fclose(file);
+  }
+
+  if (!expectPath) {
+    if (!writePath) {
+      for (const std::string& line : timeline) {
+        printf("%s\n", line.c_str());
+      }
+    }
+    return 0;
+  }
+
+  std::vector<std::string> expected;
+  if (!readLines(expectPath, expected)) return 1;
+  for (size_t i = 0; i < expected.size() || i < timeline.size(); i++) {
+    const char* want = i < expected.size() ? expected[i].c_str() : "(end)";
+    const char* got = i < timeline.size() ? timeline[i].c_str() : "(end)";
+    if (strcmp(want, got) != 0) {
+      fprintf(stderr, "replay_session: event %zu differs\n  expected: %s\n  replayed: %s\n", i + 1, want, got);
+      return 1;
+    }
+  }
+  printf("# timeline matches %s\n", expectPath);
+  return 0;
+}
@@ -0,0 +1,99 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * Host stand-in for the STM32duino core (Linux builds only)
+ *
+ * Declares just the part of the Arduino / CMSIS API the firmware uses, so
+ * the sketch sources compile unchanged with a desktop compiler. Time is a
+ * virtual clock driven by the tests (see HostArduino.h); delay() advances it
+ * and fires the HardwareTimer callbacks that fall due.
+ *
+ * The HAL_*_MODULE_ENABLED macros are not defined, so the IWDG and flash
+ * drivers compile to their portable fallbacks. HOST_UART_DMA=1 turns on the
+ * simulated UART DMA (HostHal.h) for the BleDmaReceiver hardware path.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+enum { LOW = 0, HIGH = 1 };
+enum { INPUT = 0, OUTPUT = 1, INPUT_PULLUP = 2, INPUT_PULLDOWN = 3 };
+enum { CHANGE = 2, FALLING = 3, RISING = 4 };
+enum { BIN = 2, OCT = 8, DEC = 10, HEX = 16 };
+
+// Pin numbers (values only need to be distinct)
+enum PinName {
+  PA0, PA1, PA2, PA3, PA4, PA5, PA6, PA7, PA8, PA9, PA10, PA11, PA12, PA13, PA14, PA15,
+  PB0, PB1, PB2, PB3, PB4, PB5, PB6, PB7, PB8, PB9, PB10, PB11, PB12, PB13, PB14, PB15,
+  PC13, PC14, PC15,
+  NUM_DIGITAL_PINS
+};
+
+#define F(x) (x)
+typedef char __FlashStringHelper;
+
+// Digital / analog I/O
+void pinMode(uint32_t pin, uint32_t mode);
+void digitalWrite(uint32_t pin, uint32_t value);
+int digitalRead(uint32_t pin);
+void analogWrite(uint32_t pin, int value);
+uint32_t digitalPinToInterrupt(uint32_t pin);
+void attachInterrupt(uint32_t pin, void (*callback)(void), uint32_t mode);
+void detachInterrupt(uint32_t pin);
+
+// Time (virtual clock)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+// Interrupt masking (no concurrency on the host)
+void noInterrupts();
+void interrupts();
+inline uint32_t __get_PRIMASK() { return 0; }
+inline void __set_PRIMASK(uint32_t) {}
+inline void __disable_irq() {}
+inline void __enable_irq() {}
+inline void __DSB() {}
+inline void __ISB() {}
+void NVIC_SystemReset();
+
+// Register blocks touched outside the HAL guards
+struct IWDG_TypeDef {
+  volatile uint32_t KR, PR, RLR, SR;
+};
+struct RCC_TypeDef {
+  volatile uint32_t CR, CFGR, CIR, APB2RSTR, APB1RSTR, AHBENR, APB2ENR, APB1ENR, BDCR, CSR;
+};
+struct USART_TypeDef {
+  volatile uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR;
+};
+struct TIM_TypeDef {
+  volatile uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CNT, PSC, ARR;
+};
+
+#define RCC_CSR_LSION  (1UL << 0)
+#define RCC_CSR_LSIRDY (1UL << 1)
+
+extern IWDG_TypeDef* const IWDG;
+extern RCC_TypeDef* const RCC;
+extern USART_TypeDef* const USART1;
+extern USART_TypeDef* const USART2;
+extern TIM_TypeDef* const TIM2;
+extern TIM_TypeDef* const TIM3;
+extern TIM_TypeDef* const TIM4;
+
+#include "HostHal.h"
+#include "Print.h"
+#include "HardwareSerial.h"
+#include "HardwareTimer.h"
+
+#endif  // HOST_ARDUINO_H
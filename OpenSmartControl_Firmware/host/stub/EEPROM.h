@@ -0,0 +1,19 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <cstdint>
+
+/**
+ * STM32duino emulated EEPROM, buffered API (host version)
+ * Backed by host::eeprom(); a flush copies the RAM buffer to it.
+ */
+#define E2END 0x3FF
+
+void eeprom_buffer_fill();
+void eeprom_buffer_flush();
+uint8_t eeprom_buffered_read_byte(uint32_t pos);
+void eeprom_buffered_write_byte(uint32_t pos, uint8_t value);
+uint8_t eeprom_read_byte(uint32_t pos);
+void eeprom_write_byte(uint32_t pos, uint8_t value);
+
+#endif  // HOST_EEPROM_H
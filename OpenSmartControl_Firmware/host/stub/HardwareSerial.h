@@ -0,0 +1,116 @@
+#ifndef HOST_HARDWARE_SERIAL_H
+#define HOST_HARDWARE_SERIAL_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "Print.h"
+
+/**
+ * Arduino Stream base class (host version)
+ */
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+class HardwareSerial;
+
+/**
+ * Simulated device on the far end of a host UART (e.g. the HM10 module)
+ * Sees every byte the firmware transmits and answers through
+ * HardwareSerial::hostTransmit().
+ */
+class HostSerialPeer {
+public:
+  virtual ~HostSerialPeer() {}
+  virtual void onHostBegin(HardwareSerial& port, unsigned long baud) { (void)port; (void)baud; }
+  virtual void onHostWrite(HardwareSerial& port, uint8_t c) = 0;
+};
+
+/**
+ * STM32duino HardwareSerial (host version)
+ *
+ * Models the parts of the UART the firmware depends on:
+ * - 64-byte RX buffer filled from a timed line: bytes arriving while the
+ *   buffer is full are lost and counted, like the core's RX interrupt
+ * - 64-byte TX buffer drained at the configured baud (availableForWrite())
+ * - Nothing is received while the port is closed (before begin() / after end())
+ * - HAL handle with simulated ReceiveToIdle DMA (HostHal.h): while the
+ *   transfer runs, received bytes bypass the RX buffer
+ *
+ * Test-side methods start with "host".
+ */
+class HardwareSerial : public Stream {
+public:
+  static const size_t RX_BUFFER_SIZE = 64;   // SERIAL_RX_BUFFER_SIZE in the core
+  static const size_t TX_BUFFER_SIZE = 64;   // SERIAL_TX_BUFFER_SIZE in the core
+
+  HardwareSerial(uint32_t rxPin, uint32_t txPin);
+
+  void begin(unsigned long baud);
+  void end();
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  void flush() override;
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int availableForWrite() override;
+
+  operator bool() const { return open; }
+
+  // --- Host side ---
+  // Bytes that reach the RX pin now, all at once (no line pacing)
+  void hostInject(const uint8_t* data, size_t length);
+  // Bytes sent by the peer at the port's baud, queued behind earlier traffic
+  void hostTransmit(const uint8_t* data, size_t length);
+  // Time (us) at which the last queued RX byte reaches the buffer
+  uint64_t hostLineIdleAt() const;
+  // Everything written by the firmware since the last call
+  std::vector<uint8_t> hostTakeOutput();
+  const std::vector<uint8_t>& hostOutput() const { return output; }
+
+  void hostSetPeer(HostSerialPeer* device) { peer = device; }
+  void hostSetEcho(bool enabled) { echo = enabled; }
+  bool hostIsOpen() const { return open; }
+  unsigned long hostBaud() const { return baud; }
+  unsigned long hostRxOverruns() const { return rxOverruns; }
+  unsigned long hostRxLost() const { return rxLost; }
+  // Bit time of one 8N1 character at the current baud (us)
+  uint64_t hostCharMicros() const;
+  // Clock moved: DMA transfer progress and RX events (host::advanceMicros())
+  void hostAdvance();
+
+protected:
+  serial_t _serial;
+
+private:
+  struct Arrival {
+    uint64_t at;
+    uint8_t value;
+  };
+
+  void deliver();
+  bool dmaReceiving() const;
+  void dmaStore(uint8_t value);
+
+  bool open;
+  bool echo;
+  unsigned long baud;
+  HostSerialPeer* peer;
+
+  std::deque<Arrival> line;       // Bytes on the wire, by arrival time
+  std::deque<uint8_t> rxBuffer;   // Received, not yet read
+  std::deque<uint64_t> txDone;    // Completion time of each queued TX byte
+  std::vector<uint8_t> output;    // Captured TX stream
+  unsigned long rxOverruns;       // Dropped because the RX buffer was full
+  unsigned long rxLost;           // Dropped because the port was closed
+  uint64_t lastRxAt;              // Arrival of the last byte (IDLE detection)
+};
+
+#endif  // HOST_HARDWARE_SERIAL_H
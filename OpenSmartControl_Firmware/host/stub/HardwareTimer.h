@@ -0,0 +1,48 @@
+#ifndef HOST_HARDWARE_TIMER_H
+#define HOST_HARDWARE_TIMER_H
+
+#include <cstdint>
+#include <functional>
+
+struct TIM_TypeDef;
+
+typedef enum {
+  TICK_FORMAT,
+  MICROSEC_FORMAT,
+  HERTZ_FORMAT
+} TimerFormat_t;
+
+typedef std::function<void(void)> callback_function_t;
+
+/**
+ * STM32duino HardwareTimer (host version)
+ * Update interrupts fire from the virtual clock (host::advanceMicros(),
+ * delay()) at the configured period. TICK_FORMAT counts 1 us ticks.
+ */
+class HardwareTimer {
+public:
+  explicit HardwareTimer(TIM_TypeDef* instance);
+  ~HardwareTimer();
+
+  void setOverflow(uint32_t value, TimerFormat_t format = TICK_FORMAT);
+  void attachInterrupt(callback_function_t callback);
+  void detachInterrupt();
+  void resume();
+  void pause();
+  void refresh();
+
+  // --- Host side ---
+  uint32_t hostPeriodMicros() const { return periodMicros; }
+  bool hostRunning() const { return running; }
+  uint64_t hostNextDue() const { return nextDue; }
+  void hostFire();
+
+private:
+  TIM_TypeDef* timer;
+  callback_function_t callback;
+  uint32_t periodMicros;
+  uint64_t nextDue;
+  bool running;
+};
+
+#endif  // HOST_HARDWARE_TIMER_H
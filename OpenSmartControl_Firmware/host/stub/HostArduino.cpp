@@ -0,0 +1,808 @@
+#include "HostArduino.h"
+#include <EEPROM.h>
+#include <sys/mman.h>
+#include <cstdio>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+namespace {
+
+const size_t PIN_COUNT = NUM_DIGITAL_PINS;
+const size_t EEPROM_SIZE = E2END + 1;
+
+struct PinState {
+  uint32_t mode;
+  int level;
+  void (*isr)(void);
+  uint32_t isrMode;
+};
+
+uint64_t clockMicros = 0;
+PinState pins[PIN_COUNT];
+std::vector<host::PinEvent> events;
+uint8_t eepromData[EEPROM_SIZE];
+uint8_t eepromBuffer[EEPROM_SIZE];
+unsigned long flushCount = 0;
+bool eepromErased = false;
+
+const size_t FLASH_BYTES = 128 * 1024;
+const uint32_t PAGE_ERASE_NANOS = 20000000;
+const uint32_t HALFWORD_PROGRAM_NANOS = 52500;
+uint8_t* flashCells = nullptr;
+bool flashLocked = true;
+unsigned long flashOps = 0;
+unsigned long flashCutAt = 0;
+uint32_t flashStallNanos = 0;
+
+// Function-local so timers created during static initialization register safely
+std::vector<HardwareTimer*>& timers() {
+  static std::vector<HardwareTimer*> list;
+  return list;
+}
+
+std::vector<HardwareSerial*>& serials() {
+  static std::vector<HardwareSerial*> list;
+  return list;
+}
+
+void eraseEepromOnce() {
+  if (!eepromErased) {
+    memset(eepromData, 0xFF, sizeof(eepromData));
+    memset(eepromBuffer, 0xFF, sizeof(eepromBuffer));
+    eepromErased = true;
+  }
+}
+
+/**
+ * The flash lives at its STM32 address, so firmware pointers into it
+ * (FlashBank::map()) work unchanged; erased on first use
+ */
+uint8_t* mapFlash() {
+  if (!flashCells) {
+    void* cells = mmap(reinterpret_cast<void*>(FLASH_BASE), FLASH_BYTES, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (cells != reinterpret_cast<void*>(FLASH_BASE)) {
+      fprintf(stderr, "host flash: cannot map 0x%08lX\n", (unsigned long)FLASH_BASE);
+      abort();
+    }
+    flashCells = static_cast<uint8_t*>(cells);
+    memset(flashCells, 0xFF, FLASH_BYTES);
+  }
+  return flashCells;
+}
+
+bool inFlash(uint32_t address, size_t length) {
+  return address >= FLASH_BASE && address - FLASH_BASE + length <= FLASH_BYTES;
+}
+
+// Count the operation; true when the power goes now (the flash locks again, as after a reset)
+bool flashPowerFails() {
+  flashOps++;
+  if (flashCutAt == 0 || flashOps != flashCutAt) {
+    return false;
+  }
+  flashCutAt = 0;
+  flashLocked = true;
+  return true;
+}
+
+// The CPU waits for the flash (timer interrupts still come due on the way)
+void flashStall(uint32_t nanos) {
+  flashStallNanos += nanos;
+  host::advanceMicros(flashStallNanos / 1000);
+  flashStallNanos %= 1000;
+}
+
+void setLevel(uint32_t pin, int level, bool logChange) {
+  if (pin >= PIN_COUNT) {
+    return;
+  }
+  PinState& state = pins[pin];
+  int old = state.level;
+  state.level = level;
+  if (old == level) {
+    return;
+  }
+  if (logChange) {
+    events.push_back({ clockMicros, pin, level });
+  }
+  if (state.isr) {
+    bool rising = (old == LOW && level != LOW);
+    bool falling = (old != LOW && level == LOW);
+    if (state.isrMode == CHANGE || (state.isrMode == RISING && rising) || (state.isrMode == FALLING && falling)) {
+      state.isr();
+    }
+  }
+}
+
+const char* const PIN_NAMES[] = {
+  "PA0", "PA1", "PA2", "PA3", "PA4", "PA5", "PA6", "PA7", "PA8", "PA9", "PA10", "PA11", "PA12", "PA13", "PA14", "PA15",
+  "PB0", "PB1", "PB2", "PB3", "PB4", "PB5", "PB6", "PB7", "PB8", "PB9", "PB10", "PB11", "PB12", "PB13", "PB14", "PB15",
+  "PC13", "PC14", "PC15"
+};
+static_assert(sizeof(PIN_NAMES) / sizeof(PIN_NAMES[0]) == NUM_DIGITAL_PINS, "PIN_NAMES out of step with PinName");
+
+IWDG_TypeDef iwdgRegs;
+RCC_TypeDef rccRegs = { 0, 0, 0, 0, 0, 0, 0, 0, 0, RCC_CSR_LSIRDY };
+USART_TypeDef usart1Regs;
+USART_TypeDef usart2Regs;
+TIM_TypeDef tim2Regs;
+TIM_TypeDef tim3Regs;
+TIM_TypeDef tim4Regs;
+
+}  // namespace
+
+DMA_Channel_TypeDef host_dma1Channel6;
+
+IWDG_TypeDef* const IWDG = &iwdgRegs;
+RCC_TypeDef* const RCC = &rccRegs;
+USART_TypeDef* const USART1 = &usart1Regs;
+USART_TypeDef* const USART2 = &usart2Regs;
+TIM_TypeDef* const TIM2 = &tim2Regs;
+TIM_TypeDef* const TIM3 = &tim3Regs;
+TIM_TypeDef* const TIM4 = &tim4Regs;
+
+///////////////////////////////////////////////// HOST CONTROL /////////////////////////////////////////////////
+namespace host {
+
+/**
+ * Back to power-on state (registered timers are kept, but stopped)
+ */
+void reset() {
+  clockMicros = 0;
+  for (size_t i = 0; i < PIN_COUNT; i++) {
+    pins[i] = PinState{ INPUT, LOW, nullptr, 0 };
+  }
+  events.clear();
+  for (HardwareTimer* timer : timers()) {
+    timer->pause();
+  }
+  eepromErased = false;
+  eraseEepromOnce();
+  flushCount = 0;
+}
+
+uint64_t nowMicros() {
+  return clockMicros;
+}
+
+/**
+ * Move the clock forward, firing every timer update that falls due on the way
+ */
+void advanceMicros(uint64_t us) {
+  uint64_t target = clockMicros + us;
+  for (;;) {
+    HardwareTimer* next = nullptr;
+    for (HardwareTimer* timer : timers()) {
+      if (timer->hostRunning() && timer->hostNextDue() <= target && (!next || timer->hostNextDue() < next->hostNextDue())) {
+        next = timer;
+      }
+    }
+    if (!next) {
+      break;
+    }
+    if (next->hostNextDue() > clockMicros) {
+      clockMicros = next->hostNextDue();
+    }
+    next->hostFire();
+  }
+  if (target > clockMicros) {
+    clockMicros = target;
+  }
+  for (HardwareSerial* serial : serials()) {
+    serial->hostAdvance();
+  }
+}
+
+void advanceMillis(uint64_t ms) {
+  advanceMicros(ms * 1000ULL);
+}
+
+void setInput(uint32_t pin, int level) {
+  setLevel(pin, level, false);
+}
+
+int pinLevel(uint32_t pin) {
+  return pin < PIN_COUNT ? pins[pin].level : LOW;
+}
+
+const char* pinName(uint32_t pin) {
+  return pin < PIN_COUNT ? PIN_NAMES[pin] : "?";
+}
+
+const std::vector<PinEvent>& pinEvents() {
+  return events;
+}
+
+void clearPinEvents() {
+  events.clear();
+}
+
+uint8_t* eeprom() {
+  eraseEepromOnce();
+  return eepromData;
+}
+
+size_t eepromSize() {
+  return EEPROM_SIZE;
+}
+
+unsigned long eepromFlushes() {
+  return flushCount;
+}
+
+uint8_t* flash() {
+  return mapFlash();
+}
+
+size_t flashSize() {
+  return FLASH_BYTES;
+}
+
+unsigned long flashOperations() {
+  return flashOps;
+}
+
+void flashPowerLossAt(unsigned long operation) {
+  flashCutAt = operation;
+}
+
+}  // namespace host
+
+///////////////////////////////////////////////// ARDUINO CORE /////////////////////////////////////////////////
+void pinMode(uint32_t pin, uint32_t mode) {
+  if (pin >= PIN_COUNT) {
+    return;
+  }
+  pins[pin].mode = mode;
+  if (mode == INPUT_PULLUP) {
+    setLevel(pin, HIGH, false);
+  } else if (mode == INPUT_PULLDOWN) {
+    setLevel(pin, LOW, false);
+  }
+}
+
+void digitalWrite(uint32_t pin, uint32_t value) {
+  setLevel(pin, value ? HIGH : LOW, true);
+}
+
+int digitalRead(uint32_t pin) {
+  return host::pinLevel(pin);
+}
+
+void analogWrite(uint32_t pin, int value) {
+  setLevel(pin, value, true);
+}
+
+uint32_t digitalPinToInterrupt(uint32_t pin) {
+  return pin;
+}
+
+void attachInterrupt(uint32_t pin, void (*callback)(void), uint32_t mode) {
+  if (pin < PIN_COUNT) {
+    pins[pin].isr = callback;
+    pins[pin].isrMode = mode;
+  }
+}
+
+void detachInterrupt(uint32_t pin) {
+  if (pin < PIN_COUNT) {
+    pins[pin].isr = nullptr;
+  }
+}
+
+unsigned long millis() {
+  return (unsigned long)(clockMicros / 1000ULL);
+}
+
+unsigned long micros() {
+  return (unsigned long)clockMicros;
+}
+
+void delay(unsigned long ms) {
+  host::advanceMillis(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+  host::advanceMicros(us);
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+void noInterrupts() {}
+
+void interrupts() {}
+
+void NVIC_SystemReset() {
+  throw host::SystemReset();
+}
+
+///////////////////////////////////////////////// EEPROM /////////////////////////////////////////////////
+void eeprom_buffer_fill() {
+  eraseEepromOnce();
+  memcpy(eepromBuffer, eepromData, EEPROM_SIZE);
+}
+
+void eeprom_buffer_flush() {
+  eraseEepromOnce();
+  memcpy(eepromData, eepromBuffer, EEPROM_SIZE);
+  flushCount++;
+}
+
+uint8_t eeprom_buffered_read_byte(uint32_t pos) {
+  eraseEepromOnce();
+  return pos < EEPROM_SIZE ? eepromBuffer[pos] : 0xFF;
+}
+
+void eeprom_buffered_write_byte(uint32_t pos, uint8_t value) {
+  eraseEepromOnce();
+  if (pos < EEPROM_SIZE) {
+    eepromBuffer[pos] = value;
+  }
+}
+
+uint8_t eeprom_read_byte(uint32_t pos) {
+  return pos < EEPROM_SIZE ? host::eeprom()[pos] : 0xFF;
+}
+
+void eeprom_write_byte(uint32_t pos, uint8_t value) {
+  if (pos < EEPROM_SIZE) {
+    host::eeprom()[pos] = value;
+    flushCount++;
+  }
+}
+
+///////////////////////////////////////////////// PRINT /////////////////////////////////////////////////
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (write(*buffer++) == 0) {
+      break;
+    }
+    n++;
+  }
+  return n;
+}
+
+size_t Print::printNumber(unsigned long value, int base, bool negative) {
+  char text[8 * sizeof(long) + 2];
+  char* p = &text[sizeof(text) - 1];
+  *p = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    unsigned long digit = value % base;
+    value /= base;
+    *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+  } while (value);
+  if (negative) {
+    *--p = '-';
+  }
+  return write(p);
+}
+
+size_t Print::print(const char* str) {
+  return write(str);
+}
+
+size_t Print::print(char c) {
+  return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char value, int base) {
+  return printNumber(value, base, false);
+}
+
+size_t Print::print(int value, int base) {
+  return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+  return printNumber(value, base, false);
+}
+
+// long is 32 bits on the target: negative values in a non-decimal base
+// print as their 32-bit two's complement
+size_t Print::print(long value, int base) {
+  if (base == 10 && value < 0) {
+    return printNumber((unsigned long)(-value), 10, true);
+  }
+  return printNumber((uint32_t)value, base, false);
+}
+
+size_t Print::print(unsigned long value, int base) {
+  return printNumber((uint32_t)value, base, false);
+}
+
+size_t Print::print(double value, int digits) {
+  char text[48];
+  snprintf(text, sizeof(text), "%.*f", digits, value);
+  return write(text);
+}
+
+size_t Print::println(const char* str) {
+  return print(str) + println();
+}
+
+size_t Print::println(char c) {
+  return print(c) + println();
+}
+
+size_t Print::println(unsigned char value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(int value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(unsigned int value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base) {
+  return print(value, base) + println();
+}
+
+size_t Print::println(double value, int digits) {
+  return print(value, digits) + println();
+}
+
+size_t Print::println() {
+  return write("\r\n");
+}
+
+///////////////////////////////////////////////// HARDWARE SERIAL /////////////////////////////////////////////////
+HardwareSerial::HardwareSerial(uint32_t rxPin, uint32_t txPin)
+  : open(false), echo(false), baud(0), peer(nullptr), rxOverruns(0), rxLost(0), lastRxAt(0) {
+  (void)txPin;
+  memset(&_serial, 0, sizeof(_serial));
+  _serial.handle.Instance = (rxPin == PA3) ? USART2 : USART1;
+  _serial.handle.RxState = HAL_UART_STATE_READY;
+  serials().push_back(this);
+}
+
+/**
+ * (Re)open the port; like the core's uart_init() this ends a DMA transfer
+ */
+void HardwareSerial::begin(unsigned long rate) {
+  baud = rate;
+  open = true;
+  _serial.handle.Init.BaudRate = rate;
+  _serial.handle.RxState = HAL_UART_STATE_READY;
+  _serial.handle.ReceptionType = HAL_UART_RECEPTION_STANDARD;
+  line.clear();
+  rxBuffer.clear();
+  txDone.clear();
+  if (peer) {
+    peer->onHostBegin(*this, rate);
+  }
+}
+
+void HardwareSerial::end() {
+  deliver();
+  open = false;
+  _serial.handle.RxState = HAL_UART_STATE_READY;
+  rxBuffer.clear();
+  txDone.clear();
+}
+
+uint64_t HardwareSerial::hostCharMicros() const {
+  unsigned long rate = baud ? baud : 9600;
+  return (10ULL * 1000000ULL + rate - 1) / rate;
+}
+
+/**
+ * Move bytes that have reached the RX pin into the 64-byte buffer
+ * (nothing reads in between, so doing it lazily gives the same result)
+ */
+void HardwareSerial::deliver() {
+  uint64_t now = host::nowMicros();
+  while (!line.empty() && line.front().at <= now) {
+    if (!open) {
+      rxLost++;
+    } else if (dmaReceiving()) {
+      lastRxAt = line.front().at;
+      dmaStore(line.front().value);
+    } else if (rxBuffer.size() >= RX_BUFFER_SIZE) {
+      rxOverruns++;
+    } else {
+      rxBuffer.push_back(line.front().value);
+    }
+    line.pop_front();
+  }
+}
+
+bool HardwareSerial::dmaReceiving() const {
+  const UART_HandleTypeDef& h = _serial.handle;
+  return h.RxState == HAL_UART_STATE_BUSY_RX && h.ReceptionType == HAL_UART_RECEPTION_TOIDLE && h.pRxBuffPtr;
+}
+
+/**
+ * One byte through the circular DMA channel, with the half / full transfer events
+ */
+void HardwareSerial::dmaStore(uint8_t value) {
+  UART_HandleTypeDef& h = _serial.handle;
+  h.pRxBuffPtr[h.hostDmaPos++] = value;
+  if (h.hostDmaPos == h.RxXferSize / 2 || h.hostDmaPos == h.RxXferSize) {
+    h.hostDmaReported = h.hostDmaPos;
+    HAL_UARTEx_RxEventCallback(&h, h.hostDmaPos);
+  }
+  if (h.hostDmaPos == h.RxXferSize) {
+    h.hostDmaPos = 0;
+    h.hostDmaReported = 0;
+  }
+}
+
+/**
+ * DMA reception: deliver what has arrived and raise the IDLE event once the
+ * line has been quiet for one character time
+ */
+void HardwareSerial::hostAdvance() {
+  if (!dmaReceiving()) {
+    return;
+  }
+  deliver();
+  UART_HandleTypeDef& h = _serial.handle;
+  if (h.hostDmaPos != h.hostDmaReported && host::nowMicros() >= lastRxAt + hostCharMicros() &&
+      (line.empty() || line.front().at > lastRxAt + hostCharMicros())) {
+    h.hostDmaReported = h.hostDmaPos;
+    HAL_UARTEx_RxEventCallback(&h, h.hostDmaPos);
+  }
+}
+
+int HardwareSerial::available() {
+  deliver();
+  return (int)rxBuffer.size();
+}
+
+int HardwareSerial::read() {
+  deliver();
+  if (rxBuffer.empty()) {
+    return -1;
+  }
+  int c = rxBuffer.front();
+  rxBuffer.pop_front();
+  return c;
+}
+
+int HardwareSerial::peek() {
+  deliver();
+  return rxBuffer.empty() ? -1 : rxBuffer.front();
+}
+
+void HardwareSerial::flush() {
+  if (!txDone.empty() && txDone.back() > host::nowMicros()) {
+    host::advanceMicros(txDone.back() - host::nowMicros());
+  }
+  txDone.clear();
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  uint64_t now = host::nowMicros();
+  while (!txDone.empty() && txDone.front() <= now) {
+    txDone.pop_front();
+  }
+  uint64_t start = txDone.empty() ? now : txDone.back();
+  txDone.push_back(start + hostCharMicros());
+  output.push_back(c);
+  if (echo) {
+    fputc(c, stdout);
+  }
+  if (peer) {
+    peer->onHostWrite(*this, c);
+  }
+  return 1;
+}
+
+int HardwareSerial::availableForWrite() {
+  uint64_t now = host::nowMicros();
+  while (!txDone.empty() && txDone.front() <= now) {
+    txDone.pop_front();
+  }
+  return txDone.size() >= TX_BUFFER_SIZE ? 0 : (int)(TX_BUFFER_SIZE - txDone.size());
+}
+
+void HardwareSerial::hostInject(const uint8_t* data, size_t length) {
+  uint64_t now = host::nowMicros();
+  for (size_t i = 0; i < length; i++) {
+    line.push_back({ now, data[i] });
+  }
+}
+
+void HardwareSerial::hostTransmit(const uint8_t* data, size_t length) {
+  uint64_t at = host::nowMicros();
+  if (!line.empty() && line.back().at > at) {
+    at = line.back().at;
+  }
+  for (size_t i = 0; i < length; i++) {
+    at += hostCharMicros();
+    line.push_back({ at, data[i] });
+  }
+}
+
+uint64_t HardwareSerial::hostLineIdleAt() const {
+  return line.empty() ? host::nowMicros() : line.back().at;
+}
+
+std::vector<uint8_t> HardwareSerial::hostTakeOutput() {
+  std::vector<uint8_t> taken;
+  taken.swap(output);
+  return taken;
+}
+
+///////////////////////////////////////////////// HAL UART DMA /////////////////////////////////////////////////
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma) {
+  return hdma && hdma->Instance ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef* hdma) {
+  return hdma ? HAL_OK : HAL_ERROR;
+}
+
+// Transfer events are raised by HardwareSerial directly
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef* hdma) {
+  (void)hdma;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt, uint32_t sub) {
+  (void)irq;
+  (void)preempt;
+  (void)sub;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type irq) {
+  (void)irq;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type irq) {
+  (void)irq;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart) {
+  huart->RxState = HAL_UART_STATE_READY;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size) {
+  if (!huart->hdmarx || !data || size == 0) {
+    return HAL_ERROR;
+  }
+  if (huart->RxState != HAL_UART_STATE_READY) {
+    return HAL_BUSY;
+  }
+  huart->pRxBuffPtr = data;
+  huart->RxXferSize = size;
+  huart->hostDmaPos = 0;
+  huart->hostDmaReported = 0;
+  huart->ReceptionType = HAL_UART_RECEPTION_TOIDLE;
+  huart->RxState = HAL_UART_STATE_BUSY_RX;
+  return HAL_OK;
+}
+
+extern "C" __attribute__((weak)) void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t size) {
+  (void)huart;
+  (void)size;
+}
+
+///////////////////////////////////////////////// HAL FLASH /////////////////////////////////////////////////
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+  flashLocked = false;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+  flashLocked = true;
+  return HAL_OK;
+}
+
+/**
+ * Halfword program: only erased cells (or clearing to 0x0000, as the F1 allows)
+ */
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t typeProgram, uint32_t address, uint64_t data) {
+  if (flashLocked || typeProgram != FLASH_TYPEPROGRAM_HALFWORD || (address & 1) || !inFlash(address, 2)) {
+    return HAL_ERROR;
+  }
+  uint8_t* cell = mapFlash() + (address - FLASH_BASE);
+  uint16_t value = (uint16_t)data;
+  uint16_t old = cell[0] | ((uint16_t)cell[1] << 8);
+  if (old != 0xFFFF && value != 0x0000) {
+    return HAL_ERROR;  // PGERR
+  }
+  if (flashPowerFails()) {
+    cell[0] &= (uint8_t)value;
+    throw host::PowerLoss();
+  }
+  cell[0] = (uint8_t)value;
+  cell[1] = (uint8_t)(value >> 8);
+  flashStall(HALFWORD_PROGRAM_NANOS);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* erase, uint32_t* pageError) {
+  *pageError = erase->PageAddress;
+  if (flashLocked || erase->TypeErase != HOST_FLASH_TYPEERASE_PAGES || (erase->PageAddress % FLASH_PAGE_SIZE) ||
+      !inFlash(erase->PageAddress, (size_t)erase->NbPages * FLASH_PAGE_SIZE)) {
+    return HAL_ERROR;
+  }
+  for (uint32_t i = 0; i < erase->NbPages; i++) {
+    uint32_t address = erase->PageAddress + i * FLASH_PAGE_SIZE;
+    uint8_t* page = mapFlash() + (address - FLASH_BASE);
+    if (flashPowerFails()) {
+      memset(page, 0xFF, FLASH_PAGE_SIZE / 2);
+      *pageError = address;
+      throw host::PowerLoss();
+    }
+    memset(page, 0xFF, FLASH_PAGE_SIZE);
+    flashStall(PAGE_ERASE_NANOS);
+  }
+  *pageError = 0xFFFFFFFF;
+  return HAL_OK;
+}
+
+///////////////////////////////////////////////// HARDWARE TIMER /////////////////////////////////////////////////
+HardwareTimer::HardwareTimer(TIM_TypeDef* instance)
+  : timer(instance), periodMicros(0), nextDue(0), running(false) {
+  timers().push_back(this);
+}
+
+HardwareTimer::~HardwareTimer() {
+  std::vector<HardwareTimer*>& list = timers();
+  for (size_t i = 0; i < list.size(); i++) {
+    if (list[i] == this) {
+      list.erase(list.begin() + i);
+      break;
+    }
+  }
+}
+
+void HardwareTimer::setOverflow(uint32_t value, TimerFormat_t format) {
+  if (format == HERTZ_FORMAT) {
+    periodMicros = value ? 1000000UL / value : 0;
+  } else {
+    periodMicros = value;
+  }
+  if (running) {
+    nextDue = host::nowMicros() + periodMicros;
+  }
+}
+
+void HardwareTimer::attachInterrupt(callback_function_t cb) {
+  callback = cb;
+}
+
+void HardwareTimer::detachInterrupt() {
+  callback = nullptr;
+}
+
+void HardwareTimer::resume() {
+  if (!running && periodMicros > 0) {
+    running = true;
+    nextDue = host::nowMicros() + periodMicros;
+  }
+}
+
+void HardwareTimer::pause() {
+  running = false;
+}
+
+void HardwareTimer::refresh() {
+  nextDue = host::nowMicros() + periodMicros;
+}
+
+void HardwareTimer::hostFire() {
+  nextDue += periodMicros;
+  if (callback) {
+    callback();
+  }
+}
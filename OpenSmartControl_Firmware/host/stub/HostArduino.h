@@ -0,0 +1,75 @@
+#ifndef HOST_ARDUINO_CONTROL_H
+#define HOST_ARDUINO_CONTROL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Arduino.h"
+
+/**
+ * Test-side control of the host Arduino core
+ *
+ * Features:
+ * - Virtual clock: nothing moves until a test (or delay()) advances it,
+ *   so a 20-minute session replays in milliseconds and every run is
+ *   deterministic
+ * - Timer interrupts fire in deadline order while the clock advances
+ * - Output pin log (only level changes) for motor timeline assertions
+ * - Input pins with CHANGE/RISING/FALLING interrupts
+ * - 1 KB emulated EEPROM
+ * - 128 KB flash model behind the HAL flash calls (HOST_FLASH variants):
+ *   erase to 0xFF, halfword programming of erased cells only, the CPU
+ *   stall of each operation on the clock, and power loss on demand
+ */
+namespace host {
+
+/**
+ * One output pin level change
+ */
+struct PinEvent {
+  uint64_t micros;
+  uint32_t pin;
+  int value;
+};
+
+/**
+ * Thrown by NVIC_SystemReset() so a test can catch the reboot
+ */
+struct SystemReset {};
+
+/**
+ * Thrown by the flash model at the operation set with flashPowerLossAt()
+ */
+struct PowerLoss {};
+
+// Back to power-on: clock 0, pins floating, log and EEPROM cleared
+void reset();
+
+uint64_t nowMicros();
+void advanceMicros(uint64_t us);
+void advanceMillis(uint64_t ms);
+
+// Drive an input pin (fires attached interrupts)
+void setInput(uint32_t pin, int level);
+int pinLevel(uint32_t pin);
+const char* pinName(uint32_t pin);
+
+const std::vector<PinEvent>& pinEvents();
+void clearPinEvents();
+
+uint8_t* eeprom();
+size_t eepromSize();
+unsigned long eepromFlushes();
+
+// Flash at FLASH_BASE (kept by reset(), like the chip). A page erase stalls
+// the clock 20ms, a halfword program 52.5us (datasheet typical values).
+uint8_t* flash();
+size_t flashSize();
+unsigned long flashOperations();  // Page erases + halfword programs so far
+// Cut the power during that operation (counted like flashOperations(), 0 = never):
+// an erase stops halfway through the page, a halfword gets its low byte only
+void flashPowerLossAt(unsigned long operation);
+
+}  // namespace host
+
+#endif  // HOST_ARDUINO_CONTROL_H
@@ -0,0 +1,141 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <cstdint>
+
+/**
+ * STM32 HAL UART / DMA / Flash subset (host version)
+ *
+ * Just what BleDmaReceiver needs for circular reception-to-idle on USART2,
+ * and what FirmwareUpdater's flash driver needs for page erase and halfword
+ * programming. The types are always declared, so every firmware variant
+ * links against the same stub library; the HAL_*_MODULE_ENABLED switches
+ * that turn the firmware paths on are only defined when the variant is
+ * built with HOST_UART_DMA=1 or HOST_FLASH=1.
+ *
+ * The transfer is simulated by HardwareSerial: while a ReceiveToIdle
+ * transfer runs, bytes reaching the RX pin go to the DMA buffer instead of
+ * the 64-byte RX buffer, and HAL_UARTEx_RxEventCallback() fires on the
+ * half-transfer, full-transfer and IDLE-line events as the clock advances.
+ *
+ * The flash is a 128 KB model mapped at FLASH_BASE (host::flash()), so the
+ * firmware reads it through plain pointers as on the board.
+ */
+
+#if HOST_UART_DMA
+#define HAL_UART_MODULE_ENABLED
+#define HAL_DMA_MODULE_ENABLED
+#define DMA1_Channel6 (&host_dma1Channel6)
+#endif
+
+#if HOST_FLASH
+#define HAL_FLASH_MODULE_ENABLED
+#define FLASH_TYPEERASE_PAGES HOST_FLASH_TYPEERASE_PAGES
+#define FLASH_BANK_1 0x01U
+#endif
+
+typedef enum {
+  HAL_OK = 0x00,
+  HAL_ERROR = 0x01,
+  HAL_BUSY = 0x02,
+  HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+typedef enum {
+  DMA1_Channel6_IRQn = 16
+} IRQn_Type;
+
+#define HAL_UART_STATE_READY 0x20U
+#define HAL_UART_STATE_BUSY_RX 0x22U
+#define HAL_UART_RECEPTION_STANDARD 0x00U
+#define HAL_UART_RECEPTION_TOIDLE 0x01U
+
+#define DMA_PERIPH_TO_MEMORY 0x00000000U
+#define DMA_PINC_DISABLE 0x00000000U
+#define DMA_MINC_ENABLE 0x00000080U
+#define DMA_PDATAALIGN_BYTE 0x00000000U
+#define DMA_MDATAALIGN_BYTE 0x00000000U
+#define DMA_CIRCULAR 0x00000020U
+#define DMA_PRIORITY_MEDIUM 0x00001000U
+
+#define USART_SR_ORE (1UL << 3)
+#define USART_SR_NE (1UL << 2)
+#define USART_SR_FE (1UL << 1)
+#define USART_CR1_PEIE (1UL << 8)
+#define USART_CR3_EIE (1UL << 0)
+
+#define CLEAR_BIT(reg, bit) ((reg) &= ~(bit))
+
+struct DMA_Channel_TypeDef {
+  volatile uint32_t CCR, CNDTR, CPAR, CMAR;
+};
+extern DMA_Channel_TypeDef host_dma1Channel6;
+
+struct DMA_InitTypeDef {
+  uint32_t Direction, PeriphInc, MemInc, PeriphDataAlignment, MemDataAlignment, Mode, Priority;
+};
+
+struct DMA_HandleTypeDef {
+  DMA_Channel_TypeDef* Instance;
+  DMA_InitTypeDef Init;
+  void* Parent;
+};
+
+struct UART_InitTypeDef {
+  uint32_t BaudRate;
+};
+
+struct UART_HandleTypeDef {
+  struct USART_TypeDef* Instance;
+  UART_InitTypeDef Init;
+  DMA_HandleTypeDef* hdmarx;
+  uint8_t* pRxBuffPtr;
+  uint16_t RxXferSize;
+  volatile uint32_t RxState;
+  volatile uint32_t ReceptionType;
+  uint16_t hostDmaPos;       // Bytes written in the current lap (RxXferSize - CNDTR)
+  uint16_t hostDmaReported;  // Position given to the last RX event
+};
+
+// STM32duino keeps the HAL handle of a HardwareSerial in serial_t
+struct serial_t {
+  UART_HandleTypeDef handle;
+};
+
+#define __HAL_RCC_DMA1_CLK_ENABLE() do { } while (0)
+#define __HAL_LINKDMA(handle, field, dma) \
+  do { \
+    (handle)->field = &(dma); \
+    (dma).Parent = (handle); \
+  } while (0)
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef* hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef* hdma);
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt, uint32_t sub);
+void HAL_NVIC_EnableIRQ(IRQn_Type irq);
+void HAL_NVIC_DisableIRQ(IRQn_Type irq);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size);
+
+// Defined by the firmware when it uses the DMA path (weak no-op otherwise)
+extern "C" void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t size);
+
+#define FLASH_BASE 0x08000000UL
+#define FLASH_PAGE_SIZE 0x400U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+#define HOST_FLASH_TYPEERASE_PAGES 0x00U
+
+struct FLASH_EraseInitTypeDef {
+  uint32_t TypeErase;
+  uint32_t Banks;
+  uint32_t PageAddress;
+  uint32_t NbPages;
+};
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t typeProgram, uint32_t address, uint64_t data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* erase, uint32_t* pageError);
+
+#endif  // HOST_HAL_H
@@ -0,0 +1,53 @@
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Arduino Print base class (host version)
+ * Same overload set as the core; numbers are formatted in HostArduino.cpp.
+ */
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str) {
+    return str ? write((const uint8_t*)str, strlen(str)) : 0;
+  }
+  size_t write(const char* buffer, size_t size) {
+    return write((const uint8_t*)buffer, size);
+  }
+
+  // Free space in the output buffer (0 = unknown, like the core default)
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const char* str);
+  size_t print(char c);
+  size_t print(unsigned char value, int base = DEC_BASE);
+  size_t print(int value, int base = DEC_BASE);
+  size_t print(unsigned int value, int base = DEC_BASE);
+  size_t print(long value, int base = DEC_BASE);
+  size_t print(unsigned long value, int base = DEC_BASE);
+  size_t print(double value, int digits = 2);
+
+  size_t println(const char* str);
+  size_t println(char c);
+  size_t println(unsigned char value, int base = DEC_BASE);
+  size_t println(int value, int base = DEC_BASE);
+  size_t println(unsigned int value, int base = DEC_BASE);
+  size_t println(long value, int base = DEC_BASE);
+  size_t println(unsigned long value, int base = DEC_BASE);
+  size_t println(double value, int digits = 2);
+  size_t println();
+
+private:
+  static const int DEC_BASE = 10;
+  size_t printNumber(unsigned long value, int base, bool negative);
+};
+
+#endif  // HOST_PRINT_H
@@ -0,0 +1,103 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <HostArduino.h>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Minimal test helpers for the host build
+ *
+ * CHECK() / CHECK_EQ() report the failing line and keep going;
+ * main() ends with "return host_test::result();" (non-zero on failure).
+ */
+namespace host_test {
+
+inline int& failures() {
+  static int count = 0;
+  return count;
+}
+
+inline bool check(bool ok, const char* expr, const char* file, int line) {
+  if (!ok) {
+    fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, expr);
+    failures()++;
+  }
+  return ok;
+}
+
+inline bool checkEq(long long actual, long long expected, const char* expr, const char* file, int line) {
+  if (actual != expected) {
+    fprintf(stderr, "%s:%d: CHECK_EQ failed: %s (got %lld, expected %lld)\n", file, line, expr, actual, expected);
+    failures()++;
+    return false;
+  }
+  return true;
+}
+
+inline int result() {
+  if (failures()) {
+    fprintf(stderr, "%d check(s) failed\n", failures());
+    return 1;
+  }
+  printf("ok\n");
+  return 0;
+}
+
+}  // namespace host_test
+
+#define CHECK(cond) host_test::check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(actual, expected) \
+  host_test::checkEq((long long)(actual), (long long)(expected), #actual " == " #expected, __FILE__, __LINE__)
+
+///////////////////////////////////////////////// SKETCH RIG /////////////////////////////////////////////////
+// Globals defined by the .ino (Sketch.cpp)
+class MassageController;
+extern HardwareSerial mySerial;
+extern HardwareSerial mySerial2;
+extern MassageController* massageController;
+void setup();
+void loop();
+
+namespace host_test {
+
+// Main loop pass period used by runFor() (a busy pass on the F103 is ~0.5 ms)
+static const uint32_t LOOP_PASS_MICROS = 500;
+
+/**
+ * Power on and run setup() (once per process: setup() allocates the controller)
+ */
+inline void boot() {
+  host::reset();
+  setup();
+}
+
+/**
+ * Run loop() for the given virtual time, one pass every passMicros
+ */
+inline void runFor(uint64_t ms, uint32_t passMicros = LOOP_PASS_MICROS) {
+  uint64_t end = host::nowMicros() + ms * 1000ULL;
+  while (host::nowMicros() < end) {
+    loop();
+    host::advanceMicros(passMicros);
+  }
+}
+
+/**
+ * Boot with the roller parked at the UP limit and run through the startup
+ * delay and the GO HOME sequence, so commands are accepted afterwards
+ * (limit inputs read HIGH when active)
+ */
+inline void bootToReady() {
+  boot();
+  host::setInput(PB4, HIGH);  // LMT_UP_PIN
+  host::setInput(PB3, LOW);   // LMT_DOWN_PIN
+  runFor(6000);
+  mySerial.hostTakeOutput();
+  mySerial2.hostTakeOutput();
+  host::clearPinEvents();
+}
+
+}  // namespace host_test
+
+#endif  // HOST_TEST_H
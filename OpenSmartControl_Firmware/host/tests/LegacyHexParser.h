@@ -0,0 +1,130 @@
+#ifndef LEGACY_HEX_PARSER_H
+#define LEGACY_HEX_PARSER_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * The receive path HexFrameDecoder replaced, kept as a host-side yardstick
+ *
+ * Same steps and buffers as the original CommunicationManager code:
+ * parsePacket() collects characters into hexString2, hexStringToBytes()
+ * converts them after strlen(), the 7 bytes are copied into completePacket
+ * and verifyCompletePacket() copies the payload once more to check it.
+ * Debug prints and the UART1 branch are left out.
+ */
+class LegacyHexParser {
+public:
+  static const uint8_t STX = 0x02;
+  static const uint8_t ETX = 0x03;
+  static const int PACKET_SIZE = 9;
+  static const int PAYLOAD_SIZE = 6;
+  static const int MAX_DATA_SIZE = 20;
+  static const int MAX_HEX_STRING_SIZE = 40;
+
+  // Receive state the old path kept per UART
+  struct State {
+    char hexString[MAX_HEX_STRING_SIZE];
+    uint8_t data[MAX_DATA_SIZE];
+    int dataLen;
+    int hexIdx;
+    bool dataReady;
+    uint8_t parseState;
+  };
+  // Plus the stack copies made per frame (completePacket, payload)
+  static const size_t RAM_BYTES = sizeof(State) + PACKET_SIZE + PAYLOAD_SIZE;
+
+  LegacyHexParser() {
+    memset(&state, 0, sizeof(state));
+  }
+
+  /**
+   * One received byte; true when a valid 7-byte packet was completed
+   * (copied to packet[0..6])
+   */
+  bool feed(uint8_t b, uint8_t packet[7]) {
+    parsePacket(b);
+    if (!state.dataReady) return false;
+    state.dataReady = false;
+
+    state.dataLen = hexStringToBytes(state.hexString, state.data);
+    if (state.dataLen != 7) return false;
+
+    uint8_t completePacket[PACKET_SIZE];
+    completePacket[0] = STX;
+    for (int i = 0; i < 7; i++) {
+      completePacket[i + 1] = state.data[i];
+    }
+    completePacket[8] = ETX;
+    if (!verifyCompletePacket(completePacket, PACKET_SIZE)) return false;
+    memcpy(packet, completePacket + 1, 7);
+    return true;
+  }
+
+private:
+  enum { WAIT_START, READ_HEX_STRING };
+
+  State state;
+
+  void parsePacket(uint8_t receivedByte) {
+    switch (state.parseState) {
+      case WAIT_START:
+        if (receivedByte == STX) {
+          state.parseState = READ_HEX_STRING;
+          state.hexIdx = 0;
+        }
+        break;
+
+      case READ_HEX_STRING:
+        if (receivedByte == ETX) {
+          state.parseState = WAIT_START;
+          state.hexString[state.hexIdx] = '\0';
+          state.dataReady = true;
+        } else if (state.hexIdx < MAX_HEX_STRING_SIZE - 1) {
+          state.hexString[state.hexIdx++] = receivedByte;
+        }
+        break;
+    }
+  }
+
+  static uint8_t hexCharToByte(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return 0;
+  }
+
+  static int hexStringToBytes(const char* hexStr, uint8_t* outBytes) {
+    int len = strlen(hexStr);
+    int byteCount = 0;
+    for (int i = 0; i < len; i += 2) {
+      if (i + 1 < len) {
+        outBytes[byteCount++] = (hexCharToByte(hexStr[i]) << 4) | hexCharToByte(hexStr[i + 1]);
+      }
+    }
+    return byteCount;
+  }
+
+  static uint8_t calculateChecksum(const uint8_t* data, int len) {
+    uint16_t sum = 0;
+    for (int i = 0; i < len; i++) {
+      sum += data[i];
+    }
+    while (sum >> 8) {
+      sum = (sum & 0xFF) + (sum >> 8);
+    }
+    return ((~sum) + 0x10) & 0xFF;
+  }
+
+  static bool verifyCompletePacket(const uint8_t* packet, int length) {
+    if (length != PACKET_SIZE) return false;
+    if (packet[0] != STX || packet[8] != ETX) return false;
+    uint8_t payload[PAYLOAD_SIZE];
+    for (int i = 0; i < PAYLOAD_SIZE; i++) {
+      payload[i] = packet[i + 1];
+    }
+    return calculateChecksum(payload, PAYLOAD_SIZE) == packet[7];
+  }
+};
+
+#endif  // LEGACY_HEX_PARSER_H
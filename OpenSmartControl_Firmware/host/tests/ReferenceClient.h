@@ -0,0 +1,227 @@
+#ifndef REFERENCE_CLIENT_H
+#define REFERENCE_CLIENT_H
+
+#include <HostArduino.h>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include "ReferenceFrames.h"
+
+/**
+ * Reference app-side sender over a lossy BLE link
+ *
+ * Sits on the far end of the BLE UART in place of the HM10 and its
+ * connected phone, and sends commands the way the protocol README
+ * describes for each mode:
+ * - MODE_BLIND: legacy app, every command sent BLIND_COPIES times
+ *   BLIND_GAP_MICROS apart with the same sequence; no replies expected
+ * - MODE_ACK:   SEQUENCE_WINDOW + LINK_OPT_ACK; a command is resent with
+ *   the same sequence when no CMD_ACK arrived within retransmitMicros, at
+ *   once on a CMD_NACK, at most MAX_RETRIES times
+ *
+ * Link model, per frame and direction: lost with probability `loss`; an
+ * app frame is also corrupted (one hex digit changed, so the checksum
+ * fails) with probability `corrupt`. Frames that were lost still took
+ * their air time. Replies reach the client at the line rate, not when
+ * the firmware writes them.
+ *
+ * poll() must run between loop() passes.
+ */
+class ReferenceClient : public HostSerialPeer {
+public:
+  enum Mode { MODE_BLIND, MODE_ACK };
+
+  static const uint8_t DEVICE_ID = 0x70;
+  static const int BLIND_COPIES = 3;
+  static const uint64_t BLIND_GAP_MICROS = 100000;
+  static const uint64_t RETRANSMIT_MICROS = 100000;  // README suggestion (~3 round trips)
+  static const int MAX_RETRIES = 3;
+
+  // App -> firmware command constants (CommunicationManager.h)
+  static const uint8_t CMD_LINK_CONFIG = 0xE0;
+  static const uint8_t CMD_ACK = 0xE1;
+  static const uint8_t CMD_NACK = 0xE2;
+  static const uint8_t LINK_OPT_SEQUENCE = 0x02;
+  static const uint8_t LINK_OPT_ACK = 0x03;
+  static const uint8_t SEQUENCE_WINDOW = 0x01;
+  static const uint8_t RESULT_DUPLICATE = 0x01;
+
+  uint64_t retransmitMicros = RETRANSMIT_MICROS;
+
+  // Statistics
+  unsigned long framesSent = 0;     // Including lost and resent ones
+  unsigned long bytesSent = 0;
+  unsigned long bytesReceived = 0;  // Including lost replies
+  unsigned long resends = 0;
+  unsigned long acks = 0;
+  unsigned long duplicateAcks = 0;
+  unsigned long nacks = 0;
+  unsigned long giveUps = 0;
+  uint64_t confirmMicrosTotal = 0;  // First send -> ACK, summed over acked commands
+
+  ReferenceClient(HardwareSerial& bleSerial, Mode clientMode, double lossRate, double corruptRate, uint32_t seed)
+    : port(bleSerial), mode(clientMode), loss(lossRate), corrupt(corruptRate), rng(seed) {
+    port.hostSetPeer(this);
+  }
+  ~ReferenceClient() override {
+    port.hostSetPeer(nullptr);
+  }
+
+  /**
+   * MODE_ACK: ask for SEQUENCE_WINDOW and ACK replies (each option is
+   * resent until its CMD_LINK_CONFIG reply arrives)
+   */
+  void connect() {
+    if (mode != MODE_ACK) return;
+    send(CMD_LINK_CONFIG, LINK_OPT_SEQUENCE, SEQUENCE_WINDOW);
+    send(CMD_LINK_CONFIG, LINK_OPT_ACK, 0x01);
+  }
+
+  /**
+   * Queue a new command (new sequence number); returns the sequence
+   */
+  uint8_t send(uint8_t command, uint8_t data1, uint8_t data2 = 0x00) {
+    Pending pending;
+    pending.sequence = nextSequence++;
+    pending.command = command;
+    pending.frame = reference::hexFrame(reference::command(DEVICE_ID, pending.sequence, command, data1, data2));
+    pending.firstSentAt = host::nowMicros();
+    pending.sends = 0;
+    pending.nextAt = pending.firstSentAt;
+    pending.confirmedBy = (command == CMD_LINK_CONFIG) ? CMD_LINK_CONFIG : CMD_ACK;
+    queue.push_back(pending);
+    poll();
+    return pending.sequence;
+  }
+
+  /**
+   * Commands still being sent (MODE_BLIND) or waiting for their ACK
+   */
+  bool busy() const {
+    return !queue.empty();
+  }
+
+  /**
+   * Replies that have arrived, due sends and retransmits
+   */
+  void poll() {
+    uint64_t now = host::nowMicros();
+    while (!arriving.empty() && arriving.front().at <= now) {
+      receive(arriving.front().value);
+      arriving.pop_front();
+    }
+
+    for (size_t i = 0; i < queue.size();) {
+      Pending& pending = queue[i];
+      if (now < pending.nextAt) {
+        i++;
+        continue;
+      }
+      int limit = (mode == MODE_BLIND) ? BLIND_COPIES : 1 + MAX_RETRIES;
+      if (pending.sends == limit) {
+        if (mode == MODE_ACK) giveUps++;
+        queue.erase(queue.begin() + i);
+        continue;
+      }
+      transmit(pending);
+      pending.nextAt = now + ((mode == MODE_BLIND) ? BLIND_GAP_MICROS : retransmitMicros);
+      i++;
+    }
+  }
+
+  void onHostWrite(HardwareSerial& serial, uint8_t c) override {
+    // The byte is on the wire once the earlier ones have gone
+    uint64_t at = std::max(host::nowMicros(), lineFreeAt) + serial.hostCharMicros();
+    lineFreeAt = at;
+    arriving.push_back({ at, c });
+  }
+
+  /**
+   * Air time of everything sent both ways so far (us)
+   */
+  uint64_t airMicros() const {
+    return (uint64_t)(bytesSent + bytesReceived) * port.hostCharMicros();
+  }
+
+private:
+  struct Pending {
+    uint8_t sequence;
+    uint8_t command;
+    uint8_t confirmedBy;  // CMD_ACK, or the command's own reply
+    reference::Bytes frame;
+    uint64_t firstSentAt;
+    uint64_t nextAt;
+    int sends;
+  };
+
+  struct Arrival {
+    uint64_t at;
+    uint8_t value;
+  };
+
+  HardwareSerial& port;
+  Mode mode;
+  double loss;
+  double corrupt;
+  std::mt19937 rng;
+  uint8_t nextSequence = 0x01;
+  std::deque<Pending> queue;
+  std::deque<Arrival> arriving;
+  uint64_t lineFreeAt = 0;
+  reference::Bytes reply;
+
+  bool chance(double probability) {
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < probability;
+  }
+
+  void transmit(Pending& pending) {
+    if (pending.sends > 0) resends++;
+    pending.sends++;
+    framesSent++;
+    bytesSent += pending.frame.size();
+    if (chance(loss)) return;
+    reference::Bytes frame = pending.frame;
+    if (chance(corrupt)) {
+      uint8_t& digit = frame[1 + rng() % (frame.size() - 2)];
+      digit = (digit == '0') ? '1' : '0';
+    }
+    port.hostTransmit(frame.data(), frame.size());
+  }
+
+  void receive(uint8_t c) {
+    bytesReceived++;
+    if (c == reference::STX) reply.clear();
+    reply.push_back(c);
+    if (c != reference::ETX) return;
+    if (chance(loss)) return;
+    for (const reference::Bytes& body : reference::decodeHexStream(reply)) {
+      handleReply(body);
+    }
+    reply.clear();
+  }
+
+  void handleReply(const reference::Bytes& body) {
+    uint8_t command = body[2];
+    if (command == CMD_NACK) {
+      // The sequence may be wrong: resend the oldest unacked command now
+      nacks++;
+      if (mode == MODE_ACK && !queue.empty()) queue.front().nextAt = host::nowMicros();
+      return;
+    }
+    for (size_t i = 0; i < queue.size(); i++) {
+      const Pending& pending = queue[i];
+      if (pending.sequence != body[1] || pending.confirmedBy != command) continue;
+      if (command == CMD_ACK) {
+        if (body[3] != pending.command) continue;
+        acks++;
+        duplicateAcks += (body[4] == RESULT_DUPLICATE);
+        confirmMicrosTotal += host::nowMicros() - pending.firstSentAt;
+      }
+      queue.erase(queue.begin() + i);
+      return;
+    }
+  }
+};
+
+#endif  // REFERENCE_CLIENT_H
@@ -0,0 +1,183 @@
+#ifndef REFERENCE_FRAMES_H
+#define REFERENCE_FRAMES_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Reference encoder / decoder for the BLE frame formats
+ *
+ * Written from the protocol description (README, app BleService.js), not
+ * from PacketCodec, so it can serve as the oracle for the firmware
+ * decoders: a frame is accepted here or nowhere.
+ *
+ * - Hex:    STX + 2N hex digits (either case) + ETX, N = 7..19
+ * - Binary: SOH + N body bytes, SOH/STX/ETX/DLE sent as DLE, b ^ 0x20 + ETX
+ * - Body:   DeviceID, Sequence, Command, data..., checksum over the rest
+ *           (sum with end-around carry, ~sum + 0x10)
+ */
+namespace reference {
+
+static const uint8_t SOH = 0x01;
+static const uint8_t STX = 0x02;
+static const uint8_t ETX = 0x03;
+static const uint8_t DLE = 0x10;
+static const size_t MIN_BODY = 7;
+static const size_t MAX_BODY = 19;
+
+typedef std::vector<uint8_t> Bytes;
+
+inline uint8_t checksum(const uint8_t* data, size_t len) {
+  unsigned sum = 0;
+  for (size_t i = 0; i < len; i++) {
+    sum += data[i];
+  }
+  while (sum >> 8) {
+    sum = (sum & 0xFF) + (sum >> 8);
+  }
+  return (uint8_t)((~sum) + 0x10);
+}
+
+/**
+ * Body with its checksum appended
+ */
+inline Bytes body(std::initializer_list<uint8_t> fields) {
+  Bytes b(fields);
+  b.push_back(checksum(b.data(), b.size()));
+  return b;
+}
+
+inline Bytes command(uint8_t device, uint8_t sequence, uint8_t cmd, uint8_t data1, uint8_t data2 = 0, uint8_t data3 = 0) {
+  return body({ device, sequence, cmd, data1, data2, data3 });
+}
+
+inline Bytes hexFrame(const Bytes& b, bool lowerCase = false) {
+  const char* digits = lowerCase ? "0123456789abcdef" : "0123456789ABCDEF";
+  Bytes out;
+  out.push_back(STX);
+  for (uint8_t v : b) {
+    out.push_back(digits[v >> 4]);
+    out.push_back(digits[v & 0x0F]);
+  }
+  out.push_back(ETX);
+  return out;
+}
+
+inline bool isMarker(uint8_t v) {
+  return v == SOH || v == STX || v == ETX || v == DLE;
+}
+
+inline Bytes binaryFrame(const Bytes& b) {
+  Bytes out;
+  out.push_back(SOH);
+  for (uint8_t v : b) {
+    if (isMarker(v)) {
+      out.push_back(DLE);
+      out.push_back(v ^ 0x20);
+    } else {
+      out.push_back(v);
+    }
+  }
+  out.push_back(ETX);
+  return out;
+}
+
+inline int hexValue(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+inline bool validBody(const Bytes& b) {
+  return b.size() >= MIN_BODY && b.size() <= MAX_BODY && b.back() == checksum(b.data(), b.size() - 1);
+}
+
+/**
+ * Every body accepted from a byte stream, hex frames only
+ * A frame is the text between an STX and the next ETX with no STX in
+ * between; all of it must be hex digits.
+ */
+inline std::vector<Bytes> decodeHexStream(const Bytes& stream) {
+  std::vector<Bytes> frames;
+  bool inFrame = false;
+  std::string text;
+  for (uint8_t c : stream) {
+    if (c == STX) {
+      inFrame = true;
+      text.clear();
+    } else if (inFrame && c == ETX) {
+      inFrame = false;
+      if (text.size() % 2) continue;
+      Bytes b;
+      bool ok = true;
+      for (size_t i = 0; ok && i < text.size(); i += 2) {
+        int hi = hexValue(text[i]);
+        int lo = hexValue(text[i + 1]);
+        ok = hi >= 0 && lo >= 0;
+        b.push_back((uint8_t)((hi << 4) | (lo & 0x0F)));
+      }
+      if (ok && validBody(b)) frames.push_back(b);
+    } else if (inFrame) {
+      text += (char)c;
+    }
+  }
+  return frames;
+}
+
+/**
+ * Every body accepted from a byte stream, binary frames only
+ * A frame runs from an SOH to the first ETX that is not escaped; an SOH
+ * before that starts over. Raw STX, and escapes of anything but a marker,
+ * void the frame.
+ */
+inline std::vector<Bytes> decodeBinaryStream(const Bytes& stream) {
+  std::vector<Bytes> frames;
+  size_t i = 0;
+  while (i < stream.size()) {
+    if (stream[i] != SOH) {
+      i++;
+      continue;
+    }
+    Bytes b;
+    bool ok = true;
+    size_t j = i + 1;
+    bool closed = false;
+    while (j < stream.size()) {
+      uint8_t c = stream[j];
+      if (c == SOH) break;  // Restart at this SOH
+      if (c == ETX) {
+        closed = true;
+        j++;
+        break;
+      }
+      if (c == DLE) {
+        if (j + 1 >= stream.size()) {
+          j++;
+          break;
+        }
+        uint8_t next = stream[j + 1];
+        if (next == SOH) {
+          j++;
+          break;
+        }
+        uint8_t value = next ^ 0x20;
+        if (!isMarker(value)) ok = false;
+        b.push_back(value);
+        j += 2;
+        continue;
+      }
+      if (c == STX) ok = false;
+      b.push_back(c);
+      j++;
+    }
+    if (closed && ok && validBody(b)) frames.push_back(b);
+    i = j;
+  }
+  return frames;
+}
+
+}  // namespace reference
+
+#endif  // REFERENCE_FRAMES_H
@@ -0,0 +1,137 @@
+#ifndef SIM_HM10_H
+#define SIM_HM10_H
+
+#include <HostArduino.h>
+#include <cstring>
+#include <string>
+
+/**
+ * Simulated HM10 BLE module on the far end of the BLE UART
+ *
+ * Features:
+ * - AT commands without line endings, taken once the line is idle for
+ *   COMMAND_GAP_MICROS: "AT" -> "OK", "AT+BAUDx" -> "OK+Set:x",
+ *   "AT+BAUD?" -> "OK+Get:x"
+ * - The rate set by AT+BAUDx is stored and applied at the next reset
+ * - Bytes sent at another rate than the module's are garbage and ignored
+ * - BREAK pin (PB9) pulled low resets the module: no replies until
+ *   BOOT_MICROS after the pin is released, and any BLE connection is dropped
+ * - While connected, bytes go to the phone instead of the AT parser
+ *
+ * poll() must run between loop() passes (see run()).
+ */
+class SimHm10 : public HostSerialPeer {
+public:
+  static const uint32_t BREAK_PIN = PB9;
+  static const uint64_t COMMAND_GAP_MICROS = 10000;
+  static const uint64_t BOOT_MICROS = 300000;
+
+  unsigned long moduleBaud = 9600;  // Rate the module's UART runs at
+  bool connected = false;           // A phone is connected
+  bool answering = true;            // false: dead module, never replies
+
+  unsigned long resets = 0;
+  unsigned long commands = 0;       // AT commands answered
+  unsigned long forwarded = 0;      // Bytes sent to the phone while connected
+  unsigned long garbled = 0;        // Bytes received at the wrong rate
+  std::string lastCommand;
+
+  explicit SimHm10(HardwareSerial& bleSerial) : port(bleSerial) {
+    port.hostSetPeer(this);
+  }
+  ~SimHm10() override {
+    port.hostSetPeer(nullptr);
+  }
+
+  void onHostWrite(HardwareSerial& serial, uint8_t c) override {
+    if (inReset || host::nowMicros() < bootDoneAt) return;
+    if (serial.hostBaud() != moduleBaud) {
+      garbled++;
+      return;
+    }
+    if (connected) {
+      forwarded++;
+      return;
+    }
+    input.push_back((char)c);
+    lastByteAt = host::nowMicros();
+  }
+
+  /**
+   * BREAK pin and idle-line command handling
+   */
+  void poll() {
+    uint64_t now = host::nowMicros();
+    bool breakLow = (host::pinLevel(BREAK_PIN) == LOW);
+    if (!breakLow) driven = true;  // Floating (low) until the firmware takes the pin
+    if (breakLow && driven && !inReset) {
+      inReset = true;
+      input.clear();
+    } else if (!breakLow && inReset) {
+      inReset = false;
+      resets++;
+      connected = false;
+      moduleBaud = storedBaud;
+      bootDoneAt = now + BOOT_MICROS;
+    }
+    if (!input.empty() && now - lastByteAt >= COMMAND_GAP_MICROS) {
+      handle(input);
+      input.clear();
+    }
+  }
+
+  /**
+   * Run loop() for the given virtual time with the module attached
+   */
+  void run(uint64_t ms) {
+    uint64_t end = host::nowMicros() + ms * 1000ULL;
+    while (host::nowMicros() < end) {
+      loop();
+      host::advanceMicros(500);
+      poll();
+    }
+  }
+
+private:
+  HardwareSerial& port;
+  bool driven = false;
+  bool inReset = false;
+  uint64_t bootDoneAt = 0;
+  uint64_t lastByteAt = 0;
+  unsigned long storedBaud = 9600;
+  std::string input;
+
+  static unsigned long codeToBaud(char code) {
+    static const unsigned long RATES[] = { 9600, 19200, 38400, 57600, 115200 };
+    return (code >= '0' && code <= '4') ? RATES[code - '0'] : 0;
+  }
+
+  static char baudToCode(unsigned long baud) {
+    for (char code = '0'; code <= '4'; code++) {
+      if (codeToBaud(code) == baud) return code;
+    }
+    return '?';
+  }
+
+  void reply(const std::string& text) {
+    port.hostTransmit((const uint8_t*)text.data(), text.size());
+  }
+
+  void handle(const std::string& command) {
+    lastCommand = command;
+    if (!answering) return;
+    if (command == "AT") {
+      reply("OK");
+    } else if (command == "AT+BAUD?") {
+      reply(std::string("OK+Get:") + baudToCode(moduleBaud));
+    } else if (command.size() == 8 && command.compare(0, 7, "AT+BAUD") == 0 && codeToBaud(command[7])) {
+      storedBaud = codeToBaud(command[7]);
+      reply("OK+Set:" + command.substr(7));
+    } else {
+      return;
+    }
+    commands++;
+  }
+};
+
+#endif  // SIM_HM10_H
@@ -0,0 +1,92 @@
+/**
+ * CMD_BATCH is all or nothing: a tuple its handler would refuse (bad data,
+ * program start before GO HOME, intensity outside COMPRESSION / PERCUSSION /
+ * COMBINED) refuses the whole frame and the chair state does not change;
+ * the ACK carries the reason. INTENSITY_LEVEL follows the same rule alone.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+#include "SequenceController.h"
+
+namespace {
+
+typedef CommunicationManager CM;
+
+uint8_t sequence = 0x40;
+
+/**
+ * Send a frame body and return the result of its ACK (-1 if none)
+ */
+int sendForAck(const reference::Bytes& body) {
+  mySerial2.hostTakeOutput();
+  reference::Bytes frame = reference::hexFrame(body);
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  host_test::runFor(200);
+  int result = -1;
+  for (const reference::Bytes& reply : reference::decodeHexStream(mySerial2.hostTakeOutput())) {
+    if (reply[2] == CM::CMD_ACK && reply[3] == body[2]) result = reply[4];
+  }
+  return result;
+}
+
+int sendBatch(std::initializer_list<uint8_t> tuples) {
+  reference::Bytes fields = { 0x70, sequence++, CM::CMD_BATCH };
+  fields.insert(fields.end(), tuples.begin(), tuples.end());
+  fields.push_back(reference::checksum(fields.data(), fields.size()));
+  return sendForAck(fields);
+}
+
+}  // namespace
+
+int main() {
+  // Roller between the limits: GO HOME is still searching for the UP limit
+  // when the BLE UART comes up (9600 fallback: no module answers the target
+  // check or the probes)
+  host_test::boot();
+  host::setInput(PB4, LOW);  // LMT_UP_PIN
+  host::setInput(PB3, LOW);  // LMT_DOWN_PIN
+  host_test::runFor(5000);
+  SequenceController* seq = massageController->getSequenceController();
+  CHECK_EQ(sendForAck(reference::command(0x70, sequence++, CM::CMD_LINK_CONFIG, CM::LINK_OPT_ACK, 0x01)), -1);
+
+  // Not homed: KNEADING ON is refused, so ROLL OFF is not applied either
+  CHECK(!seq->getHomeRun());
+  CHECK_EQ(sendBatch({ CM::CMD_ROLL_MOTOR, CM::DATA_OFF, CM::CMD_KNEADING, CM::DATA_ON }), CM::RESULT_REJECTED);
+  CHECK(!seq->getRollMotorUserDisabled());
+  CHECK(!seq->getKneadingMode());
+
+  // The same rule for plain frames: checkCommand() refuses every program start
+  const uint8_t programs[] = { CM::CMD_AUTO, CM::CMD_KNEADING, CM::CMD_PERCUSSION, CM::CMD_COMPRESSION, CM::CMD_COMBINE };
+  for (uint8_t program : programs) {
+    CHECK_EQ(sendForAck(reference::command(0x70, sequence++, program, CM::DATA_ON)), CM::RESULT_REJECTED);
+  }
+  CHECK(!seq->isAutoModeActive());
+
+  // Bad data in the last tuple
+  CHECK_EQ(sendBatch({ CM::CMD_ROLL_MOTOR, CM::DATA_OFF, CM::CMD_KNEADING, 0x55 }), CM::RESULT_INVALID);
+  CHECK(!seq->getRollMotorUserDisabled());
+
+  // Homed: a preset applies completely
+  host::setInput(PB4, HIGH);
+  host_test::runFor(4000);
+  CHECK(seq->getHomeRun());
+  CHECK_EQ(sendBatch({ CM::CMD_KNEADING, CM::DATA_ON, CM::CMD_ROLL_MOTOR, CM::DATA_OFF }), CM::RESULT_OK);
+  CHECK(seq->getRollMotorUserDisabled());
+  CHECK(seq->getKneadingMode());
+  CHECK(seq->getModeAuto());
+
+  // KNEADING runs at full intensity
+  CHECK_EQ(sendForAck(reference::command(0x70, sequence++, CM::CMD_INTENSITY_LEVEL, CM::INTENSITY_HIGH)), CM::RESULT_REJECTED);
+  // Intensity before the program that allows it
+  CHECK_EQ(sendBatch({ CM::CMD_INTENSITY_LEVEL, 0xC8, CM::CMD_COMPRESSION, CM::DATA_ON }), CM::RESULT_REJECTED);
+  CHECK(seq->getKneadingMode());
+  // A preset switching to COMPRESSION may set the intensity before the switch runs
+  CHECK_EQ(sendBatch({ CM::CMD_COMPRESSION, CM::DATA_ON, CM::CMD_INTENSITY_LEVEL, 0xC8 }), CM::RESULT_OK);
+  CHECK_EQ(seq->getIntensityLevel(), 0xC8);
+  CHECK_EQ(seq->getCurrentAutoProgram(), SequenceController::AUTO_COMPRESSION);
+  CHECK_EQ(sendForAck(reference::command(0x70, sequence++, CM::CMD_INTENSITY_LEVEL, CM::INTENSITY_HIGH)), CM::RESULT_OK);
+
+  CHECK_EQ(massageController->getCommunicationManager()->getBatchRejects(), 3);
+  return host_test::result();
+}
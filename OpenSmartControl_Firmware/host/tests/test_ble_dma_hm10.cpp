@@ -0,0 +1,90 @@
+/**
+ * BLE_UART_DMA_RX=1 with module resets (simulated HM10 and UART DMA)
+ * DMA reception owns USART2 RX, so it must be stopped before Hm10Manager
+ * resets the module or exchanges AT commands, and restarted once the UART
+ * carries frames again.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "SimHm10.h"
+#include "MassageController.h"
+#include "BleDmaReceiver.h"
+#include "Hm10Manager.h"
+
+namespace {
+
+typedef CommunicationManager CM;
+
+uint8_t sequence = 0x10;
+
+bool runUntilReady(SimHm10& module, Hm10Manager* hm10, uint64_t limitMs) {
+  for (uint64_t ms = 0; ms < limitMs; ms += 10) {
+    module.run(10);
+    if (hm10->getState() == Hm10Manager::STATE_READY) return true;
+  }
+  return false;
+}
+
+// A RELEASE frame from the app reaches the command decoder
+bool frameGetsThrough(SimHm10& module, CM* comm) {
+  unsigned long framesIn = comm->getLinkStats().framesIn;
+  reference::Bytes frame = reference::hexFrame(reference::command(0x70, sequence++, 0x90, 0x00));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  module.run(100);
+  return comm->getLinkStats().framesIn == framesIn + 1;
+}
+
+}  // namespace
+
+int main() {
+  SimHm10 module(mySerial2);
+  host_test::boot();
+  host::setInput(PB4, HIGH);  // LMT_UP_PIN
+  host::setInput(PB3, LOW);   // LMT_DOWN_PIN
+  CM* comm = massageController->getCommunicationManager();
+  Hm10Manager* hm10 = comm->getHm10Manager();
+
+  // Negotiation runs on the HardwareSerial path, DMA takes over afterwards
+  CHECK(runUntilReady(module, hm10, 6000));
+  CHECK_EQ(hm10->getBaud(), 115200);
+  module.run(3000);  // GO HOME done
+  BleDmaReceiver* dma = comm->getBleDmaReceiver();
+  CHECK(dma != nullptr);
+  if (!dma) return host_test::result();
+  CHECK(dma->isActive());
+  unsigned long found = dma->getFramesFound();
+  CHECK(frameGetsThrough(module, comm));
+  CHECK_EQ(dma->getFramesFound(), found + 1);
+
+  // Module reset: DMA stops at once, the ready check reads "OK" through
+  // HardwareSerial, then DMA restarts
+  unsigned long commands = module.commands;
+  comm->resetHM10();
+  CHECK(!dma->isActive());
+  CHECK(runUntilReady(module, hm10, 3000));
+  CHECK(!hm10->isRecovering());
+  CHECK_EQ(module.commands, commands + 1);
+  module.run(20);
+  CHECK(dma->isActive());
+  CHECK(frameGetsThrough(module, comm));
+
+  // Module silent after a reset: recovery backoff keeps the HardwareSerial
+  // path (the next reset is pending); a frame ends the recovery and DMA
+  // comes back
+  module.answering = false;
+  comm->resetHM10();
+  for (int i = 0; i < 300 && hm10->getState() != Hm10Manager::STATE_BACKOFF; i++) {
+    module.run(10);
+  }
+  CHECK_EQ(hm10->getState(), Hm10Manager::STATE_BACKOFF);
+  CHECK(hm10->isRecovering());
+  CHECK(!dma->isActive());
+  CHECK(frameGetsThrough(module, comm));
+  CHECK_EQ(hm10->getState(), Hm10Manager::STATE_READY);
+  module.run(20);
+  CHECK(dma->isActive());
+  CHECK(frameGetsThrough(module, comm));
+
+  CHECK_EQ(mySerial2.hostRxOverruns(), 0);
+  return host_test::result();
+}
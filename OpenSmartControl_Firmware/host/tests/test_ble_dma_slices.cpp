@@ -0,0 +1,149 @@
+/**
+ * BleDmaReceiver slice / ring logic, with the test as the DMA producer
+ * (bytes written to getBuffer(), positions published via onReceiveEvent()
+ * like the HAL half / full / IDLE events)
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "BleDmaReceiver.h"
+#include <string>
+
+namespace {
+
+const uint16_t SIZE = BleDmaReceiver::DMA_BUFFER_SIZE;
+
+/**
+ * Circular DMA writer
+ */
+struct Producer {
+  BleDmaReceiver& rx;
+  uint16_t pos = 0;
+
+  explicit Producer(BleDmaReceiver& receiver) : rx(receiver) {}
+
+  // Write bytes and raise an IDLE event (plus a full-transfer event at the wrap)
+  void send(const reference::Bytes& bytes) {
+    for (uint8_t b : bytes) {
+      rx.getBuffer()[pos++] = b;
+      if (pos == SIZE) {
+        rx.onReceiveEvent(SIZE);
+        pos = 0;
+      }
+    }
+    rx.onReceiveEvent(pos);
+  }
+};
+
+reference::Bytes sliceBytes(const BleRxSlice& slice) {
+  reference::Bytes out(slice.first, slice.first + slice.firstLen);
+  if (slice.second) out.insert(out.end(), slice.second, slice.second + slice.secondLen);
+  return out;
+}
+
+reference::Bytes frame(uint8_t sequence) {
+  return reference::hexFrame(reference::command(0x70, sequence, 0x90, 0x00));
+}
+
+}  // namespace
+
+int main() {
+  BleDmaReceiver rx(nullptr);
+  Producer dma(rx);
+  BleRxSlice slice;
+
+  // One frame, noise before it dropped
+  CHECK(!rx.nextFrame(slice));
+  dma.send({ 'x', 'y' });
+  reference::Bytes f1 = frame(1);
+  dma.send(f1);
+  CHECK(rx.nextFrame(slice));
+  CHECK(sliceBytes(slice) == f1);
+  CHECK(slice.second == nullptr);
+  CHECK_EQ(rx.getPendingBytes(), f1.size());
+  rx.release(slice);
+  CHECK_EQ(rx.getPendingBytes(), 0);
+  CHECK_EQ(rx.getDroppedBytes(), 2);
+  CHECK(!rx.nextFrame(slice));
+
+  // Frame still arriving: nothing until its ETX, then the whole span
+  reference::Bytes f2 = frame(2);
+  dma.send(reference::Bytes(f2.begin(), f2.begin() + 5));
+  CHECK(!rx.nextFrame(slice));
+  dma.send(reference::Bytes(f2.begin() + 5, f2.end()));
+  CHECK(rx.nextFrame(slice));
+  CHECK(sliceBytes(slice) == f2);
+  rx.release(slice);
+
+  // Two frames in one event, the second wrapping the buffer end
+  while (dma.pos < SIZE - 30) dma.send({ 0x00 });
+  rx.nextFrame(slice);  // Skips the filler
+  reference::Bytes f3 = frame(3);
+  reference::Bytes f4 = frame(4);
+  reference::Bytes both = f3;
+  both.insert(both.end(), f4.begin(), f4.end());
+  dma.send(both);
+  CHECK(rx.nextFrame(slice));
+  CHECK(sliceBytes(slice) == f3);
+  rx.release(slice);
+  CHECK(rx.nextFrame(slice));
+  CHECK(sliceBytes(slice) == f4);
+  CHECK(slice.second != nullptr);
+  CHECK_EQ(slice.length(), f4.size());
+  rx.release(slice);
+
+  // Binary frames (SOH) are handed out the same way
+  reference::Bytes b5 = reference::binaryFrame(reference::command(0x70, 5, 0x90, 0x00));
+  dma.send(b5);
+  CHECK(rx.nextFrame(slice));
+  CHECK(sliceBytes(slice) == b5);
+  rx.release(slice);
+
+  // A new start inside a span drops the unfinished frame
+  unsigned long dropped = rx.getDroppedBytes();
+  reference::Bytes f6 = frame(6);
+  reference::Bytes restarted(f6.begin(), f6.begin() + 6);
+  restarted.insert(restarted.end(), f6.begin(), f6.end());
+  dma.send(restarted);
+  CHECK(rx.nextFrame(slice));
+  CHECK(sliceBytes(slice) == f6);
+  rx.release(slice);
+  CHECK_EQ(rx.getDroppedBytes() - dropped, 6);
+
+  // Span longer than MAX_FRAME_SIZE without ETX is dropped
+  reference::Bytes longSpan(1, BleDmaReceiver::STX);
+  longSpan.resize(BleDmaReceiver::MAX_FRAME_SIZE + 10, 'A');
+  dma.send(longSpan);
+  reference::Bytes f7 = frame(7);
+  dma.send(f7);
+  CHECK(rx.nextFrame(slice));
+  CHECK(sliceBytes(slice) == f7);
+  rx.release(slice);
+
+  // Consumer lapped: counted as a ring overrun, reception resumes after it
+  unsigned long frames = rx.getFramesFound();
+  reference::Bytes flood;
+  for (uint8_t i = 0; flood.size() <= SIZE; i++) {
+    reference::Bytes f = frame(i);
+    flood.insert(flood.end(), f.begin(), f.end());
+  }
+  dma.send(flood);
+  CHECK(!rx.nextFrame(slice));
+  CHECK_EQ(rx.getRingOverruns(), 1);
+  CHECK_EQ(rx.getFramesFound(), frames);
+  reference::Bytes f8 = frame(8);
+  dma.send(f8);
+  CHECK(rx.nextFrame(slice));
+  CHECK(sliceBytes(slice) == f8);
+  rx.release(slice);
+
+  // reset() drops what was received
+  dma.send(frame(9));
+  rx.reset();
+  CHECK_EQ(rx.getPendingBytes(), 0);
+  CHECK(!rx.nextFrame(slice));
+
+  rx.resetStatistics();
+  CHECK_EQ(rx.getRingOverruns(), 0);
+  CHECK_EQ(rx.getDroppedBytes(), 0);
+  return host_test::result();
+}
@@ -0,0 +1,71 @@
+/**
+ * Back-to-back frames at the 9600-baud line rate are never dropped
+ *
+ * The app's frames arrive without gaps while loop() passes take anywhere
+ * from 1 to 60 ms (a busy auto program). Each pass drains the whole UART
+ * buffer, so the 64-byte hardware buffer (~67 ms at 9600 baud) never
+ * overflows. Passes longer than that do lose bytes, which the test also
+ * shows so the check above cannot pass vacuously.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+
+namespace {
+
+typedef CommunicationManager CM;
+
+const int FRAMES = 200;
+
+reference::Bytes releaseFrames(int count) {
+  reference::Bytes stream;
+  for (int i = 0; i < count; i++) {
+    // RELEASE of a manual motion: no state change whatever the order
+    reference::Bytes frame = reference::hexFrame(reference::command(0x70, (uint8_t)i, 0x90, 0x00));
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  }
+  return stream;
+}
+
+/**
+ * Send the stream at line rate, one loop() pass every periodMs() ms
+ */
+template <typename Period>
+void receive(const reference::Bytes& stream, Period periodMs) {
+  mySerial2.hostTransmit(stream.data(), stream.size());
+  uint64_t idle = mySerial2.hostLineIdleAt();
+  while (host::nowMicros() <= idle + 100000) {
+    loop();
+    host::advanceMicros(periodMs() * 1000ULL);
+  }
+}
+
+}  // namespace
+
+int main() {
+  host_test::bootToReady();
+  CHECK_EQ(mySerial2.hostBaud(), 9600);
+  CM* comm = massageController->getCommunicationManager();
+  comm->resetBleRxStats();
+
+  // Loop passes of 1..60 ms
+  unsigned seed = 1;
+  unsigned long framesIn = comm->getLinkStats().framesIn;
+  receive(releaseFrames(FRAMES), [&] {
+    seed = seed * 1103515245 + 12345;
+    return 1 + (seed >> 16) % 60;
+  });
+  CHECK_EQ(comm->getLinkStats().framesIn - framesIn, FRAMES);
+  CHECK_EQ(mySerial2.hostRxOverruns(), 0);
+  CHECK_EQ(comm->getLinkStats().uartOverruns, 0);
+  CHECK(comm->getBleMaxBytesInFlight() <= HardwareSerial::RX_BUFFER_SIZE);
+  printf("1..60 ms passes: %d frames, max %u bytes in flight\n", FRAMES, comm->getBleMaxBytesInFlight());
+
+  // 80 ms passes exceed the UART buffer: bytes and frames are lost
+  framesIn = comm->getLinkStats().framesIn;
+  receive(releaseFrames(FRAMES), [] { return 80; });
+  CHECK(comm->getLinkStats().framesIn - framesIn < FRAMES);
+  CHECK(mySerial2.hostRxOverruns() > 0);
+
+  return host_test::result();
+}
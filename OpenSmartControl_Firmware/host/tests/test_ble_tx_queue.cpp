@@ -0,0 +1,166 @@
+/**
+ * BleTxQueue against a UART with a small TX buffer
+ *
+ * The Print stub takes only a few bytes per pump(), as the F103's TX ring
+ * does at 9600 baud. Control frames go out before bulk ones, a frame once
+ * started is finished before any other (even a control frame queued
+ * meanwhile), and frames refused by a full lane are counted on that lane.
+ */
+#include "HostTest.h"
+#include "BleTxQueue.h"
+#include <vector>
+
+namespace {
+
+typedef BleTxQueue Q;
+
+/**
+ * UART whose TX buffer has room for `room` bytes until drain() is called
+ */
+class SmallUart : public Print {
+public:
+  std::vector<uint8_t> sent;
+  int room = 0;
+  int capacity;
+
+  explicit SmallUart(int txBuffer) : capacity(txBuffer) {}
+
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    CHECK((int)size <= room);  // pump() never writes more than it was offered
+    sent.insert(sent.end(), buffer, buffer + size);
+    room -= (int)size;
+    return size;
+  }
+  int availableForWrite() override {
+    return room;
+  }
+
+  // The TX interrupt emptied the buffer
+  void drain() {
+    room = capacity;
+  }
+};
+
+const uint8_t FRAME_LENGTH = 18;  // Hex frame of a 7-byte body
+
+// Every byte of frame `id` is `id`, so the output shows which frame it came from
+void enqueue(Q& queue, Q::Lane lane, uint8_t id, bool expected = true) {
+  uint8_t frame[FRAME_LENGTH];
+  memset(frame, id, sizeof(frame));
+  CHECK_EQ(queue.enqueue(lane, frame, sizeof(frame)), expected);
+}
+
+/**
+ * Pump until idle, draining the UART before each pass; returns the passes
+ */
+int pumpAll(Q& queue, SmallUart& uart) {
+  int passes = 0;
+  while (!queue.isIdle() && passes < 1000) {
+    uart.drain();
+    queue.pump();
+    passes++;
+  }
+  return passes;
+}
+
+/**
+ * Frame ids in output order; false if any frame is split by another
+ */
+bool framesInOrder(const std::vector<uint8_t>& sent, std::vector<uint8_t>& ids) {
+  ids.clear();
+  for (size_t i = 0; i < sent.size(); i += FRAME_LENGTH) {
+    if (i + FRAME_LENGTH > sent.size()) return false;
+    for (size_t j = i; j < i + FRAME_LENGTH; j++) {
+      if (sent[j] != sent[i]) return false;
+    }
+    ids.push_back(sent[i]);
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  std::vector<uint8_t> ids;
+
+  // Control before bulk when both are waiting
+  {
+    SmallUart uart(8);
+    Q queue(&uart);
+    enqueue(queue, Q::LANE_BULK, 0xB1);
+    enqueue(queue, Q::LANE_BULK, 0xB2);
+    enqueue(queue, Q::LANE_CONTROL, 0xC1);
+    enqueue(queue, Q::LANE_CONTROL, 0xC2);
+    int passes = pumpAll(queue, uart);
+    CHECK(framesInOrder(uart.sent, ids));
+    CHECK(ids == std::vector<uint8_t>({ 0xC1, 0xC2, 0xB1, 0xB2 }));
+    CHECK_EQ(passes, (4 * FRAME_LENGTH + 7) / 8);
+    CHECK_EQ(queue.getFramesSent(), 4);
+  }
+
+  // A started bulk frame finishes before a control frame queued meanwhile
+  {
+    SmallUart uart(5);
+    Q queue(&uart);
+    enqueue(queue, Q::LANE_BULK, 0xB1);
+    enqueue(queue, Q::LANE_BULK, 0xB2);
+    uart.drain();
+    queue.pump();
+    CHECK_EQ(uart.sent.size(), 5);
+    queue.pump();  // No room: nothing more, nothing lost
+    CHECK_EQ(uart.sent.size(), 5);
+    enqueue(queue, Q::LANE_CONTROL, 0xC1);
+    uart.drain();
+    queue.pump();
+    enqueue(queue, Q::LANE_CONTROL, 0xC2);
+    pumpAll(queue, uart);
+    CHECK(framesInOrder(uart.sent, ids));
+    CHECK(ids == std::vector<uint8_t>({ 0xB1, 0xC1, 0xC2, 0xB2 }));
+  }
+
+  // Full lanes refuse and count per lane; the other lane is unaffected
+  {
+    SmallUart uart(8);
+    Q queue(&uart);
+    for (uint8_t i = 0; i < Q::CONTROL_FRAMES; i++) {
+      enqueue(queue, Q::LANE_CONTROL, 0xC0 + i);
+    }
+    enqueue(queue, Q::LANE_CONTROL, 0xCF, false);
+    for (uint8_t i = 0; i < Q::BULK_FRAMES; i++) {
+      enqueue(queue, Q::LANE_BULK, 0xB0 + i);
+    }
+    enqueue(queue, Q::LANE_BULK, 0xBE, false);
+    enqueue(queue, Q::LANE_BULK, 0xBF, false);
+    CHECK_EQ(queue.getDrops(Q::LANE_CONTROL), 1);
+    CHECK_EQ(queue.getDrops(Q::LANE_BULK), 2);
+    CHECK_EQ(queue.getHighWater(Q::LANE_CONTROL), Q::CONTROL_FRAMES);
+    CHECK_EQ(queue.getHighWater(Q::LANE_BULK), Q::BULK_FRAMES);
+
+    // Taking one frame frees a slot for the next
+    uart.drain();
+    queue.pump();
+    enqueue(queue, Q::LANE_CONTROL, 0xC8);
+    pumpAll(queue, uart);
+    CHECK(framesInOrder(uart.sent, ids));
+    CHECK_EQ(ids.size(), Q::CONTROL_FRAMES + 1 + Q::BULK_FRAMES);
+    CHECK_EQ(ids[Q::CONTROL_FRAMES], 0xC8);
+    CHECK_EQ(ids.back(), 0xB0 + Q::BULK_FRAMES - 1);
+    CHECK_EQ(queue.getDrops(Q::LANE_CONTROL), 1);
+    CHECK_EQ(queue.getDrops(Q::LANE_BULK), 2);
+  }
+
+  // A UART that reports no room (core default) gets nothing
+  {
+    SmallUart uart(0);
+    Q queue(&uart);
+    enqueue(queue, Q::LANE_CONTROL, 0xC1);
+    queue.pump();
+    CHECK(uart.sent.empty());
+    CHECK(!queue.isIdle());
+  }
+
+  return host_test::result();
+}
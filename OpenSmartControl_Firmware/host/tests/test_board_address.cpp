@@ -0,0 +1,152 @@
+/**
+ * Board address: set over the link, kept across a reboot
+ *
+ * First run: CMD_ADDRESS_CONFIG moves the unit from 0x70 to 0x31 and joins
+ * group 3; reserved units and groups are refused and change nothing. The
+ * emulated EEPROM is then written to WORK_DIR and the test runs itself
+ * again as the rebooted board: frames to 0x31, 0xE3 and 0xFF act, frames to
+ * 0x70, 0x32 and 0xE4 are ignored, and ACKs carry 0x31.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+typedef CommunicationManager CM;
+
+const uint8_t NEW_UNIT = 0x31;
+const uint8_t GROUP = 3;
+const char* REBOOTED = "--rebooted";
+
+uint8_t sequence = 0x10;
+
+std::string eepromPath() {
+  return std::string(WORK_DIR) + "/board_address_eeprom.bin";
+}
+
+void send(uint8_t address, uint8_t cmd, uint8_t data1, uint8_t data2 = 0) {
+  reference::Bytes frame = reference::hexFrame(reference::command(address, sequence++, cmd, data1, data2));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  host_test::runFor(100);
+}
+
+/**
+ * Send an ADDRESS_CONFIG and return its reply body (empty if none)
+ */
+reference::Bytes configure(uint8_t address, uint8_t option, uint8_t value) {
+  mySerial2.hostTakeOutput();
+  send(address, CM::CMD_ADDRESS_CONFIG, option, value);
+  for (const reference::Bytes& reply : reference::decodeHexStream(mySerial2.hostTakeOutput())) {
+    if (reply[2] == CM::CMD_ADDRESS_CONFIG) return reply;
+  }
+  return reference::Bytes();
+}
+
+bool rl1Running() {
+  return host::pinLevel(RL1_PWM_PIN) != LOW;
+}
+
+void firstBoot(const char* self) {
+  host_test::bootToReady();
+
+  reference::Bytes reply = configure(BoardAddress::DEFAULT_UNIT, CM::ADDR_OPT_UNIT, NEW_UNIT);
+  if (CHECK_EQ(reply.size(), reference::MIN_BODY)) {
+    CHECK_EQ(reply[0], NEW_UNIT);
+    CHECK_EQ(reply[3], NEW_UNIT);
+  }
+  reply = configure(NEW_UNIT, CM::ADDR_OPT_GROUP_JOIN, GROUP);
+  if (CHECK_EQ(reply.size(), reference::MIN_BODY)) {
+    CHECK_EQ(reply[0], NEW_UNIT);
+    CHECK_EQ(reply[4] | (reply[5] << 8), 1 << GROUP);
+  }
+
+  // Reserved units (0x00, groups, 0xF0..0xFF) and group 16 are refused
+  const uint8_t reservedUnits[] = { 0x00, 0xE0, 0xEF, 0xF0, 0xFE, BoardAddress::BROADCAST };
+  for (uint8_t unit : reservedUnits) {
+    reply = configure(NEW_UNIT, CM::ADDR_OPT_UNIT, unit);
+    if (CHECK_EQ(reply.size(), reference::MIN_BODY)) CHECK_EQ(reply[3], NEW_UNIT);
+  }
+  reply = configure(NEW_UNIT, CM::ADDR_OPT_GROUP_JOIN, BoardAddress::GROUP_COUNT);
+  if (CHECK_EQ(reply.size(), reference::MIN_BODY)) CHECK_EQ(reply[4] | (reply[5] << 8), 1 << GROUP);
+
+  // Address settings only go to one board: group and broadcast are ignored
+  CHECK(configure(BoardAddress::GROUP_BASE + GROUP, CM::ADDR_OPT_UNIT, 0x40).empty());
+  CHECK(configure(BoardAddress::BROADCAST, CM::ADDR_OPT_UNIT, 0x40).empty());
+
+  // Power off: keep the emulated EEPROM for the next run
+  FILE* file = fopen(eepromPath().c_str(), "wb");
+  if (!CHECK(file != nullptr)) return;
+  CHECK_EQ(fwrite(host::eeprom(), 1, host::eepromSize(), file), host::eepromSize());
+  fclose(file);
+  fflush(stdout);
+  execl(self, self, REBOOTED, (char*)nullptr);
+  CHECK(false);  // exec failed
+}
+
+/**
+ * Does a RECLINE PUSH to this address start RL1? (the RELEASE goes to the unit)
+ * ACK replies are collected in acks.
+ */
+bool acts(uint8_t address, std::vector<reference::Bytes>& acks) {
+  send(address, CM::CMD_RECLINE, CM::DATA_ON);
+  bool running = rl1Running();
+  send(NEW_UNIT, CM::CMD_RECLINE, CM::DATA_OFF);
+  CHECK(!rl1Running());
+  for (const reference::Bytes& reply : reference::decodeHexStream(mySerial2.hostTakeOutput())) {
+    if (reply[2] == CM::CMD_ACK) acks.push_back(reply);
+  }
+  return running;
+}
+
+void secondBoot() {
+  // Same as bootToReady(), with the EEPROM from the first run
+  host::reset();
+  FILE* file = fopen(eepromPath().c_str(), "rb");
+  if (!CHECK(file != nullptr)) return;
+  CHECK_EQ(fread(host::eeprom(), 1, host::eepromSize(), file), host::eepromSize());
+  fclose(file);
+  setup();
+  host::setInput(PB4, HIGH);  // LMT_UP_PIN
+  host::setInput(PB3, LOW);   // LMT_DOWN_PIN
+  host_test::runFor(6000);
+
+  CM* comm = massageController->getCommunicationManager();
+  std::vector<uint8_t> log = mySerial.hostTakeOutput();
+  CHECK(std::string(log.begin(), log.end()).find("ADDR: unit 0x31, groups 0x8") != std::string::npos);
+
+  // ACKs on: only frames sent to the unit are answered, from the new unit
+  send(NEW_UNIT, CM::CMD_LINK_CONFIG, CM::LINK_OPT_ACK, 0x01);
+  mySerial2.hostTakeOutput();
+  std::vector<reference::Bytes> acks;
+  CHECK(acts(NEW_UNIT, acks));
+  CHECK(acts(BoardAddress::GROUP_BASE + GROUP, acks));
+  CHECK(acts(BoardAddress::BROADCAST, acks));
+  unsigned long mismatches = comm->getLinkStats().addressMismatches;
+  CHECK(!acts(BoardAddress::DEFAULT_UNIT, acks));
+  CHECK(!acts(NEW_UNIT + 1, acks));
+  CHECK(!acts(BoardAddress::GROUP_BASE + GROUP + 1, acks));
+  CHECK_EQ(comm->getLinkStats().addressMismatches, mismatches + 3);
+
+  // One per RELEASE plus the PUSH to the unit
+  CHECK_EQ(acks.size(), 7);
+  for (const reference::Bytes& ack : acks) {
+    CHECK_EQ(ack[0], NEW_UNIT);
+    CHECK_EQ(ack[3], CM::CMD_RECLINE);
+    CHECK_EQ(ack[4], CM::RESULT_OK);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc > 1 && strcmp(argv[1], REBOOTED) == 0) {
+    secondBoot();
+  } else {
+    firstBoot("/proc/self/exe");
+  }
+  return host_test::result();
+}
@@ -0,0 +1,95 @@
+/**
+ * RingBuffer SPSC stress test with real threads
+ *
+ * A producer thread (the ingest / ISR side) pushes decoded CommandRecords
+ * into a queue of the firmware's type and size while the main thread (the
+ * loop side) pops them. Every record must arrive once, in order and
+ * intact, and the high-water mark must stay within the capacity. The byte
+ * ring the UART drain uses gets the same treatment.
+ */
+#include "HostTest.h"
+#include "CommunicationManager.h"
+#include "RingBuffer.h"
+#include <thread>
+
+namespace {
+
+const unsigned long RECORDS = 500000;
+
+CommandRecord makeRecord(unsigned long n) {
+  CommandRecord record;
+  memset(&record, 0, sizeof(record));
+  record.frame.length = PacketCodec::BODY_SIZE + (n % 3);
+  for (uint8_t i = 0; i < record.frame.length; i++) {
+    record.frame.body[i] = (uint8_t)(n * 31 + i);
+  }
+  record.rxTick = n;
+  return record;
+}
+
+bool sameRecord(const CommandRecord& a, const CommandRecord& b) {
+  return a.rxTick == b.rxTick && a.frame.length == b.frame.length &&
+         memcmp(a.frame.body, b.frame.body, a.frame.length) == 0;
+}
+
+}  // namespace
+
+int main() {
+  static RingBuffer<CommandRecord, CommunicationManager::COMMAND_QUEUE_SIZE> queue;
+  std::thread producer([] {
+    for (unsigned long n = 0; n < RECORDS;) {
+      if (queue.push(makeRecord(n))) {
+        n++;
+      } else {
+        std::this_thread::yield();  // Full: the firmware drops and NACKs here
+      }
+    }
+  });
+
+  unsigned long received = 0;
+  unsigned long bad = 0;
+  while (received < RECORDS) {
+    CommandRecord record;
+    if (!queue.pop(record)) {
+      std::this_thread::yield();
+      continue;
+    }
+    bad += !sameRecord(record, makeRecord(received));
+    received++;
+  }
+  producer.join();
+
+  CHECK_EQ(bad, 0);
+  CHECK(queue.isEmpty());
+  CHECK(queue.getHighWater() > 0);
+  CHECK(queue.getHighWater() <= queue.capacity());
+  printf("%lu records, high water %u of %u\n", received, queue.getHighWater(), queue.capacity());
+
+  // Byte ring with 16-bit index wrap-around many times over
+  static RingBuffer<byte, CommunicationManager::BLE_RX_RING_SIZE> bytes;
+  const unsigned long BYTES = 1000000;
+  std::thread writer([&] {
+    for (unsigned long n = 0; n < BYTES;) {
+      if (bytes.push((byte)(n * 7))) {
+        n++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  unsigned long mismatches = 0;
+  for (unsigned long n = 0; n < BYTES;) {
+    byte b;
+    if (bytes.pop(b)) {
+      mismatches += (b != (byte)(n * 7));
+      n++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  writer.join();
+  CHECK_EQ(mismatches, 0);
+  CHECK(bytes.getHighWater() <= bytes.capacity());
+
+  return host_test::result();
+}
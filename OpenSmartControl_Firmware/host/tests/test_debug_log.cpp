@@ -0,0 +1,89 @@
+/**
+ * DebugLog keeps or drops channel lines whole: a line printed in several
+ * write() calls (print(), print(value), println()) never reaches the UART
+ * cut short, and the drop marker counts lines.
+ */
+#include "HostTest.h"
+#include "DebugLog.h"
+#include <string>
+
+namespace {
+
+// Complete lines sent on the UART so far ("\r\n" stripped)
+std::vector<std::string> takeLines(HardwareSerial& port) {
+  std::vector<uint8_t> out = port.hostTakeOutput();
+  std::vector<std::string> lines;
+  std::string text(out.begin(), out.end());
+  size_t start = 0;
+  for (size_t end; (end = text.find("\r\n", start)) != std::string::npos; start = end + 2) {
+    lines.push_back(text.substr(start, end - start));
+  }
+  CHECK_EQ(start, text.size());  // No partial line left over
+  return lines;
+}
+
+void drainAll(DebugLog& log, HardwareSerial& port) {
+  while (log.getPendingBytes() > 0) {
+    log.drain();
+    host::advanceMicros(port.hostCharMicros());
+  }
+  for (int i = 0; i < 1000; i++) {
+    log.drain();  // Drop marker, once the buffer is empty
+    host::advanceMicros(port.hostCharMicros());
+  }
+}
+
+}  // namespace
+
+int main() {
+  host::reset();
+  mySerial.begin(9600);
+  DebugLog log(&mySerial);
+  Print* out = log.getChannel(DebugLog::MODULE_MOTOR);
+
+  // Far more than the buffer holds, nothing drained in between
+  const int LINES = 200;
+  for (int i = 0; i < LINES; i++) {
+    out->print("motor ");
+    out->print(i);
+    out->println(" started");
+  }
+  CHECK(log.getDroppedLines() > 0);
+  unsigned long dropped = log.getDroppedLines();
+  drainAll(log, mySerial);
+
+  std::vector<std::string> lines = takeLines(mySerial);
+  int kept = 0;
+  for (size_t i = 0; i < lines.size(); i++) {
+    if (lines[i].compare(0, 6, "[log: ") == 0) {
+      CHECK(lines[i] == "[log: " + std::to_string(dropped) + " lines dropped]");
+      continue;
+    }
+    CHECK(lines[i] == "motor " + std::to_string(kept) + " started");
+    kept++;
+  }
+  CHECK_EQ(kept + dropped, LINES);
+
+  // A line started before a drain() cannot be taken back: it goes out as
+  // printed so far, and the rest of it is still dropped
+  out->print("partial ");
+  log.drain();
+  while (log.getFreeBytes() > 12) {
+    log.log(DebugLog::MODULE_SYSTEM, DebugLog::LEVEL_INFO, "filler");
+  }
+  out->println("does not fit in the buffer");
+  out->println("next");
+  CHECK(log.getPendingBytes() > 0);
+
+  // Once room is back, lines go through again
+  drainAll(log, mySerial);
+  out->print("after ");
+  out->println(1);
+  drainAll(log, mySerial);
+  std::vector<uint8_t> tail = mySerial.hostTakeOutput();
+  std::string text(tail.begin(), tail.end());
+  CHECK(text.find("does not fit") == std::string::npos);
+  CHECK(text.find("after 1\r\n") != std::string::npos);
+
+  return host_test::result();
+}
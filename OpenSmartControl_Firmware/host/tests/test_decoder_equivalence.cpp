@@ -0,0 +1,133 @@
+/**
+ * HexFrameDecoder against the receive path it replaced (LegacyHexParser)
+ *
+ * 1. Frames made of hex digits (valid, bad checksum, digits changed, wrong
+ *    but even length, noise between frames): both accept exactly the same
+ *    7-byte packets, byte for byte. Longer bodies are extended frames,
+ *    which only the new decoder takes.
+ * 2. Input the old path misread, each pinned down explicitly: the new
+ *    decoder is stricter there (or resynchronises) on purpose.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "LegacyHexParser.h"
+#include "PacketCodec.h"
+#include <random>
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789ABCDEFabcdef";
+
+struct Outcome {
+  bool legacy;
+  bool decoder;
+  uint8_t decoderLength;
+};
+
+/**
+ * Feed the same stream to fresh parsers; every ETX yields one outcome
+ */
+std::vector<Outcome> run(const reference::Bytes& stream, bool* packetsMatch = nullptr) {
+  LegacyHexParser legacy;
+  HexFrameDecoder decoder;
+  std::vector<Outcome> outcomes;
+  if (packetsMatch) *packetsMatch = true;
+  for (uint8_t b : stream) {
+    uint8_t packet[7];
+    bool legacyOk = legacy.feed(b, packet);
+    HexFrameDecoder::Result result = decoder.feed(b);
+    if (b != PacketCodec::ETX) continue;
+    const Frame& frame = decoder.getFrame();
+    bool decoderOk = (result == HexFrameDecoder::FRAME);
+    outcomes.push_back({ legacyOk, decoderOk, decoderOk ? frame.length : (uint8_t)0 });
+    if (packetsMatch && legacyOk && decoderOk && memcmp(packet, frame.body, 7) != 0) {
+      *packetsMatch = false;
+    }
+  }
+  return outcomes;
+}
+
+reference::Bytes randomHexFrame(std::mt19937& rng) {
+  // Mostly 7-byte bodies, some shorter / longer
+  int bytes = (rng() % 4) ? 7 : (int)(rng() % 21);
+  reference::Bytes body;
+  for (int i = 0; i < bytes; i++) body.push_back((uint8_t)rng());
+  if (bytes > 1 && rng() % 3) {
+    body.back() = reference::checksum(body.data(), body.size() - 1);
+  }
+  reference::Bytes frame = reference::hexFrame(body, rng() % 2);
+  // Change a digit to another digit
+  if (frame.size() > 2 && rng() % 4 == 0) {
+    frame[1 + rng() % (frame.size() - 2)] = HEX_DIGITS[rng() % (sizeof(HEX_DIGITS) - 1)];
+  }
+  return frame;
+}
+
+}  // namespace
+
+int main() {
+  // 1. Hex-digit frames, back to back with noise that holds no markers
+  std::mt19937 rng(7);
+  long agreed = 0;
+  long accepted = 0;
+  for (int iteration = 0; iteration < 20000; iteration++) {
+    reference::Bytes stream;
+    int frames = 1 + rng() % 4;
+    for (int f = 0; f < frames; f++) {
+      for (int noise = rng() % 3; noise > 0; noise--) {
+        uint8_t b = (uint8_t)rng();
+        if (b != PacketCodec::STX && b != PacketCodec::ETX) stream.push_back(b);
+      }
+      reference::Bytes frame = randomHexFrame(rng);
+      stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    bool packetsMatch;
+    for (const Outcome& outcome : run(stream, &packetsMatch)) {
+      bool decoderPlain = outcome.decoder && outcome.decoderLength == PacketCodec::BODY_SIZE;
+      if (!CHECK(outcome.legacy == decoderPlain)) return host_test::result();
+      agreed++;
+      accepted += outcome.legacy;
+    }
+    if (!CHECK(packetsMatch)) return host_test::result();
+  }
+  CHECK(accepted > 5000);
+  printf("%ld frames judged alike, %ld accepted by both\n", agreed, accepted);
+
+  // 2. Deliberate differences
+  reference::Bytes valid = reference::hexFrame(reference::command(0x70, 0x01, 0x10, 0xF0));
+  std::vector<Outcome> outcome;
+
+  // Non-hex digit: the old path read it as 0 ('G' in place of '0')
+  reference::Bytes zeroData = reference::hexFrame(reference::command(0x70, 0x01, 0x10, 0x00));
+  reference::Bytes letter = zeroData;
+  letter[8] = 'G';
+  outcome = run(letter);
+  CHECK(outcome[0].legacy && !outcome[0].decoder);
+
+  // Odd digit count: the old path ignored the last digit
+  reference::Bytes odd = valid;
+  odd.insert(odd.end() - 1, '7');
+  outcome = run(odd);
+  CHECK(outcome[0].legacy && !outcome[0].decoder);
+
+  // NUL inside the digits: strlen() cut the string; here both refuse
+  reference::Bytes nul = valid;
+  nul[5] = 0x00;
+  outcome = run(nul);
+  CHECK(!outcome[0].legacy && !outcome[0].decoder);
+
+  // Lost ETX: the old path stored the next STX as text and lost both frames;
+  // the decoder restarts on STX and keeps the second one
+  reference::Bytes lost(valid.begin(), valid.end() - 3);
+  lost.insert(lost.end(), valid.begin(), valid.end());
+  outcome = run(lost);
+  CHECK_EQ(outcome.size(), 1);
+  CHECK(!outcome[0].legacy && outcome[0].decoder);
+
+  // Extended frame (more than 7 bytes): new in the decoder
+  reference::Bytes extended = reference::hexFrame(reference::body({ 0x70, 0x01, 0x60, 1, 2, 3, 4, 5 }));
+  outcome = run(extended);
+  CHECK(!outcome[0].legacy && outcome[0].decoder && outcome[0].decoderLength == 9);
+
+  return host_test::result();
+}
@@ -0,0 +1,631 @@
+/**
+ * BLE firmware update end to end, on the simulated flash
+ *
+ * The release image is the running application. tools/fw_package builds
+ * packages of a changed image (lz, and delta against the release) which
+ * go through the firmware at 9600 baud in extended DATA frames, binary and
+ * hex framed, resent the way the README describes (from the reported next
+ * offset after a gap, BEGIN again after a disconnect). The last transfer is
+ * committed: the firmware writes the boot control record and resets, and
+ * the bootloader's BootInstaller copies the image over the application,
+ * also after power cuts at every stage of the copy.
+ *
+ * A package of back-to-back MAX_COPY matches (1.5 KB of image per chunk)
+ * checks that no loop pass programs more than DECODE_BUDGET bytes, and the
+ * layout constants of fw_package, the updater and the bootloader must agree.
+ *
+ * Prints the end-to-end times (BEGIN -> VERIFIED, and the bootloader copy).
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "BootInstaller.h"
+#include "CommunicationManager.h"
+#include "FirmwareUpdater.h"
+#include "MassageController.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+typedef FirmwareUpdater FU;
+typedef reference::Bytes Bytes;
+
+static_assert(BootFlash::PAGE_SIZE == FlashBank::PAGE_SIZE, "bootloader and updater layouts differ");
+static_assert(BootInstaller::APP_ADDRESS == FU::APP_ADDRESS, "bootloader and updater layouts differ");
+static_assert(BootInstaller::REGION_SIZE == FU::REGION_SIZE, "bootloader and updater layouts differ");
+static_assert(BootInstaller::CONTROL_ADDRESS == FU::CONTROL_ADDRESS, "bootloader and updater layouts differ");
+static_assert(BootInstaller::BOOT_MAGIC == FU::BOOT_MAGIC, "bootloader and updater records differ");
+static_assert(sizeof(BootInstaller::BootControl) == sizeof(FU::BootControl), "bootloader and updater records differ");
+
+const uint8_t DEVICE_ID = 0x70;
+const char* const RELEASE_HEX = "../OpenSmartControl_Release.hex";
+
+// Next release: 96 bytes of new code early on, 24 words changed after it
+const size_t INSERT_AT = 0x4000;
+const size_t INSERT_BYTES = 96;
+const int CHANGED_WORDS = 24;
+
+const uint64_t STALL_MICROS = 1000000;       // No progress: resend from the last reported offset
+const uint64_t DISCONNECT_MICROS = 3000000;  // Link down, then BEGIN again
+const uint64_t SESSION_LIMIT_MICROS = 400000000;
+const uint32_t LONG_COPIES = 48;  // "OSC" then 48 matches of MAX_COPY bytes
+
+struct Package {
+  Bytes bytes;
+  uint32_t crc;  // Stream CRC32 (BEGIN)
+};
+
+struct Status {
+  uint8_t state;
+  uint8_t code;
+  uint32_t next;
+  uint32_t size;
+};
+
+struct Faults {
+  size_t corruptChunk = SIZE_MAX;       // Sent once with a flipped byte (CRC-16 fails)
+  size_t disconnectAtChunk = SIZE_MAX;  // Link lost before this chunk
+};
+
+struct Transfer {
+  bool verified = false;
+  uint8_t state = FU::STATE_IDLE;
+  uint8_t code = FU::CODE_OK;
+  uint64_t eraseMicros = 0;  // BEGIN -> RECEIVING
+  uint64_t totalMicros = 0;  // BEGIN -> VERIFIED
+  unsigned long wireBytes = 0;
+  unsigned long resent = 0;  // Chunks sent more than once
+  uint64_t longestPassMicros = 0;  // Longest loop() while receiving
+};
+
+///////////////////////////////////////////////// FILES /////////////////////////////////////////////////
+bool readHex(const std::string& path, Bytes& image, uint32_t& start) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (!file) return false;
+  char line[600];
+  uint32_t upper = 0;
+  bool first = true;
+  while (fgets(line, sizeof(line), file)) {
+    if (line[0] != ':') continue;
+    Bytes record;
+    for (size_t i = 1; reference::hexValue(line[i]) >= 0 && reference::hexValue(line[i + 1]) >= 0; i += 2) {
+      record.push_back((uint8_t)(reference::hexValue(line[i]) << 4 | reference::hexValue(line[i + 1])));
+    }
+    if (record.size() < 5 || record.size() != 5u + record[0]) break;
+    uint8_t type = record[3];
+    if (type == 0x04) {
+      upper = (uint32_t)(record[4] << 8 | record[5]) << 16;
+    } else if (type == 0x00) {
+      uint32_t address = upper | (record[1] << 8 | record[2]);
+      if (first) start = address;
+      first = false;
+      if (address - start + record[0] > image.size()) image.resize(address - start + record[0], 0xFF);
+      memcpy(&image[address - start], &record[4], record[0]);
+    } else if (type == 0x01) {
+      break;
+    }
+  }
+  fclose(file);
+  return !image.empty();
+}
+
+void hexRecord(FILE* file, const Bytes& record) {
+  uint8_t sum = 0;
+  fputc(':', file);
+  for (uint8_t b : record) {
+    fprintf(file, "%02X", b);
+    sum += b;
+  }
+  fprintf(file, "%02X\n", (uint8_t)-sum);
+}
+
+bool writeHex(const std::string& path, const Bytes& image, uint32_t start) {
+  FILE* file = fopen(path.c_str(), "w");
+  if (!file) return false;
+  uint32_t upper = UINT32_MAX;
+  for (size_t offset = 0; offset < image.size(); offset += 16) {
+    uint32_t address = start + (uint32_t)offset;
+    if (address >> 16 != upper) {
+      upper = address >> 16;
+      hexRecord(file, { 0x02, 0x00, 0x00, 0x04, (uint8_t)(upper >> 8), (uint8_t)upper });
+    }
+    size_t length = std::min<size_t>(16, image.size() - offset);
+    Bytes record = { (uint8_t)length, (uint8_t)(address >> 8), (uint8_t)address, 0x00 };
+    record.insert(record.end(), image.begin() + offset, image.begin() + offset + length);
+    hexRecord(file, record);
+  }
+  hexRecord(file, { 0x00, 0x00, 0x00, 0x01 });
+  return fclose(file) == 0;
+}
+
+Bytes readFile(const std::string& path) {
+  Bytes data;
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) return data;
+  int c;
+  while ((c = fgetc(file)) != EOF) data.push_back((uint8_t)c);
+  fclose(file);
+  return data;
+}
+
+/**
+ * fw_package --layout: the constants it shares with the firmware
+ */
+bool readLayout(std::vector<std::pair<std::string, unsigned long>>& layout) {
+  FILE* pipe = popen((std::string(FW_PACKAGE) + " --layout").c_str(), "r");
+  if (!pipe) return false;
+  char name[32];
+  unsigned long value;
+  while (fscanf(pipe, "%31s %lu", name, &value) == 2) layout.push_back({ name, value });
+  return pclose(pipe) == 0 && !layout.empty();
+}
+
+/**
+ * Package from tools/fw_package, as the release process builds it
+ */
+Package buildPackage(const std::string& name, const std::string& arguments) {
+  std::string path = std::string(WORK_DIR) + "/" + name + ".osfw";
+  std::string command = std::string(FW_PACKAGE) + " " + arguments + " -o " + path + " > " + path + ".log";
+  CHECK_EQ(system(command.c_str()), 0);
+  Package package;
+  package.bytes = readFile(path);
+  package.crc = FU::crc32(0, package.bytes.data(), package.bytes.size());
+  CHECK(package.bytes.size() > FU::HEADER_SIZE);
+  return package;
+}
+
+/**
+ * LZ package of "OSC" repeated by LONG_COPIES matches of MAX_COPY bytes
+ * (op 0x7F: match, extended length; LEB128 MAX_COPY - 3 - 63; distance 3)
+ */
+Package longCopyPackage(Bytes& image) {
+  image = { 'O', 'S', 'C' };
+  Bytes payload = { 0x02, 'O', 'S', 'C' };
+  uint32_t extension = FU::MAX_COPY - FU::MIN_MATCH - 63;
+  for (uint32_t i = 0; i < LONG_COPIES; i++) {
+    payload.insert(payload.end(), { 0x7F, (uint8_t)(0x80 | (extension & 0x7F)), (uint8_t)(extension >> 7), 0x02 });
+    for (uint32_t j = 0; j < FU::MAX_COPY; j++) image.push_back(image[image.size() - 3]);
+  }
+  uint32_t size = image.size();
+  uint32_t crc = FU::crc32(0, image.data(), image.size());
+  Package package;
+  package.bytes = { 'O', 'S', 'F', 'W', 1, FU::FORMAT_LZ, 0, 0 };
+  for (uint32_t field : { size, crc, 0u, 0u }) {
+    for (int shift = 24; shift >= 0; shift -= 8) package.bytes.push_back((uint8_t)(field >> shift));
+  }
+  package.bytes.insert(package.bytes.end(), payload.begin(), payload.end());
+  package.crc = FU::crc32(0, package.bytes.data(), package.bytes.size());
+  return package;
+}
+
+Bytes nextRelease(const Bytes& release) {
+  Bytes next(release.begin(), release.begin() + INSERT_AT);
+  for (size_t i = 0; i < INSERT_BYTES; i++) next.push_back((uint8_t)(0x5A ^ (i * 37)));
+  next.insert(next.end(), release.begin() + INSERT_AT, release.end());
+  for (int i = 0; i < CHANGED_WORDS; i++) {
+    size_t at = (INSERT_AT + INSERT_BYTES + 256 + (size_t)i * 1901) & ~(size_t)3;
+    next[at] ^= 0x24;
+    next[at + 1] ^= (uint8_t)i;
+  }
+  return next;
+}
+
+///////////////////////////////////////////////// APP SIDE /////////////////////////////////////////////////
+/**
+ * App end of the BLE UART: CMD_FW_UPDATE requests out, status frames in
+ */
+class Link {
+public:
+  bool binary;
+  unsigned long wireBytes = 0;
+
+  explicit Link(bool binaryFrames)
+    : binary(binaryFrames) {
+  }
+
+  void begin(const Package& package) {
+    uint32_t size = package.bytes.size();
+    send({ FU::OP_BEGIN, (uint8_t)(size >> 16), (uint8_t)(size >> 8), (uint8_t)size, (uint8_t)(package.crc >> 24),
+           (uint8_t)(package.crc >> 16), (uint8_t)(package.crc >> 8), (uint8_t)package.crc });
+  }
+
+  void chunk(const Package& package, size_t index, bool corrupt) {
+    uint32_t offset = index * FU::MAX_CHUNK;
+    size_t length = std::min<size_t>(FU::MAX_CHUNK, package.bytes.size() - offset);
+    Bytes fields = { FU::OP_DATA, (uint8_t)(offset >> 16), (uint8_t)(offset >> 8), (uint8_t)offset };
+    fields.insert(fields.end(), package.bytes.begin() + offset, package.bytes.begin() + offset + length);
+    uint16_t crc = FU::crc16(FU::crc16(0xFFFF, &fields[1], 3), &fields[4], (uint8_t)length);
+    if (corrupt) fields[4] ^= 0x01;
+    fields.push_back((uint8_t)(crc >> 8));
+    fields.push_back((uint8_t)crc);
+    send(fields);
+  }
+
+  // QUERY / COMMIT / ABORT in a plain frame
+  void request(uint8_t op) {
+    transmit(reference::command(DEVICE_ID, sequence++, CommunicationManager::CMD_FW_UPDATE, op));
+  }
+
+  // Status frames written by the firmware since the last call
+  std::vector<Status> statuses() {
+    Bytes out = mySerial2.hostTakeOutput();
+    received.insert(received.end(), out.begin(), out.end());
+    std::vector<Status> list;
+    size_t end = received.size();
+    while (end > 0 && received[end - 1] != reference::ETX) end--;
+    if (end == 0) return list;
+    Bytes complete(received.begin(), received.begin() + end);
+    received.erase(received.begin(), received.begin() + end);
+    for (const Bytes& body : reference::decodeHexStream(complete)) {
+      if (body.size() != 13 || body[2] != CommunicationManager::CMD_FW_UPDATE || body[3] != FU::OP_STATUS) continue;
+      list.push_back({ body[4], body[5], (uint32_t)(body[6] << 16 | body[7] << 8 | body[8]),
+                       (uint32_t)(body[9] << 16 | body[10] << 8 | body[11]) });
+    }
+    return list;
+  }
+
+private:
+  static uint8_t sequence;
+  Bytes received;
+
+  void send(const Bytes& fields) {
+    Bytes body = { DEVICE_ID, sequence++, CommunicationManager::CMD_FW_UPDATE };
+    body.insert(body.end(), fields.begin(), fields.end());
+    body.push_back(reference::checksum(body.data(), body.size()));
+    transmit(body);
+  }
+
+  void transmit(const Bytes& body) {
+    Bytes frame = binary ? reference::binaryFrame(body) : reference::hexFrame(body);
+    mySerial2.hostTransmit(frame.data(), frame.size());
+    wireBytes += frame.size();
+  }
+};
+
+uint8_t Link::sequence = 0x01;
+
+// One loop pass; returns the virtual time loop() took (flash stalls)
+uint64_t pass() {
+  uint64_t start = host::nowMicros();
+  loop();
+  uint64_t busy = host::nowMicros() - start;
+  host::advanceMicros(host_test::LOOP_PASS_MICROS);
+  return busy;
+}
+
+/**
+ * Stream a package until VERIFIED or FAILED
+ * Chunks go out back to back. Resent from the status' next offset when a
+ * chunk was refused (CHUNK_REFUSED), after the BEGIN that resumes a
+ * dropped link, and when no status shows progress for STALL_MICROS.
+ */
+Transfer transfer(const Package& package, bool binary, const Faults& faults = Faults()) {
+  Transfer result;
+  Link link(binary);
+  uint64_t start = host::nowMicros();
+  size_t chunks = (package.bytes.size() + FU::MAX_CHUNK - 1) / FU::MAX_CHUNK;
+  std::vector<uint8_t> sends(chunks, 0);
+  size_t next = 0;
+  uint32_t confirmed = 0;
+  bool receiving = false;
+  bool linkDown = false;
+  bool disconnected = false;
+  bool resuming = false;
+  uint64_t progressAt = start;
+  uint64_t reconnectAt = 0;
+
+  link.begin(package);
+  while (host::nowMicros() - start < SESSION_LIMIT_MICROS) {
+    uint64_t busy = pass();
+    if (receiving) result.longestPassMicros = std::max(result.longestPassMicros, busy);
+    uint64_t now = host::nowMicros();
+    for (const Status& status : link.statuses()) {
+      result.state = status.state;
+      result.code = status.code;
+      if (status.state == FU::STATE_FAILED) {
+        result.totalMicros = now - start;
+        result.wireBytes = link.wireBytes;
+        return result;
+      }
+      if (status.state == FU::STATE_VERIFIED) {
+        result.verified = true;
+        result.totalMicros = now - start;
+        result.wireBytes = link.wireBytes;
+        return result;
+      }
+      if (status.state == FU::STATE_ERASING) continue;
+      if (!receiving) {
+        receiving = true;
+        result.eraseMicros = now - start;
+        progressAt = now;
+      }
+      if (status.next > confirmed) {
+        confirmed = status.next;
+        progressAt = now;
+      }
+      if (status.code == FU::CODE_CHUNK_REFUSED || resuming) {
+        next = std::min(next, (size_t)(status.next / FU::MAX_CHUNK));
+        resuming = false;
+      }
+    }
+    if (!receiving) continue;
+
+    if (linkDown) {
+      if (now < reconnectAt) continue;
+      linkDown = false;
+      progressAt = now;
+      resuming = true;
+      link.begin(package);  // Resume: the status names the next offset
+      continue;
+    }
+    if (confirmed < package.bytes.size() && now - progressAt > STALL_MICROS) {
+      next = confirmed / FU::MAX_CHUNK;
+      progressAt = now;
+    }
+    while (next < chunks && mySerial2.hostLineIdleAt() <= now + host_test::LOOP_PASS_MICROS) {
+      if (next == faults.disconnectAtChunk && !disconnected) {
+        disconnected = linkDown = true;
+        reconnectAt = now + DISCONNECT_MICROS;
+        break;
+      }
+      link.chunk(package, next, next == faults.corruptChunk && sends[next] == 0);
+      result.resent += (sends[next]++ > 0);
+      next++;
+    }
+  }
+  result.wireBytes = link.wireBytes;
+  return result;
+}
+
+/**
+ * OP_ABORT, answered with status IDLE
+ */
+bool abortSession() {
+  Link link(false);
+  link.request(FU::OP_ABORT);
+  bool idle = false;
+  for (int i = 0; i < 200; i++) {
+    pass();
+    for (const Status& status : link.statuses()) idle = status.state == FU::STATE_IDLE;
+  }
+  return idle;
+}
+
+void report(const char* name, const Package& package, const Transfer& transfer) {
+  printf("%-16s %6zu bytes  erase %4.2f s  BEGIN->VERIFIED %6.1f s  %7lu bytes on the wire (%5.1f s)  %lu resent\n", name,
+         package.bytes.size(), transfer.eraseMicros / 1e6, transfer.totalMicros / 1e6, transfer.wireBytes,
+         transfer.wireBytes * mySerial2.hostCharMicros() / 1e6, transfer.resent);
+}
+
+///////////////////////////////////////////////// BOOTLOADER SIDE /////////////////////////////////////////////////
+/**
+ * BootFlash on the HAL flash model (the bootloader itself drives the registers)
+ */
+class HalBootFlash : public BootFlash {
+public:
+  bool erasePage(uint32_t address) override {
+    FLASH_EraseInitTypeDef erase = { HOST_FLASH_TYPEERASE_PAGES, 0, address, 1 };
+    uint32_t pageError = 0;
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &pageError);
+    HAL_FLASH_Lock();
+    return status == HAL_OK && pageError == 0xFFFFFFFF;
+  }
+
+  bool program(uint32_t address, const uint8_t* data, uint16_t length) override {
+    bool ok = true;
+    HAL_FLASH_Unlock();
+    for (uint16_t i = 0; ok && i < length; i += 2) {
+      ok = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, address + i, data[i] | ((uint16_t)data[i + 1] << 8)) == HAL_OK;
+    }
+    HAL_FLASH_Lock();
+    return ok && memcmp(map(address), data, length) == 0;
+  }
+
+  const uint8_t* map(uint32_t address) const override {
+    return reinterpret_cast<const uint8_t*>(address);
+  }
+};
+
+const FU::BootControl& controlRecord() {
+  return *reinterpret_cast<const FU::BootControl*>(FU::CONTROL_ADDRESS);
+}
+
+void writeRecord(HalBootFlash& flash, uint32_t size, uint32_t crc, uint32_t check) {
+  FU::BootControl record = { FU::BOOT_MAGIC, size, crc, check };
+  flash.erasePage(FU::CONTROL_ADDRESS);
+  flash.program(FU::CONTROL_ADDRESS, reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+}
+
+bool appHolds(const Bytes& image) {
+  return memcmp(reinterpret_cast<const void*>(FU::APP_ADDRESS), image.data(), image.size()) == 0;
+}
+
+/**
+ * Power on into the bootloader; false when the power went during the run
+ */
+bool bootOnce(BootInstaller& installer, BootInstaller::Result& result) {
+  host::reset();
+  try {
+    result = installer.run();
+    return true;
+  } catch (host::PowerLoss&) {
+    return false;
+  }
+}
+
+}  // namespace
+
+int main() {
+  // fw_package builds what this firmware and bootloader decode and install
+  std::vector<std::pair<std::string, unsigned long>> layout;
+  CHECK(readLayout(layout));
+  const std::pair<const char*, unsigned long> expected[] = {
+    { "APP_ADDRESS", FU::APP_ADDRESS }, { "PAGE_SIZE", FlashBank::PAGE_SIZE }, { "REGION_SIZE", FU::REGION_SIZE },
+    { "HEADER_SIZE", FU::HEADER_SIZE }, { "MIN_MATCH", FU::MIN_MATCH },        { "MAX_COPY", FU::MAX_COPY },
+    { "ROW_SIZE", FU::ROW_SIZE },       { "MAX_CHUNK", FU::MAX_CHUNK },
+  };
+  CHECK_EQ(layout.size(), sizeof(expected) / sizeof(expected[0]));
+  for (const auto& constant : expected) {
+    auto found = std::find_if(layout.begin(), layout.end(), [&](const std::pair<std::string, unsigned long>& entry) {
+      return entry.first == constant.first;
+    });
+    if (CHECK(found != layout.end())) CHECK_EQ(found->second, constant.second);
+  }
+
+  Bytes release;
+  uint32_t start = 0;
+  CHECK(readHex(RELEASE_HEX, release, start));
+  Bytes next = nextRelease(release);
+  uint32_t nextCrc = FU::crc32(0, next.data(), next.size());
+  std::string nextHex = std::string(WORK_DIR) + "/next_release.hex";
+  CHECK(writeHex(nextHex, next, start));
+  Package lz = buildPackage("next_lz", "-f lz " + nextHex);
+  Package delta = buildPackage("next_delta", std::string("-f delta -b ") + RELEASE_HEX + " " + nextHex);
+  Package rollback = buildPackage("rollback_delta", "-f delta -b " + nextHex + " " + RELEASE_HEX);
+
+  // The release runs; staging holds whatever an earlier session left
+  uint8_t* flash = host::flash();
+  memcpy(flash + (FU::APP_ADDRESS - FLASH_BASE), release.data(), release.size());
+  memset(flash + (FU::STAGING_ADDRESS - FLASH_BASE), 0x00, FU::REGION_SIZE);
+  host_test::bootToReady();
+  FirmwareUpdater* updater = massageController->getCommunicationManager()->getFirmwareUpdater();
+  CHECK(updater != nullptr);
+  if (!updater) return host_test::result();
+
+  // A delta made against another image is refused once the header is in
+  Transfer refused = transfer(rollback, true);
+  CHECK(!refused.verified);
+  CHECK_EQ(refused.state, FU::STATE_FAILED);
+  CHECK_EQ(refused.code, FU::CODE_BASE_MISMATCH);
+  CHECK(abortSession());
+
+  // Clean 9600-baud transfers
+  Transfer lzBinary = transfer(lz, true);
+  CHECK(lzBinary.verified);
+  CHECK(memcmp(flash + (FU::STAGING_ADDRESS - FLASH_BASE), next.data(), next.size()) == 0);
+  CHECK(abortSession());
+  Transfer lzHex = transfer(lz, false);
+  CHECK(lzHex.verified);
+  CHECK(abortSession());
+  Transfer deltaHex = transfer(delta, false);
+  CHECK(deltaHex.verified);
+  CHECK(abortSession());
+
+  // A refused chunk and a dropped link on the way
+  unsigned long chunkErrors = updater->getChunkErrors();
+  Faults faults;
+  faults.corruptChunk = 20;
+  faults.disconnectAtChunk = 50;
+  Transfer deltaFaults = transfer(delta, true, faults);
+  CHECK(deltaFaults.verified);
+  CHECK(deltaFaults.resent > 0);
+  CHECK(updater->getChunkErrors() > chunkErrors);
+  CHECK(abortSession());
+
+  // Long copies are written over several loop passes, DECODE_BUDGET at a time
+  Bytes longImage;
+  Package longCopies = longCopyPackage(longImage);
+  Transfer longBinary = transfer(longCopies, true);
+  CHECK(longBinary.verified);
+  CHECK(memcmp(flash + (FU::STAGING_ADDRESS - FLASH_BASE), longImage.data(), longImage.size()) == 0);
+  const uint64_t budgetMicros = (FU::DECODE_BUDGET + FU::ROW_SIZE) / 2 * 525 / 10;  // Rows flushed, 52.5us a halfword
+  printf("long copies: longest pass %llu us (budget %llu us)\n", (unsigned long long)longBinary.longestPassMicros,
+         (unsigned long long)budgetMicros);
+  CHECK(longBinary.longestPassMicros <= budgetMicros);
+  CHECK(abortSession());
+
+  Transfer deltaBinary = transfer(delta, true);
+  CHECK(deltaBinary.verified);
+  CHECK_EQ(lzBinary.resent + lzHex.resent + deltaHex.resent + deltaBinary.resent, 0);
+  CHECK(memcmp(flash + (FU::STAGING_ADDRESS - FLASH_BASE), next.data(), next.size()) == 0);
+
+  printf("image %zu -> %zu bytes, 9600 baud:\n", release.size(), next.size());
+  report("lz binary", lz, lzBinary);
+  report("lz hex", lz, lzHex);
+  report("delta hex", delta, deltaHex);
+  report("delta binary", delta, deltaBinary);
+  report("delta + faults", delta, deltaFaults);
+  report("long copies", longCopies, longBinary);
+
+  // COMMIT: record written, restart 500ms later (after the INSTALLING status)
+  Link link(true);
+  uint64_t commitAt = host::nowMicros();
+  link.request(FU::OP_COMMIT);
+  bool installing = false;
+  bool restarted = false;
+  try {
+    while (host::nowMicros() - commitAt < 2000000) {
+      pass();
+      for (const Status& status : link.statuses()) installing |= status.state == FU::STATE_INSTALLING;
+    }
+  } catch (host::SystemReset&) {
+    restarted = true;
+  }
+  CHECK(installing);
+  CHECK(restarted);
+  CHECK(host::nowMicros() - commitAt >= FU::RESTART_DELAY_TICKS * 10000);
+  const FU::BootControl& record = controlRecord();
+  CHECK_EQ(record.magic, FU::BOOT_MAGIC);
+  CHECK_EQ(record.imageSize, next.size());
+  CHECK_EQ(record.imageCrc, nextCrc);
+  CHECK_EQ(record.check, ~(record.magic ^ record.imageSize ^ record.imageCrc));
+  CHECK(appHolds(release));
+
+  // Bootloader, the power cut at every stage of the copy: each boot starts over
+  HalBootFlash bootFlash;
+  BootInstaller installer(bootFlash);
+  BootInstaller::Result result = BootInstaller::RESULT_NO_UPDATE;
+  unsigned long pages = (next.size() + FlashBank::PAGE_SIZE - 1) / FlashBank::PAGE_SIZE;
+  unsigned long copyOps = pages + (next.size() + 1) / 2;
+  const unsigned long cuts[] = { 1, 2, copyOps / 3, copyOps / 2, copyOps - 1, copyOps };
+  for (unsigned long cut : cuts) {
+    host::flashPowerLossAt(host::flashOperations() + cut);
+    CHECK(!bootOnce(installer, result));
+    CHECK_EQ(controlRecord().magic, FU::BOOT_MAGIC);
+  }
+
+  unsigned long opsBefore = host::flashOperations();
+  CHECK(bootOnce(installer, result));
+  CHECK_EQ(result, BootInstaller::RESULT_INSTALLED);
+  CHECK_EQ(host::flashOperations() - opsBefore, copyOps + 1);
+  uint64_t copyMicros = host::nowMicros();
+  CHECK(appHolds(next));
+  CHECK(installer.appBootable());
+  CHECK(controlRecord().magic != FU::BOOT_MAGIC);
+  printf("bootloader: %lu pages + %lu halfwords copied in %.2f s\n", pages, copyOps - pages, copyMicros / 1e6);
+
+  // Copied, but the power went before the record was erased: no second copy
+  writeRecord(bootFlash, next.size(), nextCrc, ~(FU::BOOT_MAGIC ^ (uint32_t)next.size() ^ nextCrc));
+  opsBefore = host::flashOperations();
+  CHECK(bootOnce(installer, result));
+  CHECK_EQ(result, BootInstaller::RESULT_INSTALLED);
+  CHECK_EQ(host::flashOperations() - opsBefore, 1);
+
+  // Power cut while erasing the record: gone or still there, never harmful
+  writeRecord(bootFlash, next.size(), nextCrc, ~(FU::BOOT_MAGIC ^ (uint32_t)next.size() ^ nextCrc));
+  host::flashPowerLossAt(host::flashOperations() + 1);
+  CHECK(!bootOnce(installer, result));
+  CHECK(bootOnce(installer, result));
+  CHECK(result == BootInstaller::RESULT_NO_UPDATE || result == BootInstaller::RESULT_INSTALLED);
+  CHECK(appHolds(next));
+
+  // Staging that does not match the record: dropped, application kept
+  writeRecord(bootFlash, next.size(), nextCrc ^ 1, ~(FU::BOOT_MAGIC ^ (uint32_t)next.size() ^ (nextCrc ^ 1)));
+  CHECK(bootOnce(installer, result));
+  CHECK_EQ(result, BootInstaller::RESULT_BAD_STAGING);
+  CHECK(appHolds(next));
+  CHECK(controlRecord().magic != FU::BOOT_MAGIC);
+
+  // Half-written record (commit cut short): dropped
+  writeRecord(bootFlash, next.size(), nextCrc, 0xFFFFFFFF);
+  CHECK(bootOnce(installer, result));
+  CHECK_EQ(result, BootInstaller::RESULT_NO_UPDATE);
+  CHECK(controlRecord().magic != FU::BOOT_MAGIC);
+  CHECK(bootOnce(installer, result));
+  CHECK_EQ(result, BootInstaller::RESULT_NO_UPDATE);
+  CHECK(appHolds(next));
+
+  return host_test::result();
+}
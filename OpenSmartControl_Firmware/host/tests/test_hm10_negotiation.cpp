@@ -0,0 +1,82 @@
+/**
+ * HM10 baud-rate negotiation against a simulated module (BLE_UART_BAUD_NEGOTIATION=1)
+ * - Factory module at 9600: reset, probe, AT+BAUD4, reset, loopback check
+ * - Module that kept 115200: one "AT" at 115200, no reset
+ * - Phone connected (the "AT" goes to the phone): reset, then the probes
+ * - Dead module: 9600 fallback
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "SimHm10.h"
+#include "MassageController.h"
+#include "Hm10Manager.h"
+
+namespace {
+
+typedef CommunicationManager CM;
+
+// Run until the UART belongs to the frame path again
+bool runUntilReady(SimHm10& module, Hm10Manager* hm10, uint64_t limitMs) {
+  for (uint64_t ms = 0; ms < limitMs; ms += 10) {
+    module.run(10);
+    if (!hm10->isBusy()) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+int main() {
+  SimHm10 module(mySerial2);
+  host_test::boot();
+  host::setInput(PB4, HIGH);  // LMT_UP_PIN
+  host::setInput(PB3, LOW);   // LMT_DOWN_PIN
+  CM* comm = massageController->getCommunicationManager();
+  Hm10Manager* hm10 = comm->getHm10Manager();
+
+  // First boot with a factory module: the target check fails, so the module
+  // is reset, found at 9600, switched and reset again to apply the rate
+  CHECK(runUntilReady(module, hm10, 6000));
+  CHECK_EQ(hm10->getBaud(), 115200);
+  CHECK(!hm10->isFallback());
+  CHECK_EQ(module.moduleBaud, 115200);
+  CHECK_EQ(module.resets, 2);
+  CHECK(module.lastCommand == "AT+BAUD?");
+
+  // Next boot: the module kept 115200 and answers at once, no reset
+  unsigned long resets = module.resets;
+  uint64_t start = host::nowMicros();
+  hm10->negotiate(BLE_UART_TARGET_BAUD);
+  CHECK(runUntilReady(module, hm10, 1000));
+  CHECK(host::nowMicros() - start < 100000);
+  CHECK_EQ(module.resets, resets);
+  CHECK_EQ(hm10->getBaud(), 115200);
+
+  // Frames flow at the negotiated rate
+  module.run(3000);  // GO HOME done
+  unsigned long framesIn = comm->getLinkStats().framesIn;
+  reference::Bytes frame = reference::hexFrame(reference::command(0x70, 0x21, 0x90, 0x00));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  module.run(100);
+  CHECK_EQ(comm->getLinkStats().framesIn, framesIn + 1);
+
+  // Phone connected: the module forwards the "AT" instead of answering; the
+  // reset drops the connection and the probe finds it at 115200
+  module.connected = true;
+  hm10->negotiate(BLE_UART_TARGET_BAUD);
+  CHECK(runUntilReady(module, hm10, 3000));
+  CHECK(module.forwarded > 0);
+  CHECK(!module.connected);
+  CHECK_EQ(module.resets, resets + 1);
+  CHECK_EQ(hm10->getBaud(), 115200);
+
+  // Module that never answers: fallback to 9600
+  module.answering = false;
+  hm10->negotiate(BLE_UART_TARGET_BAUD);
+  CHECK(runUntilReady(module, hm10, 10000));
+  CHECK(hm10->isFallback());
+  CHECK_EQ(hm10->getBaud(), Hm10Manager::FALLBACK_BAUD);
+  CHECK_EQ(mySerial2.hostBaud(), Hm10Manager::FALLBACK_BAUD);
+
+  return host_test::result();
+}
@@ -0,0 +1,106 @@
+/**
+ * Hold-to-run leases on RL1 (RECLINE)
+ *
+ * A PUSH with data2 = 30 (300 ms) and no renewal stops RL1 one lease later
+ * and clears manual priority as a RELEASE would. Renewing the PUSH every
+ * 200 ms keeps RL1 on. A legacy PUSH (data2 = 0) only has the 60 s hard
+ * timeout.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+#include "MotorController.h"
+
+namespace {
+
+typedef CommunicationManager CM;
+
+const uint8_t LEASE_TICKS = 30;  // 300 ms
+const uint64_t HARD_TIMEOUT_MS = 60000;  // MotorController::RL1_RL2_TIMEOUT_TICKS
+
+uint8_t sequence = 0x10;
+
+void send(uint8_t cmd, uint8_t data1, uint8_t data2 = 0) {
+  reference::Bytes frame = reference::hexFrame(reference::command(0x70, sequence++, cmd, data1, data2));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+}
+
+bool rl1Running() {
+  return host::pinLevel(RL1_PWM_PIN) != LOW;
+}
+
+/**
+ * Run until RL1 stops or the time is up; returns the ms it took
+ */
+uint64_t runUntilRl1Stops(uint64_t limitMs) {
+  uint64_t start = host::nowMicros();
+  while (rl1Running() && host::nowMicros() - start < limitMs * 1000ULL) {
+    host_test::runFor(1);
+  }
+  return (host::nowMicros() - start) / 1000;
+}
+
+/**
+ * PUSH and wait until the frame is handled; returns the virtual time it was sent
+ */
+uint64_t push(uint8_t data2) {
+  uint64_t sent = host::nowMicros();
+  send(CM::CMD_RECLINE, CM::DATA_ON, data2);
+  while (!rl1Running() && host::nowMicros() - sent < 100000) {
+    host_test::runFor(1);
+  }
+  return sent;
+}
+
+}  // namespace
+
+int main() {
+  host_test::bootToReady();
+  CM* comm = massageController->getCommunicationManager();
+  MotorController* motors = massageController->getMotorController();
+
+  // No renewal: RL1 stops one lease after the PUSH
+  uint64_t sent = push(LEASE_TICKS);
+  CHECK(rl1Running());
+  CHECK(comm->getManualPriority());
+  runUntilRl1Stops(1000);
+  uint64_t stoppedAfter = (host::nowMicros() - sent) / 1000;
+  printf("lease %u ms: RL1 stopped %llu ms after the PUSH\n", LEASE_TICKS * 10u, (unsigned long long)stoppedAfter);
+  CHECK(!rl1Running());
+  CHECK(stoppedAfter >= LEASE_TICKS * 10u);
+  CHECK(stoppedAfter <= LEASE_TICKS * 10u + 40);
+  CHECK_EQ(motors->getLeaseExpiries(), 1);
+  CHECK(!comm->getManualPriority());
+
+  // Renewed every 200 ms: RL1 stays on until the RELEASE
+  push(LEASE_TICKS);
+  for (int renewal = 0; renewal < 15; renewal++) {
+    host_test::runFor(200);
+    CHECK(rl1Running());
+    send(CM::CMD_RECLINE, CM::DATA_ON, LEASE_TICKS);
+  }
+  host_test::runFor(200);
+  CHECK(rl1Running());
+  CHECK(comm->getManualPriority());
+  CHECK_EQ(motors->getLeaseExpiries(), 1);
+  send(CM::CMD_RECLINE, CM::DATA_OFF);
+  host_test::runFor(100);
+  CHECK(!rl1Running());
+  CHECK(!comm->getManualPriority());
+
+  // Legacy PUSH: no lease, RL1 runs until the 60 s hard timeout
+  sent = push(0);
+  host_test::runFor(5000);
+  CHECK(rl1Running());
+  CHECK(comm->getManualPriority());
+  runUntilRl1Stops(65000);
+  stoppedAfter = (host::nowMicros() - sent) / 1000;
+  printf("legacy PUSH: RL1 stopped %llu ms after the PUSH\n", (unsigned long long)stoppedAfter);
+  CHECK(!rl1Running());
+  CHECK(stoppedAfter >= HARD_TIMEOUT_MS);
+  CHECK(stoppedAfter <= HARD_TIMEOUT_MS + 200);
+  CHECK_EQ(motors->getLeaseExpiries(), 1);
+  CHECK(!comm->getManualPriority());
+
+  return host_test::result();
+}
@@ -0,0 +1,81 @@
+/**
+ * LatencyProbe stages for one RECLINE PUSH at 9600 baud
+ *
+ * The frame reaches the motor in one sample per stage: FRAME + DECODE +
+ * QUEUE + HANDLER make up TOTAL, the RECLINE slot holds the same TOTAL, and
+ * the report on the debug UART lists them. Time is the virtual clock, so
+ * only reception (bytes drained once per loop pass) takes any.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+#include <string>
+
+namespace {
+
+typedef CommunicationManager CM;
+typedef LatencyProbe LP;
+
+uint8_t commandSlot(uint8_t command) {
+  for (uint8_t slot = 0; slot < CM::COMMAND_COUNT; slot++) {
+    if (CM::COMMAND_TABLE[slot].command == command) return slot;
+  }
+  return LP::MAX_SLOTS;
+}
+
+}  // namespace
+
+int main() {
+  host_test::bootToReady();
+  CM* comm = massageController->getCommunicationManager();
+  LP* probe = comm->getLatencyProbe();
+  if (!CHECK(probe != nullptr)) return host_test::result();
+  CHECK(comm->requestLatencyReport(true));
+
+  reference::Bytes frame = reference::hexFrame(reference::command(0x70, 0x21, CM::CMD_RECLINE, CM::DATA_ON));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  host_test::runFor(100);
+  CHECK(host::pinLevel(RL1_PWM_PIN) != LOW);
+
+  const LP::Histogram& total = probe->getStage(LP::STAGE_TOTAL);
+  const LP::Histogram& handler = probe->getStage(LP::STAGE_HANDLER);
+  for (uint8_t stage = 0; stage < LP::STAGE_COUNT; stage++) {
+    const LP::Histogram& histogram = probe->getStage((LP::Stage)stage);
+    printf("%-16s n=%lu max=%lu us\n", LP::getStageName((LP::Stage)stage), (unsigned long)histogram.count,
+           (unsigned long)histogram.maxUs);
+    CHECK_EQ(histogram.count, stage == LP::STAGE_STOP ? 0 : 1);
+  }
+
+  // One sample each: the stages add up to TOTAL, which is the slowest
+  uint32_t stages = 0;
+  for (uint8_t stage = LP::STAGE_FRAME; stage <= LP::STAGE_HANDLER; stage++) {
+    uint32_t us = probe->getStage((LP::Stage)stage).maxUs;
+    CHECK(us <= total.maxUs);
+    stages += us;
+  }
+  CHECK_EQ(stages, total.maxUs);
+  CHECK(handler.maxUs <= total.maxUs);
+  // STX .. ETX on the wire, each byte seen up to one loop pass late
+  CHECK(total.maxUs + host_test::LOOP_PASS_MICROS >= (frame.size() - 1) * mySerial2.hostCharMicros());
+  CHECK(total.maxUs < 100000);
+
+  const LP::Histogram& recline = probe->getCommand(commandSlot(CM::CMD_RECLINE));
+  CHECK_EQ(recline.count, 1);
+  CHECK_EQ(recline.maxUs, total.maxUs);
+
+  // The same numbers on the debug UART
+  mySerial.hostTakeOutput();
+  CHECK(comm->requestLatencyReport(false));
+  host_test::runFor(200);
+  std::vector<uint8_t> out = mySerial.hostTakeOutput();
+  std::string report(out.begin(), out.end());
+  char line[LP::LINE_SIZE];
+  LP::formatLine(line, "TOTAL", total);
+  CHECK(report.find(line) != std::string::npos);
+  LP::formatLine(line, "HANDLER", handler);
+  CHECK(report.find(line) != std::string::npos);
+  LP::formatLine(line, "RECLINE", recline);
+  CHECK(report.find(line) != std::string::npos);
+
+  return host_test::result();
+}
@@ -0,0 +1,154 @@
+/**
+ * ACK / retransmit against blind repeats over a lossy 9600-baud link
+ *
+ * The same button presses (INTENSITY_LEVEL, cycling through three levels
+ * so every press changes the chair) go out once per PRESS_MICROS through
+ * ReferenceClient, first like the legacy app (three copies), then with
+ * SEQUENCE_WINDOW + ACK and timeout retransmit. For each press the test
+ * records when the level took effect in the firmware; air time counts
+ * every byte sent either way, lost frames included.
+ */
+#include "HostTest.h"
+#include "ReferenceClient.h"
+#include "MassageController.h"
+#include "SequenceController.h"
+#include <algorithm>
+
+namespace {
+
+typedef CommunicationManager CM;
+
+// Five sessions stay inside the 20-minute AUTO program
+const int PRESSES = 120;
+// Longer than the last retransmit (4 x 300 ms), so presses never overlap
+const uint64_t PRESS_MICROS = 1500000;
+const uint8_t LEVELS[] = { 0xA0, 0xB0, 0xC0 };
+
+struct Session {
+  int applied = 0;
+  std::vector<uint64_t> latencies;  // First send -> level set in the firmware (us)
+  uint64_t airMicros = 0;
+  unsigned long acks = 0;
+  unsigned long duplicateAcks = 0;
+  unsigned long nacks = 0;
+  unsigned long giveUps = 0;
+  uint64_t confirmMicrosTotal = 0;
+
+  double meanMillis() const {
+    uint64_t sum = 0;
+    for (uint64_t latency : latencies) sum += latency;
+    return latencies.empty() ? 0.0 : sum / 1000.0 / latencies.size();
+  }
+
+  double percentileMillis(double fraction) const {
+    if (latencies.empty()) return 0.0;
+    std::vector<uint64_t> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[(size_t)(fraction * (sorted.size() - 1))] / 1000.0;
+  }
+};
+
+void pass(ReferenceClient& client) {
+  loop();
+  host::advanceMicros(host_test::LOOP_PASS_MICROS);
+  client.poll();
+}
+
+Session runSession(ReferenceClient::Mode mode, double loss, double corrupt,
+                   uint64_t retransmitMicros = ReferenceClient::RETRANSMIT_MICROS) {
+  SequenceController* seq = massageController->getSequenceController();
+  ReferenceClient client(mySerial2, mode, loss, corrupt, 1);
+  client.retransmitMicros = retransmitMicros;
+  client.connect();
+  while (client.busy()) pass(client);
+  uint64_t airBefore = client.airMicros();
+
+  Session session;
+  for (int press = 0; press < PRESSES; press++) {
+    uint8_t level = LEVELS[press % 3];
+    uint64_t sentAt = host::nowMicros();
+    client.send(CM::CMD_INTENSITY_LEVEL, level);
+    bool applied = false;
+    while (host::nowMicros() - sentAt < PRESS_MICROS) {
+      pass(client);
+      if (!applied && seq->getIntensityLevel() == level) {
+        applied = true;
+        session.applied++;
+        session.latencies.push_back(host::nowMicros() - sentAt);
+      }
+    }
+  }
+  session.airMicros = client.airMicros() - airBefore;
+  session.acks = client.acks;
+  session.duplicateAcks = client.duplicateAcks;
+  session.nacks = client.nacks;
+  session.giveUps = client.giveUps;
+  session.confirmMicrosTotal = client.confirmMicrosTotal;
+  return session;
+}
+
+/**
+ * App closes the link (heartbeat OFF): link options back to the defaults
+ */
+void closeLink() {
+  reference::Bytes frame = reference::hexFrame(reference::command(0x70, 0x00, CM::CMD_HEARTBEAT, CM::DATA_OFF));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  host_test::runFor(100);
+}
+
+void report(const char* name, const Session& session) {
+  printf("%-14s %3d/%d applied  latency mean %6.1f ms  p95 %6.1f ms  max %6.1f ms  air %5.1f ms/press",
+         name, session.applied, PRESSES, session.meanMillis(), session.percentileMillis(0.95),
+         session.percentileMillis(1.0), session.airMicros / 1000.0 / PRESSES);
+  if (session.acks) {
+    printf("  (acked after %.1f ms, %lu NACK, %lu DUPLICATE)", session.confirmMicrosTotal / 1000.0 / session.acks,
+           session.nacks, session.duplicateAcks);
+  }
+  printf("\n");
+}
+
+}  // namespace
+
+int main() {
+  host_test::bootToReady();
+  CHECK_EQ(mySerial2.hostBaud(), 9600);
+
+  // Intensity only applies to COMPRESSION / PERCUSSION / COMBINED
+  reference::Bytes frame = reference::hexFrame(reference::command(0x70, 0x90, CM::CMD_COMPRESSION, CM::DATA_ON));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  host_test::runFor(500);
+  CHECK_EQ(massageController->getSequenceController()->getCurrentAutoProgram(), SequenceController::AUTO_COMPRESSION);
+
+  // Clean link: both deliver everything, the ACK costs a reply per press
+  Session blindClean = runSession(ReferenceClient::MODE_BLIND, 0.0, 0.0);
+  closeLink();
+  Session ackClean = runSession(ReferenceClient::MODE_ACK, 0.0, 0.0);
+  closeLink();
+  report("blind x3", blindClean);
+  report("ack", ackClean);
+  CHECK_EQ(blindClean.applied, PRESSES);
+  CHECK_EQ(ackClean.applied, PRESSES);
+  CHECK_EQ(ackClean.acks, PRESSES);
+  CHECK(ackClean.airMicros < blindClean.airMicros);
+
+  // Lossy link: 10% of frames lost each way, 5% of app frames corrupted
+  Session blindLossy = runSession(ReferenceClient::MODE_BLIND, 0.10, 0.05);
+  closeLink();
+  Session ackLossy = runSession(ReferenceClient::MODE_ACK, 0.10, 0.05);
+  closeLink();
+  // A timeout of ~10 round trips: same delivery, slower recovery
+  Session ackSlow = runSession(ReferenceClient::MODE_ACK, 0.10, 0.05, 300000);
+  report("blind x3 lossy", blindLossy);
+  report("ack lossy", ackLossy);
+  report("ack 300ms", ackSlow);
+  CHECK_EQ(ackLossy.applied, PRESSES);
+  CHECK_EQ(ackLossy.giveUps, 0);
+  CHECK(ackLossy.nacks > 0);          // Corrupt frames answered at once
+  CHECK(ackLossy.duplicateAcks > 0);  // Lost ACKs: the resend is not applied twice
+  CHECK(ackLossy.airMicros < blindLossy.airMicros);
+  CHECK(ackLossy.meanMillis() < blindLossy.meanMillis());
+  CHECK_EQ(ackSlow.applied, PRESSES);
+  CHECK_EQ(massageController->getSequenceController()->getCurrentAutoProgram(), SequenceController::AUTO_COMPRESSION);
+
+  return host_test::result();
+}
@@ -0,0 +1,103 @@
+/**
+ * Link supervision: a held RECLINE stops when the app goes silent
+ *
+ * The app heartbeats every 5 s. From its first heartbeat on, linkTimeoutTicks
+ * without a valid frame is a lost link: RL1 stops although no RELEASE came,
+ * and SafetyManager is told the link was lost (not closed). Before any
+ * heartbeat, silence is not a loss.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+#include "SafetyManager.h"
+#include "TimerManager.h"
+
+namespace {
+
+typedef CommunicationManager CM;
+
+uint8_t sequence = 0x10;
+
+void send(uint8_t cmd, uint8_t data1, uint8_t data2 = 0) {
+  reference::Bytes frame = reference::hexFrame(reference::command(0x70, sequence++, cmd, data1, data2));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+}
+
+bool rl1Running() {
+  return host::pinLevel(RL1_PWM_PIN) != LOW;
+}
+
+/**
+ * Run until RL1 stops or the time is up; returns the ms it took
+ */
+uint64_t runUntilRl1Stops(uint64_t limitMs) {
+  uint64_t start = host::nowMicros();
+  while (rl1Running() && host::nowMicros() - start < limitMs * 1000ULL) {
+    host_test::runFor(1);
+  }
+  return (host::nowMicros() - start) / 1000;
+}
+
+}  // namespace
+
+int main() {
+  host_test::bootToReady();
+  CM* comm = massageController->getCommunicationManager();
+  SafetyManager* safety = massageController->getSafetyManager();
+  const uint64_t timeoutMs = comm->getLinkTimeout() * 10;
+
+  // No heartbeat yet: a legacy PUSH holds RL1 through the silence
+  send(CM::CMD_RECLINE, CM::DATA_ON);
+  host_test::runFor(100);
+  CHECK(comm->isLinkUp());
+  CHECK(!comm->isLinkSupervised());
+  CHECK(rl1Running());
+  host_test::runFor(timeoutMs + 2000);
+  CHECK(rl1Running());
+  CHECK(comm->isLinkUp());
+  send(CM::CMD_RECLINE, CM::DATA_OFF);
+  host_test::runFor(100);
+  CHECK(!rl1Running());
+
+  // One heartbeat starts supervision; the app keeps it up every 5 s
+  send(CM::CMD_HEARTBEAT, CM::DATA_ON);
+  host_test::runFor(100);
+  CHECK(comm->isLinkSupervised());
+  send(CM::CMD_RECLINE, CM::DATA_ON);
+  for (int beat = 0; beat < 4; beat++) {
+    host_test::runFor(5000);
+    send(CM::CMD_HEARTBEAT, CM::DATA_ON);
+  }
+  host_test::runFor(100);
+  CHECK(rl1Running());
+  CHECK(comm->isLinkUp());
+  CHECK_EQ(safety->getLinkDropCount(), 0);
+
+  // The app goes silent with the button held: safe stop inside the window
+  uint64_t stoppedAfter = runUntilRl1Stops(timeoutMs + 1000);
+  printf("RL1 stopped %llu ms after the last frame (link timeout %llu ms)\n",
+         (unsigned long long)stoppedAfter + 100, (unsigned long long)timeoutMs);
+  CHECK(!rl1Running());
+  CHECK(stoppedAfter + 100 <= timeoutMs + 20);
+  CHECK(stoppedAfter + 100 >= timeoutMs - 20);
+  CHECK(!comm->isLinkUp());
+  CHECK(!comm->isLinkSupervised());
+  CHECK(!comm->getManualPriority());
+  CHECK(!safety->isLinkUp());
+  CHECK_EQ(safety->getLinkDropCount(), 1);
+
+  // The next heartbeat brings the link back up, supervised again
+  send(CM::CMD_HEARTBEAT, CM::DATA_ON);
+  host_test::runFor(100);
+  CHECK(comm->isLinkUp());
+  CHECK(safety->isLinkUp());
+  CHECK(comm->isLinkSupervised());
+
+  // Heartbeat OFF closes the link: not counted as a loss
+  send(CM::CMD_HEARTBEAT, CM::DATA_OFF);
+  host_test::runFor(100);
+  CHECK(!comm->isLinkUp());
+  CHECK_EQ(safety->getLinkDropCount(), 1);
+
+  return host_test::result();
+}
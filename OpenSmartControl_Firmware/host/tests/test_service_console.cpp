@@ -0,0 +1,111 @@
+/**
+ * Service console lines typed in fragments on the debug UART
+ *
+ * A terminal delivers a line a few bytes at a time; the console collects
+ * them across loop passes and answers once the line ends. get / set change
+ * the live tunable (range checked, case folded, backspace honoured) and
+ * "prof" prints its capture after the requested passes.
+ */
+#include "HostTest.h"
+#include "MassageController.h"
+#include "SequenceController.h"
+#include "ServiceConsole.h"
+#include <string>
+
+namespace {
+
+typedef CommunicationManager CM;
+
+std::string takeOutput() {
+  std::vector<uint8_t> out = mySerial.hostTakeOutput();
+  return std::string(out.begin(), out.end());
+}
+
+/**
+ * Type the fragments with a few loop passes between them; returns the debug
+ * output seen before the last fragment and after it
+ */
+std::string type(const std::vector<std::string>& fragments, std::string* early = nullptr) {
+  takeOutput();
+  std::string before;
+  for (size_t i = 0; i < fragments.size(); i++) {
+    if (i + 1 == fragments.size()) before = takeOutput();
+    mySerial.hostTransmit((const uint8_t*)fragments[i].data(), fragments[i].size());
+    host_test::runFor(5);
+  }
+  if (early) *early = before;
+  host_test::runFor(50);
+  return takeOutput();
+}
+
+bool contains(const std::string& text, const char* expected) {
+  return text.find(expected) != std::string::npos;
+}
+
+}  // namespace
+
+int main() {
+  host_test::bootToReady();
+  CM* comm = massageController->getCommunicationManager();
+  SequenceController* sequences = massageController->getSequenceController();
+
+  // Nothing is answered until the line ends
+  std::string early;
+  std::string out = type({ "ge", "t pw", "m.hi", "gh\r\n" }, &early);
+  CHECK(!contains(early, "pwm.high"));
+  char expected[64];
+  snprintf(expected, sizeof(expected), "pwm.high = %u PWM, intensity HIGH\r\n", comm->getIntensityHighPWM());
+  CHECK(contains(out, expected));
+
+  // set changes the live value; the line is case folded
+  out = type({ "SET pwm", ".HIGH 2", "00", "\r" });
+  CHECK(contains(out, "OK pwm.high = 200\r\n"));
+  CHECK_EQ(comm->getIntensityHighPWM(), 200);
+
+  // Out of range: refused, value kept
+  out = type({ "set pwm.high 3", "00\n" });
+  CHECK(contains(out, "ERR pwm.high: 0..255\r\n"));
+  CHECK_EQ(comm->getIntensityHighPWM(), 200);
+  out = type({ "set link.time", "out 5\r\n" });
+  CHECK(contains(out, "ERR link.timeout: "));
+  out = type({ "set link.timeout 1500", "\r\n" });
+  CHECK(contains(out, "OK link.timeout = 1500\r\n"));
+  CHECK_EQ(comm->getLinkTimeout(), 1500);
+
+  // Backspace edits the line before it runs
+  out = type({ "set pwm.low 9", "\b", "80\r\n" });
+  CHECK(contains(out, "OK pwm.low = 80\r\n"));
+  CHECK_EQ(comm->getIntensityLowPWM(), 80);
+
+  // Auto step override, read back
+  out = type({ "set step.3 ", "250\r\n" });
+  CHECK(contains(out, "OK step.3 = 250\r\n"));
+  CHECK_EQ(sequences->getStepTicks(3), 250);
+  out = type({ "get step", ".3\r\n" });
+  CHECK(contains(out, "step.3 = 250 ticks (0 = built-in)\r\n"));
+
+  // Two lines in one fragment: both run, one per pass
+  out = type({ "get pwm.low\r\nget pwm.high\r\n" });
+  CHECK(contains(out, "pwm.low = 80 "));
+  CHECK(contains(out, "pwm.high = 200 "));
+
+  // Errors
+  out = type({ "fr", "ob\r\n" });
+  CHECK(contains(out, "ERR unknown command 'frob' (help)\r\n"));
+  out = type({ std::string(ServiceConsole::LINE_SIZE, 'x'), "\r\n" });
+  CHECK(contains(out, "ERR line too long\r\n"));
+  out = type({ "set pwm.high\r\n" });
+  CHECK(contains(out, "ERR usage: set <name> <value>\r\n"));
+  CHECK_EQ(comm->getIntensityHighPWM(), 200);
+
+  // Profiling: the report follows the requested number of passes
+  out = type({ "prof ", "20\r\n" });
+  CHECK(contains(out, "OK profiling 20 passes\r\n"));
+  CHECK(contains(out, "=== PROFILE (us, p99 = bucket bound) ===\r\n"));
+  CHECK(contains(out, "COMMUNICATION    n=20 "));
+  CHECK(contains(out, "PASS (total)     n=20 "));
+  CHECK(contains(out, "=== END PROFILE ===\r\n"));
+  CHECK(!massageController->getServiceConsole()->isProfiling());
+
+  return host_test::result();
+}
@@ -0,0 +1,65 @@
+/**
+ * Host build smoke test: the real setup() / loop() run on the stub core,
+ * timer interrupts follow the virtual clock, a frame from the app
+ * reaches the motor pins, and state telemetry stays off until negotiated.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+#include "PinDefinitions.h"
+#include <string>
+
+namespace {
+
+// Number of CMD_STATE frames the board sent to the app since the last call
+int takeStateFrames() {
+  int count = 0;
+  for (const reference::Bytes& body : reference::decodeHexStream(mySerial2.hostTakeOutput())) {
+    count += (body[2] == CommunicationManager::CMD_STATE);
+  }
+  return count;
+}
+
+}  // namespace
+
+int main() {
+  host_test::boot();
+  host::setInput(LMT_UP_PIN, HIGH);
+  host::setInput(LMT_DOWN_PIN, LOW);
+  std::vector<uint8_t> boot = mySerial.hostTakeOutput();
+  CHECK(std::string(boot.begin(), boot.end()).find("System started successfully") != std::string::npos);
+  CHECK(mySerial2.hostIsOpen());
+
+  // TIM2 drives the 10 ms master tick from the virtual clock
+  TimerManager* timer = massageController->getTimerManager();
+  unsigned long ticks = timer->getMasterTicks();
+  host_test::runFor(1000);
+  CHECK_EQ(timer->getMasterTicks() - ticks, 100);
+
+  // GO HOME runs after the 2 s startup delay
+  host_test::runFor(5000);
+
+  // AUTO ON from the app starts motors within a second
+  host::clearPinEvents();
+  reference::Bytes frame = reference::hexFrame(reference::command(0x70, 0xC3, 0x10, 0xF0));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  host_test::runFor(1000);
+  bool motorOn = false;
+  for (const host::PinEvent& event : host::pinEvents()) {
+    if (event.value != LOW && (event.pin == RL3_PWM_PIN || event.pin == FETT_PWM_PIN || event.pin == FETK_PWM_PIN)) {
+      motorOn = true;
+    }
+  }
+  CHECK(motorOn);
+  CHECK_EQ(mySerial2.hostRxOverruns(), 0);
+  CHECK_EQ(takeStateFrames(), 0);
+
+  // LINK_OPT_TELEMETRY on: the current state goes out at once
+  frame = reference::hexFrame(reference::command(0x70, 0x32, CommunicationManager::CMD_LINK_CONFIG,
+                                                 CommunicationManager::LINK_OPT_TELEMETRY, 0x01));
+  mySerial2.hostTransmit(frame.data(), frame.size());
+  host_test::runFor(300);
+  CHECK_EQ(takeStateFrames(), 1);
+
+  return host_test::result();
+}
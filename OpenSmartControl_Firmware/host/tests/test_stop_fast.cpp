@@ -0,0 +1,119 @@
+/**
+ * Stop fast path: only for frames deduplication accepts, and ahead of the queue
+ *
+ * With SEQUENCE_WINDOW, a retransmitted or stale AUTO OFF arriving after a
+ * new AUTO ON must leave the program and its motors alone. A RECLINE RELEASE
+ * queued behind another command stops RL1 before that command runs.
+ */
+#include "HostTest.h"
+#include "ReferenceFrames.h"
+#include "MassageController.h"
+#include "SequenceController.h"
+
+namespace {
+
+typedef CommunicationManager CM;
+typedef LatencyProbe LP;
+
+reference::Bytes frame(uint8_t sequence, uint8_t cmd, uint8_t data1, uint8_t data2 = 0) {
+  return reference::hexFrame(reference::command(0x70, sequence, cmd, data1, data2));
+}
+
+void send(uint8_t sequence, uint8_t cmd, uint8_t data1, uint8_t data2 = 0) {
+  reference::Bytes bytes = frame(sequence, cmd, data1, data2);
+  mySerial2.hostTransmit(bytes.data(), bytes.size());
+  host_test::runFor(100);
+}
+
+// Kneading / compression output changes since the last clearPinEvents()
+int autoMotorEvents() {
+  int count = 0;
+  for (const host::PinEvent& event : host::pinEvents()) {
+    if (event.pin == FETT_PWM_PIN || event.pin == FETK_PWM_PIN) count++;
+  }
+  return count;
+}
+
+uint8_t commandSlot(uint8_t command) {
+  for (uint8_t slot = 0; slot < CM::COMMAND_COUNT; slot++) {
+    if (CM::COMMAND_TABLE[slot].command == command) return slot;
+  }
+  return LP::MAX_SLOTS;
+}
+
+}  // namespace
+
+int main() {
+  host_test::bootToReady();
+  CM* comm = massageController->getCommunicationManager();
+  SequenceController* seq = massageController->getSequenceController();
+  LP* probe = comm->getLatencyProbe();
+  if (!CHECK(probe != nullptr)) return host_test::result();
+
+  send(0x00, CM::CMD_LINK_CONFIG, CM::LINK_OPT_SEQUENCE, CM::SEQUENCE_WINDOW);
+  CHECK_EQ(comm->getSequenceMode(), CM::SEQUENCE_WINDOW);
+
+  // AUTO ON, AUTO OFF (fast path), AUTO ON again
+  send(0x01, CM::CMD_AUTO, CM::DATA_ON);
+  host_test::runFor(3000);
+  CHECK(seq->isAutoModeActive());
+  send(0x02, CM::CMD_AUTO, CM::DATA_OFF);
+  CHECK(!seq->isAutoModeActive());
+  CHECK_EQ(comm->getFastStops(), 1);
+  host_test::runFor(8000);  // GO HOME again before AUTO is accepted
+  CHECK(seq->getHomeRun());
+  send(0x03, CM::CMD_AUTO, CM::DATA_ON);
+  host_test::runFor(3000);
+  CHECK(seq->isAutoModeActive());
+
+  // The app's retransmit of the old OFF, then one from before the window
+  const uint8_t lateOff[] = { 0x02, (uint8_t)(0x03 - SequenceWindow::WINDOW_SIZE) };
+  for (uint8_t sequence : lateOff) {
+    host::clearPinEvents();
+    send(sequence, CM::CMD_AUTO, CM::DATA_OFF);
+    CHECK_EQ(autoMotorEvents(), 0);
+    CHECK(seq->isAutoModeActive());
+    CHECK_EQ(comm->getFastStops(), 1);
+  }
+  send(0x04, CM::CMD_AUTO, CM::DATA_OFF);
+  CHECK(!seq->isAutoModeActive());
+  CHECK_EQ(comm->getFastStops(), 2);
+
+  // RECLINE held; a FORWARD PUSH and the RECLINE RELEASE land in one busy
+  // loop pass. The RELEASE came second but RL1 stops before the FORWARD
+  // handler runs; its own handler follows.
+  send(0x05, CM::CMD_RECLINE, CM::DATA_ON);
+  CHECK(host::pinLevel(RL1_PWM_PIN) != LOW);
+  CHECK(comm->requestLatencyReport(true));
+  host::clearPinEvents();
+  reference::Bytes burst = frame(0x06, CM::CMD_FORWARD, CM::DATA_ON);
+  reference::Bytes release = frame(0x07, CM::CMD_RECLINE, CM::DATA_OFF);
+  burst.insert(burst.end(), release.begin(), release.end());
+  mySerial2.hostTransmit(burst.data(), burst.size());
+  host_test::runFor(40, 40000);
+  host_test::runFor(100);
+  CHECK(host::pinLevel(RL1_PWM_PIN) == LOW);
+  CHECK(host::pinLevel(RL2_PWM_PIN) != LOW);
+  CHECK_EQ(comm->getFastStops(), 3);
+
+  int rl1Off = -1;
+  int rl2On = -1;
+  const std::vector<host::PinEvent>& events = host::pinEvents();
+  for (size_t i = 0; i < events.size(); i++) {
+    if (events[i].pin == RL1_PWM_PIN && events[i].value == LOW && rl1Off < 0) rl1Off = (int)i;
+    if (events[i].pin == RL2_PWM_PIN && events[i].value != LOW && rl2On < 0) rl2On = (int)i;
+  }
+  CHECK(rl1Off >= 0 && rl2On > rl1Off);
+
+  // The virtual clock stands still while handlers run, so STOP equals the
+  // RELEASE's TOTAL here; on the board TOTAL adds the FORWARD handler
+  const LP::Histogram& stop = probe->getStage(LP::STAGE_STOP);
+  const LP::Histogram& recline = probe->getCommand(commandSlot(CM::CMD_RECLINE));
+  printf("RECLINE RELEASE behind FORWARD PUSH: STOP %lu us, TOTAL %lu us\n", (unsigned long)stop.maxUs,
+         (unsigned long)recline.maxUs);
+  CHECK_EQ(stop.count, 1);
+  CHECK_EQ(recline.count, 1);
+  CHECK(stop.maxUs <= recline.maxUs);
+
+  return host_test::result();
+}
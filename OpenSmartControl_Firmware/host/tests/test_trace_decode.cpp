@@ -0,0 +1,67 @@
+/**
+ * TRACE records from the running firmware decode back to text
+ *
+ * The debug UART output of a boot (the Hm10Manager trace of the 115200
+ * probe among text lines) plus one TRACE with known arguments goes through
+ * tools/trace_decode, with this executable as the .elf. The host build links
+ * without PIE so the tokens are .trace_fmt offsets, as on the board.
+ */
+#include "HostTest.h"
+#include "DebugLog.h"
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+std::string decode(const std::vector<uint8_t>& capture) {
+  char self[4096];
+  ssize_t length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+  if (length <= 0) return "";
+  self[length] = '\0';
+
+  std::string path = std::string(WORK_DIR) + "/trace_capture.bin";
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) return "";
+  fwrite(capture.data(), 1, capture.size(), file);
+  fclose(file);
+
+  std::string command = std::string(TRACE_DECODE) + " " + self + " " + path;
+  FILE* decoder = popen(command.c_str(), "r");
+  if (!decoder) return "";
+  std::string text;
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), decoder)) > 0) {
+    text.append(chunk, n);
+  }
+  CHECK_EQ(pclose(decoder), 0);
+  return text;
+}
+
+}  // namespace
+
+int main() {
+  host_test::boot();
+  host::setInput(PB4, HIGH);  // LMT_UP_PIN
+  host::setInput(PB3, LOW);   // LMT_DOWN_PIN
+  host_test::runFor(6000);
+  TRACE(MODULE_SYSTEM, "trace test %d %u 0x%04X %c", -5, 42u, 0xBEEF, 'k');
+  host_test::runFor(100);
+
+  std::vector<uint8_t> capture = mySerial.hostTakeOutput();
+  size_t records = 0;
+  for (uint8_t c : capture) {
+    if (c == DebugLog::TRACE_MARKER) records++;
+  }
+  CHECK(records > 1);
+
+  std::string text = decode(capture);
+  printf("%zu TRACE records, %zu bytes of text decoded\n", records, text.size());
+  CHECK(text.find("trace test -5 42 0xBEEF k\r\n") != std::string::npos);
+  CHECK(text.find("\nHM10: no reply at 115200 baud, resetting to probe\r\n") != std::string::npos);
+  CHECK(text.find("STARTUP: Stabilization delay completed") != std::string::npos);
+  CHECK(text.find("<trace:") == std::string::npos);
+  CHECK(text.find((char)DebugLog::TRACE_MARKER) == std::string::npos);
+
+  return host_test::result();
+}
@@ -0,0 +1,320 @@
+/**
+ * ble_capture - extract and decode a BLE capture journal from a debug log
+ *
+ * A firmware built with -DBLE_CAPTURE=1 journals every byte received from the
+ * HM10 and prints the journal on the debug UART on CMD_BLE_CAPTURE (0xE5):
+ *   === BLE CAPTURE v1 base=<tick> entries=<n> overwritten=<n> missed=<n> ===
+ *   CAP <entry><entry>...       (up to 16 entries, 4 hex digits each)
+ *   === END CAPTURE ===
+ * Entry bit 15 = 0: received byte in bits 0..7, ticks since the previous
+ * entry in bits 8..14. Bit 15 = 1: ticks 0..0x7FFF to add, no byte.
+ * One tick is 10 ms (TimerManager).
+ *
+ * The tool prints the received frames with their arrival time and can write
+ *   - the journal as a binary file ("BLEC", version, base tick LE32,
+ *     entry count LE32, entries LE16) for a replay harness, and
+ *   - the raw byte stream, to feed a board or a bench module again.
+ * The last dump in the log is used.
+ *
+ * Build:  g++ -std=c++17 -O2 -o ble_capture ble_capture.cpp
+ * Usage:  ble_capture [-j journal.bin] [-r raw.bin] [debug.log]   (stdin when no log)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const uint16_t GAP_FLAG = 0x8000;
+static const uint16_t MAX_GAP = 0x7FFF;
+static const uint8_t MAX_DELTA = 0x7F;
+static const uint32_t MS_PER_TICK = 10;
+
+static const uint8_t SOH = 0x01;
+static const uint8_t STX = 0x02;
+static const uint8_t ETX = 0x03;
+static const uint8_t DLE = 0x10;
+static const uint8_t ESCAPE_XOR = 0x20;
+static const size_t BODY_SIZE = 7;
+static const size_t MAX_BODY_SIZE = 19;
+
+/**
+ * Journal as printed by the firmware
+ */
+struct Journal {
+  uint32_t baseTick = 0;
+  unsigned long overwritten = 0;
+  unsigned long missed = 0;
+  size_t expected = 0;
+  std::vector<uint16_t> entries;
+};
+
+/**
+ * Received byte with its absolute tick
+ */
+struct TimedByte {
+  uint32_t tick;
+  uint8_t value;
+};
+
+/**
+ * Find the last complete dump in the log (TRACE records may surround it)
+ */
+static bool parseLog(FILE* input, Journal& journal) {
+  std::string text;
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), input)) > 0) {
+    text.append(chunk, n);
+  }
+
+  bool found = false;
+  bool inDump = false;
+  Journal current;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string::npos) end = text.size();
+    std::string line = text.substr(pos, end - pos);
+    pos = end + 1;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+
+    size_t header = line.find("=== BLE CAPTURE v1 ");
+    if (header != std::string::npos) {
+      current = Journal();
+      unsigned long base = 0, entries = 0;
+      if (sscanf(line.c_str() + header, "=== BLE CAPTURE v1 base=%lu entries=%lu overwritten=%lu missed=%lu",
+                 &base, &entries, &current.overwritten, &current.missed) == 4) {
+        current.baseTick = (uint32_t)base;
+        current.expected = entries;
+        inDump = true;
+      }
+      continue;
+    }
+    if (!inDump) continue;
+
+    if (line.find("=== END CAPTURE ===") != std::string::npos) {
+      if (current.entries.size() != current.expected) {
+        fprintf(stderr, "ble_capture: dump has %zu of %zu entries, skipped\n", current.entries.size(), current.expected);
+      } else {
+        journal = current;
+        found = true;
+      }
+      inDump = false;
+      continue;
+    }
+
+    size_t cap = line.find("CAP ");
+    if (cap == std::string::npos) continue;
+    const char* digits = line.c_str() + cap + 4;
+    size_t len = strlen(digits);
+    for (size_t i = 0; i + 4 <= len; i += 4) {
+      char word[5] = { digits[i], digits[i + 1], digits[i + 2], digits[i + 3], 0 };
+      char* stop;
+      unsigned long entry = strtoul(word, &stop, 16);
+      if (*stop != 0) break;
+      current.entries.push_back((uint16_t)entry);
+    }
+  }
+  return found;
+}
+
+/**
+ * Expand the journal to bytes with absolute ticks
+ */
+static std::vector<TimedByte> expand(const Journal& journal) {
+  std::vector<TimedByte> bytes;
+  uint32_t tick = journal.baseTick;
+  for (uint16_t entry : journal.entries) {
+    if (entry & GAP_FLAG) {
+      tick += entry & MAX_GAP;
+    } else {
+      tick += (entry >> 8) & MAX_DELTA;
+      bytes.push_back({ tick, (uint8_t)(entry & 0xFF) });
+    }
+  }
+  return bytes;
+}
+
+/**
+ * Firmware checksum: byte sum, carries folded, one's complement + 0x10
+ */
+static uint8_t checksum(const std::vector<uint8_t>& body) {
+  uint16_t sum = 0;
+  for (size_t i = 0; i + 1 < body.size(); i++) {
+    sum += body[i];
+  }
+  while (sum >> 8) {
+    sum = (sum & 0xFF) + (sum >> 8);
+  }
+  return ((~sum) + 0x10) & 0xFF;
+}
+
+static int hexNibble(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+/**
+ * Decode one frame body (between the start byte and ETX); empty if malformed
+ */
+static std::vector<uint8_t> decodeBody(uint8_t start, const std::vector<uint8_t>& raw) {
+  std::vector<uint8_t> body;
+  if (start == STX) {
+    if (raw.size() % 2 != 0) return {};
+    for (size_t i = 0; i < raw.size(); i += 2) {
+      int high = hexNibble(raw[i]);
+      int low = hexNibble(raw[i + 1]);
+      if (high < 0 || low < 0) return {};
+      body.push_back((uint8_t)((high << 4) | low));
+    }
+  } else {
+    for (size_t i = 0; i < raw.size(); i++) {
+      if (raw[i] == DLE) {
+        if (++i == raw.size()) return {};
+        body.push_back(raw[i] ^ ESCAPE_XOR);
+      } else {
+        body.push_back(raw[i]);
+      }
+    }
+  }
+  if (body.size() < BODY_SIZE || body.size() > MAX_BODY_SIZE) return {};
+  return body;
+}
+
+/**
+ * Print one line per frame (and per run of bytes outside any frame)
+ */
+static void printTimeline(const std::vector<TimedByte>& bytes, uint32_t baseTick) {
+  size_t frames = 0, errors = 0, stray = 0;
+  size_t i = 0;
+  while (i < bytes.size()) {
+    uint8_t start = bytes[i].value;
+    uint32_t startTick = bytes[i].tick;
+    double ms = (double)(startTick - baseTick) * MS_PER_TICK;
+
+    if (start != STX && start != SOH) {
+      // Bytes outside any frame (noise, module status strings)
+      size_t j = i;
+      while (j < bytes.size() && bytes[j].value != STX && bytes[j].value != SOH) j++;
+      printf("%10.0f ms  STRAY   %zu byte(s):", ms, j - i);
+      for (size_t k = i; k < j && k < i + 16; k++) printf(" %02X", bytes[k].value);
+      printf("%s\n", (j - i > 16) ? " ..." : "");
+      stray += j - i;
+      i = j;
+      continue;
+    }
+
+    std::vector<uint8_t> raw;
+    size_t j = i + 1;
+    while (j < bytes.size() && bytes[j].value != ETX && bytes[j].value != STX && bytes[j].value != SOH) {
+      raw.push_back(bytes[j].value);
+      j++;
+    }
+    bool closed = (j < bytes.size() && bytes[j].value == ETX);
+    const char* kind = (start == STX) ? "HEX" : "BINARY";
+    std::vector<uint8_t> body = closed ? decodeBody(start, raw) : std::vector<uint8_t>();
+
+    if (body.empty()) {
+      printf("%10.0f ms  %-7s %s (%zu body bytes)\n", ms, kind, closed ? "MALFORMED" : "UNTERMINATED", raw.size());
+      errors++;
+    } else {
+      uint32_t span = (bytes[j].tick - startTick) * MS_PER_TICK;
+      bool valid = (checksum(body) == body.back());
+      printf("%10.0f ms  %-7s dev=%02X seq=%02X cmd=%02X data=", ms, kind, body[0], body[1], body[2]);
+      for (size_t k = 3; k + 1 < body.size(); k++) printf("%02X", body[k]);
+      printf("%s  (+%u ms)\n", valid ? "" : "  BAD CHECKSUM", span);
+      if (valid) {
+        frames++;
+      } else {
+        errors++;
+      }
+    }
+    i = closed ? j + 1 : j;
+  }
+  printf("--- %zu frame(s), %zu bad, %zu stray byte(s)\n", frames, errors, stray);
+}
+
+/**
+ * Write the journal in binary form (little-endian)
+ */
+static bool writeJournal(const char* path, const Journal& journal) {
+  FILE* file = fopen(path, "wb");
+  if (!file) return false;
+  uint8_t header[13] = { 'B', 'L', 'E', 'C', 1 };
+  uint32_t count = (uint32_t)journal.entries.size();
+  for (int i = 0; i < 4; i++) {
+    header[5 + i] = (uint8_t)(journal.baseTick >> (8 * i));
+    header[9 + i] = (uint8_t)(count >> (8 * i));
+  }
+  fwrite(header, 1, sizeof(header), file);
+  for (uint16_t entry : journal.entries) {
+    uint8_t le[2] = { (uint8_t)(entry & 0xFF), (uint8_t)(entry >> 8) };
+    fwrite(le, 1, 2, file);
+  }
+  return fclose(file) == 0;
+}
+
+/**
+ * Write the received bytes without timing
+ */
+static bool writeRaw(const char* path, const std::vector<TimedByte>& bytes) {
+  FILE* file = fopen(path, "wb");
+  if (!file) return false;
+  for (const TimedByte& b : bytes) {
+    fputc(b.value, file);
+  }
+  return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+  const char* journalPath = nullptr;
+  const char* rawPath = nullptr;
+  const char* logPath = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      journalPath = argv[++i];
+    } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      rawPath = argv[++i];
+    } else if (argv[i][0] != '-' && !logPath) {
+      logPath = argv[i];
+    } else {
+      fprintf(stderr, "usage: ble_capture [-j journal.bin] [-r raw.bin] [debug.log]\n");
+      return 2;
+    }
+  }
+
+  FILE* input = logPath ? fopen(logPath, "rb") : stdin;
+  if (!input) {
+    fprintf(stderr, "ble_capture: cannot open %s\n", logPath);
+    return 1;
+  }
+  Journal journal;
+  bool found = parseLog(input, journal);
+  if (logPath) fclose(input);
+  if (!found) {
+    fprintf(stderr, "ble_capture: no complete capture dump found\n");
+    return 1;
+  }
+
+  std::vector<TimedByte> bytes = expand(journal);
+  printf("--- capture: %zu entries, %zu bytes, start tick %lu", journal.entries.size(), bytes.size(), (unsigned long)journal.baseTick);
+  if (journal.overwritten) printf(", %lu older entries overwritten", journal.overwritten);
+  if (journal.missed) printf(", %lu bytes missed during a dump", journal.missed);
+  printf("\n");
+  printTimeline(bytes, journal.baseTick);
+
+  if (journalPath && !writeJournal(journalPath, journal)) {
+    fprintf(stderr, "ble_capture: cannot write %s\n", journalPath);
+    return 1;
+  }
+  if (rawPath && !writeRaw(rawPath, bytes)) {
+    fprintf(stderr, "ble_capture: cannot write %s\n", rawPath);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,644 @@
+/**
+ * fw_package - build a firmware update package for CMD_FW_UPDATE (0xE7)
+ *
+ * Reads the new application image from an Intel HEX file and writes the
+ * package streamed by the app (FirmwareUpdater, FIRMWARE_UPDATE builds):
+ *   "OSFW", version 1, format, 2 reserved bytes, image size, image CRC32,
+ *   base size, base CRC32 (big-endian), then the payload:
+ *   - raw:   the image
+ *   - lz:    ops with back references into the image being written
+ *   - delta: ops that may also copy blocks of the running image (-b), so
+ *            code that only moved between releases costs a few bytes
+ * Op byte: kind in bits 7..6, length in bits 5..0 (63 = add a LEB128 value);
+ *   literal (0): length + 1 bytes follow
+ *   match (1):   length + 3 bytes from LEB128 (distance - 1) back
+ *   base (2):    length + 3 bytes from the base at cursor + zigzag LEB128 delta
+ *
+ * The package is decoded again into a model of the STM32 flash (page erase
+ * to 0xFF, halfword programming of erased cells only, 64-byte rows as on the
+ * board) and checked against the image before it is written. The tool then
+ * prints the package sizes and the expected update time.
+ *
+ * Build:  g++ -std=c++17 -O2 -o fw_package fw_package.cpp
+ * Usage:  fw_package [-b running.hex] [-f raw|lz|delta] [-o package.bin] new.hex
+ *         (default format: delta with -b, lz otherwise)
+ *         fw_package --layout   (prints the constants shared with the firmware;
+ *                                host/tests/test_firmware_update compares them)
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const uint32_t APP_ADDRESS = 0x08001000;
+static const uint32_t PAGE_SIZE = 1024;
+static const uint32_t REGION_SIZE = 61 * PAGE_SIZE;
+
+static const uint8_t FORMAT_RAW = 0;
+static const uint8_t FORMAT_LZ = 1;
+static const uint8_t FORMAT_DELTA = 2;
+static const size_t HEADER_SIZE = 24;
+
+static const uint8_t KIND_LITERAL = 0;
+static const uint8_t KIND_MATCH = 1;
+static const uint8_t KIND_BASE = 2;
+static const uint32_t LENGTH_EXTENDED = 63;
+static const uint32_t MIN_MATCH = 3;
+static const uint32_t MAX_COPY = 512;
+static const uint32_t ROW_SIZE = 64;
+
+static const int HASH_BITS = 15;
+static const int MAX_CHAIN = 256;
+
+// Link framing (CommunicationManager / PacketCodec)
+static const size_t MAX_CHUNK = 9;
+
+// STM32F103 flash timing (datasheet typical values)
+static const double PAGE_ERASE_MS = 20.0;
+static const double HALFWORD_PROGRAM_US = 52.5;
+
+/**
+ * CRC-32 (IEEE 802.3), as FirmwareUpdater::crc32()
+ */
+static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length) {
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+  }
+  return ~crc;
+}
+
+/**
+ * Frame checksum, as PacketCodec::checksum()
+ */
+static uint8_t checksum(const uint8_t* data, size_t length) {
+  uint16_t sum = 0;
+  for (size_t i = 0; i < length; i++) sum += data[i];
+  while (sum >> 8) sum = (sum & 0xFF) + (sum >> 8);
+  return (uint8_t)((~sum) + 0x10);
+}
+
+static bool needsEscape(uint8_t b) {
+  return b == 0x01 || b == 0x02 || b == 0x03 || b == 0x10;
+}
+
+static void putBE32(std::vector<uint8_t>& out, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(value >> shift));
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+  while (value >= 0x80) {
+    out.push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back((uint8_t)value);
+}
+
+static size_t varintSize(uint32_t value) {
+  size_t n = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    n++;
+  }
+  return n;
+}
+
+static uint32_t zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int hexNibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+/**
+ * Load an Intel HEX file as one image from its lowest address (gaps 0xFF)
+ */
+static bool readHex(const char* path, std::vector<uint8_t>& image, uint32_t& start) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    fprintf(stderr, "fw_package: cannot open %s\n", path);
+    return false;
+  }
+
+  std::vector<std::pair<uint32_t, uint8_t>> bytes;
+  uint32_t upper = 0;
+  char line[600];
+  int lineNumber = 0;
+  bool ok = true;
+  bool ended = false;
+  while (ok && !ended && fgets(line, sizeof(line), file)) {
+    lineNumber++;
+    size_t n = strcspn(line, "\r\n");
+    if (n == 0) continue;
+    std::vector<uint8_t> record;
+    ok = line[0] == ':' && (n & 1) == 1;
+    for (size_t i = 1; ok && i + 1 < n; i += 2) {
+      int hi = hexNibble(line[i]);
+      int lo = hexNibble(line[i + 1]);
+      ok = hi >= 0 && lo >= 0;
+      record.push_back((uint8_t)((hi << 4) | lo));
+    }
+    ok = ok && record.size() >= 5 && record.size() == (size_t)record[0] + 5;
+    if (ok) {
+      uint8_t sum = 0;
+      for (uint8_t b : record) sum += b;
+      ok = sum == 0;
+    }
+    if (!ok) {
+      fprintf(stderr, "fw_package: %s:%d: bad record\n", path, lineNumber);
+      break;
+    }
+
+    uint8_t count = record[0];
+    uint32_t offset = ((uint32_t)record[1] << 8) | record[2];
+    switch (record[3]) {
+      case 0x00:
+        for (uint8_t i = 0; i < count; i++) bytes.push_back({ upper + offset + i, record[4 + i] });
+        break;
+      case 0x01:
+        ended = true;
+        break;
+      case 0x02:
+        upper = (((uint32_t)record[4] << 8) | record[5]) << 4;
+        break;
+      case 0x04:
+        upper = (((uint32_t)record[4] << 8) | record[5]) << 16;
+        break;
+      default:  // 0x03 / 0x05 start address: not part of the image
+        break;
+    }
+  }
+  fclose(file);
+  if (!ok) return false;
+  if (bytes.empty()) {
+    fprintf(stderr, "fw_package: %s: no data\n", path);
+    return false;
+  }
+
+  uint32_t low = UINT32_MAX;
+  uint32_t high = 0;
+  for (const auto& b : bytes) {
+    if (b.first < low) low = b.first;
+    if (b.first > high) high = b.first;
+  }
+  if (high - low + 1 > REGION_SIZE) {
+    fprintf(stderr, "fw_package: %s: image of %u bytes does not fit the %u byte region\n", path, high - low + 1, REGION_SIZE);
+    return false;
+  }
+  start = low;
+  image.assign(high - low + 1, 0xFF);
+  for (const auto& b : bytes) image[b.first - low] = b.second;
+  return true;
+}
+
+/**
+ * Hash chains over a buffer (3-byte keys)
+ */
+struct MatchIndex {
+  const std::vector<uint8_t>* data = nullptr;
+  std::vector<int32_t> head;
+  std::vector<int32_t> prev;
+
+  static uint32_t hash(const uint8_t* p) {
+    return ((p[0] << 16 | p[1] << 8 | p[2]) * 2654435761u) >> (32 - HASH_BITS);
+  }
+
+  void reset(const std::vector<uint8_t>* buffer) {
+    data = buffer;
+    head.assign(1 << HASH_BITS, -1);
+    prev.assign(buffer->size(), -1);
+  }
+
+  void insert(size_t pos) {
+    if (pos + MIN_MATCH > data->size()) return;
+    uint32_t h = hash(data->data() + pos);
+    prev[pos] = head[h];
+    head[h] = (int32_t)pos;
+  }
+};
+
+/**
+ * Candidate copy: length and encoded size of its op
+ */
+struct Copy {
+  uint8_t kind = KIND_LITERAL;
+  uint32_t length = 0;
+  uint32_t source = 0;
+  size_t cost = 0;
+};
+
+static size_t copyCost(uint32_t length, uint32_t argument) {
+  uint32_t field = length - MIN_MATCH;
+  return 1 + (field >= LENGTH_EXTENDED ? varintSize(field - LENGTH_EXTENDED) : 0) + varintSize(argument);
+}
+
+static uint32_t matchLength(const uint8_t* a, const uint8_t* b, uint32_t limit) {
+  uint32_t n = 0;
+  while (n < limit && a[n] == b[n]) n++;
+  return n;
+}
+
+/**
+ * Greedy LZ / delta encoder (lazy by one byte)
+ */
+class Encoder {
+public:
+  Encoder(const std::vector<uint8_t>& target, const std::vector<uint8_t>* running)
+    : image(target), base(running), basePos(0) {
+    own.reset(&image);
+    if (base) {
+      baseIndex.reset(base);
+      for (size_t i = 0; i < base->size(); i++) baseIndex.insert(i);
+    }
+  }
+
+  std::vector<uint8_t> encode() {
+    size_t pos = 0;
+    size_t inserted = 0;
+    while (pos < image.size()) {
+      while (inserted < pos) own.insert(inserted++);
+      Copy copy = best(pos);
+      if (copy.length && pos + 1 < image.size()) {
+        own.insert(inserted++);
+        Copy next = best(pos + 1);
+        if (next.length && gain(next) > gain(copy) + 1) copy.length = 0;  // Literal now, better copy next
+      }
+      if (!copy.length) {
+        literals.push_back(image[pos++]);
+        continue;
+      }
+      flushLiterals();
+      emitCopy(copy, pos);
+      pos += copy.length;
+    }
+    flushLiterals();
+    return out;
+  }
+
+private:
+  const std::vector<uint8_t>& image;
+  const std::vector<uint8_t>* base;
+  MatchIndex own;
+  MatchIndex baseIndex;
+  uint32_t basePos;
+  std::vector<uint8_t> literals;
+  std::vector<uint8_t> out;
+
+  static long gain(const Copy& copy) {
+    return (long)copy.length - (long)copy.cost;
+  }
+
+  Copy best(size_t pos) const {
+    Copy best;
+    uint32_t limit = (uint32_t)std::min<size_t>(MAX_COPY, image.size() - pos);
+    if (limit < MIN_MATCH) return best;
+    const uint8_t* here = image.data() + pos;
+
+    auto consider = [&](uint8_t kind, uint32_t source, uint32_t length, uint32_t argument) {
+      if (length < MIN_MATCH) return;
+      Copy c;
+      c.kind = kind;
+      c.length = length;
+      c.source = source;
+      c.cost = copyCost(length, argument);
+      if (gain(c) > gain(best)) best = c;
+    };
+
+    int chain = 0;
+    for (int32_t cand = own.head[MatchIndex::hash(here)]; cand >= 0 && chain < MAX_CHAIN; cand = own.prev[cand], chain++) {
+      if ((size_t)cand >= pos) continue;
+      consider(KIND_MATCH, (uint32_t)cand, matchLength(image.data() + cand, here, limit), (uint32_t)(pos - cand - 1));
+    }
+
+    if (base) {
+      auto considerBase = [&](uint32_t source) {
+        if (source + MIN_MATCH > base->size()) return;
+        uint32_t baseLimit = (uint32_t)std::min<size_t>(limit, base->size() - source);
+        consider(KIND_BASE, source, matchLength(base->data() + source, here, baseLimit), zigzag((int32_t)(source - basePos)));
+      };
+      considerBase(basePos);                // Code that follows the previous block
+      if (pos < base->size()) considerBase((uint32_t)pos);
+      chain = 0;
+      for (int32_t cand = baseIndex.head[MatchIndex::hash(here)]; cand >= 0 && chain < MAX_CHAIN; cand = baseIndex.prev[cand], chain++) {
+        considerBase((uint32_t)cand);
+      }
+    }
+    return gain(best) > 0 ? best : Copy();
+  }
+
+  void putOp(uint8_t kind, uint32_t field) {
+    out.push_back((uint8_t)((kind << 6) | std::min(field, LENGTH_EXTENDED)));
+    if (field >= LENGTH_EXTENDED) putVarint(out, field - LENGTH_EXTENDED);
+  }
+
+  void flushLiterals() {
+    if (literals.empty()) return;
+    putOp(KIND_LITERAL, (uint32_t)literals.size() - 1);
+    out.insert(out.end(), literals.begin(), literals.end());
+    literals.clear();
+  }
+
+  void emitCopy(const Copy& copy, size_t pos) {
+    putOp(copy.kind, copy.length - MIN_MATCH);
+    if (copy.kind == KIND_MATCH) {
+      putVarint(out, (uint32_t)(pos - copy.source - 1));
+    } else {
+      putVarint(out, zigzag((int32_t)(copy.source - basePos)));
+      basePos = copy.source + copy.length;
+    }
+  }
+};
+
+/**
+ * STM32 flash model: erase sets 0xFF, programming needs erased halfwords
+ */
+struct FlashModel {
+  std::vector<uint8_t> cells;
+  std::vector<bool> programmed;  // Per halfword
+  unsigned long programCalls = 0;
+
+  explicit FlashModel(size_t size) : cells(size, 0x00), programmed(size / 2, true) {}
+
+  void erase() {
+    std::fill(cells.begin(), cells.end(), 0xFF);
+    std::fill(programmed.begin(), programmed.end(), false);
+  }
+
+  bool program(uint32_t offset, const uint8_t* data, size_t length) {
+    if ((offset & 1) || (length & 1) || offset + length > cells.size()) return false;
+    programCalls++;
+    for (size_t i = 0; i < length; i += 2) {
+      if (programmed[(offset + i) / 2]) return false;
+      programmed[(offset + i) / 2] = true;
+      cells[offset + i] = data[i];
+      cells[offset + i + 1] = data[i + 1];
+    }
+    return true;
+  }
+};
+
+/**
+ * Decode a package into the flash model the way the board does (64-byte rows)
+ */
+static bool decodePackage(const std::vector<uint8_t>& package, const std::vector<uint8_t>& base, FlashModel& flash, std::string& error) {
+  const uint8_t* p = package.data();
+  uint32_t imageSize = (p[8] << 24) | (p[9] << 16) | (p[10] << 8) | p[11];
+  uint8_t format = p[5];
+  size_t in = HEADER_SIZE;
+  uint32_t outPos = 0;
+  uint32_t basePos = 0;
+  uint8_t row[ROW_SIZE + 1];
+  uint32_t rowFill = 0;
+  uint32_t rowBase = 0;
+
+  auto flush = [&]() {
+    if (rowFill == 0) return true;
+    uint32_t length = rowFill;
+    if (length & 1) row[length++] = 0xFF;
+    bool ok = flash.program(rowBase, row, length);
+    rowBase += rowFill;
+    rowFill = 0;
+    return ok;
+  };
+  auto put = [&](uint8_t b) {
+    if (outPos >= imageSize) return false;
+    row[rowFill++] = b;
+    outPos++;
+    return rowFill < ROW_SIZE || flush();
+  };
+  auto output = [&](uint32_t position) {
+    return position >= rowBase ? row[position - rowBase] : flash.cells[position];
+  };
+  auto varint = [&](uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 28; shift += 7) {
+      if (in >= package.size()) return false;
+      uint8_t b = package[in++];
+      value |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) return true;
+    }
+    return false;
+  };
+
+  if (format == FORMAT_RAW) {
+    while (in < package.size()) {
+      if (!put(package[in++])) break;
+    }
+  }
+  while (format != FORMAT_RAW && in < package.size()) {
+    uint8_t op = package[in++];
+    uint8_t kind = op >> 6;
+    uint32_t length = op & LENGTH_EXTENDED;
+    uint32_t extra = 0;
+    if (length == LENGTH_EXTENDED && !varint(extra)) break;
+    length += extra;
+
+    if (kind == KIND_LITERAL) {
+      length += 1;
+      if (in + length > package.size()) break;
+      bool ok = true;
+      for (uint32_t i = 0; ok && i < length; i++) ok = put(package[in++]);
+      if (!ok) break;
+      continue;
+    }
+    length += MIN_MATCH;
+    uint32_t argument;
+    if (length > MAX_COPY || !varint(argument)) break;
+    bool ok = true;
+    if (kind == KIND_MATCH && argument + 1 <= outPos) {
+      uint32_t source = outPos - argument - 1;
+      for (uint32_t i = 0; ok && i < length; i++) ok = put(output(source + i));
+    } else if (kind == KIND_BASE && format == FORMAT_DELTA) {
+      int64_t source = (int64_t)basePos + ((int32_t)(argument >> 1) ^ -(int32_t)(argument & 1));
+      ok = source >= 0 && source + length <= (int64_t)base.size();
+      for (uint32_t i = 0; ok && i < length; i++) ok = put(base[source + i]);
+      basePos = (uint32_t)source + length;
+    } else {
+      ok = false;
+    }
+    if (!ok) break;
+  }
+
+  if (in != package.size() || outPos != imageSize) {
+    error = "decoder stopped at package byte " + std::to_string(in) + ", image byte " + std::to_string(outPos);
+    return false;
+  }
+  if (!flush()) {
+    error = "flash programming rule violated";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Header + payload
+ */
+static std::vector<uint8_t> buildPackage(uint8_t format, const std::vector<uint8_t>& image, const std::vector<uint8_t>* base) {
+  std::vector<uint8_t> package = { 'O', 'S', 'F', 'W', 1, format, 0, 0 };
+  putBE32(package, (uint32_t)image.size());
+  putBE32(package, crc32(0, image.data(), image.size()));
+  putBE32(package, (format == FORMAT_DELTA) ? (uint32_t)base->size() : 0);
+  putBE32(package, (format == FORMAT_DELTA) ? crc32(0, base->data(), base->size()) : 0);
+
+  if (format == FORMAT_RAW) {
+    package.insert(package.end(), image.begin(), image.end());
+  } else {
+    std::vector<uint8_t> payload = Encoder(image, (format == FORMAT_DELTA) ? base : nullptr).encode();
+    package.insert(package.end(), payload.begin(), payload.end());
+  }
+  return package;
+}
+
+/**
+ * Bytes on the BLE UART for the whole transfer in hex and binary framing
+ * (BEGIN, DATA chunks of MAX_CHUNK bytes, COMMIT; status replies go the
+ * other way and are not counted)
+ */
+static void wireBytes(const std::vector<uint8_t>& package, size_t& hexBytes, size_t& binaryBytes) {
+  size_t bodies[2] = { 12, 7 };  // BEGIN (extended), COMMIT (plain)
+  hexBytes = 0;
+  binaryBytes = 0;
+  for (size_t body : bodies) {
+    hexBytes += 2 + 2 * body;
+    binaryBytes += 2 + body + 1;  // ~1 escaped byte
+  }
+
+  uint8_t frame[32];
+  for (size_t offset = 0; offset < package.size(); offset += MAX_CHUNK) {
+    size_t n = std::min(MAX_CHUNK, package.size() - offset);
+    size_t len = 0;
+    frame[len++] = 0x70;
+    frame[len++] = (uint8_t)(offset / MAX_CHUNK);
+    frame[len++] = 0xE7;
+    frame[len++] = 0x02;
+    frame[len++] = (uint8_t)(offset >> 16);
+    frame[len++] = (uint8_t)(offset >> 8);
+    frame[len++] = (uint8_t)offset;
+    memcpy(frame + len, package.data() + offset, n);
+    len += n;
+    frame[len++] = 0x5A;  // CRC-16: escape rate of random data is enough here
+    frame[len++] = 0xA5;
+    frame[len] = checksum(frame, len);
+    len++;
+
+    hexBytes += 2 + 2 * len;
+    binaryBytes += 2 + len;
+    for (size_t i = 0; i < len; i++) {
+      if (needsEscape(frame[i])) binaryBytes++;
+    }
+  }
+}
+
+/**
+ * Constants that must match FirmwareUpdater.h, one "NAME value" per line
+ */
+static void printLayout() {
+  printf("APP_ADDRESS %u\n", APP_ADDRESS);
+  printf("PAGE_SIZE %u\n", PAGE_SIZE);
+  printf("REGION_SIZE %u\n", REGION_SIZE);
+  printf("HEADER_SIZE %zu\n", HEADER_SIZE);
+  printf("MIN_MATCH %u\n", MIN_MATCH);
+  printf("MAX_COPY %u\n", MAX_COPY);
+  printf("ROW_SIZE %u\n", ROW_SIZE);
+  printf("MAX_CHUNK %zu\n", MAX_CHUNK);
+}
+
+static const char* formatName(uint8_t format) {
+  return format == FORMAT_RAW ? "raw" : format == FORMAT_LZ ? "lz" : "delta";
+}
+
+int main(int argc, char** argv) {
+  const char* basePath = nullptr;
+  const char* outPath = nullptr;
+  const char* imagePath = nullptr;
+  int forced = -1;
+  if (argc == 2 && strcmp(argv[1], "--layout") == 0) {
+    printLayout();
+    return 0;
+  }
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      basePath = argv[++i];
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      const char* name = argv[++i];
+      forced = strcmp(name, "raw") == 0 ? FORMAT_RAW : strcmp(name, "lz") == 0 ? FORMAT_LZ : strcmp(name, "delta") == 0 ? FORMAT_DELTA : -2;
+    } else if (argv[i][0] != '-' && !imagePath) {
+      imagePath = argv[i];
+    } else {
+      forced = -2;
+    }
+  }
+  if (!imagePath || forced == -2 || (forced == FORMAT_DELTA && !basePath)) {
+    fprintf(stderr, "usage: fw_package [-b running.hex] [-f raw|lz|delta] [-o package.bin] new.hex\n"
+                    "       fw_package --layout\n");
+    return 2;
+  }
+
+  std::vector<uint8_t> image;
+  std::vector<uint8_t> base;
+  uint32_t imageStart;
+  uint32_t baseStart;
+  if (!readHex(imagePath, image, imageStart)) return 1;
+  if (basePath && !readHex(basePath, base, baseStart)) return 1;
+  if (imageStart != APP_ADDRESS) {
+    printf("warning: image starts at 0x%08X, the bootloader expects 0x%08X (build.flash_offset=0x1000)\n", imageStart, APP_ADDRESS);
+  }
+  if (basePath && baseStart != imageStart) {
+    printf("warning: base starts at 0x%08X, image at 0x%08X\n", baseStart, imageStart);
+  }
+
+  printf("--- image: %s, %zu bytes, CRC32 %08X\n", imagePath, image.size(), crc32(0, image.data(), image.size()));
+  printf("%-6s %8s %7s %9s %9s %9s %9s\n", "format", "package", "ratio", "hex 9600", "bin 9600", "hex 115k", "bin 115k");
+
+  uint8_t chosen = (forced >= 0) ? (uint8_t)forced : (basePath ? FORMAT_DELTA : FORMAT_LZ);
+  std::vector<uint8_t> written;
+  for (uint8_t format = FORMAT_RAW; format <= FORMAT_DELTA; format++) {
+    if (format == FORMAT_DELTA && !basePath) break;
+    std::vector<uint8_t> package = buildPackage(format, image, &base);
+
+    FlashModel flash(REGION_SIZE);
+    flash.erase();
+    std::string error;
+    if (!decodePackage(package, base, flash, error) || memcmp(flash.cells.data(), image.data(), image.size()) != 0) {
+      fprintf(stderr, "fw_package: %s package does not decode to the image (%s)\n", formatName(format), error.empty() ? "content differs" : error.c_str());
+      return 1;
+    }
+
+    size_t hexBytes;
+    size_t binaryBytes;
+    wireBytes(package, hexBytes, binaryBytes);
+    printf("%-6s %8zu %6.1f%% %8.1fs %8.1fs %8.1fs %8.1fs\n", formatName(format), package.size(), 100.0 * package.size() / image.size(),
+           hexBytes * 10.0 / 9600, binaryBytes * 10.0 / 9600, hexBytes * 10.0 / 115200, binaryBytes * 10.0 / 115200);
+    if (format == chosen) written = package;
+  }
+
+  // Board side, on top of the transfer
+  double eraseSeconds = REGION_SIZE / PAGE_SIZE * PAGE_ERASE_MS / 1000;
+  double programSeconds = (image.size() + 1) / 2 * HALFWORD_PROGRAM_US / 1e6;
+  printf("board: staging erase %.1fs before the first chunk, programming %.1fs (overlaps the transfer),\n", eraseSeconds, programSeconds);
+  printf("       bootloader copy %.1fs after commit\n", eraseSeconds + programSeconds);
+  printf("(UART time only: the BLE connection interval can make the link slower)\n");
+
+  if (outPath) {
+    FILE* file = fopen(outPath, "wb");
+    if (!file || fwrite(written.data(), 1, written.size(), file) != written.size() || fclose(file) != 0) {
+      fprintf(stderr, "fw_package: cannot write %s\n", outPath);
+      return 1;
+    }
+    printf("wrote %s package %s (%zu bytes, stream CRC32 %08X)\n", formatName(chosen), outPath, written.size(), crc32(0, written.data(), written.size()));
+  }
+  return 0;
+}
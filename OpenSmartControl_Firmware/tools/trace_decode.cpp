@@ -0,0 +1,213 @@
+/**
+ * trace_decode - turn the firmware debug UART stream back into text
+ *
+ * The firmware sends plain text mixed with binary TRACE() records:
+ *   0x1E | module << 4 | argc | token (LE16) | argc x argument (LE32)
+ * The token is the offset of the format string in the .trace_fmt section of
+ * the firmware .elf. That section is not flashed, so the .elf of the exact
+ * build running on the board is needed to decode the stream. A host build
+ * (ELF64) decodes the same way if linked -no-pie: in a PIE the token picks
+ * up the load address.
+ *
+ * Build:  g++ -std=c++17 -O2 -o trace_decode trace_decode.cpp
+ * Usage:  trace_decode firmware.elf [capture.bin]      (stdin when no capture)
+ *         stty -F /dev/ttyUSB0 115200 raw && trace_decode firmware.elf < /dev/ttyUSB0
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const uint8_t TRACE_MARKER = 0x1E;
+static const uint8_t TRACE_MAX_ARGS = 4;
+static const char* const MODULE_NAMES[] = { "SYSTEM", "TIMER", "MOTOR", "SENSOR", "COMM", "SAFETY", "SEQUENCE" };
+
+/**
+ * Little-endian field readers
+ */
+static uint32_t readLE(const std::vector<uint8_t>& data, size_t offset, size_t size) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < size; i++) {
+    value |= (uint32_t)data[offset + i] << (8 * i);
+  }
+  return value;
+}
+
+static uint64_t readLE64(const std::vector<uint8_t>& data, size_t offset) {
+  return readLE(data, offset, 4) | ((uint64_t)readLE(data, offset + 4, 4) << 32);
+}
+
+/**
+ * Load the .trace_fmt section from an ELF32/ELF64 little-endian file
+ */
+static bool loadTraceSection(const char* path, std::vector<uint8_t>& section) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "trace_decode: cannot open %s\n", path);
+    return false;
+  }
+  std::vector<uint8_t> elf;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    elf.insert(elf.end(), chunk, chunk + n);
+  }
+  fclose(file);
+
+  if (elf.size() < 52 || memcmp(elf.data(), "\x7F" "ELF", 4) != 0 || elf[5] != 1) {
+    fprintf(stderr, "trace_decode: %s is not a little-endian ELF file\n", path);
+    return false;
+  }
+
+  bool is64 = (elf[4] == 2);
+  uint64_t shoff = is64 ? readLE64(elf, 0x28) : readLE(elf, 0x20, 4);
+  uint32_t shentsize = readLE(elf, is64 ? 0x3A : 0x2E, 2);
+  uint32_t shnum = readLE(elf, is64 ? 0x3C : 0x30, 2);
+  uint32_t shstrndx = readLE(elf, is64 ? 0x3E : 0x32, 2);
+  if (shoff + (uint64_t)shentsize * shnum > elf.size() || shstrndx >= shnum) {
+    fprintf(stderr, "trace_decode: %s has a broken section table\n", path);
+    return false;
+  }
+
+  // Section header fields: name, offset, size
+  auto header = [&](uint32_t index, uint32_t& name, uint64_t& offset, uint64_t& size) {
+    size_t base = shoff + (size_t)index * shentsize;
+    name = readLE(elf, base, 4);
+    offset = is64 ? readLE64(elf, base + 0x18) : readLE(elf, base + 0x10, 4);
+    size = is64 ? readLE64(elf, base + 0x20) : readLE(elf, base + 0x14, 4);
+  };
+
+  uint32_t name;
+  uint64_t strOffset, strSize;
+  header(shstrndx, name, strOffset, strSize);
+  if (strOffset + strSize > elf.size()) return false;
+
+  for (uint32_t i = 0; i < shnum; i++) {
+    uint64_t offset, size;
+    header(i, name, offset, size);
+    if (name >= strSize || offset + size > elf.size()) continue;
+    const char* sectionName = (const char*)&elf[strOffset + name];
+    if (strncmp(sectionName, ".trace_fmt", strSize - name) == 0) {
+      section.assign(elf.begin() + offset, elf.begin() + offset + size);
+      return true;
+    }
+  }
+
+  fprintf(stderr, "trace_decode: no .trace_fmt section in %s (built with DEBUG_TRACE 0?)\n", path);
+  return false;
+}
+
+/**
+ * Expand one format string with the record arguments
+ * Supports %d %i %u %x %X %c %% with flags and width; h/l modifiers are
+ * accepted and ignored since every argument is sent as 32 bits.
+ */
+static std::string formatRecord(const char* format, const uint32_t* args, uint8_t argc) {
+  std::string out;
+  uint8_t next = 0;
+  char text[64];
+
+  for (const char* p = format; *p; p++) {
+    if (*p != '%') {
+      out += *p;
+      continue;
+    }
+    if (p[1] == '%') {
+      out += '%';
+      p++;
+      continue;
+    }
+
+    std::string spec = "%";
+    p++;
+    while (*p && strchr("-+ 0#", *p)) spec += *p++;
+    while (*p >= '0' && *p <= '9') spec += *p++;
+    while (*p == 'l' || *p == 'h') p++;
+    if (!*p) break;
+
+    char conversion = *p;
+    if (next >= argc || !strchr("diuxXc", conversion)) {
+      out += "<?>";
+      continue;
+    }
+
+    uint32_t value = args[next++];
+    spec += conversion;
+    if (conversion == 'd' || conversion == 'i') {
+      snprintf(text, sizeof(text), spec.c_str(), (int)(int32_t)value);
+    } else if (conversion == 'c') {
+      snprintf(text, sizeof(text), spec.c_str(), (int)(value & 0xFF));
+    } else {
+      snprintf(text, sizeof(text), spec.c_str(), (unsigned int)value);
+    }
+    out += text;
+  }
+  return out;
+}
+
+/**
+ * Decode the stream until end of input
+ */
+static void decodeStream(FILE* input, const std::vector<uint8_t>& section) {
+  int c;
+  while ((c = fgetc(input)) != EOF) {
+    if (c != TRACE_MARKER) {
+      fputc(c, stdout);
+      if (c == '\n') fflush(stdout);
+      continue;
+    }
+
+    uint8_t record[3 + 4 * TRACE_MAX_ARGS];
+    if (fread(record, 1, 3, input) != 3) break;
+
+    uint8_t module = record[0] >> 4;
+    uint8_t argc = record[0] & 0x0F;
+    uint16_t token = (uint16_t)(record[1] | (record[2] << 8));
+    if (argc > TRACE_MAX_ARGS) {
+      printf("<trace: bad record header 0x%02X>\n", record[0]);
+      continue;
+    }
+    if (fread(record + 3, 1, 4 * argc, input) != (size_t)(4 * argc)) break;
+
+    uint32_t args[TRACE_MAX_ARGS];
+    for (uint8_t i = 0; i < argc; i++) {
+      const uint8_t* a = &record[3 + 4 * i];
+      args[i] = a[0] | (a[1] << 8) | (a[2] << 16) | ((uint32_t)a[3] << 24);
+    }
+
+    if (token >= section.size() || memchr(&section[token], '\0', section.size() - token) == nullptr) {
+      const char* moduleName = module < sizeof(MODULE_NAMES) / sizeof(MODULE_NAMES[0]) ? MODULE_NAMES[module] : "?";
+      printf("<trace: %s token 0x%04X not in .elf (wrong build?)>\n", moduleName, token);
+      continue;
+    }
+
+    printf("%s\r\n", formatRecord((const char*)&section[token], args, argc).c_str());
+    fflush(stdout);
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s firmware.elf [capture.bin]\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t> section;
+  if (!loadTraceSection(argv[1], section)) return 1;
+
+  FILE* input = stdin;
+  if (argc == 3) {
+    input = fopen(argv[2], "rb");
+    if (!input) {
+      fprintf(stderr, "trace_decode: cannot open %s\n", argv[2]);
+      return 1;
+    }
+  }
+
+  decodeStream(input, section);
+
+  if (input != stdin) fclose(input);
+  return 0;
+}
@@ -0,0 +1,88 @@
+#ifndef BLE_CAPTURE_H
+#define BLE_CAPTURE_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstdio>
+#include "FeatureConfig.h"
+
+/**
+ * BleCapture Class
+ *
+ * Journal of every byte received from the BLE module with the TimerManager
+ * tick it was drained at, so a field session can be dumped over the debug
+ * UART and replayed on a host (tools/ble_capture).
+ *
+ * Journal entries (uint16_t, one per received byte unless time jumps):
+ * - bit 15 = 0: byte in bits 0..7, ticks since the previous entry in bits 8..14
+ * - bit 15 = 1: no byte, ticks 0..0x7FFF to add before the next entry
+ *
+ * Features:
+ * - Fixed RAM ring (BLE_CAPTURE_ENTRIES), oldest entries overwritten first
+ * - Tick of the oldest entry kept exact when entries are overwritten
+ * - Recording paused while a dump is being printed
+ * - Only compiled in with BLE_CAPTURE (FeatureConfig.h)
+ */
+class BleCapture {
+public:
+  static const uint16_t ENTRIES = BLE_CAPTURE_ENTRIES;
+  static const uint16_t GAP_FLAG = 0x8000;
+  static const uint8_t MAX_DELTA = 0x7F;     // Ticks that fit in a byte entry
+  static const uint16_t MAX_GAP = 0x7FFF;    // Ticks that fit in a gap entry
+  static const uint8_t ENTRIES_PER_LINE = 16;
+  static const uint8_t LINE_SIZE = 96;       // Dump line, CR LF included
+
+  static_assert(ENTRIES > 0 && (ENTRIES & (ENTRIES - 1)) == 0, "BLE_CAPTURE_ENTRIES must be a power of two");
+
+private:
+  static const uint16_t MASK = ENTRIES - 1;
+
+  uint16_t entries[ENTRIES];
+  uint16_t head;          // Next write position
+  uint16_t count;         // Entries held
+  uint32_t baseTick;      // Tick the oldest entry's delta counts from
+  uint32_t lastTick;      // Tick of the newest entry
+  bool started;
+  bool paused;
+  unsigned long overwritten;  // Entries lost to the ring wrapping
+  unsigned long missed;       // Bytes not recorded while paused
+
+  void push(uint16_t entry);
+
+public:
+  // Constructor
+  BleCapture();
+
+  // Recording (main loop, from the BLE byte path)
+  void record(uint8_t value, uint32_t tick);
+  void clear();
+  void setPaused(bool pause) {
+    paused = pause;
+  }
+
+  // Journal access (entry 0 = oldest)
+  uint16_t size() const {
+    return count;
+  }
+  uint16_t entryAt(uint16_t index) const {
+    return entries[(uint16_t)(head - count + index) & MASK];
+  }
+  uint32_t getBaseTick() const {
+    return baseTick;
+  }
+  unsigned long getOverwritten() const {
+    return overwritten;
+  }
+  unsigned long getMissed() const {
+    return missed;
+  }
+  static uint16_t entryTicks(uint16_t entry) {
+    return (entry & GAP_FLAG) ? (entry & MAX_GAP) : ((entry >> 8) & MAX_DELTA);
+  }
+
+  // Dump lines for the debug UART
+  int formatHeader(char* line) const;
+  int formatLine(char* line, uint16_t firstEntry) const;
+};
+
+#endif  // BLE_CAPTURE_H
@@ -0,0 +1,158 @@
+#ifndef BLE_DMA_RECEIVER_H
+#define BLE_DMA_RECEIVER_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <cstdint>
+#include "FeatureConfig.h"
+
+// Hardware path needs the HAL UART/DMA drivers and the F1 USART2 RX channel
+#if BLE_UART_DMA_RX && defined(HAL_UART_MODULE_ENABLED) && defined(HAL_DMA_MODULE_ENABLED) && defined(DMA1_Channel6)
+#define BLE_DMA_HW_AVAILABLE 1
+#else
+#define BLE_DMA_HW_AVAILABLE 0
+#endif
+
+/**
+ * Received frame span inside the DMA buffer (zero-copy)
+ * A frame that wraps the end of the buffer is split into two segments.
+ */
+struct BleRxSlice {
+  const uint8_t* first;
+  uint16_t firstLen;
+  const uint8_t* second;
+  uint16_t secondLen;
+
+  uint16_t length() const {
+    return firstLen + secondLen;
+  }
+};
+
+/**
+ * BleDmaReceiver Class
+ *
+ * Alternate receive driver for the HM10 BLE UART (USART2, PA2/PA3).
+ * The USART writes into a circular buffer through DMA1 Channel 6 and the
+ * IDLE-line / half / full transfer events publish the write position, so
+ * reception needs no CPU time while the main loop is busy.
+ *
+ * Features:
+ * - Circular DMA reception with IDLE-line interrupt (HAL ReceiveToIdle)
+ * - STX/SOH..ETX spans handed out as zero-copy slices
+ * - Overrun / framing / noise error counters
+ * - Ring overrun detection when the consumer falls a full buffer behind
+ * - Automatic restart if the HAL aborts the transfer
+ *
+ * The slice logic does not touch hardware and can run with the DMA path
+ * compiled out (onReceiveEvent() then acts as the producer).
+ */
+class BleDmaReceiver {
+public:
+  static const uint16_t DMA_BUFFER_SIZE = 256;  // ~266ms at 9600 baud, ~22ms at 115200
+  static const uint16_t MAX_FRAME_SIZE = 64;    // Longer frame spans are dropped
+  static const uint8_t SOH = 0x01;  // Binary frame start
+  static const uint8_t STX = 0x02;  // Hex frame start
+  static const uint8_t ETX = 0x03;
+
+private:
+  static_assert((DMA_BUFFER_SIZE & (DMA_BUFFER_SIZE - 1)) == 0, "DMA_BUFFER_SIZE must be a power of two");
+  static const uint16_t MASK = DMA_BUFFER_SIZE - 1;
+
+  HardwareSerial* serial;
+
+  // DMA target buffer
+  uint8_t dmaBuffer[DMA_BUFFER_SIZE];
+
+  // Producer state (ISR)
+  volatile uint16_t lastDmaPos;   // Last DMA position reported by the HAL
+  volatile uint32_t writeTotal;   // Bytes written since start (free-running)
+
+  // Consumer state (main loop)
+  uint32_t readTotal;             // Start of the oldest unreleased byte
+  uint32_t scanTotal;             // Next byte to inspect for ETX
+
+  // Error counters
+  unsigned long overrunErrors;    // USART ORE
+  unsigned long framingErrors;    // USART FE
+  unsigned long noiseErrors;      // USART NE
+  unsigned long ringOverruns;     // Consumer lapped by DMA
+  unsigned long droppedBytes;     // Bytes outside any valid frame span
+  unsigned long framesFound;
+  unsigned long restarts;         // Transfers restarted after a HAL abort
+
+  bool active;
+
+#if BLE_DMA_HW_AVAILABLE
+  DMA_HandleTypeDef hdmaRx;
+  UART_HandleTypeDef* uartHandle() const;
+  bool startTransfer();
+#endif
+
+  void fillSlice(BleRxSlice& slice, uint32_t start, uint32_t end) const;
+
+  static bool isFrameStart(uint8_t b) {
+    return b == STX || b == SOH;
+  }
+
+public:
+  // Constructor
+  BleDmaReceiver(HardwareSerial* bleSerial);
+
+  // Destructor
+  ~BleDmaReceiver();
+
+  // Hardware control
+  bool begin();
+  void end();
+  bool isActive() const;
+
+  // Producer (called from the HAL RX event callback)
+  void onReceiveEvent(uint16_t dmaPos);
+
+  // Consumer (main loop)
+  void poll();
+  bool nextFrame(BleRxSlice& slice);
+  void release(const BleRxSlice& slice);
+  void reset();
+  uint16_t getPendingBytes() const;
+
+  // Statistics
+  unsigned long getOverrunErrors() const {
+    return overrunErrors;
+  }
+  unsigned long getFramingErrors() const {
+    return framingErrors;
+  }
+  unsigned long getNoiseErrors() const {
+    return noiseErrors;
+  }
+  unsigned long getRingOverruns() const {
+    return ringOverruns;
+  }
+  unsigned long getDroppedBytes() const {
+    return droppedBytes;
+  }
+  unsigned long getFramesFound() const {
+    return framesFound;
+  }
+  unsigned long getRestarts() const {
+    return restarts;
+  }
+  void resetStatistics();
+
+  // Buffer access (producer side when the DMA path is compiled out)
+  uint8_t* getBuffer() {
+    return dmaBuffer;
+  }
+
+#if BLE_DMA_HW_AVAILABLE
+  // ISR access
+  void onDmaIRQ();
+  bool ownsUart(UART_HandleTypeDef* huart) const;
+#endif
+
+  // Static instance for ISR access
+  static BleDmaReceiver* instance;
+};
+
+#endif  // BLE_DMA_RECEIVER_H
@@ -0,0 +1,80 @@
+#include "BleTxQueue.h"
+
+/**
+ * Constructor
+ */
+BleTxQueue::BleTxQueue(Print* output)
+  : serial(output), currentOffset(0), sending(false), framesSent(0) {
+  memset(&current, 0, sizeof(current));
+  memset(drops, 0, sizeof(drops));
+}
+
+/**
+ * Queue an encoded frame (false and counted if its lane is full)
+ */
+bool BleTxQueue::enqueue(Lane lane, const uint8_t* frame, uint8_t length) {
+  if (length == 0 || length > PacketCodec::MAX_FRAME_SIZE) return false;
+
+  TxFrame entry;
+  entry.length = length;
+  memcpy(entry.bytes, frame, length);
+
+  bool queued = (lane == LANE_CONTROL) ? control.push(entry) : bulk.push(entry);
+  if (!queued) {
+    drops[lane]++;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Start the next frame, control lane first
+ */
+bool BleTxQueue::takeNext() {
+  if (!control.pop(current) && !bulk.pop(current)) return false;
+  currentOffset = 0;
+  sending = true;
+  return true;
+}
+
+/**
+ * Copy as many queued bytes as the UART TX buffer accepts
+ * The UART's TX interrupt sends them; a frame may span several calls.
+ */
+void BleTxQueue::pump() {
+  if (!serial) return;
+
+  while (sending || takeNext()) {
+    int room = serial->availableForWrite();
+    if (room <= 0) return;
+
+    uint8_t remaining = current.length - currentOffset;
+    uint8_t chunk = (room < remaining) ? (uint8_t)room : remaining;
+    serial->write(current.bytes + currentOffset, chunk);
+    currentOffset += chunk;
+
+    if (currentOffset < current.length) return;  // TX buffer full
+    sending = false;
+    framesSent++;
+  }
+}
+
+/**
+ * Drop every queued frame and the one being sent (link gone, module reset)
+ */
+void BleTxQueue::clear() {
+  control.clear();
+  bulk.clear();
+  sending = false;
+  currentOffset = 0;
+}
+
+/**
+ * Reset drop counters and high-water marks
+ */
+void BleTxQueue::resetStatistics() {
+  memset(drops, 0, sizeof(drops));
+  framesSent = 0;
+  control.resetHighWater();
+  bulk.resetHighWater();
+}
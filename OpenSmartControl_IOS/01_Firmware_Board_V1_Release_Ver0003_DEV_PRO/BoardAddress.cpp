@@ -0,0 +1,83 @@
+#include "BoardAddress.h"
+#include <EEPROM.h>
+
+/**
+ * Constructor
+ */
+BoardAddress::BoardAddress()
+  : unit(DEFAULT_UNIT), groups(0), savedUnit(DEFAULT_UNIT), savedGroups(0) {
+}
+
+/**
+ * Restore the address from EEPROM (defaults if no valid record)
+ */
+void BoardAddress::load() {
+  eeprom_buffer_fill();
+
+  uint8_t record[RECORD_SIZE];
+  for (uint8_t i = 0; i < RECORD_SIZE; i++) {
+    record[i] = eeprom_buffered_read_byte(EEPROM_OFFSET + i);
+  }
+
+  uint8_t storedUnit = record[1];
+  uint16_t storedGroups = (uint16_t)(record[2] | (record[3] << 8));
+  if (record[0] == RECORD_MAGIC && record[4] == recordCheck(storedUnit, storedGroups) && isUnitAddress(storedUnit)) {
+    unit = storedUnit;
+    groups = storedGroups;
+  } else {
+    unit = DEFAULT_UNIT;
+    groups = 0;
+  }
+  savedUnit = unit;
+  savedGroups = groups;
+}
+
+/**
+ * Write the address to EEPROM if it changed
+ * Blocks for one flash page erase/program (tens of ms); callers only save
+ * on an explicit configuration command.
+ */
+bool BoardAddress::save() {
+  if (!isDirty()) return false;
+
+  eeprom_buffer_fill();
+  eeprom_buffered_write_byte(EEPROM_OFFSET + 0, RECORD_MAGIC);
+  eeprom_buffered_write_byte(EEPROM_OFFSET + 1, unit);
+  eeprom_buffered_write_byte(EEPROM_OFFSET + 2, (uint8_t)(groups & 0xFF));
+  eeprom_buffered_write_byte(EEPROM_OFFSET + 3, (uint8_t)(groups >> 8));
+  eeprom_buffered_write_byte(EEPROM_OFFSET + 4, recordCheck(unit, groups));
+  eeprom_buffer_flush();
+
+  savedUnit = unit;
+  savedGroups = groups;
+  return true;
+}
+
+/**
+ * Set the unit address (false if it is a group, broadcast or reserved address)
+ */
+bool BoardAddress::setUnit(uint8_t address) {
+  if (!isUnitAddress(address)) return false;
+  unit = address;
+  return true;
+}
+
+/**
+ * Join or leave a group (0..GROUP_COUNT-1)
+ */
+bool BoardAddress::setGroup(uint8_t group, bool member) {
+  if (group >= GROUP_COUNT) return false;
+  if (member) {
+    groups |= (uint16_t)(1u << group);
+  } else {
+    groups &= (uint16_t)~(1u << group);
+  }
+  return true;
+}
+
+/**
+ * Record check byte (catches a blank page and partial writes)
+ */
+uint8_t BoardAddress::recordCheck(uint8_t unitAddress, uint16_t groupMask) {
+  return (uint8_t)~(RECORD_MAGIC + unitAddress + (groupMask & 0xFF) + (groupMask >> 8));
+}
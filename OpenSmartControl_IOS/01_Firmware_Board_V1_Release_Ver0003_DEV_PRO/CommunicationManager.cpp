@@ -1,39 +1,140 @@
 #include "CommunicationManager.h"
 #include "MotorController.h"
+#include "SafetyManager.h"  // Before SequenceController.h (Massage_v1_hardware.h macros)
 #include "SequenceController.h"
 #include "SensorManager.h"
 
 /**
  * Constructor
  */
-CommunicationManager::CommunicationManager(TimerManager *timerMgr, HardwareSerial *debug, HardwareSerial *ble)
-  : timerManager(timerMgr), debugSerial(debug), bleSerial(ble), dataLen1(0), dataLen2(0), hexIdx1(0), hexIdx2(0), dataReady1(false), dataReady2(false), state1(WAIT_START), state2(WAIT_START), rawBufferIndex(0), autoCmdTimerTick(0), offCmdTimerTick(0), autoCmdTimerActive(false), offCmdTimerActive(false), lastCommand({ 0xFF, 0xFF, 0xFF, 0 }), motorController(nullptr), sequenceController(nullptr), sensorManager(nullptr), manualPriority(false) {
+CommunicationManager::CommunicationManager(TimerManager *timerMgr, Print *debug, HardwareSerial *ble)
+  : debugSerial(debug), bleSerial(ble), groupFrame(false), repliesMuted(false), hm10(nullptr), bleFramesLastPass(0), bleMaxBytesInFlight(0), txFraming(FRAMING_HEX), txQueue(ble), ackEnabled(false), acksSent(0), nacksSent(0), commandQueueDrops(0), fastStops(0), maxCommandLatencyTicks(0), telemetryEnabled(false), telemetryPending(false), telemetrySequence(0), lastTelemetryTick(0), telemetryFramesSent(0), batchActive(false), batchAutoSyncPending(false), batchProgram(0), batchFramesTotal(0), batchRejects(0), linkUp(false), linkActivityPending(false), linkSupervised(false), linkLossPausesAuto(false), linkPausedAuto(false), lastLinkActivityTick(0), linkTimeoutTicks(LINK_TIMEOUT_TICKS), bleDma(nullptr), dmaOverrunsSeen(0), latencyProbe(nullptr), latencyReportLine(0), bleCapture(nullptr), captureDumpLine(0), firmwareUpdater(nullptr), updateSequence(0), autoCmdTimerTick(0), offCmdTimerTick(0), autoCmdTimerActive(false), offCmdTimerActive(false), lastCommand({ 0xFF, 0xFF, 0xFF, 0 }), sequenceMode(SEQUENCE_LEGACY), sequenceDuplicates(0), sequenceStale(0), timerManager(timerMgr), motorController(nullptr), sequenceController(nullptr), sensorManager(nullptr), safetyManager(nullptr), manualPriority(false), intensityHighPWM(INTENSITY_HIGH_PWM), intensityLowPWM(INTENSITY_LOW_PWM) {
   // Initialize data buffers
-  memset(data1, 0, sizeof(data1));
-  memset(data2, 0, sizeof(data2));
-  memset(hexString1, 0, sizeof(hexString1));
-  memset(hexString2, 0, sizeof(hexString2));
-  memset(rawBuffer, 0, sizeof(rawBuffer));
+  memset(&lastState, 0, sizeof(lastState));
+  memset(&linkStats, 0, sizeof(linkStats));
+#if LATENCY_PROBES
+  memset(&rxStamps, 0, sizeof(rxStamps));
+#endif
 }
 
 /**
  * Destructor
  */
 CommunicationManager::~CommunicationManager() {
-  // Cleanup if needed
+  if (bleDma) {
+    delete bleDma;
+    bleDma = nullptr;
+  }
+  if (hm10) {
+    delete hm10;
+    hm10 = nullptr;
+  }
+  if (latencyProbe) {
+    delete latencyProbe;
+    latencyProbe = nullptr;
+  }
+  if (bleCapture) {
+    delete bleCapture;
+    bleCapture = nullptr;
+  }
+  if (firmwareUpdater) {
+    delete firmwareUpdater;
+    firmwareUpdater = nullptr;
+  }
 }
 
 /**
  * Initialize communication manager
  */
 void CommunicationManager::initialize() {
-  // Initialize HM10 BREAK pin
-  pinMode(HM10_BREAK, OUTPUT);
-  digitalWrite(HM10_BREAK, HIGH);  // Normal state (HIGH = not reset)
-
   serialInit();
   resetDataBuffers();
   resetParseStates();
+
+  // Protocol address from EEPROM (factory DEVICE_ID if never configured)
+  boardAddress.load();
+  if (debugSerial && (boardAddress.getUnit() != DEVICE_ID || boardAddress.getGroups() != 0)) {
+    debugSerial->print("ADDR: unit 0x");
+    debugSerial->print(boardAddress.getUnit(), HEX);
+    debugSerial->print(", groups 0x");
+    debugSerial->println(boardAddress.getGroups(), HEX);
+  }
+
+  if (!bleSerial) return;
+
+#if LATENCY_PROBES
+  if (!latencyProbe) {
+    latencyProbe = new LatencyProbe();
+    latencyProbe->begin();
+  }
+#endif
+
+#if BLE_CAPTURE
+  if (!bleCapture) {
+    bleCapture = new BleCapture();
+  }
+#endif
+
+#if FIRMWARE_UPDATE
+  if (!firmwareUpdater) {
+    FlashBank* flash = FirmwareUpdater::createMcuFlash();
+    if (flash) firmwareUpdater = new FirmwareUpdater(flash, timerManager);
+  }
+#endif
+
+  // HM10 BREAK pin and module state (UART opened at 9600 baud by setup())
+  if (!hm10) {
+    hm10 = new Hm10Manager(bleSerial, timerManager, HM10_BREAK);
+  }
+  hm10->begin(Hm10Manager::FALLBACK_BAUD);
+
+#if BLE_UART_BAUD_NEGOTIATION
+  // Handshake runs from serial2DataIncome(); reception starts when it is done
+  hm10->negotiate(BLE_UART_TARGET_BAUD);
+#else
+  onBleUartReady();
+#endif
+}
+
+/**
+ * BLE UART usable for frames (after startup negotiation or a module reset)
+ */
+void CommunicationManager::onBleUartReady() {
+  if (debugSerial) {
+    debugSerial->print("BLE: HM10 UART ");
+    debugSerial->print((unsigned long)hm10->getBaud());
+    if (hm10->isRecovering()) {
+      debugSerial->print(" baud, not answering - reset retry ");
+      debugSerial->println(hm10->getRecoveryAttempt());
+    } else {
+      debugSerial->println(hm10->isFallback() ? " baud (module not answering, fallback)" : " baud");
+    }
+  }
+
+#if BLE_UART_DMA_RX
+  // Switch BLE reception to DMA; keep the HardwareSerial path if it cannot
+  // start, and during a recovery backoff (the next reset is already pending)
+  if (hm10->getState() == Hm10Manager::STATE_READY) {
+    if (!bleDma) {
+      bleDma = new BleDmaReceiver(bleSerial);
+    }
+    if (!bleDma->begin()) {
+      delete bleDma;
+      bleDma = nullptr;
+    }
+  }
+#endif
+}
+
+/**
+ * Hand USART2 reception back to HardwareSerial
+ * Hm10Manager reads AT replies with available() / read() and changes the
+ * baud rate with begin(); neither works while DMA owns the receiver.
+ */
+void CommunicationManager::stopBleDma() {
+  if (bleDma && bleDma->isActive()) {
+    bleDma->end();
+  }
 }
 
 /**
@@ -52,24 +153,30 @@ void CommunicationManager::serialInit() {
 
 /**
  * Reset HM10 BLE module
+ * Returns at once; serial2DataIncome() finishes the reset pulse and boot wait.
  */
 void CommunicationManager::resetHM10() {
-  pinMode(HM10_BREAK, OUTPUT);
-  digitalWrite(HM10_BREAK, LOW);
-  delay(100);
-  digitalWrite(HM10_BREAK, HIGH);
-  delay(100);
+  if (!hm10) return;
+  stopBleDma();
+  hm10->requestReset();
 }
 
 /**
  * Set controller references
  */
-void CommunicationManager::setControllers(void *motorCtrl, void *seqCtrl, void *sensorCtrl) {
+void CommunicationManager::setControllers(MotorController *motorCtrl, SequenceController *seqCtrl, SensorManager *sensorCtrl) {
   motorController = motorCtrl;
   sequenceController = seqCtrl;
   sensorManager = sensorCtrl;
 }
 
+/**
+ * Set safety manager reference (receives link-up/link-down reports)
+ */
+void CommunicationManager::setSafetyManager(SafetyManager *safetyMgr) {
+  safetyManager = safetyMgr;
+}
+
 /**
  * Manual priority management
  */
@@ -95,328 +202,637 @@ void CommunicationManager::testUART2() {
 
 /**
  * Process incoming BLE data
+ *
+ * Drains every byte the UART has buffered into the receive ring, then parses
+ * the whole batch. Each ETX completes a frame that is queued immediately,
+ * so a full frame no longer needs one loop pass per byte. Queued commands
+ * are executed by executePendingCommands().
  */
 void CommunicationManager::serial2DataIncome() {
   if (!bleSerial) return;
 
+  bleFramesLastPass = 0;
+
+  // Module resetting or negotiating: the UART carries AT replies, not frames
+  if (hm10) {
+    // Out of STATE_READY a reset or AT exchange can start in poll()
+    if (hm10->getState() != Hm10Manager::STATE_READY) stopBleDma();
+    bool wasBusy = hm10->isBusy();
+    hm10->poll();
+    if (hm10->isBusy()) return;
+    // Ready again: after a reset / negotiation, or a recovery a frame ended
+    if (wasBusy || (bleDma && !bleDma->isActive() && hm10->getState() == Hm10Manager::STATE_READY)) {
+      onBleUartReady();
+    }
+  }
+
   // UART2 data processing only (BLE data)
-  if (bleSerial->available()) {
-    byte receivedByte = bleSerial->read();
-    parsePacket(receivedByte, state2, hexString2, hexIdx2, dataReady2);
+  if (bleDma && bleDma->isActive()) {
+    processBleDmaFrames();
+  } else {
+    int drained = drainBleSerial();
+    if (drained > bleMaxBytesInFlight) {
+      bleMaxBytesInFlight = drained;
+    }
+
+    byte receivedByte;
+    while (bleRxRing.pop(receivedByte)) {
+      ingestBleByte(receivedByte);
+    }
   }
+}
 
-  // Process UART1 data (if any)
-  if (dataReady1) {
-    if (debugSerial) {
-      // UART1 Packet debug disabled
+/**
+ * Move all pending BLE UART bytes into the receive ring
+ * Bytes that do not fit stay in the UART buffer for the next pass.
+ */
+int CommunicationManager::drainBleSerial() {
+  int count = 0;
+#ifdef SERIAL_RX_BUFFER_SIZE
+  // A full UART buffer has been dropping bytes since it filled
+  if (bleSerial->available() >= SERIAL_RX_BUFFER_SIZE - 1) {
+    linkStats.uartOverruns++;
+  }
+#endif
+  while (!bleRxRing.isFull() && bleSerial->available() > 0) {
+    bleRxRing.push((byte)bleSerial->read());
+    count++;
+  }
+  return count;
+}
+
+/**
+ * Process every complete frame the DMA receiver has collected
+ * Slices point straight into the DMA buffer and are released once parsed.
+ */
+void CommunicationManager::processBleDmaFrames() {
+  bleDma->poll();
+
+  // USART overruns and DMA ring laps both lose bytes
+  unsigned long overruns = bleDma->getOverrunErrors() + bleDma->getRingOverruns();
+  if (overruns < dmaOverrunsSeen) dmaOverrunsSeen = 0;  // Receiver statistics were reset
+  linkStats.uartOverruns += overruns - dmaOverrunsSeen;
+  dmaOverrunsSeen = overruns;
+
+  uint16_t pending = bleDma->getPendingBytes();
+  if (pending > bleMaxBytesInFlight) {
+    bleMaxBytesInFlight = pending;
+  }
+
+  BleRxSlice slice;
+  while (bleDma->nextFrame(slice)) {
+    for (uint16_t i = 0; i < slice.firstLen; i++) {
+      ingestBleByte(slice.first[i]);
     }
-    processHexString(hexString1, data1, dataLen1);
-    printProcessedData(data1, dataLen1);
-    dataReady1 = false;
+    for (uint16_t i = 0; i < slice.secondLen; i++) {
+      ingestBleByte(slice.second[i]);
+    }
+    bleDma->release(slice);
   }
+}
 
-  // Process UART2 data (BLE)
-  if (dataReady2) {
-    if (debugSerial) {
-      // BLE: Processing hex string debug disabled
+/**
+ * Feed one BLE byte to the frame decoders and process each completed frame
+ * SOH starts a binary frame, STX a hex frame; both may arrive on the same link.
+ */
+void CommunicationManager::ingestBleByte(byte receivedByte) {
+#if BLE_CAPTURE
+  if (bleCapture && timerManager) bleCapture->record(receivedByte, timerManager->getMasterTicks());
+#endif
+  linkStats.bytesIn++;
+
+#if LATENCY_PROBES
+  // Frame delimiters never occur inside a body (hex digits / DLE stuffing)
+  if (receivedByte == PacketCodec::SOH || receivedByte == PacketCodec::STX) {
+    rxStamps.stx = LatencyProbe::now();
+  } else if (receivedByte == PacketCodec::ETX) {
+    rxStamps.etx = LatencyProbe::now();
+  }
+#endif
+
+  if (binDecoder.isReceiving() || receivedByte == PacketCodec::SOH) {
+    hexDecoder.reset();  // A binary frame ends any partial hex frame
+
+    BinaryFrameDecoder::Result result = binDecoder.feed(receivedByte);
+    if (result == BinaryFrameDecoder::FRAME) {
+      bleFramesLastPass++;
+      linkStats.framesIn++;
+      linkStats.binaryFramesIn++;
+      enqueueCommand(binDecoder.getFrame());
+    } else if (result == BinaryFrameDecoder::ERROR) {
+      linkStats.binaryErrors++;
+      countFrameError(binDecoder.getError());
+      sendNack(binDecoder.getFrame().body[1], NACK_CORRUPT);
     }
+    return;
+  }
 
-    processHexString(hexString2, data2, dataLen2);
-    printProcessedData(data2, dataLen2);
+  HexFrameDecoder::Result result = hexDecoder.feed(receivedByte);
+  if (result == HexFrameDecoder::FRAME) {
+    bleFramesLastPass++;
+    linkStats.framesIn++;
+    enqueueCommand(hexDecoder.getFrame());
+  } else if (result == HexFrameDecoder::ERROR) {
+    countFrameError(hexDecoder.getError());
+    if (debugSerial) debugSerial->println("!!! Invalid BLE frame (length/checksum)");
+    sendNack(hexDecoder.getFrame().body[1], NACK_CORRUPT);
+  }
+}
 
-    // Process as complete 9-byte packet if length is correct
-    if (dataLen2 == 7) {  // 7 hex bytes = payload + checksum (no STX/ETX in hex string)
+/**
+ * Queue a decoded command for execution
+ * Returns false (command dropped and counted) if the queue is full.
+ */
+bool CommunicationManager::enqueueCommand(const Frame &frame) {
+#if LATENCY_PROBES
+  rxStamps.valid = LatencyProbe::now();
+#endif
+
+  // Every valid frame proves the app is still there, even if it cannot be queued
+  noteLinkActivity();
+
+  // RELEASE / stop frames switch their motors off now, not after the queue
+  stopFast(frame);
+
+  CommandRecord record;
+  record.frame = frame;
+  record.rxTick = timerManager ? timerManager->getMasterTicks() : 0;
+#if LATENCY_PROBES
+  record.stamps = rxStamps;
+#endif
+
+  if (!commandQueue.push(record)) {
+    commandQueueDrops++;
+    if (debugSerial) debugSerial->println("!!! Command queue full - command dropped");
+    // Group / broadcast frames are not answered (every board would reply)
+    if (boardAddress.match(frame.body[0]) == BoardAddress::MATCH_UNIT) {
+      sendNack(frame.body[1], NACK_QUEUE_FULL);
+    }
+    return false;
+  }
+  return true;
+}
 
-      // Reconstruct complete packet for verification
-      uint8_t completePacket[9];
-      completePacket[0] = STX;
-      for (int i = 0; i < 7; i++) {
-        completePacket[i + 1] = data2[i];
-      }
-      completePacket[8] = ETX;
+/**
+ * Stop fast path: switch off the motors a stop-class frame (CMD_FLAG_STOP
+ * command with DATA_OFF, addressed to this board) is going to stop
+ * Runs before the frame waits behind other commands; the queued frame still
+ * gets the full handler (deduplication, log, ACK, mode state). Frames the
+ * handler will refuse as duplicate or stale are skipped: a late AUTO OFF
+ * must not switch off a program started after it.
+ */
+void CommunicationManager::stopFast(const Frame &frame) {
+  if (!motorController || frame.isExtended()) return;
+
+  const Packet &packet = frame.packet();
+  if (packet.data1 != DATA_OFF || boardAddress.match(packet.deviceId) == BoardAddress::MATCH_NONE) return;
+  const CommandSpec *spec = findCommand(packet.command);
+  if (!spec || !(spec->flags & CMD_FLAG_STOP)) return;
+  if (isStopDuplicate(packet)) return;
+
+#if LATENCY_PROBES
+  if (latencyProbe) latencyProbe->beginStop();
+#endif
+  switch (packet.command) {
+    case CMD_INCLINE:
+    case CMD_RECLINE:
+      motorController->offReclineIncline();
+      break;
+    case CMD_FORWARD:
+    case CMD_BACKWARD:
+      motorController->offForwardBackward();
+      break;
+    case CMD_DISCONNECT:
+      motorController->offForwardBackward();
+      motorController->offReclineIncline();
+      [[fallthrough]];  // DISCONNECT also stops the auto program
+    case CMD_AUTO:
+      // Same motors as stopAutoMode(); the roll motor stays for GO HOME
+      motorController->offKneadingMotor();
+      motorController->offCompressionMotor();
+      break;
+    default:
+      break;
+  }
+#if LATENCY_PROBES
+  if (latencyProbe) latencyProbe->endStop(rxStamps);
+#endif
+  fastStops++;
+}
 
+/**
+ * Deduplication answer for a stop frame, ahead of its turn in the queue
+ * Frames queued before it cannot turn an accepted sequence stale (the queue
+ * is shorter than the window); a repeat of one of them only stops again.
+ */
+bool CommunicationManager::isStopDuplicate(const Packet &packet) {
+  if (sequenceMode == SEQUENCE_WINDOW) {
+    return sequenceWindow.peek(packet.sequence) != SequenceWindow::ACCEPTED;
+  }
+  return isCommandDuplicate(packet.sequence, packet.command, packet.data1);
+}
 
-      processCompleteFrame(completePacket, 9);
-    } else {
-      if (debugSerial) {
-        // BLE: Invalid packet length debug disabled
+static_assert(CommunicationManager::COMMAND_QUEUE_SIZE < SequenceWindow::WINDOW_SIZE,
+              "Command queue must be shorter than the sequence window (stop fast path)");
+
+/**
+ * Execute every queued command in arrival order
+ * Called once per loop pass by MassageController, after reception.
+ */
+int CommunicationManager::executePendingCommands() {
+  int executed = 0;
+  CommandRecord record;
+
+  while (commandQueue.pop(record)) {
+    if (timerManager) {
+      unsigned long latency = timerManager->getMasterTicks() - record.rxTick;
+      if (latency > maxCommandLatencyTicks) {
+        maxCommandLatencyTicks = latency;
       }
     }
-    dataReady2 = false;
+#if LATENCY_PROBES
+    if (latencyProbe) {
+      uint8_t slot = record.frame.isExtended() ? COMMAND_COUNT : COMMAND_INDEX.slot[record.frame.body[2]];
+      latencyProbe->beginCommand(slot, record.stamps);
+    }
+#endif
+    if (record.frame.isExtended()) {
+      processExtendedFrame(record.frame);
+    } else {
+      processPacket(record.frame.packet());
+    }
+#if LATENCY_PROBES
+    if (latencyProbe) latencyProbe->endCommand();
+#endif
+    executed++;
   }
+  return executed;
 }
 
 /**
- * Parse incoming packet
+ * Reset BLE receive statistics
  */
-void CommunicationManager::parsePacket(byte receivedByte, ParseState &currentState,
-                                       char hexString[], int &hexIndex, bool &dataReady) {
-  // Debug output for BLE data
+void CommunicationManager::resetBleRxStats() {
+  bleFramesLastPass = 0;
+  bleMaxBytesInFlight = 0;
+  bleRxRing.resetHighWater();
+  commandQueue.resetHighWater();
+  commandQueueDrops = 0;
+  fastStops = 0;
+  maxCommandLatencyTicks = 0;
+  sequenceDuplicates = 0;
+  sequenceStale = 0;
+  if (bleDma) {
+    bleDma->resetStatistics();
+  }
+}
 
-  switch (currentState) {
-    case WAIT_START:
-      if (receivedByte == STX) {
-        currentState = READ_HEX_STRING;
-        hexIndex = 0;
-        // if (debugSerial) debugSerial->println("BLE: STX received, starting packet");
-      }
-      break;
+/**
+ * Command dispatch table
+ * One entry per plain command, in any order. Entries are checked at compile
+ * time below and COMMAND_INDEX maps a command byte to its entry, so lookup
+ * and rejection of unknown commands take one table read. The tables and
+ * names are constant data and stay in flash.
+ */
+constexpr CommunicationManager::CommandSpec CommunicationManager::COMMAND_TABLE[] = {
+  // Command            Handler                                           Data1        Flags                                            Priority          Name
+  { CMD_AUTO,            &CommunicationManager::processAutoCommand,        DATA_ON_OFF, CMD_FLAG_BATCH | CMD_FLAG_STOP | CMD_FLAG_HOMED,  PRIORITY_NORMAL,  "AUTO MODE" },
+  { CMD_ROLL_MOTOR,      &CommunicationManager::processRollMotorCommand,   DATA_ON_OFF, CMD_FLAG_BATCH,                                  PRIORITY_NORMAL,  "ROLL MOTOR" },
+  { CMD_KNEADING,        &CommunicationManager::processKneadingCommand,    DATA_ON_OFF, CMD_FLAG_BATCH | CMD_FLAG_HOMED,                 PRIORITY_NORMAL,  "KNEADING" },
+  { CMD_PERCUSSION,      &CommunicationManager::processPercussionCommand,  DATA_ON_OFF, CMD_FLAG_BATCH | CMD_FLAG_HOMED,                 PRIORITY_NORMAL,  "PERCUSSION" },
+  { CMD_COMPRESSION,     &CommunicationManager::processCompressionCommand, DATA_ON_OFF, CMD_FLAG_BATCH | CMD_FLAG_HOMED,                 PRIORITY_NORMAL,  "COMPRESSION" },
+  { CMD_COMBINE,         &CommunicationManager::processCombineCommand,     DATA_ON_OFF, CMD_FLAG_BATCH | CMD_FLAG_HOMED,                 PRIORITY_NORMAL,  "COMBINE" },
+  { CMD_INTENSITY_LEVEL, &CommunicationManager::processIntensityCommand,   DATA_ANY,    CMD_FLAG_BATCH,                                  PRIORITY_NORMAL,  "INTENSITY LEVEL" },
+  { CMD_INCLINE,         &CommunicationManager::processInclineCommand,     DATA_ON_OFF, CMD_FLAG_REPEAT_ON | CMD_FLAG_STOP,               PRIORITY_HIGH,    "INCLINE" },
+  { CMD_RECLINE,         &CommunicationManager::processReclineCommand,     DATA_ON_OFF, CMD_FLAG_REPEAT_ON | CMD_FLAG_STOP,               PRIORITY_HIGH,    "RECLINE" },
+  { CMD_FORWARD,         &CommunicationManager::processForwardCommand,     DATA_ON_OFF, CMD_FLAG_REPEAT_ON | CMD_FLAG_STOP,               PRIORITY_HIGH,    "FORWARD" },
+  { CMD_BACKWARD,        &CommunicationManager::processBackwardCommand,    DATA_ON_OFF, CMD_FLAG_REPEAT_ON | CMD_FLAG_STOP,               PRIORITY_HIGH,    "BACKWARD" },
+  { CMD_LINK_CONFIG,     &CommunicationManager::processLinkConfigCommand,  DATA_ANY,    CMD_FLAG_NO_ACK | CMD_FLAG_UNICAST,              PRIORITY_LOW,     "LINK CONFIG" },
+  { CMD_HEARTBEAT,       &CommunicationManager::processHeartbeatCommand,   DATA_ON_OFF, CMD_FLAG_NO_DEDUP | CMD_FLAG_NO_ACK | CMD_FLAG_QUIET, PRIORITY_LOW, "HEARTBEAT" },
+  { CMD_LATENCY_REPORT,  &CommunicationManager::processLatencyReportCommand, DATA_ON_OFF, CMD_FLAG_QUIET,                               PRIORITY_LOW,     "LATENCY REPORT" },
+  { CMD_ADDRESS_CONFIG,  &CommunicationManager::processAddressConfigCommand, DATA_ANY,  CMD_FLAG_NO_ACK | CMD_FLAG_UNICAST,            PRIORITY_LOW,     "ADDRESS CONFIG" },
+  { CMD_BLE_CAPTURE,     &CommunicationManager::processBleCaptureCommand,  DATA_ON_OFF, CMD_FLAG_QUIET | CMD_FLAG_UNICAST,               PRIORITY_LOW,     "BLE CAPTURE" },
+  { CMD_LINK_STATS,      &CommunicationManager::processLinkStatsCommand,   DATA_ON_OFF, CMD_FLAG_NO_ACK | CMD_FLAG_QUIET | CMD_FLAG_UNICAST, PRIORITY_LOW,   "LINK STATS" },
+  { CMD_FW_UPDATE,       &CommunicationManager::processFirmwareUpdateCommand, DATA_ANY, CMD_FLAG_NO_DEDUP | CMD_FLAG_NO_ACK | CMD_FLAG_QUIET | CMD_FLAG_UNICAST, PRIORITY_LOW, "FW UPDATE" },
+  { CMD_DISCONNECT,      &CommunicationManager::processDisconnectCommand,  DATA_ON_OFF, CMD_FLAG_STOP,                                   PRIORITY_HIGH,    "DISCONNECT" },
+};
+
+constexpr uint8_t CommunicationManager::COMMAND_COUNT = sizeof(COMMAND_TABLE) / sizeof(COMMAND_TABLE[0]);
+
+namespace {
+typedef CommunicationManager CM;
+
+constexpr bool commandsUnique() {
+  for (uint8_t i = 0; i < CM::COMMAND_COUNT; i++) {
+    for (uint8_t j = i + 1; j < CM::COMMAND_COUNT; j++) {
+      if (CM::COMMAND_TABLE[i].command == CM::COMMAND_TABLE[j].command) return false;
+    }
+  }
+  return true;
+}
 
-    case READ_HEX_STRING:
-      if (receivedByte == ETX) {
-        currentState = WAIT_START;
-        hexString[hexIndex] = '\0';
-        dataReady = true;
-        if (debugSerial) {
-          // BLE: ETX received debug disabled
-        }
-      } else if (hexIndex < MAX_HEX_STRING_SIZE - 1) {
-        hexString[hexIndex++] = receivedByte;
-      }
-      break;
+constexpr bool commandsComplete() {
+  for (uint8_t i = 0; i < CM::COMMAND_COUNT; i++) {
+    const CM::CommandSpec &spec = CM::COMMAND_TABLE[i];
+    if (spec.handler == nullptr || spec.name == nullptr || spec.name[0] == '\0') return false;
+    if (spec.data > CM::DATA_ON_OFF || spec.priority > CM::PRIORITY_HIGH) return false;
+  }
+  return true;
+}
 
-    case FIRST_END:
-      currentState = WAIT_START;
-      break;
+constexpr bool commandFlagsConsistent() {
+  for (uint8_t i = 0; i < CM::COMMAND_COUNT; i++) {
+    const CM::CommandSpec &spec = CM::COMMAND_TABLE[i];
+    // Repeated PUSH only makes sense for ON/OFF commands
+    if ((spec.flags & CM::CMD_FLAG_REPEAT_ON) && spec.data != CM::DATA_ON_OFF) return false;
+    // The stop fast path keys on DATA_OFF
+    if ((spec.flags & CM::CMD_FLAG_STOP) && spec.data != CM::DATA_ON_OFF) return false;
+    // Homing applies to starting (DATA_ON) only
+    if ((spec.flags & CM::CMD_FLAG_HOMED) && spec.data != CM::DATA_ON_OFF) return false;
+    // Batches hold mode/setting commands only: no push-and-hold motion, no link control
+    if ((spec.flags & CM::CMD_FLAG_BATCH) && (spec.flags & (CM::CMD_FLAG_REPEAT_ON | CM::CMD_FLAG_NO_ACK | CM::CMD_FLAG_NO_DEDUP | CM::CMD_FLAG_UNICAST))) return false;
+    if ((spec.flags & CM::CMD_FLAG_BATCH) && spec.priority == CM::PRIORITY_HIGH) return false;
+  }
+  return true;
+}
+
+constexpr bool commandsNotReserved() {
+  for (uint8_t i = 0; i < CM::COMMAND_COUNT; i++) {
+    uint8_t command = CM::COMMAND_TABLE[i].command;
+    // Firmware -> app frames and extended-frame commands never reach the plain dispatcher
+    if (command == CM::CMD_STATE || command == CM::CMD_BATCH || command == CM::CMD_ACK || command == CM::CMD_NACK) return false;
+  }
+  return true;
+}
+
+constexpr CM::CommandIndex buildCommandIndex() {
+  CM::CommandIndex index{};
+  for (int i = 0; i < 256; i++) {
+    index.slot[i] = CM::NO_COMMAND;
   }
+  for (uint8_t i = 0; i < CM::COMMAND_COUNT; i++) {
+    index.slot[CM::COMMAND_TABLE[i].command] = i;
+  }
+  return index;
+}
 }
 
+static_assert(CommunicationManager::COMMAND_COUNT < CommunicationManager::NO_COMMAND, "Command table too large for the index");
+static_assert(commandsUnique(), "Duplicate command byte in COMMAND_TABLE");
+static_assert(commandsComplete(), "COMMAND_TABLE entry without handler, name or valid data/priority");
+static_assert(commandFlagsConsistent(), "COMMAND_TABLE flags do not match the data rule or batch restrictions");
+static_assert(commandsNotReserved(), "Reserved command byte in COMMAND_TABLE");
+static_assert(CM::COMMAND_COUNT < LatencyProbe::MAX_SLOTS, "LatencyProbe::MAX_SLOTS too small for COMMAND_TABLE plus extended frames");
+
+constexpr CommunicationManager::CommandIndex CommunicationManager::COMMAND_INDEX = buildCommandIndex();
+
 /**
- * Process complete frame
+ * Look up a plain command (nullptr if unknown)
  */
-void CommunicationManager::processCompleteFrame(byte *buf, int len) {
-  if (len < PACKET_SIZE) return;
+const CommunicationManager::CommandSpec *CommunicationManager::findCommand(uint8_t command) {
+  uint8_t slot = COMMAND_INDEX.slot[command];
+  return (slot == NO_COMMAND) ? nullptr : &COMMAND_TABLE[slot];
+}
 
-  // Verify packet
-  if (verifyCompletePacket(buf, len)) {
-    processCommand(buf, len);
-  } else {
-    if (debugSerial) {
-      // Invalid packet received debug disabled
-    }
-  }
+/**
+ * Check a command against its table entry without running it
+ * RESULT_INVALID: data1 breaks the entry's data rule; RESULT_REJECTED: the
+ * chair is not in a state that allows it (not homed, intensity outside
+ * COMPRESSION / PERCUSSION / COMBINED).
+ */
+uint8_t CommunicationManager::checkCommand(const CommandSpec &spec, uint8_t data1) const {
+  if (spec.data == DATA_ON_OFF && data1 != DATA_ON && data1 != DATA_OFF) return RESULT_INVALID;
+  if ((spec.flags & CMD_FLAG_HOMED) && data1 == DATA_ON && sequenceController && !sequenceController->getHomeRun()) return RESULT_REJECTED;
+  if (spec.command == CMD_INTENSITY_LEVEL && !isIntensityChangeAllowed()) return RESULT_REJECTED;
+  return RESULT_OK;
 }
 
 /**
- * Process command
+ * Run a command handler once checkCommand() accepts it
+ * With replies = false nothing the handler sends reaches the app (commands
+ * that did not come from the app).
  */
-void CommunicationManager::processCommand(byte *buf, int len) {
-  if (len < PACKET_SIZE) return;
+uint8_t CommunicationManager::dispatchCommand(const CommandSpec &spec, const Packet &packet, bool replies) {
+  uint8_t check = checkCommand(spec, packet.data1);
+  if (check != RESULT_OK) {
+    if (debugSerial && check == RESULT_INVALID) debugSerial->println(">>> INVALID DATA - Ignored");
+    return check;
+  }
+#if LATENCY_PROBES
+  LatencyProbe::markDispatch();
+#endif
+  repliesMuted = !replies;
+  uint8_t result = (this->*spec.handler)(packet);
+  repliesMuted = false;
+#if LATENCY_PROBES
+  LatencyProbe::markHandlerEnd();
+#endif
+  return result;
+}
 
-  uint8_t deviceId = buf[1];
-  uint8_t sequence = buf[2];
-  uint8_t command = buf[3];
-  uint8_t data1 = buf[4];
-  uint8_t data2 = buf[5];
-  uint8_t data3 = buf[6];
+/**
+ * Process a decoded packet (checksum already verified)
+ */
+void CommunicationManager::processPacket(const Packet &packet) {
+  uint8_t deviceId = packet.deviceId;
+  uint8_t sequence = packet.sequence;
+  uint8_t command = packet.command;
+  uint8_t data1 = packet.data1;
+
+  // Only process frames for this board, its groups or broadcast
+  BoardAddress::Match match = boardAddress.match(deviceId);
+  if (match == BoardAddress::MATCH_NONE) {
+    linkStats.addressMismatches++;
+    return;
+  }
+  groupFrame = (match != BoardAddress::MATCH_UNIT);
 
-  // Only process valid device ID
-  if (deviceId != DEVICE_ID) {
-    if (debugSerial) {
-      // Invalid device ID debug disabled
-    }
+  // Unknown commands are refused before deduplication or logging
+  const CommandSpec *spec = findCommand(command);
+  if (!spec) {
+    if (debugSerial) debugSerial->println(">>> UNKNOWN COMMAND - Ignored");
+    sendAck(sequence, command, RESULT_UNKNOWN);
     return;
   }
 
-  // Check if this is a motor PUSH command (allowed to duplicate for continuous operation)
-  bool isMotorPushCommand = ((command == CMD_RECLINE || command == CMD_INCLINE || command == CMD_FORWARD || command == CMD_BACKWARD) && data1 == DATA_ON);
+  // Link and address settings only go to one board
+  if (groupFrame && (spec->flags & CMD_FLAG_UNICAST)) return;
 
-  // Check for duplicate commands
-  if (isCommandDuplicate(sequence, command, data1)) {
-    // Block duplicate EXCEPT for motor PUSH commands (to ensure continuous operation)
-    if (!isMotorPushCommand) {
-      if (debugSerial) {
-        debugSerial->print(">>> DUPLICATE COMMAND - Ignored (within ");
-        debugSerial->print(COMMAND_DUPLICATE_WINDOW_TICKS * 10);
-        debugSerial->println("ms window)");
+  // Heartbeats only carry liveness: they skip deduplication and the command log
+  if (!(spec->flags & CMD_FLAG_NO_DEDUP)) {
+    // Sequence window replaces the time window once negotiated
+    if (sequenceMode == SEQUENCE_WINDOW) {
+      if (isSequenceRejected(sequence)) {
+        linkStats.duplicates++;
+        sendAck(sequence, command, RESULT_DUPLICATE);
+        return;
       }
-      return;
     } else {
-      if (debugSerial) {
-        debugSerial->println(">>> MOTOR PUSH DUPLICATE - Allowed (continuous operation)");
+      // Motor PUSH commands are allowed to duplicate for continuous operation
+      bool repeatAllowed = (spec->flags & CMD_FLAG_REPEAT_ON) && data1 == DATA_ON;
+
+      // Check for duplicate commands
+      if (isCommandDuplicate(sequence, command, data1)) {
+        if (!repeatAllowed) {
+          if (debugSerial) {
+            debugSerial->print(">>> DUPLICATE COMMAND - Ignored (within ");
+            debugSerial->print(COMMAND_DUPLICATE_WINDOW_TICKS * 10);
+            debugSerial->println("ms window)");
+          }
+          linkStats.duplicates++;
+          sendAck(sequence, command, RESULT_DUPLICATE);
+          return;
+        } else {
+          if (debugSerial) {
+            debugSerial->println(">>> MOTOR PUSH DUPLICATE - Allowed (continuous operation)");
+          }
+        }
       }
+
+      // Update last command
+      updateLastCommand(sequence, command, data1);
     }
   }
 
-  // Update last command
-  updateLastCommand(sequence, command, data1);
+  bool logged = debugSerial && !(spec->flags & CMD_FLAG_QUIET);
 
   // Debug output - Command received
-  if (debugSerial) {
+  if (logged) {
     debugSerial->println("\n=== COMMAND RECEIVED ===");
-
-    // Print command name
     debugSerial->print("Command Type: ");
-    switch (command) {
-      case CMD_AUTO: debugSerial->println("AUTO MODE"); break;
-      case CMD_ROLL_MOTOR: debugSerial->println("ROLL MOTOR"); break;
-      case CMD_KNEADING: debugSerial->println("KNEADING"); break;
-      case CMD_PERCUSSION: debugSerial->println("PERCUSSION"); break;
-      case CMD_COMPRESSION: debugSerial->println("COMPRESSION"); break;
-      case CMD_COMBINE: debugSerial->println("COMBINE"); break;
-      case CMD_INTENSITY_LEVEL: debugSerial->println("INTENSITY LEVEL"); break;
-      case CMD_INCLINE: debugSerial->println("INCLINE"); break;
-      case CMD_RECLINE: debugSerial->println("RECLINE"); break;
-      case CMD_FORWARD: debugSerial->println("FORWARD"); break;
-      case CMD_BACKWARD: debugSerial->println("BACKWARD"); break;
-      case CMD_DISCONNECT: debugSerial->println("DISCONNECT"); break;
-      default: debugSerial->println("UNKNOWN"); break;
-    }
-
+    debugSerial->println(spec->name);
     debugSerial->print("Action: ");
     debugSerial->println((data1 == DATA_ON) ? "ON/PUSH" : "OFF/RELEASE");
   }
 
-  // Process command based on type
-  switch (command) {
-    case CMD_AUTO:
-      processAutoCommand(data1);
-      break;
-    case CMD_ROLL_MOTOR:
-      processRollMotorCommand(data1);
-      break;
-    case CMD_KNEADING:
-      processKneadingCommand(data1);
-      break;
-    case CMD_PERCUSSION:
-      processPercussionCommand(data1);
-      break;
-    case CMD_COMPRESSION:
-      processCompressionCommand(data1);
-      break;
-    case CMD_COMBINE:
-      processCombineCommand(data1);
-      break;
-    case CMD_INTENSITY_LEVEL:
-      processIntensityCommand(data1);
-      break;
-    case CMD_INCLINE:
-      processInclineCommand(data1);
-      break;
-    case CMD_RECLINE:
-      processReclineCommand(data1);
-      break;
-    case CMD_FORWARD:
-      processForwardCommand(data1);
-      break;
-    case CMD_BACKWARD:
-      processBackwardCommand(data1);
-      break;
-    case CMD_DISCONNECT:
-      processDisconnectCommand(data1);
-      break;
-    default:
-      if (debugSerial) {
-        debugSerial->println(">>> UNKNOWN COMMAND - Ignored");
-      }
-      break;
+  uint8_t result = dispatchCommand(*spec, packet);
+
+  // LINK_CONFIG answers with its own reply frame, heartbeats are not acked
+  if (!(spec->flags & CMD_FLAG_NO_ACK)) {
+    sendAck(sequence, command, result);
   }
 
   // Debug output - Command processed
-  if (debugSerial) debugSerial->println("=== COMMAND PROCESSED ===\n");
+  if (logged) debugSerial->println("=== COMMAND PROCESSED ===\n");
 }
 
 /**
- * Create packet
+ * Run a command from the service console through its COMMAND_TABLE handler
+ * No deduplication and no ACK (the app did not send it). Link control
+ * (heartbeats, link / address settings) stays with the app.
  */
-void CommunicationManager::createPacket(uint8_t deviceId, uint8_t sequence, uint8_t command,
-                                        uint8_t data1, uint8_t data2, uint8_t data3) {
-  // Create payload
-  uint8_t payload[6] = { deviceId, sequence, command, data1, data2, data3 };
-
-  // Calculate checksum
-  uint8_t checksum = calculate_checksum1(payload, 6);
-
-  // Create complete packet
-  uint8_t packet[9];
-  packet[0] = STX;
-  packet[1] = deviceId;
-  packet[2] = sequence;
-  packet[3] = command;
-  packet[4] = data1;
-  packet[5] = data2;
-  packet[6] = data3;
-  packet[7] = checksum;
-  packet[8] = ETX;
-
-
-  // Send packet via BLE
-  if (bleSerial) {
-    bleSerial->write(packet, 9);
-  }
+uint8_t CommunicationManager::runLocalCommand(uint8_t command, uint8_t data1, uint8_t data2) {
+  const CommandSpec *spec = findCommand(command);
+  if (!spec) return RESULT_UNKNOWN;
+  if (spec->flags & (CMD_FLAG_NO_DEDUP | CMD_FLAG_UNICAST)) return RESULT_REJECTED;
+
+  Packet packet = { boardAddress.getUnit(), 0x00, command, data1, data2, 0x00, 0x00 };
+  return dispatchCommand(*spec, packet, false);
 }
 
 /**
- * Calculate checksum
+ * Process a decoded extended frame (checksum already verified)
+ * Body: DeviceID, Sequence, Command, data bytes, Checksum
  */
-uint8_t CommunicationManager::calculate_checksum1(const uint8_t *data, int len) {
-  uint16_t sum = 0;
-
-  // Sum all bytes from index 0 to (len-1) for payload only
-  int start_index = 0;
-  int end_index = len - 1;
+void CommunicationManager::processExtendedFrame(const Frame &frame) {
+  uint8_t deviceId = frame.body[0];
+  uint8_t sequence = frame.body[1];
+  uint8_t command = frame.body[2];
+
+  // Only process frames for this board, its groups or broadcast
+  BoardAddress::Match match = boardAddress.match(deviceId);
+  if (match == BoardAddress::MATCH_NONE) {
+    linkStats.addressMismatches++;
+    return;
+  }
+  groupFrame = (match != BoardAddress::MATCH_UNIT);
 
-  // For 6-byte payload: sum bytes 0-5
-  if (len == 6) {
-    end_index = 5;
+  // Update chunks carry their own offset and CRC, so resent ones are harmless
+  if (command == CMD_FW_UPDATE) {
+    if (!groupFrame) handleFirmwareUpdate(sequence, frame.body + BATCH_HEADER_SIZE, frame.length - BATCH_HEADER_SIZE - 1);
+    return;
   }
 
-  for (int i = start_index; i <= end_index; i++) {
-    sum += data[i];
+  // Same deduplication as plain commands (first data byte as legacy key)
+  if (sequenceMode == SEQUENCE_WINDOW) {
+    if (isSequenceRejected(sequence)) {
+      linkStats.duplicates++;
+      sendAck(sequence, command, RESULT_DUPLICATE);
+      return;
+    }
+  } else {
+    if (isCommandDuplicate(sequence, command, frame.body[BATCH_HEADER_SIZE])) {
+      if (debugSerial) debugSerial->println(">>> DUPLICATE EXTENDED FRAME - Ignored");
+      linkStats.duplicates++;
+      sendAck(sequence, command, RESULT_DUPLICATE);
+      return;
+    }
+    updateLastCommand(sequence, command, frame.body[BATCH_HEADER_SIZE]);
   }
 
-  // Add carry (Internet checksum style)
-  while (sum >> 8) {
-    sum = (sum & 0xFF) + (sum >> 8);
+  uint8_t result;
+  switch (command) {
+    case CMD_BATCH:
+      result = processBatchCommand(frame);
+      break;
+    default:
+      if (debugSerial) debugSerial->println(">>> UNKNOWN EXTENDED FRAME - Ignored");
+      result = RESULT_UNKNOWN;
+      break;
   }
+  sendAck(sequence, command, result);
+}
 
-  // One's complement + 0x10 offset
-  uint8_t result = ((~sum) + 0x10) & 0xFF;
+/**
+ * Create packet
+ */
+void CommunicationManager::createPacket(uint8_t deviceId, uint8_t sequence, uint8_t command,
+                                        uint8_t data1, uint8_t data2, uint8_t data3) {
+  Packet packet = { deviceId, sequence, command, data1, data2, data3, 0 };
+  PacketCodec::seal(packet);
 
-  return result;
+  sendFrame(reinterpret_cast<const uint8_t *>(&packet), PacketCodec::BODY_SIZE);
 }
 
 /**
- * Verify complete packet
+ * Send a frame body (checksum included) in the negotiated framing
+ * Hex framing is the same STX + ASCII hex + ETX form the app sends.
+ * The frame is queued and started at once as far as the UART TX buffer has
+ * room; the rest follows from processTransmit(). Returns false if the lane
+ * is full (counted by the queue) or the module cannot take frames.
  */
-bool CommunicationManager::verifyCompletePacket(uint8_t *packet, int length) {
-  // Quick checks
-  if (length != PACKET_SIZE) {
-    if (debugSerial) {
-      debugSerial->print("!!! Invalid length: ");
-      debugSerial->println(length);
-    }
-    return false;
-  }
-
-  if (packet[0] != STX || packet[8] != ETX) {
-    if (debugSerial) debugSerial->println("!!! Invalid STX/ETX");
-    return false;
+bool CommunicationManager::sendFrame(const uint8_t *body, int len, BleTxQueue::Lane lane) {
+  if (!bleSerial || len > PacketCodec::MAX_BODY_SIZE) return false;
+  if (repliesMuted) return false;            // Local command: the app did not ask
+  if (hm10 && hm10->isBusy()) return false;  // Module would take it as AT input
+
+  uint8_t frame[PacketCodec::MAX_FRAME_SIZE];
+  int frameLen;
+  if (txFraming == FRAMING_BINARY) {
+    frameLen = PacketCodec::encodeBinary(body, len, frame);
+  } else {
+    frameLen = PacketCodec::encodeHex(body, len, frame);
   }
-
-  // Extract payload and verify checksum
-  uint8_t payload[PAYLOAD_SIZE];
-  for (int i = 0; i < PAYLOAD_SIZE; i++) {
-    payload[i] = packet[i + 1];
+  bool queued = txQueue.enqueue(lane, frame, (uint8_t)frameLen);
+  if (queued) {
+    linkStats.framesOut++;
+    linkStats.bytesOut += frameLen;
   }
+  txQueue.pump();
+  return queued;
+}
 
-  uint8_t calculatedChecksum = calculate_checksum1(payload, PAYLOAD_SIZE);
-  uint8_t receivedChecksum = packet[7];
-
-  if (calculatedChecksum != receivedChecksum) {
-    if (debugSerial) {
-      debugSerial->print("!!! Checksum mismatch: Calc=0x");
-      if (calculatedChecksum < 0x10) debugSerial->print("0");
-      debugSerial->print(calculatedChecksum, HEX);
-      debugSerial->print(" Recv=0x");
-      if (receivedChecksum < 0x10) debugSerial->print("0");
-      debugSerial->println(receivedChecksum, HEX);
-    }
-    return false;
+/**
+ * Move queued frames into the UART TX buffer (called every loop pass)
+ * Frames still queued when the module starts a reset or AT exchange are
+ * dropped: they would be taken as AT input and the link is going away.
+ */
+void CommunicationManager::processTransmit() {
+  if (hm10 && hm10->isBusy()) {
+    txQueue.clear();
+    return;
   }
-
-  // if (debugSerial) debugSerial->println("✓ Packet valid");
-  return true;
+  txQueue.pump();
 }
 
 /**
@@ -443,30 +859,12 @@ void CommunicationManager::checkCommandCounters() {
 }
 
 /**
- * Check if command is duplicate
+ * Check if command is duplicate (no output: the stop fast path asks first,
+ * the caller reports what it ignores)
  */
 bool CommunicationManager::isCommandDuplicate(uint8_t sequence, uint8_t command, uint8_t data1) {
   unsigned long currentTick = timerManager->getMasterTicks();
 
-  if (debugSerial) {
-    // debugSerial->print("DEDUP CHECK: Seq=");
-    debugSerial->print(sequence, HEX);
-    debugSerial->print(" Cmd=");
-    debugSerial->print(command, HEX);
-    debugSerial->print(" Data1=");
-    debugSerial->print(data1, HEX);
-    debugSerial->print(" | Last: Seq=");
-    debugSerial->print(lastCommand.sequence, HEX);
-    debugSerial->print(" Cmd=");
-    debugSerial->print(lastCommand.command, HEX);
-    debugSerial->print(" Data1=");
-    debugSerial->print(lastCommand.data1, HEX);
-    debugSerial->print(" TimeDiff=");
-    debugSerial->print(currentTick - lastCommand.timestamp);
-    debugSerial->print(" Window=");
-    debugSerial->println(COMMAND_DUPLICATE_WINDOW_TICKS);
-  }
-
   if (lastCommand.sequence == sequence && lastCommand.command == command && lastCommand.data1 == data1 && (currentTick - lastCommand.timestamp) < COMMAND_DUPLICATE_WINDOW_TICKS) {
     return true;
   }
@@ -484,6 +882,36 @@ void CommunicationManager::updateLastCommand(uint8_t sequence, uint8_t command,
   lastCommand.timestamp = timerManager->getMasterTicks();
 }
 
+/**
+ * Sequence-window check (SEQUENCE_WINDOW mode)
+ * Returns true if the frame was already seen or is older than the window.
+ */
+bool CommunicationManager::isSequenceRejected(uint8_t sequence) {
+  SequenceWindow::Result result = sequenceWindow.check(sequence);
+  if (result == SequenceWindow::ACCEPTED) return false;
+
+  if (result == SequenceWindow::DUPLICATE) {
+    sequenceDuplicates++;
+    if (debugSerial) debugSerial->println(">>> DUPLICATE SEQUENCE - Ignored");
+  } else {
+    sequenceStale++;
+    if (debugSerial) debugSerial->println(">>> STALE SEQUENCE - Ignored");
+  }
+  return true;
+}
+
+/**
+ * Select the deduplication mode (the window restarts either way)
+ */
+void CommunicationManager::setSequenceMode(uint8_t mode) {
+  sequenceMode = (mode == SEQUENCE_WINDOW) ? SEQUENCE_WINDOW : SEQUENCE_LEGACY;
+  sequenceWindow.reset();
+  if (debugSerial) {
+    debugSerial->print("LINK: Sequence = ");
+    debugSerial->println(sequenceMode == SEQUENCE_WINDOW ? "WINDOW" : "LEGACY");
+  }
+}
+
 /**
  * Command counter management
  */
@@ -516,99 +944,58 @@ bool CommunicationManager::isOffCmdTimerActive() const {
 }
 
 /**
- * Utility functions
+ * Private helper functions
  */
-int CommunicationManager::hexStringToBytes(const char *hexStr, byte *outBytes) {
-  int len = strlen(hexStr);
-  int byteCount = 0;
-
-  for (int i = 0; i < len; i += 2) {
-    if (i + 1 < len) {
-      outBytes[byteCount++] = (hexCharToByte(hexStr[i]) << 4) | hexCharToByte(hexStr[i + 1]);
-    }
+void CommunicationManager::resetDataBuffers() {
+  bleRxRing.clear();
+  commandQueue.clear();
+  hexDecoder.reset();
+  binDecoder.reset();
+  if (bleDma) {
+    bleDma->reset();
   }
-
-  return byteCount;
 }
 
-byte CommunicationManager::hexCharToByte(char c) {
-  if (c >= '0' && c <= '9') return c - '0';
-  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-  return 0;
-}
-
-void CommunicationManager::processHexString(char hexString[], byte data[], int &dataLength) {
-  dataLength = hexStringToBytes(hexString, data);
-}
-
-void CommunicationManager::printProcessedData(byte data[], int length) {
-  // Debug output removed to reduce spam
+void CommunicationManager::resetParseStates() {
+  hexDecoder.reset();
 }
 
 /**
- * Private helper functions
+ * Command processing functions (placeholders - would need integration with other classes)
+ * Reached through dispatchCommand() only: checkCommand() has already refused
+ * DATA_ON before GO HOME for the CMD_FLAG_HOMED programs.
  */
-void CommunicationManager::resetDataBuffers() {
-  memset(data1, 0, sizeof(data1));
-  memset(data2, 0, sizeof(data2));
-  memset(hexString1, 0, sizeof(hexString1));
-  memset(hexString2, 0, sizeof(hexString2));
-  memset(rawBuffer, 0, sizeof(rawBuffer));
-
-  dataLen1 = 0;
-  dataLen2 = 0;
-  hexIdx1 = 0;
-  hexIdx2 = 0;
-  dataReady1 = false;
-  dataReady2 = false;
-  rawBufferIndex = 0;
-}
-
-void CommunicationManager::resetParseStates() {
-  state1 = WAIT_START;
-  state2 = WAIT_START;
-}
-
-/**
- * Command processing functions (placeholders - would need integration with other classes)
- */
-void CommunicationManager::processAutoCommand(uint8_t data1) {
+uint8_t CommunicationManager::processAutoCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     // if (debugSerial) debugSerial->println(">>> AUTO RUN - Starting DEFAULT program");
     if (sequenceController) {
       // Debug: Check system status (disabled to save FLASH)
       // if (debugSerial) {
       //   debugSerial->print("AUTO DEBUG: homeRun=");
-      //   debugSerial->print(((SequenceController *)sequenceController)->getHomeRun() ? "TRUE" : "FALSE");
+      //   debugSerial->print(sequenceController->getHomeRun() ? "TRUE" : "FALSE");
       //   debugSerial->print(", manualPriority=");
       //   debugSerial->print(getManualPriority() ? "TRUE" : "FALSE");
       //   debugSerial->print(", modeAuto=");
-      //   debugSerial->print(((SequenceController *)sequenceController)->getModeAuto() ? "TRUE" : "FALSE");
+      //   debugSerial->print(sequenceController->getModeAuto() ? "TRUE" : "FALSE");
       //   debugSerial->println();
       // }
 
-      // Check if system is homed first
-      if (!((SequenceController *)sequenceController)->getHomeRun()) {
-        // if (debugSerial) debugSerial->println("ERROR: Cannot start AUTO - Not homed! Please run GO HOME first");
-        return;
-      }
-
       // Clear all other modes first (like original code)
-      ((SequenceController *)sequenceController)->setKneadingMode(false);
-      ((SequenceController *)sequenceController)->setCompressionMode(false);
-      ((SequenceController *)sequenceController)->setPercussionMode(false);
-      ((SequenceController *)sequenceController)->setCombineMode(false);
+      sequenceController->setKneadingMode(false);
+      sequenceController->setCompressionMode(false);
+      sequenceController->setPercussionMode(false);
+      sequenceController->setCombineMode(false);
 
       // Set autodefaultMode (this is CMD_AUTO's unique mode)
-      ((SequenceController *)sequenceController)->setAutodefaultMode(true);
+      sequenceController->setAutodefaultMode(true);
       if (debugSerial) debugSerial->println("DEBUG: autodefaultMode set to TRUE");
 
       // AUTO_DEFAULT: Roll motor is ALWAYS ON (cannot be toggled)
       if (debugSerial) debugSerial->println("    Roll Motor: ON (DEFAULT - cannot be disabled in this mode)");
 
       // Start auto mode with 20-minute timer
-      ((SequenceController *)sequenceController)->startAutoMode();
+      startAutoMode();
 
       if (debugSerial) debugSerial->println("AUTO: Mode started successfully");
     }
@@ -616,15 +1003,17 @@ void CommunicationManager::processAutoCommand(uint8_t data1) {
     if (debugSerial) debugSerial->println(">>> AUTO STOP - Stopping all programs");
     if (sequenceController) {
       if (debugSerial) debugSerial->println("DEBUG: sequenceController is valid, calling stopAutoMode()");
-      ((SequenceController *)sequenceController)->stopAutoMode();
+      stopAutoMode();
       if (debugSerial) debugSerial->println("DEBUG: stopAutoMode() call completed");
     } else {
       if (debugSerial) debugSerial->println("ERROR: sequenceController is NULL!");
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processRollMotorCommand(uint8_t data1) {
+uint8_t CommunicationManager::processRollMotorCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     if (debugSerial) debugSerial->println(">>> ROLL MOTOR ON");
     
@@ -634,12 +1023,12 @@ void CommunicationManager::processRollMotorCommand(uint8_t data1) {
     
     // Reset flag to allow auto programs to control roll motor again
     if (sequenceController) {
-      ((SequenceController *)sequenceController)->setRollMotorUserDisabled(false);
+      sequenceController->setRollMotorUserDisabled(false);
       if (debugSerial) debugSerial->println("ROLL: Roll motor enabled by user - auto programs can control it again");
     }
     
     if (motorController) {
-      ((MotorController *)motorController)->onRollMotor();
+      motorController->onRollMotor();
     }
   } else if (data1 == DATA_OFF) {
     if (debugSerial) debugSerial->println("<<< ROLL MOTOR OFF");
@@ -650,42 +1039,38 @@ void CommunicationManager::processRollMotorCommand(uint8_t data1) {
     
     // Set flag to prevent auto programs from restarting roll motor
     if (sequenceController) {
-      ((SequenceController *)sequenceController)->setRollMotorUserDisabled(true);
+      sequenceController->setRollMotorUserDisabled(true);
       if (debugSerial) debugSerial->println("ROLL: Roll motor disabled by user - auto programs will not restart it");
     }
     
     if (motorController) {
-      ((MotorController *)motorController)->offRollMotor();
+      motorController->offRollMotor();
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processKneadingCommand(uint8_t data1) {
+uint8_t CommunicationManager::processKneadingCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     // if (debugSerial) debugSerial->println(">>> KNEADING MODE ON");
     
     if (sequenceController) {
-      // Check if system is homed first
-      if (!((SequenceController*)sequenceController)->getHomeRun()) {
-        // if (debugSerial) debugSerial->println("ERROR: Cannot start KNEADING - Not homed! Please run GO HOME first");
-        return;
-      }
-      
       // Clear all other modes first
-      ((SequenceController*)sequenceController)->setAutodefaultMode(false);
-      ((SequenceController*)sequenceController)->setCompressionMode(false);
-      ((SequenceController*)sequenceController)->setPercussionMode(false);
-      ((SequenceController*)sequenceController)->setCombineMode(false);
+      sequenceController->setAutodefaultMode(false);
+      sequenceController->setCompressionMode(false);
+      sequenceController->setPercussionMode(false);
+      sequenceController->setCombineMode(false);
       
       // Reset roll motor user disabled flag - roll motor enabled by default in KNEADING mode
-      ((SequenceController*)sequenceController)->setRollMotorUserDisabled(false);
+      sequenceController->setRollMotorUserDisabled(false);
       
       // Set kneading mode
-      ((SequenceController*)sequenceController)->setKneadingMode(true);
+      sequenceController->setKneadingMode(true);
       
       // Start auto mode if not already running
-      if (!((SequenceController*)sequenceController)->getModeAuto()) {
-        ((SequenceController*)sequenceController)->startAutoMode();
+      if (!sequenceController->getModeAuto()) {
+        startAutoMode();
         // if (debugSerial) debugSerial->println("KNEADING: Auto mode started");
       }
       
@@ -696,48 +1081,44 @@ void CommunicationManager::processKneadingCommand(uint8_t data1) {
     
     if (sequenceController) {
       // Stop kneading mode
-      ((SequenceController*)sequenceController)->setKneadingMode(false);
+      sequenceController->setKneadingMode(false);
       
       // If no other modes are active, stop auto mode
-      if (!((SequenceController*)sequenceController)->getAutodefaultMode() &&
-          !((SequenceController*)sequenceController)->getCompressionMode() &&
-          !((SequenceController*)sequenceController)->getPercussionMode() &&
-          !((SequenceController*)sequenceController)->getCombineMode()) {
-        ((SequenceController*)sequenceController)->stopAutoMode();
+      if (!sequenceController->getAutodefaultMode() &&
+          !sequenceController->getCompressionMode() &&
+          !sequenceController->getPercussionMode() &&
+          !sequenceController->getCombineMode()) {
+        stopAutoMode();
         if (debugSerial) debugSerial->println("KNEADING: Auto mode stopped - no active programs");
       }
       
       if (debugSerial) debugSerial->println("KNEADING: Mode disabled");
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processPercussionCommand(uint8_t data1) {
+uint8_t CommunicationManager::processPercussionCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     // if (debugSerial) debugSerial->println(">>> PERCUSSION MODE ON");
     
     if (sequenceController) {
-      // Check if system is homed first
-      if (!((SequenceController*)sequenceController)->getHomeRun()) {
-        // if (debugSerial) debugSerial->println("ERROR: Cannot start PERCUSSION - Not homed! Please run GO HOME first");
-        return;
-      }
-      
       // Clear all other modes first
-      ((SequenceController*)sequenceController)->setAutodefaultMode(false);
-      ((SequenceController*)sequenceController)->setKneadingMode(false);
-      ((SequenceController*)sequenceController)->setCompressionMode(false);
-      ((SequenceController*)sequenceController)->setCombineMode(false);
+      sequenceController->setAutodefaultMode(false);
+      sequenceController->setKneadingMode(false);
+      sequenceController->setCompressionMode(false);
+      sequenceController->setCombineMode(false);
       
       // Reset roll motor user disabled flag - roll motor enabled by default in PERCUSSION mode
-      ((SequenceController*)sequenceController)->setRollMotorUserDisabled(false);
+      sequenceController->setRollMotorUserDisabled(false);
       
       // Set percussion mode
-      ((SequenceController*)sequenceController)->setPercussionMode(true);
+      sequenceController->setPercussionMode(true);
       
       // Start auto mode if not already running
-      if (!((SequenceController*)sequenceController)->getModeAuto()) {
-        ((SequenceController*)sequenceController)->startAutoMode();
+      if (!sequenceController->getModeAuto()) {
+        startAutoMode();
         // if (debugSerial) debugSerial->println("PERCUSSION: Auto mode started");
       }
       
@@ -748,48 +1129,44 @@ void CommunicationManager::processPercussionCommand(uint8_t data1) {
     
     if (sequenceController) {
       // Stop percussion mode
-      ((SequenceController*)sequenceController)->setPercussionMode(false);
+      sequenceController->setPercussionMode(false);
       
       // If no other modes are active, stop auto mode
-      if (!((SequenceController*)sequenceController)->getAutodefaultMode() &&
-          !((SequenceController*)sequenceController)->getKneadingMode() &&
-          !((SequenceController*)sequenceController)->getCompressionMode() &&
-          !((SequenceController*)sequenceController)->getCombineMode()) {
-        ((SequenceController*)sequenceController)->stopAutoMode();
+      if (!sequenceController->getAutodefaultMode() &&
+          !sequenceController->getKneadingMode() &&
+          !sequenceController->getCompressionMode() &&
+          !sequenceController->getCombineMode()) {
+        stopAutoMode();
         if (debugSerial) debugSerial->println("PERCUSSION: Auto mode stopped - no active programs");
       }
       
       if (debugSerial) debugSerial->println("PERCUSSION: Mode disabled");
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processCompressionCommand(uint8_t data1) {
+uint8_t CommunicationManager::processCompressionCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     // if (debugSerial) debugSerial->println(">>> COMPRESSION MODE ON");
     
     if (sequenceController) {
-      // Check if system is homed first
-      if (!((SequenceController*)sequenceController)->getHomeRun()) {
-        // if (debugSerial) debugSerial->println("ERROR: Cannot start COMPRESSION - Not homed! Please run GO HOME first");
-        return;
-      }
-      
       // Clear all other modes first
-      ((SequenceController*)sequenceController)->setAutodefaultMode(false);
-      ((SequenceController*)sequenceController)->setKneadingMode(false);
-      ((SequenceController*)sequenceController)->setPercussionMode(false);
-      ((SequenceController*)sequenceController)->setCombineMode(false);
+      sequenceController->setAutodefaultMode(false);
+      sequenceController->setKneadingMode(false);
+      sequenceController->setPercussionMode(false);
+      sequenceController->setCombineMode(false);
       
       // Reset roll motor user disabled flag - roll motor enabled by default in COMPRESSION mode
-      ((SequenceController*)sequenceController)->setRollMotorUserDisabled(false);
+      sequenceController->setRollMotorUserDisabled(false);
       
       // Set compression mode
-      ((SequenceController*)sequenceController)->setCompressionMode(true);
+      sequenceController->setCompressionMode(true);
       
       // Start auto mode if not already running
-      if (!((SequenceController*)sequenceController)->getModeAuto()) {
-        ((SequenceController*)sequenceController)->startAutoMode();
+      if (!sequenceController->getModeAuto()) {
+        startAutoMode();
         // if (debugSerial) debugSerial->println("COMPRESSION: Auto mode started");
       }
       
@@ -800,48 +1177,44 @@ void CommunicationManager::processCompressionCommand(uint8_t data1) {
     
     if (sequenceController) {
       // Stop compression mode
-      ((SequenceController*)sequenceController)->setCompressionMode(false);
+      sequenceController->setCompressionMode(false);
       
       // If no other modes are active, stop auto mode
-      if (!((SequenceController*)sequenceController)->getAutodefaultMode() &&
-          !((SequenceController*)sequenceController)->getKneadingMode() &&
-          !((SequenceController*)sequenceController)->getPercussionMode() &&
-          !((SequenceController*)sequenceController)->getCombineMode()) {
-        ((SequenceController*)sequenceController)->stopAutoMode();
+      if (!sequenceController->getAutodefaultMode() &&
+          !sequenceController->getKneadingMode() &&
+          !sequenceController->getPercussionMode() &&
+          !sequenceController->getCombineMode()) {
+        stopAutoMode();
         if (debugSerial) debugSerial->println("COMPRESSION: Auto mode stopped - no active programs");
       }
       
       if (debugSerial) debugSerial->println("COMPRESSION: Mode disabled");
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processCombineCommand(uint8_t data1) {
+uint8_t CommunicationManager::processCombineCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     // if (debugSerial) debugSerial->println(">>> COMBINE MODE ON");
     
     if (sequenceController) {
-      // Check if system is homed first
-      if (!((SequenceController*)sequenceController)->getHomeRun()) {
-        // if (debugSerial) debugSerial->println("ERROR: Cannot start COMBINE - Not homed! Please run GO HOME first");
-        return;
-      }
-      
       // Clear all other modes first
-      ((SequenceController*)sequenceController)->setAutodefaultMode(false);
-      ((SequenceController*)sequenceController)->setKneadingMode(false);
-      ((SequenceController*)sequenceController)->setCompressionMode(false);
-      ((SequenceController*)sequenceController)->setPercussionMode(false);
+      sequenceController->setAutodefaultMode(false);
+      sequenceController->setKneadingMode(false);
+      sequenceController->setCompressionMode(false);
+      sequenceController->setPercussionMode(false);
       
       // Reset roll motor user disabled flag - roll motor enabled by default in COMBINE mode
-      ((SequenceController*)sequenceController)->setRollMotorUserDisabled(false);
+      sequenceController->setRollMotorUserDisabled(false);
       
       // Set combine mode
-      ((SequenceController*)sequenceController)->setCombineMode(true);
+      sequenceController->setCombineMode(true);
       
       // Start auto mode if not already running
-      if (!((SequenceController*)sequenceController)->getModeAuto()) {
-        ((SequenceController*)sequenceController)->startAutoMode();
+      if (!sequenceController->getModeAuto()) {
+        startAutoMode();
         // if (debugSerial) debugSerial->println("COMBINE: Auto mode started");
       }
     }
@@ -849,14 +1222,16 @@ void CommunicationManager::processCombineCommand(uint8_t data1) {
     // if (debugSerial) debugSerial->println("<<< COMBINE MODE OFF");
     
     if (sequenceController) {
-      ((SequenceController*)sequenceController)->setCombineMode(false);
-      ((SequenceController*)sequenceController)->stopAutoMode();
+      sequenceController->setCombineMode(false);
+      stopAutoMode();
       // if (debugSerial) debugSerial->println("COMBINE: Auto mode stopped");
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processIntensityCommand(uint8_t data1) {
+uint8_t CommunicationManager::processIntensityCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (debugSerial) {
     debugSerial->print(">>> INTENSITY LEVEL: ");
     if (data1 == INTENSITY_HIGH) {
@@ -876,134 +1251,168 @@ void CommunicationManager::processIntensityCommand(uint8_t data1) {
   if (sequenceController) {
     uint8_t intensityValue;
     if (data1 == INTENSITY_HIGH) {
-      intensityValue = 254;  // HIGH intensity (PWM=254)
+      intensityValue = intensityHighPWM;  // HIGH intensity (PWM=254 by default)
     } else if (data1 == INTENSITY_LOW) {
-      intensityValue = 160;  // LOW intensity (PWM=160)
+      intensityValue = intensityLowPWM;   // LOW intensity (PWM=160 by default)
     } else if (data1 == DATA_OFF) {
       // Use setIntensityOff() for proper OFF handling with reason
-      ((SequenceController*)sequenceController)->setIntensityOff("Remote OFF command");
-      return;  // Exit early since setIntensityOff() handles everything
+      sequenceController->setIntensityOff("Remote OFF command");
+      return RESULT_OK;  // Exit early since setIntensityOff() handles everything
     } else {
       // Custom intensity level (0-255)
       intensityValue = data1;
     }
     
-    ((SequenceController*)sequenceController)->setIntensityLevel(intensityValue);
+    sequenceController->setIntensityLevel(intensityValue);
     if (debugSerial) {
       debugSerial->print("INTENSITY: Set to ");
       debugSerial->println(intensityValue);
     }
   }
+  return RESULT_OK;
+}
+
+/**
+ * Start, renew or drop the hold lease of a manual motor after its PUSH
+ * data2 = lease in ticks (0 = legacy app repeating PUSH, hard timeout only)
+ */
+static void applyHoldLease(MotorController *motors, MotorController::MotorType motor, uint8_t leaseTicks) {
+  if (leaseTicks == 0) {
+    motors->clearMotorTimeout(motor);
+    return;
+  }
+  if (leaseTicks < CommunicationManager::HOLD_LEASE_MIN_TICKS) leaseTicks = CommunicationManager::HOLD_LEASE_MIN_TICKS;
+  motors->setMotorTimeout(motor, leaseTicks);
 }
 
-void CommunicationManager::processInclineCommand(uint8_t data1) {
+uint8_t CommunicationManager::processInclineCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     if (debugSerial) debugSerial->println(">>> INCLINE PUSH");
     if (motorController) {
       // Set manual priority (pause auto mode)
       setManualPriority(true);
       // Stop roll motor first (safety)
-      ((MotorController *)motorController)->offRollMotor();
-      // Start incline motor (will continue running until release)
-      ((MotorController *)motorController)->onIncline();
+      motorController->offRollMotor();
+      // Start incline motor (will continue running until release or lease end)
+      motorController->onIncline();
+      applyHoldLease(motorController, MotorController::RL1_RECLINE_INCLINE, packet.data2);
     }
   } else if (data1 == DATA_OFF) {
     if (debugSerial) debugSerial->println("<<< INCLINE RELEASE - Motor stopped");
     if (motorController) {
       // Stop incline motor immediately
-      ((MotorController *)motorController)->offReclineIncline();
+      motorController->offReclineIncline();
       // Clear manual priority (resume auto mode)
       setManualPriority(false);
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processReclineCommand(uint8_t data1) {
+uint8_t CommunicationManager::processReclineCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     if (debugSerial) debugSerial->println(">>> RECLINE PUSH");
     if (motorController) {
       // Set manual priority (pause auto mode)
       setManualPriority(true);
       // Stop roll motor first (safety)
-      ((MotorController *)motorController)->offRollMotor();
-      // Start recline motor (will continue running until release)
-      ((MotorController *)motorController)->onRecline();
+      motorController->offRollMotor();
+      // Start recline motor (will continue running until release or lease end)
+      motorController->onRecline();
+      applyHoldLease(motorController, MotorController::RL1_RECLINE_INCLINE, packet.data2);
     }
   } else if (data1 == DATA_OFF) {
     if (debugSerial) debugSerial->println("<<< RECLINE RELEASE - Motor stopped");
     if (motorController) {
       // Stop recline motor immediately
-      ((MotorController *)motorController)->offReclineIncline();
+      motorController->offReclineIncline();
       // Clear manual priority (resume auto mode)
       setManualPriority(false);
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processForwardCommand(uint8_t data1) {
+uint8_t CommunicationManager::processForwardCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     if (debugSerial) debugSerial->println(">>> FORWARD PUSH");
     if (motorController) {
       // Set manual priority (pause auto mode)
       setManualPriority(true);
       // Stop roll motor first (safety)
-      ((MotorController *)motorController)->offRollMotor();
-      // Start forward motor (will continue running until release)
-      ((MotorController *)motorController)->onForward();
+      motorController->offRollMotor();
+      // Start forward motor (will continue running until release or lease end)
+      motorController->onForward();
+      applyHoldLease(motorController, MotorController::RL2_FORWARD_BACKWARD, packet.data2);
     }
   } else if (data1 == DATA_OFF) {
     if (debugSerial) debugSerial->println("<<< FORWARD RELEASE - Motor stopped");
     if (motorController) {
       // Stop forward motor immediately
-      ((MotorController *)motorController)->offForwardBackward();
+      motorController->offForwardBackward();
       // Clear manual priority (resume auto mode)
       setManualPriority(false);
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processBackwardCommand(uint8_t data1) {
+uint8_t CommunicationManager::processBackwardCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_ON) {
     if (debugSerial) debugSerial->println(">>> BACKWARD PUSH");
     if (motorController) {
       // Set manual priority (pause auto mode)
       setManualPriority(true);
       // Stop roll motor first (safety)
-      ((MotorController *)motorController)->offRollMotor();
-      // Start backward motor (will continue running until release)
-      ((MotorController *)motorController)->onBackward();
+      motorController->offRollMotor();
+      // Start backward motor (will continue running until release or lease end)
+      motorController->onBackward();
+      applyHoldLease(motorController, MotorController::RL2_FORWARD_BACKWARD, packet.data2);
     }
   } else if (data1 == DATA_OFF) {
     if (debugSerial) debugSerial->println("<<< BACKWARD RELEASE - Motor stopped");
     if (motorController) {
       // Stop backward motor immediately
-      ((MotorController *)motorController)->offForwardBackward();
+      motorController->offForwardBackward();
       // Clear manual priority (resume auto mode)
       setManualPriority(false);
     }
   }
+  return RESULT_OK;
 }
 
-void CommunicationManager::processDisconnectCommand(uint8_t data1) {
+uint8_t CommunicationManager::processDisconnectCommand(const Packet &packet) {
+  uint8_t data1 = packet.data1;
   if (data1 == DATA_OFF) {
     // ✨ DISCONNECT = AUTO MODE OFF (same behavior)
     if (debugSerial) debugSerial->println(">>> AUTO STOP - Stopping all programs");
     
     // Stop all position motors first (safety)
     if (motorController) {
-      ((MotorController *)motorController)->offForwardBackward();
-      ((MotorController *)motorController)->offReclineIncline();
+      motorController->offForwardBackward();
+      motorController->offReclineIncline();
     }
     
     // Stop AUTO mode (same as AUTO OFF command)
     if (sequenceController) {
       if (debugSerial) debugSerial->println("DEBUG: sequenceController is valid, calling stopAutoMode()");
-      ((SequenceController *)sequenceController)->stopAutoMode();
+      sequenceController->stopAutoMode();
       if (debugSerial) debugSerial->println("DEBUG: stopAutoMode() call completed");
     } else {
       if (debugSerial) debugSerial->println("ERROR: sequenceController is NULL!");
     }
     
+    // Next connection starts with legacy link options until it negotiates again
+    resetLinkOptions();
+
+    // App closed the link on purpose
+    linkActivityPending = false;
+    if (linkUp) setLinkDown(false);
+
     // Reset BLE module (only for DISCONNECT, not for AUTO OFF)
     resetHM10();
     if (debugSerial) debugSerial->println("  - BLE module reset");
@@ -1012,4 +1421,846 @@ void CommunicationManager::processDisconnectCommand(uint8_t data1) {
     if (debugSerial) debugSerial->println(">>> CONNECTED");
     // Connection established - no action needed
   }
+  return RESULT_OK;
+}
+
+/**
+ * Link configuration (framing negotiation)
+ * Data1 = option, Data2 = requested value. The reply carries the accepted
+ * value and is sent in the old framing; the new framing applies afterwards.
+ */
+uint8_t CommunicationManager::processLinkConfigCommand(const Packet &packet) {
+  if (packet.data1 == LINK_OPT_FRAMING) {
+    uint8_t framing = (packet.data2 == FRAMING_BINARY) ? FRAMING_BINARY : FRAMING_HEX;
+    createPacket(boardAddress.getUnit(), packet.sequence, CMD_LINK_CONFIG, LINK_OPT_FRAMING, framing, 0x00);
+    setTxFraming(framing);
+  } else if (packet.data1 == LINK_OPT_SEQUENCE) {
+    // The window starts at the next frame's sequence
+    uint8_t mode = (packet.data2 == SEQUENCE_WINDOW) ? SEQUENCE_WINDOW : SEQUENCE_LEGACY;
+    createPacket(boardAddress.getUnit(), packet.sequence, CMD_LINK_CONFIG, LINK_OPT_SEQUENCE, mode, 0x00);
+    setSequenceMode(mode);
+  } else if (packet.data1 == LINK_OPT_ACK) {
+    uint8_t enabled = (packet.data2 == 0x01) ? 0x01 : 0x00;
+    createPacket(boardAddress.getUnit(), packet.sequence, CMD_LINK_CONFIG, LINK_OPT_ACK, enabled, 0x00);
+    setAckEnabled(enabled);
+  } else if (packet.data1 == LINK_OPT_TELEMETRY) {
+    // Apps that do not know CMD_STATE never see one
+    uint8_t enabled = (packet.data2 == 0x01) ? 0x01 : 0x00;
+    createPacket(boardAddress.getUnit(), packet.sequence, CMD_LINK_CONFIG, LINK_OPT_TELEMETRY, enabled, 0x00);
+    setTelemetryEnabled(enabled);
+  } else {
+    if (debugSerial) debugSerial->println("LINK: Unknown option - Ignored");
+    return RESULT_INVALID;
+  }
+  return RESULT_OK;
+}
+
+/**
+ * Address configuration: set the unit address or group membership and
+ * store it, then reply from the (new) unit address
+ * Reply: DeviceID = unit, Sequence, CMD_ADDRESS_CONFIG, unit, groups (low, high)
+ * Settings are not changed while a motor runs (the EEPROM write stalls
+ * the main loop); the reply then carries the unchanged address.
+ */
+uint8_t CommunicationManager::processAddressConfigCommand(const Packet &packet) {
+  uint8_t result = RESULT_OK;
+  bool valid;
+
+  if (packet.data1 == ADDR_OPT_QUERY) {
+    valid = true;
+  } else if (packet.data1 == ADDR_OPT_UNIT) {
+    valid = boardAddress.setUnit(packet.data2);
+  } else if (packet.data1 == ADDR_OPT_GROUP_JOIN || packet.data1 == ADDR_OPT_GROUP_LEAVE) {
+    valid = boardAddress.setGroup(packet.data2, packet.data1 == ADDR_OPT_GROUP_JOIN);
+  } else {
+    valid = false;
+  }
+  if (!valid) {
+    if (debugSerial) debugSerial->println("ADDR: Invalid option or address - Ignored");
+    result = RESULT_INVALID;
+  }
+
+  if (boardAddress.isDirty()) {
+    if (motorController && motorController->isAnyMotorRunning()) {
+      if (debugSerial) debugSerial->println("ADDR: Motors running - not saved");
+      boardAddress.load();  // Discard the change
+      result = RESULT_REJECTED;
+    } else if (boardAddress.save() && debugSerial) {
+      debugSerial->print("ADDR: Saved unit 0x");
+      debugSerial->print(boardAddress.getUnit(), HEX);
+      debugSerial->print(", groups 0x");
+      debugSerial->println(boardAddress.getGroups(), HEX);
+    }
+  }
+
+  uint16_t groups = boardAddress.getGroups();
+  createPacket(boardAddress.getUnit(), packet.sequence, CMD_ADDRESS_CONFIG, boardAddress.getUnit(), (uint8_t)(groups & 0xFF), (uint8_t)(groups >> 8));
+  return result;
+}
+
+/**
+ * Enable/disable ACK/NACK replies
+ */
+void CommunicationManager::setAckEnabled(bool enabled) {
+  ackEnabled = enabled;
+  if (debugSerial) {
+    debugSerial->print("LINK: ACK = ");
+    debugSerial->println(ackEnabled ? "ON" : "OFF");
+  }
+}
+
+/**
+ * Acknowledge a processed frame (only when ACK replies are enabled and the
+ * frame was sent to this board's unit address)
+ * Body: DeviceID, echoed Sequence, CMD_ACK, acked Command, RESULT_*, 0x00
+ */
+void CommunicationManager::sendAck(uint8_t sequence, uint8_t command, uint8_t result) {
+  if (!ackEnabled || groupFrame) return;  // Several boards would answer a group frame at once
+  createPacket(boardAddress.getUnit(), sequence, CMD_ACK, command, result, 0x00);
+  acksSent++;
+}
+
+/**
+ * Report a frame that could not be accepted (only when ACK replies are enabled)
+ * For NACK_CORRUPT the sequence is whatever was decoded and may be wrong;
+ * the app should resend its oldest unacknowledged frame.
+ */
+void CommunicationManager::sendNack(uint8_t sequence, uint8_t reason) {
+  if (!ackEnabled) return;
+  createPacket(boardAddress.getUnit(), sequence, CMD_NACK, reason, 0x00, 0x00);
+  nacksSent++;
+}
+
+/**
+ * Reset transmit statistics (ACK/NACK counts, TX queue drops and high-water marks)
+ */
+void CommunicationManager::resetTxStats() {
+  acksSent = 0;
+  nacksSent = 0;
+  txQueue.resetStatistics();
+}
+
+/**
+ * Return every negotiated link option to its legacy default (new connection)
+ */
+void CommunicationManager::resetLinkOptions() {
+  setTxFraming(FRAMING_HEX);
+  setSequenceMode(SEQUENCE_LEGACY);
+  setAckEnabled(false);
+  setTelemetryEnabled(false);
+}
+
+/**
+ * App heartbeat
+ * DATA_ON marks the app alive and starts link supervision (the app repeats
+ * it every 5s). DATA_OFF is sent when the app disconnects on purpose.
+ */
+uint8_t CommunicationManager::processHeartbeatCommand(const Packet &packet) {
+  if (packet.data1 == DATA_OFF) {
+    linkActivityPending = false;
+    if (linkUp) setLinkDown(false);
+    return RESULT_OK;
+  }
+
+  if (!linkSupervised) {
+    linkSupervised = true;
+    if (debugSerial) debugSerial->println("LINK: Heartbeat supervision active");
+  }
+  return RESULT_OK;
+}
+
+/**
+ * Latency report request: DATA_ON prints the histograms on the debug UART
+ * (streamed by processLatencyReport()), DATA_OFF clears them
+ */
+uint8_t CommunicationManager::processLatencyReportCommand(const Packet &packet) {
+  return requestLatencyReport(packet.data1 == DATA_OFF) ? RESULT_OK : RESULT_REJECTED;
+}
+
+/**
+ * Start printing the latency report, or clear the histograms (reset = true)
+ * False when built without LATENCY_PROBES.
+ */
+bool CommunicationManager::requestLatencyReport(bool reset) {
+  if (!latencyProbe) return false;
+
+  if (reset) {
+    latencyProbe->reset();
+    latencyReportLine = 0;
+  } else {
+    latencyReportLine = 1;
+  }
+  return true;
+}
+
+/**
+ * Print pending latency report lines while the debug output has room
+ * Lines: header, one per stage, one per command slot with samples (us).
+ */
+void CommunicationManager::processLatencyReport() {
+#if LATENCY_PROBES
+  if (!latencyProbe || latencyReportLine == 0 || !debugSerial) return;
+
+  char line[LatencyProbe::LINE_SIZE];
+  while (latencyReportLine != 0 && debugSerial->availableForWrite() >= LatencyProbe::LINE_SIZE) {
+    uint8_t index = latencyReportLine - 1;
+    int len = 0;
+
+    if (index == 0) {
+      static const char header[] = "=== LATENCY (us, p99 = bucket bound) ===\r\n";
+      memcpy(line, header, sizeof(header));
+      len = sizeof(header) - 1;
+    } else if (index <= LatencyProbe::STAGE_COUNT) {
+      LatencyProbe::Stage stage = (LatencyProbe::Stage)(index - 1);
+      len = LatencyProbe::formatLine(line, LatencyProbe::getStageName(stage), latencyProbe->getStage(stage));
+    } else if (index <= LatencyProbe::STAGE_COUNT + COMMAND_COUNT + 1) {
+      uint8_t slot = index - LatencyProbe::STAGE_COUNT - 1;
+      const LatencyProbe::Histogram &histogram = latencyProbe->getCommand(slot);
+      if (histogram.count > 0) {
+        len = LatencyProbe::formatLine(line, (slot < COMMAND_COUNT) ? COMMAND_TABLE[slot].name : "EXTENDED FRAME", histogram);
+      }
+    } else {
+      static const char footer[] = "=== END LATENCY ===\r\n";
+      memcpy(line, footer, sizeof(footer));
+      len = sizeof(footer) - 1;
+      latencyReportLine = 0;
+    }
+
+    if (len > 0) debugSerial->write((const uint8_t *)line, len);
+    if (latencyReportLine != 0) latencyReportLine++;
+  }
+#endif
+}
+
+/**
+ * Capture journal request: DATA_ON prints the journal on the debug UART
+ * (streamed by processCaptureDump()), DATA_OFF clears it
+ */
+uint8_t CommunicationManager::processBleCaptureCommand(const Packet &packet) {
+  if (!bleCapture) return RESULT_REJECTED;  // Built without BLE_CAPTURE
+
+  if (packet.data1 == DATA_ON) {
+    bleCapture->setPaused(true);  // Keep the entries still until the dump is out
+    captureDumpLine = 1;
+  } else {
+    bleCapture->clear();
+    bleCapture->setPaused(false);
+    captureDumpLine = 0;
+  }
+  return RESULT_OK;
+}
+
+/**
+ * Print pending capture dump lines while the debug output has room
+ * Lines: header, ENTRIES_PER_LINE entries per "CAP" line, footer.
+ * Recording resumes once the footer is out.
+ */
+void CommunicationManager::processCaptureDump() {
+#if BLE_CAPTURE
+  if (!bleCapture || captureDumpLine == 0 || !debugSerial) return;
+
+  char line[BleCapture::LINE_SIZE];
+  while (captureDumpLine != 0 && debugSerial->availableForWrite() >= BleCapture::LINE_SIZE) {
+    uint16_t index = captureDumpLine - 1;
+    uint16_t firstEntry = (index - 1) * BleCapture::ENTRIES_PER_LINE;
+    int len;
+
+    if (index == 0) {
+      len = bleCapture->formatHeader(line);
+    } else if (firstEntry < bleCapture->size()) {
+      len = bleCapture->formatLine(line, firstEntry);
+    } else {
+      static const char footer[] = "=== END CAPTURE ===\r\n";
+      memcpy(line, footer, sizeof(footer));
+      len = sizeof(footer) - 1;
+      captureDumpLine = 0;
+      bleCapture->setPaused(false);
+    }
+
+    if (len > 0) debugSerial->write((const uint8_t *)line, len);
+    if (captureDumpLine != 0) captureDumpLine++;
+  }
+#endif
+}
+
+/**
+ * Link statistics request: DATA_ON replies with the counters, DATA_OFF
+ * replies and then clears them (read-and-reset, no increment is lost)
+ */
+uint8_t CommunicationManager::processLinkStatsCommand(const Packet &packet) {
+  sendLinkStats(packet.sequence);
+  if (packet.data1 == DATA_OFF) resetLinkStats();
+  return RESULT_OK;
+}
+
+/**
+ * Send the link counters as two reply frames
+ * Body: DeviceID = unit, echoed Sequence, CMD_LINK_STATS, page, counters, Checksum
+ * - LINK_STATS_PAGE_TRAFFIC: frames in, bytes in, frames out, bytes out
+ *   (24 bit each, wrapping - the app works with differences)
+ * - LINK_STATS_PAGE_ERRORS: checksum, length, format, overflow, address,
+ *   duplicate, UART overrun (16 bit each, saturating at 0xFFFF)
+ */
+void CommunicationManager::sendLinkStats(uint8_t sequence) {
+  uint8_t body[PacketCodec::MAX_BODY_SIZE];
+  body[0] = boardAddress.getUnit();
+  body[1] = sequence;
+  body[2] = CMD_LINK_STATS;
+
+  // Traffic page (counted before it is sent, so it does not include itself)
+  const uint32_t traffic[] = { linkStats.framesIn, linkStats.bytesIn, linkStats.framesOut, linkStats.bytesOut };
+  body[3] = LINK_STATS_PAGE_TRAFFIC;
+  int len = 4;
+  for (uint8_t i = 0; i < sizeof(traffic) / sizeof(traffic[0]); i++) {
+    putCounter(body + len, traffic[i], 3);
+    len += 3;
+  }
+  body[len] = PacketCodec::checksum(body, len);
+  sendFrame(body, len + 1);
+
+  const uint32_t errors[] = { linkStats.checksumErrors, linkStats.lengthErrors, linkStats.formatErrors, linkStats.overflowErrors,
+                              linkStats.addressMismatches, linkStats.duplicates, linkStats.uartOverruns };
+  body[3] = LINK_STATS_PAGE_ERRORS;
+  len = 4;
+  for (uint8_t i = 0; i < sizeof(errors) / sizeof(errors[0]); i++) {
+    putCounter(body + len, (errors[i] > 0xFFFF) ? 0xFFFF : errors[i], 2);
+    len += 2;
+  }
+  body[len] = PacketCodec::checksum(body, len);
+  sendFrame(body, len + 1);
+}
+
+/**
+ * Clear the link counters
+ */
+void CommunicationManager::resetLinkStats() {
+  memset(&linkStats, 0, sizeof(linkStats));
+}
+
+/**
+ * Count a frame dropped by a decoder under its cause
+ */
+void CommunicationManager::countFrameError(PacketCodec::FrameError error) {
+  switch (error) {
+    case PacketCodec::ERROR_CHECKSUM: linkStats.checksumErrors++; break;
+    case PacketCodec::ERROR_LENGTH: linkStats.lengthErrors++; break;
+    case PacketCodec::ERROR_FORMAT: linkStats.formatErrors++; break;
+    case PacketCodec::ERROR_OVERFLOW: linkStats.overflowErrors++; break;
+    default: break;
+  }
+}
+
+/**
+ * Write the low width bytes of a counter, most significant first
+ */
+void CommunicationManager::putCounter(uint8_t *out, uint32_t value, uint8_t width) {
+  for (uint8_t i = 0; i < width; i++) {
+    out[i] = (uint8_t)(value >> (8 * (width - 1 - i)));
+  }
+}
+
+/**
+ * Firmware update request in a plain frame (QUERY, COMMIT or ABORT in data1)
+ */
+uint8_t CommunicationManager::processFirmwareUpdateCommand(const Packet &packet) {
+  handleFirmwareUpdate(packet.sequence, &packet.data1, 1);
+  return RESULT_OK;
+}
+
+/**
+ * Firmware update request (data: operation, then its fields, big-endian)
+ * Every request except an in-order chunk is answered with a status frame;
+ * chunks are answered every few chunks, at the end and at the first gap.
+ */
+void CommunicationManager::handleFirmwareUpdate(uint8_t sequence, const uint8_t *data, uint8_t length) {
+  updateSequence = sequence;
+  if (!firmwareUpdater) {
+    sendUpdateStatus(FirmwareUpdater::CODE_UNSUPPORTED);
+    return;
+  }
+
+  FirmwareUpdater::Code code = FirmwareUpdater::CODE_OK;
+  switch (length ? data[0] : 0) {
+    case FirmwareUpdater::OP_BEGIN:
+      if (length != 8) {
+        code = FirmwareUpdater::CODE_BAD_REQUEST;
+      } else if (motorController && motorController->isAnyMotorRunning()) {
+        code = FirmwareUpdater::CODE_BUSY;  // Flash erase stalls the CPU for ~20ms per page
+      } else {
+        uint32_t size = ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+        uint32_t crc = ((uint32_t)data[4] << 24) | ((uint32_t)data[5] << 16) | ((uint32_t)data[6] << 8) | data[7];
+        code = firmwareUpdater->begin(size, crc);
+        if (debugSerial && code == FirmwareUpdater::CODE_OK) {
+          debugSerial->print("FW: update of ");
+          debugSerial->print((unsigned long)size);
+          debugSerial->println(" bytes");
+        }
+      }
+      break;
+
+    case FirmwareUpdater::OP_DATA: {
+      // Offset (3), 1..MAX_CHUNK bytes, CRC-16 (2)
+      if (length < 7 || length > 6 + FirmwareUpdater::MAX_CHUNK) {
+        code = FirmwareUpdater::CODE_BAD_REQUEST;
+        break;
+      }
+      uint32_t offset = ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+      uint8_t chunkLength = length - 6;
+      uint16_t crc = ((uint16_t)data[4 + chunkLength] << 8) | data[5 + chunkLength];
+      unsigned long refused = firmwareUpdater->getChunkErrors();
+      if (!firmwareUpdater->writeChunk(offset, data + 4, chunkLength, crc)) return;
+      // Tells the gap report apart from the progress statuses
+      if (firmwareUpdater->getChunkErrors() != refused) code = FirmwareUpdater::CODE_CHUNK_REFUSED;
+      break;
+    }
+
+    case FirmwareUpdater::OP_COMMIT:
+      code = firmwareUpdater->commit();
+      if (debugSerial && code == FirmwareUpdater::CODE_OK) debugSerial->println("FW: image verified - restarting into the bootloader");
+      break;
+
+    case FirmwareUpdater::OP_ABORT:
+      firmwareUpdater->abort();
+      break;
+
+    case FirmwareUpdater::OP_QUERY:
+      break;
+
+    default:
+      code = FirmwareUpdater::CODE_BAD_REQUEST;
+      break;
+  }
+  sendUpdateStatus(code);
+}
+
+/**
+ * Erase / verify / restart steps of the update session
+ * The app is told when the session changes state (erase done, verify result).
+ */
+void CommunicationManager::processFirmwareUpdate() {
+  if (firmwareUpdater && firmwareUpdater->poll()) {
+    sendUpdateStatus(FirmwareUpdater::CODE_OK);
+  }
+}
+
+/**
+ * Send the update status
+ * Body: DeviceID = unit, Sequence, CMD_FW_UPDATE, OP_STATUS, state, code,
+ * next offset (3), stream size (3), Checksum. The code is the request's
+ * result, or the session's failure reason when the request itself was fine.
+ */
+void CommunicationManager::sendUpdateStatus(FirmwareUpdater::Code code) {
+  uint8_t body[13];
+  body[0] = boardAddress.getUnit();
+  body[1] = updateSequence;
+  body[2] = CMD_FW_UPDATE;
+  body[3] = FirmwareUpdater::OP_STATUS;
+
+  if (firmwareUpdater) {
+    body[4] = firmwareUpdater->getState();
+    body[5] = (code == FirmwareUpdater::CODE_OK) ? firmwareUpdater->getError() : code;
+    putCounter(body + 6, firmwareUpdater->getNextOffset(), 3);
+    putCounter(body + 9, firmwareUpdater->getStreamSize(), 3);
+  } else {
+    body[4] = FirmwareUpdater::STATE_IDLE;
+    body[5] = code;
+    memset(body + 6, 0, 6);
+  }
+  body[12] = PacketCodec::checksum(body, 12);
+  sendFrame(body, sizeof(body));
+}
+
+/**
+ * Batch frame: apply every (Command, Data1) tuple as one transaction
+ * The whole frame is checked first and refused if any tuple is not a
+ * mode/setting command or would be refused by its handler (checkCommand()),
+ * so a preset is applied completely or not at all.
+ * Auto mode start/stop requested by the tuples is settled once at the end,
+ * so intermediate programs never run and processAuto() sees one switch.
+ */
+uint8_t CommunicationManager::processBatchCommand(const Frame &frame) {
+  int dataLen = frame.length - BATCH_HEADER_SIZE - 1;
+  if (dataLen <= 0 || (dataLen & 1) != 0) {
+    batchRejects++;
+    if (debugSerial) debugSerial->println("!!! BATCH: Malformed - Ignored");
+    return RESULT_INVALID;
+  }
+
+  // Every tuple is checked before any is applied: one refused tuple refuses the frame
+  const uint8_t *tuples = &frame.body[BATCH_HEADER_SIZE];
+  int count = dataLen / 2;
+  uint8_t startProgram = sequenceController ? sequenceController->getCurrentAutoProgram() : SequenceController::AUTO_NONE;
+  batchActive = true;
+  batchProgram = startProgram;
+  for (int i = 0; i < count; i++) {
+    if (!isBatchableCommand(tuples[2 * i])) {
+      batchActive = false;
+      batchRejects++;
+      if (debugSerial) debugSerial->println("!!! BATCH: Command not allowed in batch - Ignored");
+      return RESULT_INVALID;
+    }
+    uint8_t check = checkCommand(*findCommand(tuples[2 * i]), tuples[2 * i + 1]);
+    trackBatchProgram(tuples[2 * i], tuples[2 * i + 1]);
+    if (check != RESULT_OK) {
+      batchActive = false;
+      batchRejects++;
+      if (debugSerial) {
+        debugSerial->print("!!! BATCH: Command ");
+        debugSerial->print(i + 1);
+        debugSerial->println(check == RESULT_INVALID ? " has invalid data - Ignored" : " not allowed now - Ignored");
+      }
+      return check;
+    }
+  }
+
+  if (debugSerial) {
+    debugSerial->print("=== BATCH: ");
+    debugSerial->print(count);
+    debugSerial->println(" commands ===");
+  }
+
+  // Checked above, so every handler accepts its tuple; keep the first non-OK result anyway
+  uint8_t result = RESULT_OK;
+  batchProgram = startProgram;
+  for (int i = 0; i < count; i++) {
+    uint8_t tupleResult = applyBatchCommand(frame.body[1], tuples[2 * i], tuples[2 * i + 1]);
+    trackBatchProgram(tuples[2 * i], tuples[2 * i + 1]);
+    if (result == RESULT_OK) result = tupleResult;
+  }
+  finishBatch();
+  batchFramesTotal++;
+  return result;
+}
+
+/**
+ * Commands that only select modes/settings (CMD_FLAG_BATCH in the command table)
+ */
+bool CommunicationManager::isBatchableCommand(uint8_t command) const {
+  const CommandSpec *spec = findCommand(command);
+  return spec && (spec->flags & CMD_FLAG_BATCH);
+}
+
+/**
+ * Follow the program a batch selects as its tuples are checked / applied
+ * The switch itself happens after the batch (processAuto()), so a preset's
+ * INTENSITY_LEVEL is checked against the program the preset picks, not the
+ * one still running. A program ON clears the others; AUTO OFF, COMBINE OFF
+ * or switching the selected program off leaves none.
+ */
+void CommunicationManager::trackBatchProgram(uint8_t command, uint8_t data1) {
+  uint8_t program;
+  switch (command) {
+    case CMD_AUTO: program = SequenceController::AUTO_DEFAULT; break;
+    case CMD_KNEADING: program = SequenceController::AUTO_KNEADING; break;
+    case CMD_COMPRESSION: program = SequenceController::AUTO_COMPRESSION; break;
+    case CMD_PERCUSSION: program = SequenceController::AUTO_PERCUSSION; break;
+    case CMD_COMBINE: program = SequenceController::AUTO_COMBINED; break;
+    default: return;
+  }
+  if (data1 == DATA_ON) {
+    batchProgram = program;
+  } else if (command == CMD_AUTO || command == CMD_COMBINE || program == batchProgram) {
+    batchProgram = SequenceController::AUTO_NONE;
+  }
+}
+
+/**
+ * Intensity only applies to COMPRESSION, PERCUSSION and COMBINED
+ * (SequenceController::isIntensityChangeAllowed()); inside a batch the
+ * program its earlier tuples select counts
+ */
+bool CommunicationManager::isIntensityChangeAllowed() const {
+  if (!sequenceController) return true;
+  if (batchActive) {
+    return batchProgram == SequenceController::AUTO_COMPRESSION || batchProgram == SequenceController::AUTO_PERCUSSION || batchProgram == SequenceController::AUTO_COMBINED;
+  }
+  return sequenceController->isIntensityChangeAllowed();
+}
+
+/**
+ * Apply one batch tuple with the regular command handler
+ */
+uint8_t CommunicationManager::applyBatchCommand(uint8_t sequence, uint8_t command, uint8_t data1) {
+  Packet packet = { boardAddress.getUnit(), sequence, command, data1, 0x00, 0x00, 0x00 };
+  return dispatchCommand(*findCommand(command), packet);
+}
+
+/**
+ * Start auto mode (deferred to the end of a batch)
+ */
+void CommunicationManager::startAutoMode() {
+  if (!sequenceController) return;
+  if (batchActive) {
+    batchAutoSyncPending = true;
+    return;
+  }
+  sequenceController->startAutoMode();
+}
+
+/**
+ * Stop auto mode (deferred to the end of a batch)
+ * Inside a batch the program flags are cleared straight away, as
+ * stopAutoMode() would, so later tuples start from no program.
+ */
+void CommunicationManager::stopAutoMode() {
+  if (!sequenceController) return;
+  SequenceController *seq = sequenceController;
+  if (batchActive) {
+    seq->setAutodefaultMode(false);
+    seq->setKneadingMode(false);
+    seq->setCompressionMode(false);
+    seq->setPercussionMode(false);
+    seq->setCombineMode(false);
+    batchAutoSyncPending = true;
+    return;
+  }
+  seq->stopAutoMode();
+}
+
+/**
+ * End a batch: start or stop auto mode once to match the selected programs
+ */
+void CommunicationManager::finishBatch() {
+  batchActive = false;
+  if (!batchAutoSyncPending || !sequenceController) return;
+  batchAutoSyncPending = false;
+
+  SequenceController *seq = sequenceController;
+  bool programSelected = seq->getAutodefaultMode() || seq->getKneadingMode() || seq->getCompressionMode() || seq->getPercussionMode() || seq->getCombineMode();
+  if (programSelected) {
+    seq->startAutoMode();  // No-op if already running; processAuto() picks up the new program
+  } else {
+    seq->stopAutoMode();
+  }
+}
+
+/**
+ * Record link liveness (called for every valid frame)
+ */
+void CommunicationManager::noteLinkActivity() {
+  linkActivityPending = true;
+  if (timerManager) lastLinkActivityTick = timerManager->getMasterTicks();
+  if (hm10) hm10->onModuleAlive();
+}
+
+/**
+ * Link supervision, once per loop pass after queued commands have run
+ * The link goes up on the first valid frame. From the first heartbeat on,
+ * linkTimeoutTicks without any valid frame counts as a loss: manual RL1/RL2
+ * motion is stopped and auto programs are optionally held. Before any
+ * heartbeat (app builds without one) silence is normal and a held button
+ * stays bounded by its lease or RL1_RL2_TIMEOUT_TICKS only.
+ */
+void CommunicationManager::superviseLink() {
+  if (!timerManager) return;
+
+  if (linkActivityPending) {
+    linkActivityPending = false;
+    if (!linkUp) setLinkUp();
+    return;
+  }
+
+  if (linkUp && linkSupervised && (timerManager->getMasterTicks() - lastLinkActivityTick) >= linkTimeoutTicks) {
+    setLinkDown(true);
+  }
+}
+
+/**
+ * Link came up
+ */
+void CommunicationManager::setLinkUp() {
+  linkUp = true;
+  if (debugSerial) debugSerial->println("LINK: Up");
+
+  // Resume auto programs held by a link loss
+  if (linkPausedAuto) {
+    linkPausedAuto = false;
+    setManualPriority(false);
+  }
+
+  // Give the app the current state straight away
+  requestTelemetry();
+
+  if (safetyManager) safetyManager->onLinkUp();
+}
+
+/**
+ * Link went down
+ * lost = true on supervision timeout, false when the app closed the link.
+ */
+void CommunicationManager::setLinkDown(bool lost) {
+  linkUp = false;
+  linkSupervised = false;
+  if (debugSerial) debugSerial->println(lost ? "!!! LINK: Lost - safe stop" : "LINK: Closed by app");
+
+  performLinkSafeStop(lost);
+
+  // Next connection starts with legacy link options until it negotiates again
+  resetLinkOptions();
+
+  if (safetyManager) safetyManager->onLinkDown(lost);
+}
+
+/**
+ * A manual motor stopped without its RELEASE (lease lapsed or hard timeout)
+ * Clears the manual priority the PUSH set, as the RELEASE would have, once
+ * no manual motor runs any more; a hold from a link loss stays.
+ */
+void CommunicationManager::onManualMotionTimeout() {
+  if (!motorController || motorController->isManualMotorRunning()) return;
+  if (manualPriority && !linkPausedAuto) setManualPriority(false);
+  requestTelemetry();
+}
+
+/**
+ * Stop motion nobody can release any more
+ * Manual RL1/RL2 motion always stops. On a loss, auto programs are held
+ * with manual priority if linkLossPausesAuto is set; otherwise manual
+ * priority from a held button is cleared so auto continues.
+ */
+void CommunicationManager::performLinkSafeStop(bool lost) {
+  if (motorController) {
+    MotorController *motors = motorController;
+    if (motors->isRL1Running()) motors->offReclineIncline();
+    if (motors->isRL2Running()) motors->offForwardBackward();
+  }
+
+  bool autoActive = sequenceController && sequenceController->isAutoModeActive();
+  if (lost && linkLossPausesAuto && autoActive) {
+    setManualPriority(true);
+    linkPausedAuto = true;
+    if (debugSerial) debugSerial->println("LINK: Auto program held until the app reconnects");
+  } else if (manualPriority) {
+    setManualPriority(false);
+  }
+}
+
+/**
+ * Set the link loss window (ticks without a valid frame)
+ */
+void CommunicationManager::setLinkTimeout(unsigned long timeoutTicks) {
+  linkTimeoutTicks = (timeoutTicks < LINK_TIMEOUT_MIN_TICKS) ? LINK_TIMEOUT_MIN_TICKS : timeoutTicks;
+}
+
+/**
+ * Hold auto programs when the link is lost (default: keep running)
+ */
+void CommunicationManager::setLinkLossPausesAuto(bool pause) {
+  linkLossPausesAuto = pause;
+}
+
+/**
+ * Select the framing used for replies
+ */
+void CommunicationManager::setTxFraming(uint8_t framing) {
+  txFraming = (framing == FRAMING_BINARY) ? FRAMING_BINARY : FRAMING_HEX;
+  if (debugSerial) {
+    debugSerial->print("LINK: Framing = ");
+    debugSerial->println(txFraming == FRAMING_BINARY ? "BINARY" : "HEX");
+  }
+}
+
+/**
+ * Push a state frame to the app when the state changes
+ * Changes within TELEMETRY_MIN_INTERVAL_TICKS of the last frame are
+ * coalesced into one frame carrying the latest state. Unchanged state is
+ * resent every TELEMETRY_REFRESH_TICKS (remaining time, lost frames).
+ */
+void CommunicationManager::processTelemetry() {
+  if (!telemetryEnabled || !bleSerial || !sequenceController || !timerManager) return;
+
+  StateSnapshot state;
+  captureState(state);
+
+  // Remaining time alone does not count as a change
+  if (state.program != lastState.program || state.modeFlags != lastState.modeFlags || state.statusFlags != lastState.statusFlags || state.intensity != lastState.intensity) {
+    telemetryPending = true;
+  }
+
+  unsigned long currentTick = timerManager->getMasterTicks();
+  unsigned long sinceLast = currentTick - lastTelemetryTick;
+  if (sinceLast >= TELEMETRY_REFRESH_TICKS) {
+    telemetryPending = true;
+  }
+
+  if (!telemetryPending || sinceLast < TELEMETRY_MIN_INTERVAL_TICKS) return;
+
+  if (!sendStateFrame(state)) return;
+  lastState = state;
+  lastTelemetryTick = currentTick;
+  telemetryPending = false;
+}
+
+/**
+ * Send a state frame on the next telemetry pass (e.g. after connecting)
+ */
+void CommunicationManager::requestTelemetry() {
+  telemetryPending = true;
+}
+
+/**
+ * Enable/disable state telemetry (enabling sends the current state at once)
+ */
+void CommunicationManager::setTelemetryEnabled(bool enabled) {
+  telemetryEnabled = enabled;
+  telemetryPending = enabled;
+}
+
+/**
+ * Read the current chair state
+ */
+void CommunicationManager::captureState(StateSnapshot &state) {
+  SequenceController *seq = sequenceController;
+
+  state.program = (uint8_t)seq->getCurrentAutoProgram();
+
+  state.modeFlags = 0;
+  if (seq->getAutodefaultMode()) state.modeFlags |= STATE_MODE_AUTO_DEFAULT;
+  if (seq->getKneadingMode()) state.modeFlags |= STATE_MODE_KNEADING;
+  if (seq->getCompressionMode()) state.modeFlags |= STATE_MODE_COMPRESSION;
+  if (seq->getPercussionMode()) state.modeFlags |= STATE_MODE_PERCUSSION;
+  if (seq->getCombineMode()) state.modeFlags |= STATE_MODE_COMBINE;
+  if (seq->getRollSpotMode()) state.modeFlags |= STATE_MODE_ROLL_SPOT;
+  if (seq->getRollMotorUserDisabled()) state.modeFlags |= STATE_MODE_ROLL_DISABLED;
+
+  state.statusFlags = 0;
+  if (seq->getHomeRun()) state.statusFlags |= STATE_STATUS_HOME_RUN;
+  if (seq->getModeAuto()) state.statusFlags |= STATE_STATUS_MODE_AUTO;
+  if (manualPriority) state.statusFlags |= STATE_STATUS_MANUAL_PRIORITY;
+  if (seq->isHomeSequenceActive()) state.statusFlags |= STATE_STATUS_HOMING;
+  if (sensorManager) {
+    if (sensorManager->getSensorUpLimit()) state.statusFlags |= STATE_STATUS_LIMIT_UP;
+    if (sensorManager->getSensorDownLimit()) state.statusFlags |= STATE_STATUS_LIMIT_DOWN;
+  }
+  if (isBleRecovering()) state.statusFlags |= STATE_STATUS_BLE_RECOVERING;
+
+  state.intensity = seq->getIntensityLevel();
+
+  unsigned long remaining = seq->getAutoRemainingTime();
+  state.remainingSeconds = (remaining > 0xFFFF) ? 0xFFFF : (uint16_t)remaining;
+}
+
+/**
+ * Send a CMD_STATE extended frame
+ * Body: DeviceID, Seq, CMD_STATE, program, mode flags, status flags,
+ *       intensity, remaining seconds (high, low), checksum
+ */
+bool CommunicationManager::sendStateFrame(const StateSnapshot &state) {
+  uint8_t body[10];
+  body[0] = boardAddress.getUnit();
+  body[1] = telemetrySequence;
+  body[2] = CMD_STATE;
+  body[3] = state.program;
+  body[4] = state.modeFlags;
+  body[5] = state.statusFlags;
+  body[6] = state.intensity;
+  body[7] = state.remainingSeconds >> 8;
+  body[8] = state.remainingSeconds & 0xFF;
+  body[9] = PacketCodec::checksum(body, 9);
+
+  // Bulk lane: a full queue keeps the update pending for the next pass
+  if (!sendFrame(body, sizeof(body), BleTxQueue::LANE_BULK)) return false;
+  telemetrySequence++;
+  telemetryFramesSent++;
+  return true;
 }
@@ -0,0 +1,242 @@
+#include "DebugLog.h"
+
+// Static instance for TRACE() call sites
+DebugLog* DebugLog::instance = nullptr;
+
+/**
+ * Constructor
+ */
+DebugLog::DebugLog(HardwareSerial* debugSerial)
+  : serial(debugSerial), head(0), tail(0), draining(false), highWater(0), droppedBytes(0), droppedLines(0), reportedDrops(0) {
+  memset(buffer, 0, sizeof(buffer));
+  for (uint8_t i = 0; i < MODULE_COUNT; i++) {
+    levels[i] = LEVEL_INFO;
+    channels[i].attach(this, (Module)i);
+  }
+  instance = this;
+}
+
+/**
+ * Channel output (one byte)
+ */
+size_t DebugLog::Channel::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+/**
+ * Channel output (LEVEL_INFO), one piece of the channel's current line
+ */
+size_t DebugLog::Channel::write(const uint8_t* buffer, size_t size) {
+  if (!owner || !owner->isEnabled(module, LEVEL_INFO)) return 0;
+  return owner->enqueueLinePart(line, buffer, size);
+}
+
+/**
+ * Bytes a write can store without being dropped (0 while the module is off)
+ */
+int DebugLog::Channel::availableForWrite() {
+  if (!owner || !owner->isEnabled(module, LEVEL_INFO)) return 0;
+  return owner->getFreeBytes();
+}
+
+/**
+ * Log one line at the given level
+ */
+void DebugLog::log(Module module, Level level, const char* message) {
+  if (!message || !isEnabled(module, level)) return;
+
+  uint8_t line[96];
+  size_t len = strlen(message);
+  if (len > sizeof(line) - 2) len = sizeof(line) - 2;
+  memcpy(line, message, len);
+  line[len++] = '\r';
+  line[len++] = '\n';
+  enqueue(line, len);
+}
+
+/**
+ * Encode one trace record and store it whole
+ */
+void DebugLog::traceRecord(Module module, uint16_t token, const uint32_t* args, uint8_t argc) {
+  uint8_t record[4 + 4 * TRACE_MAX_ARGS];
+  size_t len = 0;
+
+  record[len++] = TRACE_MARKER;
+  record[len++] = (uint8_t)((module << 4) | argc);
+  record[len++] = (uint8_t)(token & 0xFF);
+  record[len++] = (uint8_t)(token >> 8);
+  for (uint8_t i = 0; i < argc; i++) {
+    uint32_t value = args[i];
+    record[len++] = (uint8_t)(value & 0xFF);
+    record[len++] = (uint8_t)((value >> 8) & 0xFF);
+    record[len++] = (uint8_t)((value >> 16) & 0xFF);
+    record[len++] = (uint8_t)(value >> 24);
+  }
+  enqueue(record, len);
+}
+
+/**
+ * Copy bytes into the ring buffer if they all fit (interrupts disabled)
+ */
+bool DebugLog::store(const uint8_t* data, size_t size) {
+  uint16_t h = head;
+  uint16_t used = (uint16_t)(h - tail);
+  if (size > (size_t)(BUFFER_SIZE - used)) return false;
+
+  uint16_t offset = h & MASK;
+  uint16_t first = BUFFER_SIZE - offset;
+  if (first > size) first = size;
+  memcpy(&buffer[offset], data, first);
+  memcpy(buffer, data + first, size - first);
+  head = h + size;
+
+  used += size;
+  if (used > highWater) highWater = used;
+  return true;
+}
+
+/**
+ * Store one complete record, a whole line or trace record (main loop or ISR)
+ * A record that does not fit is dropped whole. Returns the number of bytes
+ * stored.
+ */
+size_t DebugLog::enqueue(const uint8_t* data, size_t size) {
+  if (size == 0) return 0;
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  bool stored = store(data, size);
+  if (!stored) {
+    droppedBytes += size;
+    droppedLines++;
+  }
+  __set_PRIMASK(primask);
+  return stored ? size : 0;
+}
+
+/**
+ * Store one write() of a channel line (main loop or ISR)
+ * When a write does not fit, the part of its line already stored is taken
+ * back and the rest of the line, up to its '\n', is discarded, so the line
+ * is lost as a whole. The take-back is skipped if other output followed the
+ * stored part or drain() has started sending it (an ISR interrupted drain());
+ * that part then goes out without its end.
+ */
+size_t DebugLog::enqueueLinePart(LineState& line, const uint8_t* data, size_t size) {
+  if (size == 0) return 0;
+  bool endsLine = (data[size - 1] == '\n');
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  if (line.dropping) {
+    droppedBytes += size;
+    line.dropping = !endsLine;
+    __set_PRIMASK(primask);
+    return 0;
+  }
+
+  uint16_t h = head;
+  if (!line.open) line.start = h;
+  if (store(data, size)) {
+    line.open = !endsLine;
+    line.end = head;
+    __set_PRIMASK(primask);
+    return size;
+  }
+
+  droppedBytes += size;
+  droppedLines++;
+  uint16_t stored = (uint16_t)(h - line.start);
+  if (line.open && line.end == h && !draining && stored <= (uint16_t)(h - tail)) {
+    droppedBytes += stored;
+    head = line.start;
+  }
+  line.open = false;
+  line.dropping = !endsLine;
+  __set_PRIMASK(primask);
+  return 0;
+}
+
+/**
+ * Move pending bytes into the UART TX buffer without waiting
+ * Called once per loop pass; the UART interrupt does the actual sending.
+ */
+void DebugLog::drain() {
+  if (!serial) return;
+
+  draining = true;
+  int room = serial->availableForWrite();
+  while (room > 0) {
+    uint16_t t = tail;
+    uint16_t pending = (uint16_t)(head - t);
+    if (pending == 0) break;
+
+    uint16_t offset = t & MASK;
+    uint16_t chunk = BUFFER_SIZE - offset;
+    if (chunk > pending) chunk = pending;
+    if (chunk > room) chunk = room;
+
+    serial->write(&buffer[offset], chunk);
+    tail = t + chunk;
+    room -= chunk;
+  }
+
+  draining = false;
+
+  // Report drops once everything logged before them has gone out
+  if (head == tail && droppedLines != reportedDrops && room >= DROP_MARKER_ROOM) {
+    unsigned long drops = droppedLines;
+    serial->print("[log: ");
+    serial->print(drops - reportedDrops);
+    serial->println(" lines dropped]");
+    reportedDrops = drops;
+  }
+}
+
+/**
+ * Send everything pending, waiting for the UART (fatal errors, before a reset)
+ */
+void DebugLog::flush() {
+  if (!serial) return;
+
+  draining = true;
+  while (head != tail) {
+    uint16_t t = tail;
+    serial->write(buffer[t & MASK]);
+    tail = t + 1;
+  }
+  draining = false;
+  serial->flush();
+}
+
+/**
+ * Set the level of one module
+ */
+void DebugLog::setLevel(Module module, Level level) {
+  if (module < MODULE_COUNT) {
+    levels[module] = level;
+  }
+}
+
+/**
+ * Set the level of every module
+ */
+void DebugLog::setAllLevels(Level level) {
+  for (uint8_t i = 0; i < MODULE_COUNT; i++) {
+    levels[i] = level;
+  }
+}
+
+/**
+ * Reset drop counters and the high-water mark
+ */
+void DebugLog::resetStatistics() {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  droppedBytes = 0;
+  droppedLines = 0;
+  reportedDrops = 0;
+  highWater = (uint16_t)(head - tail);
+  __set_PRIMASK(primask);
+}
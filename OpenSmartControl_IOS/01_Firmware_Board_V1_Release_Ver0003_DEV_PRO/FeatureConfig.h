@@ -0,0 +1,94 @@
+#ifndef FEATURE_CONFIG_H
+#define FEATURE_CONFIG_H
+
+/**
+ * Compile-time Feature Switches for Massage Chair Firmware
+ *
+ * Each option can be overridden from the build flags (-DNAME=value)
+ * without editing this file. 0 = disabled, 1 = enabled.
+ */
+
+// BLE UART receive driver
+// 0: STM32duino HardwareSerial (per-byte RX interrupt, drained from loop)
+// 1: Circular DMA + USART IDLE-line interrupt (BleDmaReceiver)
+//    Falls back to HardwareSerial at runtime if the DMA path cannot start.
+#ifndef BLE_UART_DMA_RX
+#define BLE_UART_DMA_RX 0
+#endif
+
+// HM10 UART baud-rate negotiation at startup (Hm10Manager)
+// 0: BLE UART stays at 9600 baud
+// 1: Ask the module at BLE_UART_TARGET_BAUD first and use that rate if it
+//    answers (no reset: the module stored the rate at an earlier boot).
+//    Otherwise reset it, probe it with AT commands and switch it to the
+//    highest rate up to BLE_UART_TARGET_BAUD that passes a loopback check.
+//    Falls back to 9600 baud if the module stops answering.
+//    The module keeps the new rate, so a board that ran this build needs it
+//    (or AT+BAUD0) from then on.
+#ifndef BLE_UART_BAUD_NEGOTIATION
+#define BLE_UART_BAUD_NEGOTIATION 0
+#endif
+
+#ifndef BLE_UART_TARGET_BAUD
+#define BLE_UART_TARGET_BAUD 115200
+#endif
+
+// Debug log ring buffer (bytes, power of two)
+// Output that does not fit before the debug UART catches up is dropped and counted.
+#ifndef DEBUG_LOG_BUFFER_SIZE
+#define DEBUG_LOG_BUFFER_SIZE 512
+#endif
+
+// Tokenized trace records (TRACE macro in DebugLog.h)
+// 0: TRACE call sites compile to nothing
+// 1: Call sites log a format token plus raw arguments; the format strings stay
+//    in the .elf only and tools/trace_decode turns the UART stream back into text
+#ifndef DEBUG_TRACE
+#define DEBUG_TRACE 1
+#endif
+
+// Command latency probes (LatencyProbe)
+// 0: No timestamps, CMD_LATENCY_REPORT answers RESULT_REJECTED
+// 1: Time each BLE command from its first byte to the motor pin it switches
+//    (DWT cycle counter) and keep per-stage / per-command histograms, reported
+//    on the debug UART by CMD_LATENCY_REPORT
+#ifndef LATENCY_PROBES
+#define LATENCY_PROBES 0
+#endif
+
+// BLE receive capture (BleCapture)
+// 0: Nothing recorded, CMD_BLE_CAPTURE answers RESULT_REJECTED
+// 1: Every byte received from the HM10 is journaled with its TimerManager tick
+//    in a RAM ring (2 bytes per entry), dumped on the debug UART by
+//    CMD_BLE_CAPTURE and replayed on a host with tools/ble_capture
+#ifndef BLE_CAPTURE
+#define BLE_CAPTURE 0
+#endif
+
+// Capture ring size (entries, power of two)
+#ifndef BLE_CAPTURE_ENTRIES
+#define BLE_CAPTURE_ENTRIES 1024
+#endif
+
+// Service console on the debug UART (ServiceConsole)
+// 0: Debug UART is output only
+// 1: Line commands typed on the debug UART read / change timing and PWM
+//    tunables, dump counters and histograms, run programs and time the main
+//    loop ("help" lists them). Tunables are not persisted.
+#ifndef SERVICE_CONSOLE
+#define SERVICE_CONSOLE 1
+#endif
+
+// Firmware update over the BLE link (FirmwareUpdater)
+// 0: CMD_FW_UPDATE answers with status UNSUPPORTED
+// 1: Update packages (raw, LZ-compressed or block delta against the running
+//    image) are streamed in CRC-checked chunks into the staging flash region,
+//    verified, and handed to the bootloader on commit. Requires the update
+//    bootloader (OpenSmartControl_Firmware/bootloader) and the application
+//    linked at FirmwareUpdater::APP_ADDRESS (build.flash_offset=0x1000, which
+//    also sets VECT_TAB_OFFSET) on a 128 KB STM32F103.
+#ifndef FIRMWARE_UPDATE
+#define FIRMWARE_UPDATE 0
+#endif
+
+#endif  // FEATURE_CONFIG_H
@@ -0,0 +1,367 @@
+#include "Hm10Manager.h"
+#include "DebugLog.h"
+
+namespace {
+// HM10 AT+BAUDx codes, highest rate first
+struct BaudRate {
+  uint32_t baud;
+  char code;
+};
+
+const BaudRate RATES[Hm10Manager::RATE_COUNT] = {
+  { 115200, '4' },
+  { 57600, '3' },
+  { 38400, '2' },
+  { 19200, '1' },
+  { 9600, '0' }
+};
+}
+
+/**
+ * Constructor
+ */
+Hm10Manager::Hm10Manager(HardwareSerial* bleSerial, TimerManager* timerMgr, int breakPinNumber)
+  : serial(bleSerial), timerManager(timerMgr), breakPin(breakPinNumber), state(STATE_IDLE), stateTick(0), negotiating(false), probeIndex(0), attempts(0), currentIndex(NO_RATE), candidateIndex(RATE_COUNT - 1), baud(FALLBACK_BAUD), fallback(false), targetBaud(FALLBACK_BAUD), recovering(false), recoveryAttempt(0), backoffTicks(0), responseLen(0), resets(0), negotiations(0), recoveries(0), escalations(0) {
+  memset(response, 0, sizeof(response));
+  memset(expected, 0, sizeof(expected));
+}
+
+/**
+ * Take over the BREAK pin; the UART is already running at currentBaud
+ */
+void Hm10Manager::begin(uint32_t currentBaud) {
+  pinMode(breakPin, OUTPUT);
+  digitalWrite(breakPin, HIGH);  // Normal state (HIGH = not reset)
+  baud = currentBaud;
+  targetBaud = currentBaud;
+  enterState(STATE_READY);
+}
+
+/**
+ * Start baud-rate negotiation
+ * The module stores the rate, so after the first negotiation it already
+ * runs at the target: one "AT" there and the UART is ready without a
+ * reset. Otherwise (new module, or a BLE connection that forwards the "AT"
+ * to the phone) the module is reset, which drops any connection and leaves
+ * it in AT command mode for the probes.
+ */
+void Hm10Manager::negotiate(uint32_t target) {
+  selectTarget(target);
+  setUartBaud(RATES[candidateIndex].baud);
+  attempts = 0;
+  sendCommand("AT", "OK");
+  enterState(STATE_TARGET_CHECK);
+}
+
+/**
+ * Reset the module and keep the current rate
+ * The module must answer afterwards, otherwise recovery starts.
+ */
+void Hm10Manager::requestReset() {
+  negotiating = false;
+  recoveryAttempt = 0;
+  startReset();
+}
+
+/**
+ * Valid frame received: the module works, stop a pending recovery
+ * (an HM10 that a phone reconnected to forwards "AT" instead of answering)
+ */
+void Hm10Manager::onModuleAlive() {
+  if (state != STATE_BACKOFF) return;
+  TRACE(MODULE_COMM, "HM10: link active, recovery cancelled after %u resets", recoveryAttempt);
+  recovering = false;
+  recoveryAttempt = 0;
+  enterState(STATE_READY);
+}
+
+/**
+ * Advance the reset / AT handshake (main loop)
+ */
+void Hm10Manager::poll() {
+  if (!serial || !timerManager) return;
+
+  unsigned long elapsed = timerManager->getMasterTicks() - stateTick;
+
+  switch (state) {
+    case STATE_RESET_HOLD:
+      if (elapsed >= RESET_HOLD_TICKS) {
+        digitalWrite(breakPin, HIGH);
+        enterState(STATE_BOOT_WAIT);
+      }
+      break;
+
+    case STATE_BOOT_WAIT:
+      if (elapsed < BOOT_TICKS) break;
+      if (!negotiating && fallback) {
+        enterState(STATE_READY);  // Module never answered AT commands
+      } else if (!negotiating) {
+        // Wait for the module to answer at the current rate
+        attempts = 0;
+        sendCommand("AT", "OK");
+        enterState(STATE_READY_CHECK);
+      } else if (currentIndex != NO_RATE && currentIndex != candidateIndex) {
+        // Module restarted with the new rate: check it both ways
+        char reply[] = "OK+Get:0";
+        reply[7] = RATES[candidateIndex].code;
+        setUartBaud(RATES[candidateIndex].baud);
+        attempts = 0;
+        sendCommand("AT+BAUD?", reply);
+        enterState(STATE_VERIFY);
+      } else {
+        startProbe(0);
+      }
+      break;
+
+    case STATE_READY_CHECK:
+      if (readResponse()) {
+        if (recovering) {
+          TRACE(MODULE_COMM, "HM10: recovered after %u resets", recoveryAttempt + 1);
+        }
+        finish(currentIndex);
+      } else if (timedOut()) {
+        if (++attempts < READY_ATTEMPTS) {
+          sendCommand("AT", "OK");
+        } else {
+          scheduleRetry();
+        }
+      }
+      break;
+
+    case STATE_BACKOFF:
+      if (elapsed >= backoffTicks) {
+        startReset();
+      }
+      break;
+
+    case STATE_TARGET_CHECK:
+      if (readResponse()) {
+        finish(candidateIndex);
+      } else if (timedOut()) {
+        if (++attempts < ATTEMPTS_PER_RATE) {
+          sendCommand("AT", "OK");
+        } else {
+          TRACE(MODULE_COMM, "HM10: no reply at %lu baud, resetting to probe", RATES[candidateIndex].baud);
+          startReset();
+        }
+      }
+      break;
+
+    case STATE_PROBE:
+      if (readResponse()) {
+        onModuleFound();
+      } else if (timedOut()) {
+        if (++attempts < ATTEMPTS_PER_RATE) {
+          sendCommand("AT", "OK");
+        } else if (probeIndex + 1 < RATE_COUNT) {
+          startProbe(probeIndex + 1);
+        } else {
+          finishFallback();
+        }
+      }
+      break;
+
+    case STATE_SET_BAUD:
+      if (readResponse()) {
+        // The module stores the rate and applies it after a restart
+        startReset();
+      } else if (timedOut()) {
+        TRACE(MODULE_COMM, "HM10: AT+BAUD refused, staying at %lu baud", RATES[currentIndex].baud);
+        finish(currentIndex);
+      }
+      break;
+
+    case STATE_VERIFY:
+      if (readResponse()) {
+        finish(candidateIndex);
+      } else if (timedOut()) {
+        if (++attempts < ATTEMPTS_PER_RATE) {
+          sendCommand("AT+BAUD?", expected);
+        } else {
+          onVerifyFailed();
+        }
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * Baud rate of a RATES entry
+ */
+uint32_t Hm10Manager::rateBaud(uint8_t index) {
+  return (index < RATE_COUNT) ? RATES[index].baud : FALLBACK_BAUD;
+}
+
+/**
+ * Private Helper Functions
+ */
+void Hm10Manager::enterState(State newState) {
+  state = newState;
+  stateTick = timerManager ? timerManager->getMasterTicks() : 0;
+}
+
+/**
+ * Negotiation state for a new target rate
+ */
+void Hm10Manager::selectTarget(uint32_t target) {
+  targetBaud = target;
+  candidateIndex = RATE_COUNT - 1;
+  for (uint8_t i = 0; i < RATE_COUNT; i++) {
+    if (RATES[i].baud <= target) {
+      candidateIndex = i;
+      break;
+    }
+  }
+  currentIndex = NO_RATE;
+  fallback = false;
+  negotiating = true;
+  negotiations++;
+}
+
+void Hm10Manager::startReset() {
+  digitalWrite(breakPin, LOW);
+  resets++;
+  enterState(STATE_RESET_HOLD);
+}
+
+void Hm10Manager::startProbe(uint8_t index) {
+  probeIndex = index;
+  attempts = 0;
+  setUartBaud(RATES[index].baud);
+  sendCommand("AT", "OK");
+  enterState(STATE_PROBE);
+}
+
+/**
+ * Send an AT command and arm the reply match
+ * Bytes already received (boot noise, replies at a wrong rate) are dropped.
+ */
+void Hm10Manager::sendCommand(const char* command, const char* reply) {
+  while (serial->available() > 0) {
+    serial->read();
+  }
+  clearResponse();
+  if (reply != expected) {
+    strncpy(expected, reply, RESPONSE_SIZE);
+    expected[RESPONSE_SIZE] = '\0';
+  }
+  serial->write((const uint8_t*)command, strlen(command));
+  stateTick = timerManager->getMasterTicks();
+}
+
+/**
+ * Collect reply bytes; true once the expected reply has arrived
+ * HM10 replies carry no line ending, so the match is on the text itself.
+ */
+bool Hm10Manager::readResponse() {
+  while (serial->available() > 0) {
+    char c = (char)serial->read();
+    if (c == '\0') c = '?';
+    if (responseLen == RESPONSE_SIZE) {
+      memmove(response, response + 1, RESPONSE_SIZE - 1);
+      responseLen--;
+    }
+    response[responseLen++] = c;
+    response[responseLen] = '\0';
+  }
+  return strstr(response, expected) != nullptr;
+}
+
+void Hm10Manager::clearResponse() {
+  responseLen = 0;
+  response[0] = '\0';
+}
+
+void Hm10Manager::setUartBaud(uint32_t rate) {
+  if (rate == baud) return;
+  serial->begin(rate);
+  baud = rate;
+}
+
+/**
+ * Module answered at probeIndex: done, or switch it to the candidate rate
+ */
+void Hm10Manager::onModuleFound() {
+  currentIndex = probeIndex;
+  if (currentIndex == candidateIndex) {
+    finish(currentIndex);
+    return;
+  }
+
+  char command[] = "AT+BAUD0";
+  char reply[] = "OK+Set:0";
+  command[7] = RATES[candidateIndex].code;
+  reply[7] = RATES[candidateIndex].code;
+  sendCommand(command, reply);
+  enterState(STATE_SET_BAUD);
+}
+
+/**
+ * Module did not answer after a reset: reset again after a backoff, or
+ * re-apply the rate once the retries are used up
+ */
+void Hm10Manager::scheduleRetry() {
+  if (!recovering) {
+    recovering = true;
+    recoveries++;
+  }
+
+  if (recoveryAttempt >= RECOVERY_RETRIES) {
+    TRACE(MODULE_COMM, "HM10: no answer after %u resets, re-negotiating", recoveryAttempt + 1);
+    escalations++;
+    recoveryAttempt = 0;
+    selectTarget(targetBaud);
+    startReset();  // Module already failed to answer at its rate
+    return;
+  }
+
+  backoffTicks = BACKOFF_BASE_TICKS << recoveryAttempt;
+  if (backoffTicks > BACKOFF_MAX_TICKS) backoffTicks = BACKOFF_MAX_TICKS;
+  recoveryAttempt++;
+  TRACE(MODULE_COMM, "HM10: no answer after reset, retry %u in %lu ticks", recoveryAttempt, backoffTicks);
+  clearResponse();
+  enterState(STATE_BACKOFF);
+}
+
+/**
+ * New rate did not pass the loopback check: exclude it and search again
+ */
+void Hm10Manager::onVerifyFailed() {
+  TRACE(MODULE_COMM, "HM10: no reply at %lu baud", RATES[candidateIndex].baud);
+  currentIndex = NO_RATE;
+  if (++candidateIndex >= RATE_COUNT) {
+    finishFallback();
+    return;
+  }
+  startProbe(0);
+}
+
+void Hm10Manager::finish(uint8_t index) {
+  if (index < RATE_COUNT) {
+    setUartBaud(RATES[index].baud);
+    currentIndex = index;
+  }
+  fallback = false;
+  negotiating = false;
+  recovering = false;
+  recoveryAttempt = 0;
+  clearResponse();
+  enterState(STATE_READY);
+}
+
+void Hm10Manager::finishFallback() {
+  setUartBaud(FALLBACK_BAUD);
+  fallback = true;
+  negotiating = false;
+  recovering = false;
+  recoveryAttempt = 0;
+  clearResponse();
+  enterState(STATE_READY);
+}
+
+bool Hm10Manager::timedOut() const {
+  return timerManager->getMasterTicks() - stateTick >= RESPONSE_TIMEOUT_TICKS;
+}
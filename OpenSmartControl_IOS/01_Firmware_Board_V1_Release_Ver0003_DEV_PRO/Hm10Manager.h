@@ -0,0 +1,158 @@
+#ifndef HM10_MANAGER_H
+#define HM10_MANAGER_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <cstdint>
+#include "TimerManager.h"
+
+/**
+ * Hm10Manager Class
+ *
+ * Non-blocking control of the HM10 BLE module: hardware reset and recovery
+ * through the BREAK pin and UART baud-rate negotiation with AT commands.
+ * Every step is a state advanced by poll() from the main loop, so motors and
+ * safety keep running while the module resets or answers.
+ *
+ * Features:
+ * - Reset pulse and boot wait without delay()
+ * - Ready check after a reset ("AT" -> "OK" at the current rate)
+ * - Negotiation asks at the target rate first; a module that kept it from an
+ *   earlier boot is used as is, without a reset
+ * - Retries with doubling backoff when the module does not come back; frames
+ *   still flow between retries and any valid frame ends the recovery
+ * - Escalates to a full negotiation (re-applies the rate) after the retries
+ * - Probes the module at each supported rate ("AT" -> "OK")
+ * - Switches it to the highest allowed rate (AT+BAUDx, stored by the module)
+ * - Loopback check at the new rate ("AT+BAUD?" -> "OK+Get:x"); a rate that
+ *   fails is excluded and the next lower one is tried
+ * - Falls back to 9600 baud when the module stops answering
+ *
+ * While isBusy() the UART belongs to this class: received bytes are AT
+ * replies and nothing else may be sent to the module. poll() must still be
+ * called when not busy so a pending retry (STATE_BACKOFF) can start.
+ */
+class Hm10Manager {
+public:
+  enum State : uint8_t {
+    STATE_IDLE,        // Not started
+    STATE_RESET_HOLD,  // BREAK pin held low
+    STATE_BOOT_WAIT,   // Module restarting
+    STATE_READY_CHECK, // "AT" sent after a reset, waiting for "OK"
+    STATE_BACKOFF,     // Ready check failed, next reset pending (UART usable)
+    STATE_TARGET_CHECK,// "AT" sent at the target rate, before any reset
+    STATE_PROBE,       // "AT" sent at probeIndex
+    STATE_SET_BAUD,    // "AT+BAUDx" sent at the current rate
+    STATE_VERIFY,      // "AT+BAUD?" sent at the new rate
+    STATE_READY        // UART usable for frames
+  };
+
+  static const uint32_t FALLBACK_BAUD = 9600;  // Module factory default and legacy rate
+  static const uint8_t RATE_COUNT = 5;
+
+  static const unsigned long RESET_HOLD_TICKS = 10;       // 100ms
+  static const unsigned long BOOT_TICKS = 50;             // 500ms until the module takes AT commands
+  static const unsigned long RESPONSE_TIMEOUT_TICKS = 30; // 300ms per AT command
+  static const uint8_t ATTEMPTS_PER_RATE = 2;
+  static const uint8_t READY_ATTEMPTS = 3;                // ~0.9s for the module to answer
+  static const uint8_t RECOVERY_RETRIES = 3;              // Resets before the rate is re-negotiated
+  static const unsigned long BACKOFF_BASE_TICKS = 100;    // 1s, doubled per retry
+  static const unsigned long BACKOFF_MAX_TICKS = 800;     // 8s
+
+private:
+  static const uint8_t RESPONSE_SIZE = 24;
+  static const uint8_t NO_RATE = 0xFF;
+
+  HardwareSerial* serial;
+  TimerManager* timerManager;
+  int breakPin;
+
+  State state;
+  unsigned long stateTick;
+  bool negotiating;          // Reset is part of a negotiation (probe after boot)
+
+  uint8_t probeIndex;        // Rate being probed
+  uint8_t attempts;          // Commands sent at probeIndex / during verify
+  uint8_t currentIndex;      // Rate the module answered at (NO_RATE if unknown)
+  uint8_t candidateIndex;    // Highest rate still allowed
+  uint32_t baud;             // Rate the UART runs at
+  bool fallback;             // Module did not answer; running at FALLBACK_BAUD
+  uint32_t targetBaud;       // Rate re-applied when recovery escalates
+
+  // Recovery
+  bool recovering;           // Module did not answer after a reset
+  uint8_t recoveryAttempt;   // Resets retried so far
+  unsigned long backoffTicks;
+
+  char response[RESPONSE_SIZE + 1];
+  uint8_t responseLen;
+  char expected[RESPONSE_SIZE + 1];
+
+  unsigned long resets;
+  unsigned long negotiations;
+  unsigned long recoveries;  // Recoveries started (ready check failed)
+  unsigned long escalations; // Recoveries that re-negotiated the rate
+
+public:
+  // Constructor
+  Hm10Manager(HardwareSerial* bleSerial, TimerManager* timerMgr, int breakPinNumber);
+
+  // Control
+  void begin(uint32_t currentBaud);
+  void negotiate(uint32_t target);
+  void requestReset();
+  void onModuleAlive();
+  void poll();
+
+  // Status
+  bool isBusy() const {
+    return state != STATE_IDLE && state != STATE_READY && state != STATE_BACKOFF;
+  }
+  State getState() const {
+    return state;
+  }
+  uint32_t getBaud() const {
+    return baud;
+  }
+  bool isFallback() const {
+    return fallback;
+  }
+  bool isRecovering() const {
+    return recovering;
+  }
+  uint8_t getRecoveryAttempt() const {
+    return recoveryAttempt;
+  }
+  unsigned long getRecoveryCount() const {
+    return recoveries;
+  }
+  unsigned long getEscalationCount() const {
+    return escalations;
+  }
+  unsigned long getResetCount() const {
+    return resets;
+  }
+  unsigned long getNegotiationCount() const {
+    return negotiations;
+  }
+
+  static uint32_t rateBaud(uint8_t index);
+
+private:
+  void enterState(State newState);
+  void selectTarget(uint32_t target);
+  void startReset();
+  void startProbe(uint8_t index);
+  void sendCommand(const char* command, const char* reply);
+  bool readResponse();
+  void clearResponse();
+  void setUartBaud(uint32_t rate);
+  void onModuleFound();
+  void onVerifyFailed();
+  void scheduleRetry();
+  void finish(uint8_t index);
+  void finishFallback();
+  bool timedOut() const;
+};
+
+#endif  // HM10_MANAGER_H
@@ -0,0 +1,168 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstdio>
+#include "FeatureConfig.h"
+
+// Cortex-M3 DWT cycle counter when CMSIS provides it, micros() otherwise
+#if defined(DWT_CTRL_CYCCNTENA_Msk) && defined(CoreDebug_DEMCR_TRCENA_Msk)
+#define LATENCY_CYCLE_COUNTER 1
+#else
+#define LATENCY_CYCLE_COUNTER 0
+#endif
+
+/**
+ * LatencyProbe Class
+ *
+ * Command latency instrumentation, from the first byte of a BLE frame to the
+ * motor pin the command switches. Each stage stores one cycle-counter read
+ * (a single register load); the durations are only converted and filed into
+ * the histograms once the command has run.
+ *
+ * Stages:
+ * - FRAME:   STX/SOH byte -> ETX byte (UART reception)
+ * - DECODE:  ETX byte -> frame validated (decode + checksum)
+ * - QUEUE:   validated -> handler dispatch (command queue, dedup, logging)
+ * - HANDLER: dispatch -> first motor pin write (or handler return)
+ * - TOTAL:   STX/SOH byte -> first motor pin write (or handler return)
+ * - STOP:    STX/SOH byte -> first motor pin write of the stop fast path
+ *            (RELEASE / stop frames, before they are queued)
+ *
+ * Features:
+ * - log2 microsecond histograms per stage and per command slot
+ * - min / avg / p99 (bucket upper bound) / max per histogram
+ * - Only compiled in with LATENCY_PROBES (FeatureConfig.h)
+ *
+ * Byte times are taken when the byte is drained from the UART buffer, so
+ * FRAME also contains the time the byte waited for the loop. Commands that
+ * only select a mode switch their motors later from SequenceController; for
+ * them the handler return ends HANDLER and TOTAL. Frames that never reach a
+ * handler (duplicates, invalid data) are not counted.
+ */
+class LatencyProbe {
+public:
+  enum Stage : uint8_t {
+    STAGE_FRAME,
+    STAGE_DECODE,
+    STAGE_QUEUE,
+    STAGE_HANDLER,
+    STAGE_TOTAL,
+    STAGE_STOP,
+    STAGE_COUNT
+  };
+
+  // Receive-side timestamps, carried with the command through the queue
+  struct Stamps {
+    uint32_t stx;
+    uint32_t etx;
+    uint32_t valid;
+  };
+
+  static const uint8_t BUCKETS = 20;      // Bucket 0: < 1us, bucket b: [2^(b-1), 2^b) us, last: >= 0.26s
+  static const uint8_t MAX_SLOTS = 20;    // Command slots (COMMAND_TABLE entries + extended frames)
+  static const uint8_t LINE_SIZE = 96;    // Report line, CR LF included
+
+  struct Histogram {
+    uint32_t count;
+    uint64_t sumUs;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint16_t buckets[BUCKETS];            // Halved together when one would overflow
+
+    void clear();
+    void add(uint32_t us);
+    uint32_t averageUs() const;
+    uint32_t percentileUs(uint8_t percent) const;
+  };
+
+private:
+  uint32_t cyclesPerMicrosecond;
+
+  // Command being executed
+  bool commandActive;
+  uint8_t commandSlot;
+  Stamps commandStamps;
+  uint32_t dispatchStamp;
+  uint32_t handlerEndStamp;
+  uint32_t pinStamp;
+  bool dispatched;
+  bool handled;
+  bool pinWritten;
+  bool stopActive;      // Stop fast path running (receive side)
+
+  Histogram stages[STAGE_COUNT];
+  Histogram commands[MAX_SLOTS];
+
+  // Static instance for call sites outside CommunicationManager (motor pins)
+  static LatencyProbe* instance;
+
+  uint32_t toMicroseconds(uint32_t cycles) const {
+    return cycles / cyclesPerMicrosecond;
+  }
+
+public:
+  // Constructor / Destructor
+  LatencyProbe();
+  ~LatencyProbe();
+
+  void begin();
+
+  // Time source (cycles, or microseconds without DWT)
+  static uint32_t now() {
+#if LATENCY_CYCLE_COUNTER
+    return DWT->CYCCNT;
+#else
+    return micros();
+#endif
+  }
+
+  // Command execution (main loop)
+  void beginCommand(uint8_t slot, const Stamps& stamps);
+  void endCommand();
+
+  // Stop fast path (receive side, never inside a command)
+  void beginStop();
+  void endStop(const Stamps& stamps);
+  static void markDispatch() {
+    if (instance && instance->commandActive && !instance->dispatched) {
+      instance->dispatchStamp = now();
+      instance->dispatched = true;
+    }
+  }
+  static void markHandlerEnd() {
+    if (instance && instance->commandActive) {
+      instance->handlerEndStamp = now();
+      instance->handled = true;
+    }
+  }
+  static void markPinWrite() {
+    if (instance && (instance->commandActive || instance->stopActive) && !instance->pinWritten) {
+      instance->pinStamp = now();
+      instance->pinWritten = true;
+    }
+  }
+
+  // Results
+  const Histogram& getStage(Stage stage) const {
+    return stages[stage];
+  }
+  const Histogram& getCommand(uint8_t slot) const {
+    return commands[slot < MAX_SLOTS ? slot : MAX_SLOTS - 1];
+  }
+  static const char* getStageName(Stage stage);
+  static int formatLine(char* line, const char* name, const Histogram& histogram);
+  void reset();
+};
+
+// First motor pin write of the command being executed (MotorController)
+#if LATENCY_PROBES
+#define LATENCY_PIN_WRITE() LatencyProbe::markPinWrite()
+#else
+#define LATENCY_PIN_WRITE() \
+  do { \
+  } while (0)
+#endif
+
+#endif  // LATENCY_PROBE_H
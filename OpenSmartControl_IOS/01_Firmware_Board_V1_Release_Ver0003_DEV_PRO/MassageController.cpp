@@ -18,6 +18,8 @@ MassageController::MassageController()
     , sequenceController(nullptr)
     , debugSerial(nullptr)
     , bleSerial(nullptr)
+    , debugLog(nullptr)
+    , serviceConsole(nullptr)
     , systemInitialized(false)
     , systemRunning(false)
     , lastLoopTick(0)
@@ -34,6 +36,10 @@ MassageController::~MassageController() {
     stop();
     
     // Clean up subsystems
+    if (serviceConsole) {
+        delete serviceConsole;
+        serviceConsole = nullptr;
+    }
     if (sequenceController) {
         delete sequenceController;
         sequenceController = nullptr;
@@ -58,6 +64,10 @@ MassageController::~MassageController() {
         delete timerManager;
         timerManager = nullptr;
     }
+    if (debugLog) {
+        delete debugLog;
+        debugLog = nullptr;
+    }
 }
 
 /**
@@ -173,6 +183,11 @@ void MassageController::stop() {
  * Main run function - called from Arduino loop()
  */
 void MassageController::run() {
+    // Hand buffered debug output to the UART (never waits)
+    if (debugLog) {
+        debugLog->drain();
+    }
+    
     if (!systemInitialized || !systemRunning) {
         return;
     }
@@ -249,6 +264,14 @@ SequenceController* MassageController::getSequenceController() const {
     return sequenceController;
 }
 
+DebugLog* MassageController::getDebugLog() const {
+    return debugLog;
+}
+
+ServiceConsole* MassageController::getServiceConsole() const {
+    return serviceConsole;
+}
+
 /**
  * Enable system
  */
@@ -311,12 +334,22 @@ void MassageController::processMainLoop() {
     // Update loop statistics
     updateLoopStatistics();
     
-    // Process all subsystems
+    // Process all subsystems (phases timed while a console profile runs)
+    if (serviceConsole) serviceConsole->beginPass();
     processCommunication();
+    if (serviceConsole) serviceConsole->markPhase(ServiceConsole::PHASE_COMMUNICATION);
+    processCommands();
+    if (serviceConsole) serviceConsole->markPhase(ServiceConsole::PHASE_COMMANDS);
     processSensors();
+    if (serviceConsole) serviceConsole->markPhase(ServiceConsole::PHASE_SENSORS);
     processSequences();
+    if (serviceConsole) serviceConsole->markPhase(ServiceConsole::PHASE_SEQUENCES);
     processSafety();
+    if (serviceConsole) serviceConsole->markPhase(ServiceConsole::PHASE_SAFETY);
     processMotors();
+    if (serviceConsole) serviceConsole->markPhase(ServiceConsole::PHASE_MOTORS);
+    processTelemetry();
+    if (serviceConsole) serviceConsole->markPhase(ServiceConsole::PHASE_TELEMETRY);
     
     // Process debug output
     processDebugOutput();
@@ -326,6 +359,7 @@ void MassageController::processMainLoop() {
     
     lastLoopTick = currentTick;
     loopCounter++;
+    if (serviceConsole) serviceConsole->endPass();
 }
 
 /**
@@ -338,6 +372,22 @@ void MassageController::processCommunication() {
     }
 }
 
+/**
+ * Execute commands received this pass
+ * Runs after reception so a slow handler never delays UART ingest.
+ * Link supervision follows so a safe stop lands before sequences and motors run.
+ * Service console lines run here too, like commands from the app.
+ */
+void MassageController::processCommands() {
+    if (communicationManager) {
+        communicationManager->executePendingCommands();
+        communicationManager->superviseLink();
+    }
+    if (serviceConsole) {
+        serviceConsole->poll();
+    }
+}
+
 /**
  * Process sensors
  */
@@ -384,11 +434,29 @@ void MassageController::processSafety() {
  */
 void MassageController::processMotors() {
     if (motorController) {
-        motorController->checkMotorTimeouts();
+        // A lapsed hold lease acts like the RELEASE that never came
+        if (motorController->checkMotorTimeouts() && communicationManager) {
+            communicationManager->onManualMotionTimeout();
+        }
         motorController->resetRL1RL2();  // Process RL1/RL2 motor management
     }
 }
 
+/**
+ * Push state telemetry after this pass has updated the chair state
+ * and hand queued BLE frames to the UART
+ * (and any pending latency report / capture dump lines to the debug UART)
+ */
+void MassageController::processTelemetry() {
+    if (communicationManager) {
+        communicationManager->processTelemetry();
+        communicationManager->processTransmit();
+        communicationManager->processLatencyReport();
+        communicationManager->processCaptureDump();
+        communicationManager->processFirmwareUpdate();
+    }
+}
+
 /**
  * Check system health
  */
@@ -454,7 +522,7 @@ void MassageController::handleSystemError(const char* errorMessage) {
     // SYSTEM ERROR debug disabled
     
     // Log the error
-    logSystemEvent(errorMessage);
+    if (debugLog) debugLog->log(DebugLog::MODULE_SYSTEM, DebugLog::LEVEL_ERROR, errorMessage);
     
     // Perform error recovery
     performErrorRecovery();
@@ -478,9 +546,11 @@ void MassageController::performErrorRecovery() {
 
 /**
  * Log system event
+ * LEVEL_DEBUG: silent at the default log level, as before the DebugLog
+ * (enable with "set log.level 3" on the service console)
  */
 void MassageController::logSystemEvent(const char* event) {
-    // EVENT LOG debug disabled
+    if (debugLog) debugLog->log(DebugLog::MODULE_SYSTEM, DebugLog::LEVEL_DEBUG, event);
 }
 
 /**
@@ -535,6 +605,7 @@ void MassageController::initializeSubsystems() {
     initializeCommunication();
     initializeSafety();
     initializeSequences();
+    initializeConsole();
     
     // if (debugSerial) debugSerial->println("Subsystem initialization completed");
 }
@@ -546,6 +617,11 @@ void MassageController::initializeSerial() {
     if (debugSerial) {
         debugSerial->begin(115200);
         delay(100);
+        
+        // Subsystems print into the debug log instead of waiting for the UART
+        if (!debugLog) {
+            debugLog = new DebugLog(debugSerial);
+        }
     }
     
     // Initialize BLE serial
@@ -560,7 +636,7 @@ void MassageController::initializeSerial() {
 void MassageController::initializeTimers() {
     // if (debugSerial) debugSerial->println("Initializing timer manager...");
     
-    timerManager = new TimerManager(debugSerial);
+    timerManager = new TimerManager(logChannel(DebugLog::MODULE_TIMER));
     timerManager->initialize();
     
     // if (debugSerial) debugSerial->println("Timer manager initialized");
@@ -569,7 +645,7 @@ void MassageController::initializeTimers() {
 void MassageController::initializeMotors() {
     // if (debugSerial) debugSerial->println("Initializing motor controller...");
     
-    motorController = new MotorController(timerManager, debugSerial);
+    motorController = new MotorController(timerManager, logChannel(DebugLog::MODULE_MOTOR));
     motorController->initialize();
     
     // if (debugSerial) debugSerial->println("Motor controller initialized");
@@ -578,7 +654,7 @@ void MassageController::initializeMotors() {
 void MassageController::initializeSensors() {
     // if (debugSerial) debugSerial->println("Initializing sensor manager...");
     
-    sensorManager = new SensorManager(timerManager, motorController, debugSerial);
+    sensorManager = new SensorManager(timerManager, motorController, logChannel(DebugLog::MODULE_SENSOR));
     sensorManager->initialize();
     sensorManager->setupInterrupts();
     
@@ -588,7 +664,7 @@ void MassageController::initializeSensors() {
 void MassageController::initializeCommunication() {
     // if (debugSerial) debugSerial->println("Initializing communication manager...");
     
-    communicationManager = new CommunicationManager(timerManager, debugSerial, bleSerial);
+    communicationManager = new CommunicationManager(timerManager, logChannel(DebugLog::MODULE_COMM), bleSerial);
     communicationManager->initialize();
     
     // NOTE: setControllers() will be called AFTER sequenceController is initialized
@@ -600,27 +676,50 @@ void MassageController::initializeCommunication() {
 void MassageController::initializeSafety() {
     // if (debugSerial) debugSerial->println("Initializing safety manager...");
     
-    safetyManager = new SafetyManager(timerManager, debugSerial);
+    safetyManager = new SafetyManager(timerManager, logChannel(DebugLog::MODULE_SAFETY));
     safetyManager->initialize();
     
+    // Link-up/link-down reports from the BLE link supervisor
+    if (communicationManager) {
+        communicationManager->setSafetyManager(safetyManager);
+    }
+    
     // if (debugSerial) debugSerial->println("Safety manager initialized");
 }
 
 void MassageController::initializeSequences() {
     // if (debugSerial) debugSerial->println("Initializing sequence controller...");
     
-    sequenceController = new SequenceController(timerManager, motorController, sensorManager, debugSerial);
+    sequenceController = new SequenceController(timerManager, motorController, sensorManager, logChannel(DebugLog::MODULE_SEQUENCE));
     sequenceController->initialize();
     
     // NOW set controller references in CommunicationManager (after sequenceController is initialized)
     if (communicationManager) {
-        communicationManager->setControllers((void*)motorController, (void*)sequenceController, (void*)sensorManager);
+        communicationManager->setControllers(motorController, sequenceController, sensorManager);
         // if (debugSerial) debugSerial->println("Controller references set in CommunicationManager");
     }
     
     // if (debugSerial) debugSerial->println("Sequence controller initialized");
 }
 
+/**
+ * Service console on the debug UART (needs the debug log for its replies)
+ */
+void MassageController::initializeConsole() {
+#if SERVICE_CONSOLE
+    if (debugSerial && debugLog && !serviceConsole) {
+        serviceConsole = new ServiceConsole(this, debugSerial, debugLog);
+    }
+#endif
+}
+
+/**
+ * Debug output for a subsystem (nullptr when debug output is off)
+ */
+Print* MassageController::logChannel(DebugLog::Module module) const {
+    return debugLog ? debugLog->getChannel(module) : debugSerial;
+}
+
 void MassageController::updateLoopStatistics() {
     // Update loop statistics for monitoring
     unsigned long currentTick = timerManager ? timerManager->getMasterTicks() : 0;
@@ -667,7 +766,7 @@ bool MassageController::validateHardware() const {
 }
 
 void MassageController::resetSubsystems() {
-    if (debugSerial) debugSerial->println("Resetting subsystems...");
+    logSystemEvent("Resetting subsystems...");
     
     if (sequenceController) {
         sequenceController->resetAllModes();
@@ -683,21 +782,21 @@ void MassageController::resetSubsystems() {
 }
 
 void MassageController::recoverFromError() {
-    if (debugSerial) debugSerial->println("Attempting error recovery...");
+    logSystemEvent("Attempting error recovery...");
     
     // Try to reset subsystems
     resetSubsystems();
     
     // Check if recovery was successful
     if (isSystemHealthy()) {
-        if (debugSerial) debugSerial->println("Error recovery successful");
+        logSystemEvent("Error recovery successful");
     } else {
-        if (debugSerial) debugSerial->println("Error recovery failed");
+        logSystemEvent("Error recovery failed");
     }
 }
 
 void MassageController::performSystemReset() {
-    if (debugSerial) debugSerial->println("Performing complete system reset...");
+    logSystemEvent("Performing complete system reset...");
     
     // Stop system
     stop();
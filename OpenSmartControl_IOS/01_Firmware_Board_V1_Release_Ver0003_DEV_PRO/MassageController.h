@@ -9,6 +9,8 @@
 #include "CommunicationManager.h"
 #include "SafetyManager.h"
 #include "SequenceController.h"
+#include "DebugLog.h"
+#include "ServiceConsole.h"
 
 /**
  * MassageController Class
@@ -22,6 +24,8 @@
  * - Subsystem integration
  * - System state management
  * - Error handling and recovery
+ * - Buffered, non-blocking debug log (one channel per subsystem)
+ * - Service console on the debug UART (SERVICE_CONSOLE)
  */
 class MassageController {
 private:
@@ -37,6 +41,12 @@ private:
     HardwareSerial* debugSerial;
     HardwareSerial* bleSerial;
     
+    // Debug log (created on the debug UART, drained once per loop pass)
+    DebugLog* debugLog;
+    
+    // Service console (debug UART input, nullptr unless SERVICE_CONSOLE)
+    ServiceConsole* serviceConsole;
+    
     // System state
     bool systemInitialized;
     bool systemRunning;
@@ -75,6 +85,8 @@ public:
     CommunicationManager* getCommunicationManager() const;
     SafetyManager* getSafetyManager() const;
     SequenceController* getSequenceController() const;
+    DebugLog* getDebugLog() const;
+    ServiceConsole* getServiceConsole() const;
     
     // System Control
     void enableSystem();
@@ -85,10 +97,12 @@ public:
     // Main Loop Processing
     void processMainLoop();
     void processCommunication();
+    void processCommands();
     void processSensors();
     void processSequences();
     void processSafety();
     void processMotors();
+    void processTelemetry();
     
     // System Health
     void checkSystemHealth();
@@ -119,6 +133,8 @@ private:
     void initializeCommunication();
     void initializeSafety();
     void initializeSequences();
+    void initializeConsole();
+    Print* logChannel(DebugLog::Module module) const;
     
     // Main loop helpers
     void updateLoopStatistics();
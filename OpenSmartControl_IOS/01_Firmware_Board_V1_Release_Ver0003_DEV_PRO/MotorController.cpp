@@ -1,10 +1,12 @@
 #include "MotorController.h"
+#include "LatencyProbe.h"
+#include "DebugLog.h"
 
 /**
  * Constructor
  */
-MotorController::MotorController(TimerManager* timerMgr, HardwareSerial* debugSer)
-  : timerManager(timerMgr), debugSerial(debugSer), rl1Running(false), rl2Running(false), rl3Running(false), kneadingRunning(false), compressionRunning(false), rl1StartTick(0), rl2StartTick(0), rl1DelayStartTick(0), rl2DelayStartTick(0), rl1Direction(false), rl2Direction(false), rl3Direction(false), kneadingPWM(0), compressionPWM(0), globalRL3PWMState(false) {
+MotorController::MotorController(TimerManager* timerMgr, Print* debugSer)
+  : timerManager(timerMgr), debugSerial(debugSer), rl1Running(false), rl2Running(false), rl3Running(false), kneadingRunning(false), compressionRunning(false), rl1StartTick(0), rl2StartTick(0), rl1DelayStartTick(0), rl2DelayStartTick(0), rl1LeaseTicks(0), rl2LeaseTicks(0), rl1LeaseTick(0), rl2LeaseTick(0), leaseExpiries(0), rl1Direction(false), rl2Direction(false), rl3Direction(false), kneadingPWM(0), compressionPWM(0), globalRL3PWMState(false) {
 }
 
 /**
@@ -54,6 +56,8 @@ void MotorController::initialize() {
   rl2StartTick = 0;
   rl1DelayStartTick = 0;
   rl2DelayStartTick = 0;
+  rl1LeaseTicks = 0;
+  rl2LeaseTicks = 0;
 
   rl1Direction = false;
   rl2Direction = false;
@@ -80,6 +84,7 @@ void MotorController::onRecline() {
   // If motor was stopped but direction is still recline, restart it
   if (!rl1Running && rl1Direction == false) {
     digitalWrite(RL1_PWM, HIGH);
+    LATENCY_PIN_WRITE();
     rl1Running = true;
     rl1StartTick = timerManager->getMasterTicks();
     // RECLINE: Motor restart debug disabled
@@ -89,6 +94,7 @@ void MotorController::onRecline() {
   // Start new or restart motor
   setRL1Direction(false);  // Recline direction
   digitalWrite(RL1_PWM, HIGH);
+  LATENCY_PIN_WRITE();
   rl1Running = true;
   rl1StartTick = timerManager->getMasterTicks();
 
@@ -117,6 +123,7 @@ void MotorController::onIncline() {
   // If motor was stopped but direction is still incline, restart it
   if (!rl1Running && rl1Direction == true) {
     digitalWrite(RL1_PWM, HIGH);
+    LATENCY_PIN_WRITE();
     rl1Running = true;
     rl1StartTick = timerManager->getMasterTicks();
     // if (debugSerial) debugSerial->println("INCLINE: Motor was stopped - restarting");
@@ -126,6 +133,7 @@ void MotorController::onIncline() {
   // Start new or restart motor
   setRL1Direction(true);  // Incline direction
   digitalWrite(RL1_PWM, HIGH);
+  LATENCY_PIN_WRITE();
   rl1Running = true;
   rl1StartTick = timerManager->getMasterTicks();
 
@@ -136,9 +144,11 @@ void MotorController::offReclineIncline() {
   if (rl1Running) {
     // if (debugSerial) debugSerial->println("DEBUG: offReclineIncline() called - stopping RL1 motor");
     digitalWrite(RL1_PWM, LOW);
+    LATENCY_PIN_WRITE();
     rl1Running = false;
     rl1StartTick = 0;
   }
+  rl1LeaseTicks = 0;
 }
 
 bool MotorController::isRL1Running() const {
@@ -178,6 +188,7 @@ void MotorController::onForward() {
   // If motor was stopped but direction is still forward, restart it
   if (!rl2Running && rl2Direction == true) {
     digitalWrite(RL2_PWM, HIGH);
+    LATENCY_PIN_WRITE();
     rl2Running = true;
     rl2StartTick = timerManager->getMasterTicks();
     // if (debugSerial) debugSerial->println("FORWARD: Motor was stopped - restarting");
@@ -187,6 +198,7 @@ void MotorController::onForward() {
   // Start new or restart motor
   setRL2Direction(true);  // Forward direction
   digitalWrite(RL2_PWM, HIGH);
+  LATENCY_PIN_WRITE();
   rl2Running = true;
   rl2StartTick = timerManager->getMasterTicks();
 
@@ -215,6 +227,7 @@ void MotorController::onBackward() {
   // If motor was stopped but direction is still backward, restart it
   if (!rl2Running && rl2Direction == false) {
     digitalWrite(RL2_PWM, HIGH);
+    LATENCY_PIN_WRITE();
     rl2Running = true;
     rl2StartTick = timerManager->getMasterTicks();
     // if (debugSerial) debugSerial->println("BACKWARD: Motor was stopped - restarting");
@@ -224,6 +237,7 @@ void MotorController::onBackward() {
   // Start new or restart motor
   setRL2Direction(false);  // Backward direction
   digitalWrite(RL2_PWM, HIGH);
+  LATENCY_PIN_WRITE();
   rl2Running = true;
   rl2StartTick = timerManager->getMasterTicks();
 
@@ -234,9 +248,11 @@ void MotorController::offForwardBackward() {
   if (rl2Running) {
     // if (debugSerial) debugSerial->println("DEBUG: offForwardBackward() called - stopping RL2 motor");
     digitalWrite(RL2_PWM, LOW);
+    LATENCY_PIN_WRITE();
     rl2Running = false;
     rl2StartTick = 0;
   }
+  rl2LeaseTicks = 0;
 }
 
 bool MotorController::isRL2Running() const {
@@ -257,6 +273,7 @@ void MotorController::setRL2StartTick(unsigned long tick) {
 void MotorController::onRollMotor() {
   if (!rl3Running) {
     digitalWrite(RL3_PWM, HIGH);
+    LATENCY_PIN_WRITE();
     rl3Running = true;
     setRL3PWMState(true);
   }
@@ -265,6 +282,7 @@ void MotorController::onRollMotor() {
 void MotorController::offRollMotor() {
   if (rl3Running) {
     digitalWrite(RL3_PWM, LOW);
+    LATENCY_PIN_WRITE();
     rl3Running = false;
     setRL3PWMState(false);
   }
@@ -410,31 +428,47 @@ void MotorController::emergencyStop() {
   if (debugSerial) debugSerial->println("EMERGENCY STOP: All motors turned OFF");
 }
 
-void MotorController::checkMotorTimeouts() {
-  // Debug: Check if timeout is being checked
+/**
+ * Stop RL1/RL2 when a hold lease lapses or the hard timeout is reached
+ * Called every loop pass; leases resolve to the 10ms master tick.
+ * Returns true if a motor was stopped.
+ */
+bool MotorController::checkMotorTimeouts() {
+  // Periodic status of running RL1/RL2 (trace only: this runs every loop pass)
   static unsigned long lastDebugTick = 0;
   unsigned long currentTick = timerManager ? timerManager->getMasterTicks() : 0;
 
   if (currentTick - lastDebugTick >= 1000) {  // Every 10 seconds
-    if (debugSerial && (rl1Running || rl2Running)) {
-      debugSerial->print("TIMEOUT CHECK: RL1=");
-      debugSerial->print(rl1Running ? "RUNNING" : "STOPPED");
-      debugSerial->print(", RL2=");
-      debugSerial->print(rl2Running ? "RUNNING" : "STOPPED");
-      if (rl1Running) {
-        debugSerial->print(", RL1_RUN_TIME=");
-        debugSerial->print((currentTick - rl1StartTick) * 10);
-        debugSerial->print("ms");
-      }
-      debugSerial->println();
+    if (rl1Running || rl2Running) {
+      TRACE(MODULE_MOTOR, "TIMEOUT CHECK: RL1=%u RL2=%u RL1_RUN_TIME=%lu ms",
+            rl1Running, rl2Running, rl1Running ? (currentTick - rl1StartTick) * 10 : 0);
     }
     lastDebugTick = currentTick;
   }
 
+  bool stopped = false;
+
+  // Hold-to-run leases: the app stopped renewing (RELEASE lost, app gone)
+  if (isLeaseExpired(RL1_RECLINE_INCLINE)) {
+    if (debugSerial) debugSerial->println("MOTOR LEASE: RL1 stopped - hold not renewed");
+    handleMotorTimeout(RL1_RECLINE_INCLINE);
+    leaseExpiries++;
+    stopped = true;
+  }
+  if (isLeaseExpired(RL2_FORWARD_BACKWARD)) {
+    if (debugSerial) debugSerial->println("MOTOR LEASE: RL2 stopped - hold not renewed");
+    handleMotorTimeout(RL2_FORWARD_BACKWARD);
+    leaseExpiries++;
+    stopped = true;
+  }
+
   if (checkRL1RL2Timeout()) {
     if (debugSerial) debugSerial->println("MOTOR TIMEOUT: RL1/RL2 motors stopped after 60s");
-    resetRL1RL2();
+    if (isMotorTimeout(RL1_RECLINE_INCLINE)) handleMotorTimeout(RL1_RECLINE_INCLINE);
+    if (isMotorTimeout(RL2_FORWARD_BACKWARD)) handleMotorTimeout(RL2_FORWARD_BACKWARD);
+    stopped = true;
   }
+  return stopped;
 }
 
 /**
@@ -483,12 +517,32 @@ bool MotorController::isMotorTimeout(MotorType motorType) const {
 /**
  * Safety Functions
  */
+/**
+ * Start or renew a hold-to-run lease: the motor stops once timeoutTicks
+ * pass without another call (0 clears the lease)
+ */
 void MotorController::setMotorTimeout(MotorType motorType, unsigned long timeoutTicks) {
-  // Implementation for setting custom timeouts if needed
+  unsigned long currentTick = timerManager ? timerManager->getMasterTicks() : 0;
+
+  switch (motorType) {
+    case RL1_RECLINE_INCLINE:
+      rl1LeaseTicks = timeoutTicks;
+      rl1LeaseTick = currentTick;
+      break;
+    case RL2_FORWARD_BACKWARD:
+      rl2LeaseTicks = timeoutTicks;
+      rl2LeaseTick = currentTick;
+      break;
+    default:
+      break;
+  }
 }
 
+/**
+ * Drop the lease (legacy PUSH: hard timeout only)
+ */
 void MotorController::clearMotorTimeout(MotorType motorType) {
-  // Implementation for clearing timeouts if needed
+  setMotorTimeout(motorType, 0);
 }
 
 /**
@@ -498,6 +552,7 @@ void MotorController::setRL1State(bool running, bool direction) {
   rl1Running = running;
   rl1Direction = direction;
   digitalWrite(RL1_PWM, running ? HIGH : LOW);
+  LATENCY_PIN_WRITE();
   digitalWrite(RL1_DIR, direction ? HIGH : LOW);
 }
 
@@ -505,6 +560,7 @@ void MotorController::setRL2State(bool running, bool direction) {
   rl2Running = running;
   rl2Direction = direction;
   digitalWrite(RL2_PWM, running ? HIGH : LOW);
+  LATENCY_PIN_WRITE();
   digitalWrite(RL2_DIR, direction ? HIGH : LOW);
 }
 
@@ -512,6 +568,7 @@ void MotorController::setRL3State(bool running, bool direction) {
   rl3Running = running;
   rl3Direction = direction;
   digitalWrite(RL3_PWM, running ? HIGH : LOW);
+  LATENCY_PIN_WRITE();
   digitalWrite(RL3_DIR, direction ? HIGH : LOW);
 }
 
@@ -556,11 +613,13 @@ void MotorController::setRL3PWMState(bool state) {
 void MotorController::setKneadingPWMInternal(uint8_t pwmValue) {
   kneadingPWM = pwmValue;
   analogWrite(FETT_PWM_PIN, pwmValue);
+  LATENCY_PIN_WRITE();
 }
 
 void MotorController::setCompressionPWMInternal(uint8_t pwmValue) {
   compressionPWM = pwmValue;
   analogWrite(FETK_PWM_PIN, pwmValue);
+  LATENCY_PIN_WRITE();
   
 }
 
@@ -568,6 +627,19 @@ bool MotorController::checkRL1RL2Timeout() const {
   return isMotorTimeout(RL1_RECLINE_INCLINE) || isMotorTimeout(RL2_FORWARD_BACKWARD);
 }
 
+bool MotorController::isLeaseExpired(MotorType motorType) const {
+  unsigned long currentTick = timerManager ? timerManager->getMasterTicks() : 0;
+
+  switch (motorType) {
+    case RL1_RECLINE_INCLINE:
+      return rl1Running && rl1LeaseTicks && (currentTick - rl1LeaseTick) >= rl1LeaseTicks;
+    case RL2_FORWARD_BACKWARD:
+      return rl2Running && rl2LeaseTicks && (currentTick - rl2LeaseTick) >= rl2LeaseTicks;
+    default:
+      return false;
+  }
+}
+
 void MotorController::handleMotorTimeout(MotorType motorType) {
   switch (motorType) {
     case RL1_RECLINE_INCLINE:
@@ -18,6 +18,7 @@
  * - Direction control
  * - Motor state management
  * - Safety timeouts
+ * - Hold-to-run leases for RL1/RL2 (stop when the app stops renewing)
  * - Non-blocking motor operations
  */
 class MotorController {
@@ -69,6 +70,13 @@ private:
   unsigned long rl1DelayStartTick;
   unsigned long rl2DelayStartTick;
 
+  // Hold-to-run leases (0 = no lease, hard timeout only)
+  unsigned long rl1LeaseTicks;
+  unsigned long rl2LeaseTicks;
+  unsigned long rl1LeaseTick;  // Last renewal
+  unsigned long rl2LeaseTick;
+  unsigned long leaseExpiries;
+
   // Motor directions
   bool rl1Direction;
   bool rl2Direction;
@@ -84,11 +92,11 @@ private:
 
   // Component references
   TimerManager* timerManager;
-  HardwareSerial* debugSerial;
+  Print* debugSerial;
 
 public:
   // Constructor
-  MotorController(TimerManager* timerMgr, HardwareSerial* debugSer = nullptr);
+  MotorController(TimerManager* timerMgr, Print* debugSer = nullptr);
 
   // Destructor
   ~MotorController();
@@ -143,7 +151,7 @@ public:
   // Motor Management
   void resetRL1RL2();
   void emergencyStop();
-  void checkMotorTimeouts();
+  bool checkMotorTimeouts();
 
   // Motor State Getters
   bool isAnyMotorRunning() const;
@@ -154,9 +162,12 @@ public:
   unsigned long getMotorRunTime(MotorType motorType) const;
   bool isMotorTimeout(MotorType motorType) const;
 
-  // Safety Functions
+  // Safety Functions (hold-to-run lease, RL1/RL2 only)
   void setMotorTimeout(MotorType motorType, unsigned long timeoutTicks);
   void clearMotorTimeout(MotorType motorType);
+  unsigned long getLeaseExpiries() const {
+    return leaseExpiries;
+  }
 
 private:
   // Helper functions
@@ -177,6 +188,7 @@ private:
 
   // Safety helpers
   bool checkRL1RL2Timeout() const;
+  bool isLeaseExpired(MotorType motorType) const;
   void handleMotorTimeout(MotorType motorType);
 };
 
@@ -0,0 +1,258 @@
+#include "PacketCodec.h"
+
+/**
+ * Calculate checksum over len bytes
+ */
+uint8_t PacketCodec::checksum(const uint8_t* data, int len) {
+  uint16_t sum = 0;
+
+  for (int i = 0; i < len; i++) {
+    sum += data[i];
+  }
+
+  return foldChecksum(sum);
+}
+
+/**
+ * Turn a running byte sum into the checksum value
+ */
+uint8_t PacketCodec::foldChecksum(uint16_t sum) {
+  // Add carry (Internet checksum style)
+  while (sum >> 8) {
+    sum = (sum & 0xFF) + (sum >> 8);
+  }
+
+  // One's complement + 0x10 offset
+  return ((~sum) + 0x10) & 0xFF;
+}
+
+/**
+ * Calculate checksum of a packet payload
+ */
+uint8_t PacketCodec::checksum(const Packet& packet) {
+  return checksum(reinterpret_cast<const uint8_t*>(&packet), PAYLOAD_SIZE);
+}
+
+/**
+ * Fill in the checksum field
+ */
+void PacketCodec::seal(Packet& packet) {
+  packet.checksum = checksum(packet);
+}
+
+/**
+ * Verify the checksum field
+ */
+bool PacketCodec::isValid(const Packet& packet) {
+  return packet.checksum == checksum(packet);
+}
+
+/**
+ * Verify a body of len bytes whose last byte is the checksum
+ */
+bool PacketCodec::isValid(const uint8_t* body, int len) {
+  return len >= BODY_SIZE && len <= MAX_BODY_SIZE && body[len - 1] == checksum(body, len - 1);
+}
+
+/**
+ * Check if a body byte must be escaped in a binary frame
+ */
+bool PacketCodec::needsEscape(uint8_t b) {
+  return b == SOH || b == STX || b == ETX || b == DLE;
+}
+
+/**
+ * Encode a packet as a binary frame
+ * out must hold MAX_BINARY_FRAME_SIZE bytes. Returns the frame length.
+ */
+int PacketCodec::encodeBinary(const Packet& packet, uint8_t* out) {
+  return encodeBinary(reinterpret_cast<const uint8_t*>(&packet), BODY_SIZE, out);
+}
+
+/**
+ * Encode a body of len bytes (checksum included) as a binary frame
+ * out must hold 2 + 2 * len bytes. Returns the frame length.
+ */
+int PacketCodec::encodeBinary(const uint8_t* body, int len, uint8_t* out) {
+  int n = 0;
+
+  out[n++] = SOH;
+  for (int i = 0; i < len; i++) {
+    if (needsEscape(body[i])) {
+      out[n++] = DLE;
+      out[n++] = body[i] ^ ESCAPE_XOR;
+    } else {
+      out[n++] = body[i];
+    }
+  }
+  out[n++] = ETX;
+
+  return n;
+}
+
+/**
+ * Convert a hex character to its value (NOT_HEX for any other character)
+ */
+uint8_t PacketCodec::hexNibble(uint8_t c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return NOT_HEX;
+}
+
+/**
+ * Encode a body of len bytes (checksum included) as a hex frame
+ * out must hold 2 + 2 * len bytes. Returns the frame length.
+ */
+int PacketCodec::encodeHex(const uint8_t* body, int len, uint8_t* out) {
+  static const char digits[] = "0123456789ABCDEF";
+  int n = 0;
+
+  out[n++] = STX;
+  for (int i = 0; i < len; i++) {
+    out[n++] = digits[body[i] >> 4];
+    out[n++] = digits[body[i] & 0x0F];
+  }
+  out[n++] = ETX;
+
+  return n;
+}
+
+/**
+ * Constructor
+ */
+BinaryFrameDecoder::BinaryFrameDecoder()
+  : index(0), state(WAIT_SOH), error(PacketCodec::ERROR_NONE) {
+  memset(&frame, 0, sizeof(frame));
+}
+
+/**
+ * Drop any partial frame
+ */
+void BinaryFrameDecoder::reset() {
+  index = 0;
+  state = WAIT_SOH;
+}
+
+/**
+ * Drop the frame being received and remember why
+ */
+BinaryFrameDecoder::Result BinaryFrameDecoder::fail(PacketCodec::FrameError reason) {
+  reset();
+  error = reason;
+  return ERROR;
+}
+
+/**
+ * Feed one received byte
+ * SOH always starts a new frame, so a lost ETX costs at most one frame.
+ */
+BinaryFrameDecoder::Result BinaryFrameDecoder::feed(uint8_t b) {
+  uint8_t* body = frame.body;
+
+  if (b == PacketCodec::SOH) {
+    Result result = (state == WAIT_SOH) ? NONE : ERROR;
+    if (result == ERROR) error = PacketCodec::ERROR_LENGTH;  // Previous frame lost its ETX
+    index = 0;
+    state = READ_BODY;
+    return result;
+  }
+
+  switch (state) {
+    case WAIT_SOH:
+      return NONE;
+
+    case READ_BODY:
+      if (b == PacketCodec::ETX) {
+        frame.length = index;
+        if (index < PacketCodec::BODY_SIZE) return fail(PacketCodec::ERROR_LENGTH);
+        if (!PacketCodec::isValid(body, frame.length)) return fail(PacketCodec::ERROR_CHECKSUM);
+        reset();
+        return FRAME;
+      }
+      if (b == PacketCodec::DLE) {
+        state = READ_ESCAPED;
+        return NONE;
+      }
+      if (b == PacketCodec::STX) return fail(PacketCodec::ERROR_FORMAT);
+      if (index >= PacketCodec::MAX_BODY_SIZE) return fail(PacketCodec::ERROR_OVERFLOW);
+      body[index++] = b;
+      return NONE;
+
+    case READ_ESCAPED:
+      b ^= PacketCodec::ESCAPE_XOR;
+      if (!PacketCodec::needsEscape(b)) return fail(PacketCodec::ERROR_FORMAT);
+      if (index >= PacketCodec::MAX_BODY_SIZE) return fail(PacketCodec::ERROR_OVERFLOW);
+      body[index++] = b;
+      state = READ_BODY;
+      return NONE;
+  }
+
+  return NONE;
+}
+
+/**
+ * Constructor
+ */
+HexFrameDecoder::HexFrameDecoder()
+  : sum(0), length(0), highNibble(0), error(PacketCodec::ERROR_NONE), state(WAIT_STX) {
+  memset(&frame, 0, sizeof(frame));
+}
+
+/**
+ * Drop any partial frame
+ */
+void HexFrameDecoder::reset() {
+  state = WAIT_STX;
+}
+
+/**
+ * Feed one received byte
+ */
+HexFrameDecoder::Result HexFrameDecoder::feed(uint8_t b) {
+  if (b == PacketCodec::STX) {
+    // Start (or restart after a lost ETX) a frame
+    state = READ_HEX;
+    sum = 0;
+    length = 0;
+    error = PacketCodec::ERROR_NONE;
+    return NONE;
+  }
+  if (state == WAIT_STX) return NONE;
+
+  if (b == PacketCodec::ETX) {
+    state = WAIT_STX;
+    uint8_t bytes = length >> 1;
+    if (error != PacketCodec::ERROR_NONE) return ERROR;
+    if ((length & 1) || bytes < PacketCodec::BODY_SIZE) {
+      error = PacketCodec::ERROR_LENGTH;
+      return ERROR;
+    }
+    frame.length = bytes;
+    uint8_t received = frame.body[bytes - 1];
+    if (received != PacketCodec::foldChecksum(sum - received)) {
+      error = PacketCodec::ERROR_CHECKSUM;
+      return ERROR;
+    }
+    return FRAME;
+  }
+
+  uint8_t nibble = PacketCodec::hexNibble(b);
+  if (nibble == PacketCodec::NOT_HEX || length >= MAX_HEX_CHARS) {
+    // Keep consuming until ETX, then refuse the frame (first reason wins)
+    if (error == PacketCodec::ERROR_NONE) {
+      error = (nibble == PacketCodec::NOT_HEX) ? PacketCodec::ERROR_FORMAT : PacketCodec::ERROR_OVERFLOW;
+    }
+    return NONE;
+  }
+
+  if ((length & 1) == 0) {
+    highNibble = nibble;
+  } else {
+    uint8_t value = (highNibble << 4) | nibble;
+    frame.body[length >> 1] = value;
+    sum += value;
+  }
+  length++;
+  return NONE;
+}
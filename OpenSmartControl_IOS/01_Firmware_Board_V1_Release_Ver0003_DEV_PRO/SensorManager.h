@@ -53,6 +53,7 @@ private:
   volatile bool sensorUpPending;
   volatile bool sensorDownPending;
   unsigned long sensorConfirmStartTick;
+  unsigned long confirmDelayTicks;  // SENSOR_CONFIRM_DELAY_TICKS unless tuned at runtime
   bool sensorConfirmInProgress;
   SensorConfirmState confirmState;
 
@@ -64,7 +65,7 @@ private:
   // Component references
   TimerManager* timerManager;
   MotorController* motorController;
-  HardwareSerial* debugSerial;
+  Print* debugSerial;
 
   // Debug timing
   unsigned long lastPendingDebugTick;
@@ -76,7 +77,7 @@ private:
 
 public:
   // Constructor
-  SensorManager(TimerManager* timerMgr, MotorController* motorCtrl = nullptr, HardwareSerial* debugSer = nullptr);
+  SensorManager(TimerManager* timerMgr, MotorController* motorCtrl = nullptr, Print* debugSer = nullptr);
 
   // Destructor
   ~SensorManager();
@@ -111,6 +112,12 @@ public:
   void setSensorConfirmInProgress(bool inProgress);
   void setConfirmState(SensorConfirmState state);
   void setSensorConfirmStartTick(unsigned long tick);
+  unsigned long getConfirmDelayTicks() const {
+    return confirmDelayTicks;
+  }
+  void setConfirmDelayTicks(unsigned long ticks) {
+    confirmDelayTicks = ticks;
+  }
 
   // Global state getters/setters (for compatibility)
   bool getGlobalSensorUpLimit() const;
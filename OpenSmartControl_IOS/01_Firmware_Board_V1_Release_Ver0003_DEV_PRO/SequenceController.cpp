@@ -2,15 +2,19 @@
 #include "MotorController.h"
 #include "SensorManager.h"
 #include "PinDefinitions.h"
+#include "DebugLog.h"
 
 /**
  * Constructor
  */
-SequenceController::SequenceController(TimerManager* timerMgr, MotorController* motorCtrl, SensorManager* sensorMgr, HardwareSerial* debugSer) 
+SequenceController::SequenceController(TimerManager* timerMgr, MotorController* motorCtrl, SensorManager* sensorMgr, Print* debugSer) 
     : timerManager(timerMgr)
     , motorController(motorCtrl)
     , sensorManager(sensorMgr)
     , debugSerial(debugSer)
+    , stepScalePercent(100)
+    , limitDelayTicks(SEQ_LIMIT_DELAY_TICKS)
+    , fullIntensityPWM(SEQ_FULL_INTENSITY_PWM)
     , allowRun(false)
     , homeRun(false)
     , modeAuto(false)
@@ -75,6 +79,7 @@ SequenceController::SequenceController(TimerManager* timerMgr, MotorController*
     , percussionSequenceStarted(false)
     , combinedSequenceStarted(false)
 {
+    memset(stepTicksOverride, 0, sizeof(stepTicksOverride));
 }
 
 /**
@@ -178,7 +183,9 @@ void SequenceController::processGoHome() {
     unsigned long currentTick = timerManager->getMasterTicks();
     
     if (currentTick - lastHomeDebugTick >= 1000) {  // Every 10 seconds
-        // GO HOME DEBUG disabled to save Flash memory
+        if (!homeRun) {
+            TRACE(MODULE_SEQUENCE, "GO HOME: state=%d allowRun=%u startupDelay=%u", currentHomeState, allowRun, startupStabilizationDelay);
+        }
         lastHomeDebugTick = currentTick;
     }
     
@@ -422,7 +429,7 @@ void SequenceController::processAuto() {
     unsigned long currentTick = timerManager ? timerManager->getMasterTicks() : 0;
     
     if (currentTick - lastDebugTick >= 1000) {  // Every 10 seconds
-        // AUTO PROCESS DEBUG disabled to save Flash memory
+        TRACE(MODULE_SEQUENCE, "AUTO PROCESS: allowRun=%u homeRun=%u manualPriority=%u program=%d", allowRun, homeRun, manualPriority, currentAutoProgram);
         lastDebugTick = currentTick;
     }
     
@@ -446,11 +453,7 @@ void SequenceController::processAuto() {
         if (currentTick - lastTimeoutDebugTick >= 3000) {  // Every 30 seconds
             unsigned long remainingTicks = SEQ_AUTO_MODE_DURATION_TICKS - elapsedTicks;
             unsigned long remainingMinutes = (remainingTicks * 10) / 60000;  // Convert to minutes
-            if (debugSerial) {
-                // debugSerial->print("AUTO MODE: ");
-                debugSerial->print(remainingMinutes);
-                debugSerial->println(" minutes remaining");
-            }
+            TRACE(MODULE_SEQUENCE, "AUTO MODE: %lu minutes remaining", remainingMinutes);
             lastTimeoutDebugTick = currentTick;
         }
     }
@@ -648,6 +651,7 @@ unsigned long SequenceController::getAutoRemainingTime() {
     if (!autoModeTimerActive) return 0;
     
     unsigned long elapsed = timerManager->getMasterTicks() - autoModeStartTick;
+    if (elapsed >= SEQ_AUTO_MODE_DURATION_TICKS) return 0;
     unsigned long remaining = SEQ_AUTO_MODE_DURATION_TICKS - elapsed;
     
     return remaining / 100;  // Convert ticks to seconds
@@ -715,7 +719,7 @@ void SequenceController::resetSequenceStatesOnly() {
     percussionSequenceStartTick = 0;
     combinedSequenceStartTick = 0;
     
-    // if (debugSerial) debugSerial->println("DEBUG: Sequence states reset (mode flags preserved)");
+    TRACE(MODULE_SEQUENCE, "DEBUG: Sequence states reset (mode flags preserved)");
 }
 
 /**
@@ -805,19 +809,45 @@ void SequenceController::setIntensityOff(const char* reason) {
 }
 
 uint8_t SequenceController::getIntensityForProgram(AutoProgram program) const {
-    // AUTO_DEFAULT and AUTO_KNEADING always use HIGH intensity (255)
+    // AUTO_DEFAULT and AUTO_KNEADING always use HIGH intensity (255 unless tuned)
     // Other programs (COMPRESSION, PERCUSSION, COMBINED) use remote-set intensity
     if (program == AUTO_DEFAULT || program == AUTO_KNEADING) {
-        return 255;  // Always HIGH intensity for DEFAULT and KNEADING
+        return fullIntensityPWM;  // Always HIGH intensity for DEFAULT and KNEADING
     } else {
         // For COMPRESSION, PERCUSSION, COMBINED: use intensityLevel from remote
-        // If no intensity set (0), default to HIGH (255)
-        return (intensityLevel > 0) ? intensityLevel : 255;
+        // If no intensity set (0), default to HIGH
+        return (intensityLevel > 0) ? intensityLevel : fullIntensityPWM;
     }
 }
 bool SequenceController::getUseHighPrecisionTimer() const { return useHighPrecisionTimer; }
 void SequenceController::setUseHighPrecisionTimer(bool value) { useHighPrecisionTimer = value; }
 
+/**
+ * Runtime tunables (service console)
+ * Step overrides replace the duration written in the AUTO_CASE_n handler;
+ * the scale applies to the written durations only. Changes last until reset.
+ */
+uint16_t SequenceController::getStepTicks(uint8_t step) const {
+    return (step < AUTO_STEP_COUNT) ? stepTicksOverride[step] : 0;
+}
+
+bool SequenceController::setStepTicks(uint8_t step, uint16_t ticks) {
+    if (step >= AUTO_STEP_COUNT) return false;
+    stepTicksOverride[step] = ticks;
+    return true;
+}
+
+void SequenceController::clearStepTicks() {
+    memset(stepTicksOverride, 0, sizeof(stepTicksOverride));
+}
+
+uint16_t SequenceController::getStepScale() const { return stepScalePercent; }
+void SequenceController::setStepScale(uint16_t percent) { stepScalePercent = percent; }
+unsigned long SequenceController::getLimitDelayTicks() const { return limitDelayTicks; }
+void SequenceController::setLimitDelayTicks(unsigned long ticks) { limitDelayTicks = ticks; }
+uint8_t SequenceController::getFullIntensityPWM() const { return fullIntensityPWM; }
+void SequenceController::setFullIntensityPWM(uint8_t pwm) { fullIntensityPWM = pwm; }
+
 /**
  * Execute auto default program
  */
@@ -1473,7 +1503,7 @@ void SequenceController::updateAutoModeTimer() {
         static unsigned long lastTimerDebugTick = 0;
         
         if (autoModeElapsedTicks >= SEQ_AUTO_MODE_DURATION_TICKS) {
-            // if (debugSerial) debugSerial->println("AUTO TIMER: 20-minute timeout reached - stopping auto mode");
+            TRACE(MODULE_SEQUENCE, "AUTO TIMER: 20-minute timeout reached - stopping auto mode");
             stopAutoMode();
         }
     }
@@ -1502,13 +1532,7 @@ void SequenceController::handleProgramSwitch() {
     programSwitchCount++;
     lastProgramSwitchTick = timerManager->getMasterTicks();
     
-    if (debugSerial) {
-        // debugSerial->print("Program switched from ");
-        debugSerial->print(previousAutoProgram);
-        debugSerial->print(" to ");
-        debugSerial->print(currentAutoProgram);
-        debugSerial->println();
-    }
+    TRACE(MODULE_SEQUENCE, "Program switched from %d to %d", previousAutoProgram, currentAutoProgram);
 }
 
 void SequenceController::executeCurrentProgram() {
@@ -1548,7 +1572,7 @@ void SequenceController::handleHomeStateSearchingUp() {
     // Run roll motor up (only once when entering this state)
     if (!homeMotorStarted) {
         if (debugSerial) debugSerial->println("GO HOME: Set direction UP and start motor");
-        // if (debugSerial) debugSerial->println("DEBUG: Calling runRollUp() from handleHomeStateSearchingUp()");
+        TRACE(MODULE_SEQUENCE, "DEBUG: Calling runRollUp() from handleHomeStateSearchingUp()");
         motorController->runRollUp();
         homeMotorStarted = true;
     }
@@ -1561,7 +1585,7 @@ void SequenceController::handleHomeStateSearchingUp() {
     unsigned long currentTick = timerManager->getMasterTicks();
     
     if (currentTick - lastSearchDebugTick >= 200) {  // Every 2 seconds
-        // GO HOME: Running motor UP debug disabled to save Flash memory
+        TRACE(MODULE_SEQUENCE, "GO HOME: Running motor UP (up sensor=%u)", upSensorActive);
         lastSearchDebugTick = currentTick;
     }
     
@@ -2290,7 +2314,7 @@ void SequenceController::handleKneadingCase0() {
     
     // Check if 2-second delay has passed
     unsigned long delayElapsed = currentTick - kneadingSequenceStartTick;
-    if (delayElapsed < 200) {  // 2 seconds = 200 ticks
+    if (delayElapsed < limitDelayTicks) {  // 2 seconds unless tuned
         // Still in delay period
         if (motorController) {
             // Kneading motor always ON during kneading sequence
@@ -2300,17 +2324,13 @@ void SequenceController::handleKneadingCase0() {
             motorController->offRollMotor();
         }
         
-        // Debug: Show delay countdown (disabled to save FLASH)
-        // static unsigned long lastDelayDebugTick = 0;
-        // if (currentTick - lastDelayDebugTick >= 100) {  // Every 1 second
-        //     unsigned long remainingMs = 2000 - (delayElapsed * 10);
-        //     if (debugSerial && remainingMs > 0) {
-        //         debugSerial->print("KNEADING: In delay period - ");
-        //         debugSerial->print(remainingMs);
-        //         debugSerial->println("ms remaining");
-        //     }
-        //     lastDelayDebugTick = currentTick;
-        // }
+        // Debug: Show delay countdown
+        static unsigned long lastDelayDebugTick = 0;
+        if (currentTick - lastDelayDebugTick >= 100) {  // Every 1 second
+            unsigned long remainingMs = (limitDelayTicks - delayElapsed) * 10;
+            TRACE(MODULE_SEQUENCE, "KNEADING: In delay period - %lums remaining", remainingMs);
+            lastDelayDebugTick = currentTick;
+        }
         return;
     }
     
@@ -2328,7 +2348,7 @@ void SequenceController::handleKneadingCase0() {
             motorController->runRollUp();
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("KNEADING: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "KNEADING: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -2340,13 +2360,13 @@ void SequenceController::handleKneadingCase0() {
         // UP sensor detected, stop roll motor immediately and switch to CASE_1 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("KNEADING: UP sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "KNEADING: UP sensor detected - roll motor stopped immediately");
         }
         
         currentKneadingSequenceState = KNEADING_CASE_1;
         kneadingSequenceStartTick = timerManager->getMasterTicks();  // Reset timer for 2s delay
         
-        // if (debugSerial) debugSerial->println("KNEADING: Switching to CASE_1 (2s delay)");
+        TRACE(MODULE_SEQUENCE, "KNEADING: Switching to CASE_1 (2s delay)");
     }
     
     // Debug: Only print every 5 seconds to reduce spam
@@ -2374,7 +2394,7 @@ void SequenceController::handleKneadingCase1() {
     
     // Check if 2-second delay has passed
     unsigned long delayElapsed = currentTick - kneadingSequenceStartTick;
-    if (delayElapsed < 200) {  // 2 seconds = 200 ticks
+    if (delayElapsed < limitDelayTicks) {  // 2 seconds unless tuned
         // Still in delay period
         if (motorController) {
             // Kneading motor always ON during kneading sequence
@@ -2387,12 +2407,8 @@ void SequenceController::handleKneadingCase1() {
         // Debug: Show delay countdown
         static unsigned long lastDelayDebugTick = 0;
         if (currentTick - lastDelayDebugTick >= 100) {  // Every 1 second
-            unsigned long remainingMs = 2000 - (delayElapsed * 10);
-            if (debugSerial && remainingMs > 0) {
-                debugSerial->print("KNEADING: In delay period - ");
-                debugSerial->print(remainingMs);
-                debugSerial->println("ms remaining");
-            }
+            unsigned long remainingMs = (limitDelayTicks - delayElapsed) * 10;
+            TRACE(MODULE_SEQUENCE, "KNEADING: In delay period - %lums remaining", remainingMs);
             lastDelayDebugTick = currentTick;
         }
         return;
@@ -2411,7 +2427,7 @@ void SequenceController::handleKneadingCase1() {
             motorController->runRollDown();
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("KNEADING: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "KNEADING: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -2423,13 +2439,13 @@ void SequenceController::handleKneadingCase1() {
         // DOWN sensor detected, stop roll motor immediately and switch back to CASE_0 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("KNEADING: DOWN sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "KNEADING: DOWN sensor detected - roll motor stopped immediately");
         }
         
         currentKneadingSequenceState = KNEADING_CASE_0;
         kneadingSequenceStartTick = timerManager->getMasterTicks();  // Reset timer for 2s delay
         
-        // if (debugSerial) debugSerial->println("KNEADING: Switching to CASE_0 (2s delay)");
+        TRACE(MODULE_SEQUENCE, "KNEADING: Switching to CASE_0 (2s delay)");
     }
     
     // Debug: Only print every 5 seconds to reduce spam
@@ -2451,7 +2467,7 @@ void SequenceController::handleCompressionCase0() {
     
     // Check if 2-second delay has passed
     unsigned long delayElapsed = currentTick - compressionSequenceStartTick;
-    if (delayElapsed < 200) {  // 2 seconds = 200 ticks
+    if (delayElapsed < limitDelayTicks) {  // 2 seconds unless tuned
         // Still in delay period - ONLY roll motor stops, other motors continue
         if (motorController) {
             // Keep kneading and compression motors running during delay
@@ -2471,17 +2487,13 @@ void SequenceController::handleCompressionCase0() {
             motorController->offRollMotor();
         }
         
-    // Debug: Show delay countdown (disabled to save FLASH)
-    // static unsigned long lastDelayDebugTick = 0;
-    // if (currentTick - lastDelayDebugTick >= 200) {  // Every 2 seconds
-    //     unsigned long remainingMs = 2000 - (delayElapsed * 10);
-    //     if (debugSerial && remainingMs > 0) {
-    //         debugSerial->print("COMPRESSION: In delay period - ");
-    //         debugSerial->print(remainingMs);
-    //         debugSerial->println("ms remaining - kneading & compression motors continue");
-    //     }
-    //     lastDelayDebugTick = currentTick;
-    // }
+    // Debug: Show delay countdown
+    static unsigned long lastDelayDebugTick = 0;
+    if (currentTick - lastDelayDebugTick >= 200) {  // Every 2 seconds
+        unsigned long remainingMs = (limitDelayTicks - delayElapsed) * 10;
+        TRACE(MODULE_SEQUENCE, "COMPRESSION: In delay period - %lums remaining - kneading & compression motors continue", remainingMs);
+        lastDelayDebugTick = currentTick;
+    }
         return;
     }
     
@@ -2493,7 +2505,7 @@ void SequenceController::handleCompressionCase0() {
             motorController->runRollUp();
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("COMPRESSION: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "COMPRESSION: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -2518,13 +2530,13 @@ void SequenceController::handleCompressionCase0() {
         // UP sensor detected, stop roll motor immediately and switch to CASE_1 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("COMPRESSION: UP sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "COMPRESSION: UP sensor detected - roll motor stopped immediately");
         }
         
         currentCompressionSequenceState = COMPRESSION_CASE_1;
         compressionSequenceStartTick = timerManager->getMasterTicks();  // Reset timer for 2s delay
         
-        // if (debugSerial) debugSerial->println("COMPRESSION: Switching to CASE_1 (2s delay)");
+        TRACE(MODULE_SEQUENCE, "COMPRESSION: Switching to CASE_1 (2s delay)");
     }
     
     // Debug: Only print every 5 seconds to reduce spam
@@ -2600,7 +2612,7 @@ void SequenceController::handleCompressionCase1() {
             }
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("COMPRESSION: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "COMPRESSION: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -2646,7 +2658,7 @@ void SequenceController::handleCompressionCase1() {
         // DOWN sensor detected, stop roll motor immediately and switch to CASE_2 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("COMPRESSION: DOWN sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "COMPRESSION: DOWN sensor detected - roll motor stopped immediately");
         }
         
         currentCompressionSequenceState = COMPRESSION_CASE_2;
@@ -2727,7 +2739,7 @@ void SequenceController::handleCompressionCase2() {
             motorController->runRollUp();
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("COMPRESSION: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "COMPRESSION: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -2752,26 +2764,22 @@ void SequenceController::handleCompressionCase2() {
         // UP sensor detected, stop roll motor immediately and switch back to CASE_1 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("COMPRESSION: UP sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "COMPRESSION: UP sensor detected - roll motor stopped immediately");
         }
         
         currentCompressionSequenceState = COMPRESSION_CASE_1;
         compressionSequenceStartTick = timerManager->getMasterTicks();  // Reset timer for 2s delay
         
-        // if (debugSerial) debugSerial->println("COMPRESSION: Switching to CASE_1 (2s delay)");
+        TRACE(MODULE_SEQUENCE, "COMPRESSION: Switching to CASE_1 (2s delay)");
     }
     
-    // Debug: Only print every 10 seconds to reduce spam (disabled to save FLASH)
-    // static unsigned long lastCompressionCase2DebugTick = 0;
-    // 
-    // if (currentTick - lastCompressionCase2DebugTick >= 1000) {  // Every 10 seconds
-    //     if (debugSerial) {
-    //         debugSerial->print("COMPRESSION CASE_2: Roll UP + Kneading(OFF 2s/ON 1s) + Compression(Intensity=");
-    //         debugSerial->print(intensityLevel);
-    //         debugSerial->println(")");
-    //     }
-    //     lastCompressionCase2DebugTick = currentTick;
-    // }
+    // Debug: Only print every 10 seconds to reduce spam
+    static unsigned long lastCompressionCase2DebugTick = 0;
+
+    if (currentTick - lastCompressionCase2DebugTick >= 1000) {  // Every 10 seconds
+        TRACE(MODULE_SEQUENCE, "COMPRESSION CASE_2: Roll UP + Kneading(OFF 2s/ON 1s) + Compression(Intensity=%u)", intensityLevel);
+        lastCompressionCase2DebugTick = currentTick;
+    }
 }
 
 void SequenceController::handlePercussionCase0() {
@@ -2780,7 +2788,7 @@ void SequenceController::handlePercussionCase0() {
     
     // Check if 2-second delay has passed
     unsigned long delayElapsed = currentTick - percussionSequenceStartTick;
-    if (delayElapsed < 200) {  // 2 seconds = 200 ticks
+    if (delayElapsed < limitDelayTicks) {  // 2 seconds unless tuned
         // Still in delay period - ONLY roll motor stops, other motors continue
         if (motorController) {
             // Keep kneading and compression motors running during delay
@@ -2812,7 +2820,7 @@ void SequenceController::handlePercussionCase0() {
         // Debug: Show delay countdown
         static unsigned long lastDelayDebugTick = 0;
         if (currentTick - lastDelayDebugTick >= 100) {  // Every 1 second
-            unsigned long remainingMs = 2000 - (delayElapsed * 10);
+            unsigned long remainingMs = (limitDelayTicks - delayElapsed) * 10;
             if (debugSerial && remainingMs > 0) {
                 debugSerial->print("PERCUSSION: In delay period - ");
                 debugSerial->print(remainingMs);
@@ -2830,7 +2838,7 @@ void SequenceController::handlePercussionCase0() {
             motorController->runRollUp();
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("PERCUSSION: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "PERCUSSION: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -2863,21 +2871,21 @@ void SequenceController::handlePercussionCase0() {
         // UP sensor detected, stop roll motor immediately and switch to CASE_1 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("PERCUSSION: UP sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "PERCUSSION: UP sensor detected - roll motor stopped immediately");
         }
         
         currentPercussionSequenceState = PERCUSSION_CASE_1;
         percussionSequenceStartTick = timerManager->getMasterTicks();  // Reset timer for 2s delay
         
-        // if (debugSerial) debugSerial->println("PERCUSSION: Switching to CASE_1 (2s delay)");
+        TRACE(MODULE_SEQUENCE, "PERCUSSION: Switching to CASE_1 (2s delay)");
     }
     
-    // Debug: Only print every 10 seconds to reduce spam (disabled to save FLASH)
-    // static unsigned long lastPercussionCase0DebugTick = 0;
-    // if (currentTick - lastPercussionCase0DebugTick >= 1000) {  // Every 10 seconds
-    //     if (debugSerial) debugSerial->println("PERCUSSION: Roll UP (CASE_0)");
-    //     lastPercussionCase0DebugTick = currentTick;
-    // }
+    // Debug: Only print every 10 seconds to reduce spam
+    static unsigned long lastPercussionCase0DebugTick = 0;
+    if (currentTick - lastPercussionCase0DebugTick >= 1000) {  // Every 10 seconds
+        TRACE(MODULE_SEQUENCE, "PERCUSSION: Roll UP (CASE_0)");
+        lastPercussionCase0DebugTick = currentTick;
+    }
 }
 
 void SequenceController::handlePercussionCase1() {
@@ -2886,7 +2894,7 @@ void SequenceController::handlePercussionCase1() {
     
     // Check if 2-second delay has passed
     unsigned long delayElapsed = currentTick - percussionSequenceStartTick;
-    if (delayElapsed < 200) {  // 2 seconds = 200 ticks
+    if (delayElapsed < limitDelayTicks) {  // 2 seconds unless tuned
         // Still in delay period - ONLY roll motor stops, other motors continue
         if (motorController) {
             // Keep kneading and compression motors running during delay
@@ -2918,7 +2926,7 @@ void SequenceController::handlePercussionCase1() {
         // Debug: Show delay countdown
         static unsigned long lastDelayDebugTick = 0;
         if (currentTick - lastDelayDebugTick >= 100) {  // Every 1 second
-            unsigned long remainingMs = 2000 - (delayElapsed * 10);
+            unsigned long remainingMs = (limitDelayTicks - delayElapsed) * 10;
             if (debugSerial && remainingMs > 0) {
                 debugSerial->print("PERCUSSION: In delay period - ");
                 debugSerial->print(remainingMs);
@@ -2936,7 +2944,7 @@ void SequenceController::handlePercussionCase1() {
             motorController->runRollDown();
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("PERCUSSION: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "PERCUSSION: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -2969,21 +2977,21 @@ void SequenceController::handlePercussionCase1() {
         // DOWN sensor detected, stop roll motor immediately and switch back to CASE_0 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("PERCUSSION: DOWN sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "PERCUSSION: DOWN sensor detected - roll motor stopped immediately");
         }
         
         currentPercussionSequenceState = PERCUSSION_CASE_0;
         percussionSequenceStartTick = timerManager->getMasterTicks();  // Reset timer for 2s delay
         
-        // if (debugSerial) debugSerial->println("PERCUSSION: Switching to CASE_0 (2s delay)");
+        TRACE(MODULE_SEQUENCE, "PERCUSSION: Switching to CASE_0 (2s delay)");
     }
     
-    // Debug: Only print every 10 seconds to reduce spam (disabled to save FLASH)
-    // static unsigned long lastPercussionCase1DebugTick = 0;
-    // if (currentTick - lastPercussionCase1DebugTick >= 1000) {  // Every 10 seconds
-    //     if (debugSerial) debugSerial->println("PERCUSSION: Roll DOWN (CASE_1)");
-    //     lastPercussionCase1DebugTick = currentTick;
-    // }
+    // Debug: Only print every 10 seconds to reduce spam
+    static unsigned long lastPercussionCase1DebugTick = 0;
+    if (currentTick - lastPercussionCase1DebugTick >= 1000) {  // Every 10 seconds
+        TRACE(MODULE_SEQUENCE, "PERCUSSION: Roll DOWN (CASE_1)");
+        lastPercussionCase1DebugTick = currentTick;
+    }
 }
 
 void SequenceController::handleCombinedCase0() {
@@ -2992,7 +3000,7 @@ void SequenceController::handleCombinedCase0() {
     
     // Check if 2-second delay has passed
     unsigned long delayElapsed = currentTick - combinedSequenceStartTick;
-    if (delayElapsed < 200) {  // 2 seconds = 200 ticks
+    if (delayElapsed < limitDelayTicks) {  // 2 seconds unless tuned
         // Still in delay period - ONLY roll motor stops, other motors continue
         if (motorController) {
             // Keep kneading and compression motors running during delay
@@ -3010,7 +3018,7 @@ void SequenceController::handleCombinedCase0() {
         // Debug: Show delay countdown
         static unsigned long lastDelayDebugTick = 0;
         if (currentTick - lastDelayDebugTick >= 100) {  // Every 1 second
-            unsigned long remainingMs = 2000 - (delayElapsed * 10);
+            unsigned long remainingMs = (limitDelayTicks - delayElapsed) * 10;
             if (debugSerial && remainingMs > 0) {
                 debugSerial->print("COMBINED: In delay period - ");
                 debugSerial->print(remainingMs);
@@ -3028,7 +3036,7 @@ void SequenceController::handleCombinedCase0() {
             motorController->runRollUp();
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("COMBINED: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "COMBINED: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -3056,21 +3064,21 @@ void SequenceController::handleCombinedCase0() {
         // UP sensor detected, stop roll motor immediately and switch to CASE_1 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("COMBINED: UP sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "COMBINED: UP sensor detected - roll motor stopped immediately");
         }
         
         currentCombinedSequenceState = COMBINED_CASE_1;
         combinedSequenceStartTick = timerManager->getMasterTicks();  // Reset timer for 2s delay
         
-        // if (debugSerial) debugSerial->println("COMBINED: Switching to CASE_1 (2s delay)");
+        TRACE(MODULE_SEQUENCE, "COMBINED: Switching to CASE_1 (2s delay)");
     }
     
-    // Debug: Only print every 10 seconds to reduce spam (disabled to save FLASH)
-    // static unsigned long lastCombinedCase0DebugTick = 0;
-    // if (currentTick - lastCombinedCase0DebugTick >= 1000) {  // Every 10 seconds
-    //     if (debugSerial) debugSerial->println("COMBINED: Roll UP (CASE_0)");
-    //     lastCombinedCase0DebugTick = currentTick;
-    // }
+    // Debug: Only print every 10 seconds to reduce spam
+    static unsigned long lastCombinedCase0DebugTick = 0;
+    if (currentTick - lastCombinedCase0DebugTick >= 1000) {  // Every 10 seconds
+        if (debugSerial) debugSerial->println("COMBINED: Roll UP (CASE_0)");
+        lastCombinedCase0DebugTick = currentTick;
+    }
 }
 
 void SequenceController::handleCombinedCase1() {
@@ -3079,7 +3087,7 @@ void SequenceController::handleCombinedCase1() {
     
     // Check if 2-second delay has passed
     unsigned long delayElapsed = currentTick - combinedSequenceStartTick;
-    if (delayElapsed < 200) {  // 2 seconds = 200 ticks
+    if (delayElapsed < limitDelayTicks) {  // 2 seconds unless tuned
         // Still in delay period - ONLY roll motor stops, other motors continue
         if (motorController) {
             // Keep kneading and compression motors running during delay
@@ -3106,7 +3114,7 @@ void SequenceController::handleCombinedCase1() {
         // Debug: Show delay countdown
         static unsigned long lastDelayDebugTick = 0;
         if (currentTick - lastDelayDebugTick >= 100) {  // Every 1 second
-            unsigned long remainingMs = 2000 - (delayElapsed * 10);
+            unsigned long remainingMs = (limitDelayTicks - delayElapsed) * 10;
             if (debugSerial && remainingMs > 0) {
                 debugSerial->print("COMBINED: In delay period - ");
                 debugSerial->print(remainingMs);
@@ -3124,7 +3132,7 @@ void SequenceController::handleCombinedCase1() {
             motorController->runRollDown();
         } else if (manualPriority) {
             // Manual override active - roll motor controlled by user
-            // if (debugSerial) debugSerial->println("COMBINED: Manual priority active - roll motor controlled by user");
+            TRACE(MODULE_SEQUENCE, "COMBINED: Manual priority active - roll motor controlled by user");
         } else if (rollMotorUserDisabled) {
             // User disabled roll motor - keep it off
             // Debug output removed to reduce spam
@@ -3152,21 +3160,21 @@ void SequenceController::handleCombinedCase1() {
         // DOWN sensor detected, stop roll motor immediately and switch back to CASE_0 after 2-second delay
         if (motorController) {
             motorController->offRollMotor();
-            // if (debugSerial) debugSerial->println("COMBINED: DOWN sensor detected - roll motor stopped immediately");
+            TRACE(MODULE_SEQUENCE, "COMBINED: DOWN sensor detected - roll motor stopped immediately");
         }
         
         currentCombinedSequenceState = COMBINED_CASE_0;
         combinedSequenceStartTick = timerManager->getMasterTicks();  // Reset timer for 2s delay
         
-        // if (debugSerial) debugSerial->println("COMBINED: Switching to CASE_0 (2s delay)");
+        TRACE(MODULE_SEQUENCE, "COMBINED: Switching to CASE_0 (2s delay)");
     }
     
-    // Debug: Only print every 10 seconds to reduce spam (disabled to save FLASH)
-    // static unsigned long lastCombinedCase1DebugTick = 0;
-    // if (currentTick - lastCombinedCase1DebugTick >= 1000) {  // Every 10 seconds
-    //     if (debugSerial) debugSerial->println("COMBINED: Roll DOWN (CASE_1)");
-    //     lastCombinedCase1DebugTick = currentTick;
-    // }
+    // Debug: Only print every 10 seconds to reduce spam
+    static unsigned long lastCombinedCase1DebugTick = 0;
+    if (currentTick - lastCombinedCase1DebugTick >= 1000) {  // Every 10 seconds
+        if (debugSerial) debugSerial->println("COMBINED: Roll DOWN (CASE_1)");
+        lastCombinedCase1DebugTick = currentTick;
+    }
 }
 
 /**
@@ -3242,8 +3250,17 @@ void SequenceController::executeMotorControl(bool rollOn, bool kneadingOn, bool
     }
 }
 
+/**
+ * Duration of the current auto step (console override, else the scaled built-in value)
+ */
+unsigned long SequenceController::stepDuration(unsigned long builtInTicks) const {
+    uint16_t overrideTicks = stepTicksOverride[currentAutoSequenceState];
+    if (overrideTicks != 0) return overrideTicks;
+    return (stepScalePercent == 100) ? builtInTicks : builtInTicks * stepScalePercent / 100;
+}
+
 bool SequenceController::checkTimeoutAndTransition(unsigned long currentTick, unsigned long timeoutTicks, AutoSequenceState nextState) {
-    if (currentTick - autoLastDirChangeTick >= timeoutTicks) {
+    if (currentTick - autoLastDirChangeTick >= stepDuration(timeoutTicks)) {
         currentAutoSequenceState = nextState;
         autoLastDirChangeTick = currentTick;  // Reset timer for next case
         return true;  // Transition occurred
@@ -3360,7 +3377,7 @@ void SequenceController::executeSensorBasedAutoCase(bool rollOn, bool kneadingOn
     
     // Check for UP sensor
     if (checkUpSensor && sensorManager && sensorManager->getSensorUpLimit()) {
-        // if (debugSerial) debugSerial->println("AUTO: UP sensor detected, switching to next case immediately");
+        TRACE(MODULE_SEQUENCE, "AUTO: UP sensor detected, switching to next case immediately");
         if (stopRollOnSensor && motorController) {
             motorController->offRollMotor();  // LẬP TỨC dừng ROLL MOTOR
         }
@@ -3371,7 +3388,7 @@ void SequenceController::executeSensorBasedAutoCase(bool rollOn, bool kneadingOn
     
     // Check for DOWN sensor
     if (checkDownSensor && sensorManager && sensorManager->getSensorDownLimit()) {
-        // if (debugSerial) debugSerial->println("AUTO: DOWN sensor detected, switching to next case immediately");
+        TRACE(MODULE_SEQUENCE, "AUTO: DOWN sensor detected, switching to next case immediately");
         if (stopRollOnSensor && motorController) {
             motorController->offRollMotor();  // LẬP TỨC dừng ROLL MOTOR
         }
@@ -3440,7 +3457,7 @@ bool SequenceController::checkDirectionReversal(unsigned long currentTick, bool
         // Check if reversal has completed (wait for 500ms = 50 ticks)
         if (currentTick - directionReversalStartTick >= 50) {
             directionReversalInProgress = false;
-            // DIRECTION: Reversal completed debug disabled
+            TRACE(MODULE_SEQUENCE, "DIRECTION: Reversal completed");
             return true; // Reversal completed, can proceed
         }
         return false; // Still in reversal, should pause
@@ -3454,11 +3471,11 @@ bool SequenceController::checkDirectionReversal(unsigned long currentTick, bool
     if (expectedDirection && sensorManager && sensorManager->getSensorDownLimit()) {
         // Expected UP direction but hit DOWN sensor - going too far, reverse to UP
         sensorHit = true;
-        // DIRECTION: DOWN sensor hit during UP movement debug disabled
+        TRACE(MODULE_SEQUENCE, "DIRECTION: DOWN sensor hit during UP movement");
     } else if (!expectedDirection && sensorManager && sensorManager->getSensorUpLimit()) {
         // Expected DOWN direction but hit UP sensor - going too far, reverse to DOWN  
         sensorHit = true;
-        // DIRECTION: UP sensor hit during DOWN movement debug disabled
+        TRACE(MODULE_SEQUENCE, "DIRECTION: UP sensor hit during DOWN movement");
     }
     
     if (sensorHit) {
@@ -3473,7 +3490,7 @@ bool SequenceController::checkDirectionReversal(unsigned long currentTick, bool
         // Trigger direction reversal in hardware
         setChangeDir(!expectedDirection);
         
-        // DIRECTION: Stopping motor and reversing debug disabled
+        TRACE(MODULE_SEQUENCE, "DIRECTION: Stopping motor and reversing (up=%u)", !expectedDirection);
         
         return false; // Pause case execution during reversal
     }
@@ -143,6 +143,8 @@ public:
         
     };
     
+    static const uint8_t AUTO_STEP_COUNT = AUTO_CASE_97 + 1;
+    
     enum KneadingSequenceState {
         KNEADING_CASE_0 = 0,
         KNEADING_CASE_1 = 1
@@ -173,6 +175,14 @@ private:
     static const unsigned long SEQ_HOME_DIR_CHANGE_TICKS = 10;           // 100ms
     static const unsigned long SEQ_AUTO_DIR_CHANGE_TICKS = 10;           // 100ms
     static const unsigned long SEQ_AUTO_MODE_DURATION_TICKS = 120000;    // 20 minutes
+    static const unsigned long SEQ_LIMIT_DELAY_TICKS = 200;              // 2s pause at a roll limit
+    static const uint8_t SEQ_FULL_INTENSITY_PWM = 255;
+    
+    // Runtime timing tunables (service console, not persisted)
+    uint16_t stepTicksOverride[AUTO_STEP_COUNT];  // AUTO_CASE_n duration in ticks, 0 = built-in
+    uint16_t stepScalePercent;                    // Scale of built-in step durations (100 = as written)
+    unsigned long limitDelayTicks;                // Roll limit pause (KNEADING..COMBINED programs)
+    uint8_t fullIntensityPWM;                     // DEFAULT / KNEADING programs, unset intensity
     
     // System control flags
     bool allowRun;
@@ -271,11 +281,11 @@ private:
     TimerManager* timerManager;
     MotorController* motorController;
     SensorManager* sensorManager;
-    HardwareSerial* debugSerial;
+    Print* debugSerial;
 
 public:
     // Constructor
-    SequenceController(TimerManager* timerMgr, MotorController* motorCtrl, SensorManager* sensorMgr, HardwareSerial* debugSer = nullptr);
+    SequenceController(TimerManager* timerMgr, MotorController* motorCtrl, SensorManager* sensorMgr, Print* debugSer = nullptr);
     
     // Destructor
     ~SequenceController();
@@ -342,6 +352,17 @@ public:
     bool getUseHighPrecisionTimer() const;
     void setUseHighPrecisionTimer(bool value);
     
+    // Runtime Tunables
+    uint16_t getStepTicks(uint8_t step) const;
+    bool setStepTicks(uint8_t step, uint16_t ticks);
+    void clearStepTicks();
+    uint16_t getStepScale() const;
+    void setStepScale(uint16_t percent);
+    unsigned long getLimitDelayTicks() const;
+    void setLimitDelayTicks(unsigned long ticks);
+    uint8_t getFullIntensityPWM() const;
+    void setFullIntensityPWM(uint8_t pwm);
+    
     // Program Execution
     void executeAutoDefaultProgram();
     void executeKneadingProgram();
@@ -527,6 +548,7 @@ private:
     bool canStartHomeSequence() const;
     
     // Helper functions for auto cases optimization
+    unsigned long stepDuration(unsigned long builtInTicks) const;
     void executeMotorControl(bool rollOn, bool kneadingOn, bool percussionOn, bool percussionHigh = false);
     bool checkTimeoutAndTransition(unsigned long currentTick, unsigned long timeoutTicks, AutoSequenceState nextState);
     void executeStandardAutoCase(bool rollOn, bool kneadingOn, bool percussionOn, bool percussionHigh, 
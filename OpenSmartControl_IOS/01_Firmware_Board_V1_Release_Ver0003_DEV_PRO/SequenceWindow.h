@@ -0,0 +1,51 @@
+#ifndef SEQUENCE_WINDOW_H
+#define SEQUENCE_WINDOW_H
+
+#include <Arduino.h>
+#include <cstdint>
+
+/**
+ * SequenceWindow Class
+ *
+ * Sliding-window duplicate filter for the 8-bit frame sequence number.
+ * The sender increments the sequence for every new frame (wrapping at 256);
+ * a retransmitted frame keeps its sequence and is rejected here.
+ *
+ * Features:
+ * - O(1) check: one shift and one bit test, no time window
+ * - Exact duplicate rejection for the last WINDOW_SIZE sequences
+ * - Late (reordered) frames inside the window are still accepted once
+ * - Frames older than the window are rejected as stale
+ */
+class SequenceWindow {
+public:
+  static const uint8_t WINDOW_SIZE = 32;  // Bits in the bitmap
+
+  enum Result {
+    ACCEPTED,   // New sequence, recorded
+    DUPLICATE,  // Already seen inside the window
+    STALE       // Older than the window
+  };
+
+private:
+  uint32_t bitmap;   // Bit n set = sequence (highest - n) seen
+  uint8_t highest;   // Newest sequence accepted
+  bool started;      // First frame since reset() received
+
+public:
+  // Constructor
+  SequenceWindow();
+
+  Result check(uint8_t sequence);
+  Result peek(uint8_t sequence) const;
+  void reset();
+
+  bool isStarted() const {
+    return started;
+  }
+  uint8_t getHighest() const {
+    return highest;
+  }
+};
+
+#endif  // SEQUENCE_WINDOW_H
@@ -0,0 +1,641 @@
+#include "ServiceConsole.h"
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include "MassageController.h"
+
+typedef CommunicationManager CM;
+
+/**
+ * Tunables: name, accepted range, unit
+ */
+const ServiceConsole::TunableSpec ServiceConsole::TUNABLES[TUNE_COUNT] = {
+  { "step.scale", 10, 1000, "% of built-in auto step durations" },
+  { "limit.delay", 0, 6000, "ticks, pause at a roll limit" },
+  { "sensor.confirm", 0, 500, "ticks, limit sensor confirmation" },
+  { "pwm.high", 0, 255, "PWM, intensity HIGH" },
+  { "pwm.low", 0, 255, "PWM, intensity LOW" },
+  { "pwm.full", 0, 255, "PWM, DEFAULT / KNEADING programs" },
+  { "link.timeout", CM::LINK_TIMEOUT_MIN_TICKS, 60000, "ticks, BLE link supervision" },
+  { "log.level", DebugLog::LEVEL_OFF, DebugLog::LEVEL_DEBUG, "all modules, 0 = off .. 3 = debug" },
+};
+
+/**
+ * Program names for "run" (command sent with DATA_ON / DATA_OFF)
+ */
+namespace {
+struct ProgramName {
+  const char* name;
+  uint8_t command;
+};
+
+const ProgramName PROGRAMS[] = {
+  { "auto", CM::CMD_AUTO },
+  { "roll", CM::CMD_ROLL_MOTOR },
+  { "kneading", CM::CMD_KNEADING },
+  { "percussion", CM::CMD_PERCUSSION },
+  { "compression", CM::CMD_COMPRESSION },
+  { "combine", CM::CMD_COMBINE },
+  { "incline", CM::CMD_INCLINE },
+  { "recline", CM::CMD_RECLINE },
+  { "forward", CM::CMD_FORWARD },
+  { "backward", CM::CMD_BACKWARD },
+};
+
+const char* const HELP[] = {
+  "help                   this list",
+  "get [name]             tunables (all, or one; step.N = auto step N)",
+  "set <name> <value>     change a tunable until reset (step.N 0 = built-in, step.all 0)",
+  "stats [reset]          counters",
+  "lat [reset]            command latency histograms (LATENCY_PROBES builds)",
+  "run <program> [on|off] auto roll kneading percussion compression combine",
+  "                       incline recline forward backward",
+  "stop                   auto program and position motors off",
+  "cmd <cmd> <d1> [d2]    any app command (0x.. hex or decimal)",
+  "prof [passes]          time the main loop phases (default 1000 passes)",
+};
+}
+
+/**
+ * Constructor
+ */
+ServiceConsole::ServiceConsole(MassageController* owner, HardwareSerial* input, DebugLog* output)
+  : controller(owner), serial(input), log(output), lineLength(0), lineOverflow(false), listing(LIST_NONE), listLine(0), profileRemaining(0), profileReady(false), passOpen(false), passStamp(0), phaseStamp(0) {
+  memset(line, 0, sizeof(line));
+  for (uint8_t i = 0; i < PHASE_COUNT; i++) {
+    profile[i].clear();
+  }
+}
+
+/**
+ * Main loop: finish the pending reply, then read input and run at most one line
+ */
+void ServiceConsole::poll() {
+  if (!serial || !log) return;
+
+  if (profileReady && listing == LIST_NONE) {
+    profileReady = false;
+    startListing(LIST_PROFILE);
+  }
+  printListing();
+  if (listing != LIST_NONE) return;  // Next command once this reply is out
+
+  for (uint8_t n = 0; n < LINE_SIZE && serial->available() > 0; n++) {
+    char c = (char)serial->read();
+
+    if (c == '\r' || c == '\n') {
+      if (lineOverflow) {
+        reply("ERR line too long");
+      } else if (lineLength > 0) {
+        line[lineLength] = '\0';
+        execute();
+      }
+      lineLength = 0;
+      lineOverflow = false;
+      return;
+    }
+    if (c == '\b' || c == 0x7F) {
+      if (lineLength > 0) lineLength--;
+    } else if (lineLength < LINE_SIZE - 1) {
+      line[lineLength++] = (char)tolower((unsigned char)c);
+    } else {
+      lineOverflow = true;
+    }
+  }
+}
+
+/**
+ * Split the line into tokens and run the command
+ */
+void ServiceConsole::execute() {
+  char* tokens[MAX_TOKENS];
+  uint8_t count = 0;
+  char* cursor = line;
+
+  while (*cursor) {
+    while (*cursor == ' ' || *cursor == '\t') *cursor++ = '\0';
+    if (!*cursor) break;
+    if (count == MAX_TOKENS) {
+      reply("ERR too many arguments");
+      return;
+    }
+    tokens[count++] = cursor;
+    while (*cursor && *cursor != ' ' && *cursor != '\t') cursor++;
+  }
+  if (count == 0) return;
+
+  const char* name = tokens[0];
+  if (strcmp(name, "help") == 0) {
+    startListing(LIST_HELP);
+  } else if (strcmp(name, "get") == 0) {
+    commandGet(tokens, count);
+  } else if (strcmp(name, "set") == 0) {
+    commandSet(tokens, count);
+  } else if (strcmp(name, "stats") == 0) {
+    commandStats(tokens, count);
+  } else if (strcmp(name, "lat") == 0) {
+    commandLatency(tokens, count);
+  } else if (strcmp(name, "run") == 0 || strcmp(name, "stop") == 0) {
+    commandRun(tokens, count);
+  } else if (strcmp(name, "cmd") == 0) {
+    commandRaw(tokens, count);
+  } else if (strcmp(name, "prof") == 0) {
+    commandProfile(tokens, count);
+  } else {
+    reply("ERR unknown command '%s' (help)", name);
+  }
+}
+
+/**
+ * get [name]
+ */
+void ServiceConsole::commandGet(char** tokens, uint8_t count) {
+  if (count == 1) {
+    startListing(LIST_TUNABLES);
+    return;
+  }
+
+  uint8_t step;
+  if (parseStep(tokens[1], step)) {
+    SequenceController* sequences = controller->getSequenceController();
+    if (!sequences) return;
+    reply("step.%u = %u ticks (0 = built-in)", step, sequences->getStepTicks(step));
+    return;
+  }
+
+  int id = findTunable(tokens[1]);
+  if (id < 0) {
+    reply("ERR unknown tunable '%s'", tokens[1]);
+    return;
+  }
+  reply("%s = %ld %s", TUNABLES[id].name, readTunable((Tunable)id), TUNABLES[id].unit);
+}
+
+/**
+ * set <name> <value>
+ */
+void ServiceConsole::commandSet(char** tokens, uint8_t count) {
+  long value;
+  if (count != 3 || !parseNumber(tokens[2], value)) {
+    reply("ERR usage: set <name> <value>");
+    return;
+  }
+
+  SequenceController* sequences = controller->getSequenceController();
+  if (strcmp(tokens[1], "step.all") == 0) {
+    if (value != 0) {
+      reply("ERR step.all only takes 0 (clear overrides)");
+    } else if (sequences) {
+      sequences->clearStepTicks();
+      reply("OK all steps built-in");
+    }
+    return;
+  }
+
+  uint8_t step;
+  if (parseStep(tokens[1], step)) {
+    if (value < 0 || value > 0xFFFF) {
+      reply("ERR step.%u: 0..65535 ticks", step);
+    } else if (sequences) {
+      sequences->setStepTicks(step, (uint16_t)value);
+      reply("OK step.%u = %ld", step, value);
+    }
+    return;
+  }
+
+  int id = findTunable(tokens[1]);
+  if (id < 0) {
+    reply("ERR unknown tunable '%s'", tokens[1]);
+    return;
+  }
+  const TunableSpec& spec = TUNABLES[id];
+  if (value < spec.minValue || value > spec.maxValue) {
+    reply("ERR %s: %ld..%ld", spec.name, spec.minValue, spec.maxValue);
+    return;
+  }
+  writeTunable((Tunable)id, value);
+  reply("OK %s = %ld", spec.name, readTunable((Tunable)id));
+}
+
+/**
+ * stats [reset]
+ */
+void ServiceConsole::commandStats(char** tokens, uint8_t count) {
+  if (count == 1) {
+    startListing(LIST_STATS);
+    return;
+  }
+  if (strcmp(tokens[1], "reset") != 0) {
+    reply("ERR usage: stats [reset]");
+    return;
+  }
+
+  CommunicationManager* comm = controller->getCommunicationManager();
+  if (comm) {
+    comm->resetBleRxStats();
+    comm->resetTxStats();
+    comm->resetLinkStats();
+  }
+  log->resetStatistics();
+  reply("OK counters reset");
+}
+
+/**
+ * lat [reset]
+ * The report itself is printed by CommunicationManager::processLatencyReport().
+ */
+void ServiceConsole::commandLatency(char** tokens, uint8_t count) {
+  bool reset = (count > 1 && strcmp(tokens[1], "reset") == 0);
+  CommunicationManager* comm = controller->getCommunicationManager();
+  if (!comm || !comm->requestLatencyReport(reset)) {
+    reply("ERR built without LATENCY_PROBES");
+    return;
+  }
+  if (reset) reply("OK latency histograms cleared");
+}
+
+/**
+ * run <program> [on|off], stop
+ */
+void ServiceConsole::commandRun(char** tokens, uint8_t count) {
+  CommunicationManager* comm = controller->getCommunicationManager();
+  if (!comm) return;
+
+  if (strcmp(tokens[0], "stop") == 0) {
+    comm->runLocalCommand(CM::CMD_AUTO, CM::DATA_OFF);
+    comm->runLocalCommand(CM::CMD_INCLINE, CM::DATA_OFF);
+    comm->runLocalCommand(CM::CMD_FORWARD, CM::DATA_OFF);
+    reply("OK stopped");
+    return;
+  }
+
+  if (count < 2) {
+    reply("ERR usage: run <program> [on|off]");
+    return;
+  }
+  uint8_t data1 = CM::DATA_ON;
+  if (count > 2) {
+    if (strcmp(tokens[2], "off") == 0) {
+      data1 = CM::DATA_OFF;
+    } else if (strcmp(tokens[2], "on") != 0) {
+      reply("ERR usage: run <program> [on|off]");
+      return;
+    }
+  }
+
+  for (uint8_t i = 0; i < sizeof(PROGRAMS) / sizeof(PROGRAMS[0]); i++) {
+    if (strcmp(tokens[1], PROGRAMS[i].name) == 0) {
+      reportResult(comm->runLocalCommand(PROGRAMS[i].command, data1));
+      return;
+    }
+  }
+  reply("ERR unknown program '%s'", tokens[1]);
+}
+
+/**
+ * cmd <command> <data1> [data2]
+ */
+void ServiceConsole::commandRaw(char** tokens, uint8_t count) {
+  long command, data1, data2 = 0;
+  if (count < 3 || !parseNumber(tokens[1], command) || !parseNumber(tokens[2], data1) || (count > 3 && !parseNumber(tokens[3], data2))
+      || command < 0 || command > 0xFF || data1 < 0 || data1 > 0xFF || data2 < 0 || data2 > 0xFF) {
+    reply("ERR usage: cmd <command> <data1> [data2] (bytes)");
+    return;
+  }
+  CommunicationManager* comm = controller->getCommunicationManager();
+  if (comm) reportResult(comm->runLocalCommand((uint8_t)command, (uint8_t)data1, (uint8_t)data2));
+}
+
+/**
+ * prof [passes]
+ */
+void ServiceConsole::commandProfile(char** tokens, uint8_t count) {
+  long passes = PROFILE_PASSES;
+  if (count > 1 && (!parseNumber(tokens[1], passes) || passes < 1 || passes > 60000)) {
+    reply("ERR usage: prof [1..60000]");
+    return;
+  }
+  for (uint8_t i = 0; i < PHASE_COUNT; i++) {
+    profile[i].clear();
+  }
+  profileReady = false;
+  passOpen = false;  // Timing starts with the next whole pass
+  profileRemaining = (uint16_t)passes;
+  reply("OK profiling %ld passes", passes);
+}
+
+void ServiceConsole::reportResult(uint8_t result) {
+  switch (result) {
+    case CM::RESULT_OK: reply("OK"); break;
+    case CM::RESULT_REJECTED: reply("ERR rejected in the current state"); break;
+    case CM::RESULT_INVALID: reply("ERR invalid data"); break;
+    case CM::RESULT_UNKNOWN: reply("ERR unknown command"); break;
+    default: reply("ERR result 0x%02X", result); break;
+  }
+}
+
+/**
+ * Tunable lookup (-1 if unknown)
+ */
+int ServiceConsole::findTunable(const char* name) const {
+  for (uint8_t i = 0; i < TUNE_COUNT; i++) {
+    if (strcmp(name, TUNABLES[i].name) == 0) return i;
+  }
+  return -1;
+}
+
+/**
+ * "step.N" with N a valid auto step
+ */
+bool ServiceConsole::parseStep(const char* name, uint8_t& step) const {
+  if (strncmp(name, "step.", 5) != 0 || !isdigit((unsigned char)name[5])) return false;
+  char* end;
+  unsigned long value = strtoul(name + 5, &end, 10);
+  if (*end != '\0' || value >= SequenceController::AUTO_STEP_COUNT) return false;
+  step = (uint8_t)value;
+  return true;
+}
+
+long ServiceConsole::readTunable(Tunable id) const {
+  SequenceController* sequences = controller->getSequenceController();
+  SensorManager* sensors = controller->getSensorManager();
+  CommunicationManager* comm = controller->getCommunicationManager();
+
+  switch (id) {
+    case TUNE_STEP_SCALE: return sequences ? sequences->getStepScale() : 0;
+    case TUNE_LIMIT_DELAY: return sequences ? (long)sequences->getLimitDelayTicks() : 0;
+    case TUNE_SENSOR_CONFIRM: return sensors ? (long)sensors->getConfirmDelayTicks() : 0;
+    case TUNE_PWM_HIGH: return comm ? comm->getIntensityHighPWM() : 0;
+    case TUNE_PWM_LOW: return comm ? comm->getIntensityLowPWM() : 0;
+    case TUNE_PWM_FULL: return sequences ? sequences->getFullIntensityPWM() : 0;
+    case TUNE_LINK_TIMEOUT: return comm ? (long)comm->getLinkTimeout() : 0;
+    case TUNE_LOG_LEVEL: return log->getLevel(DebugLog::MODULE_SYSTEM);
+    default: return 0;
+  }
+}
+
+void ServiceConsole::writeTunable(Tunable id, long value) {
+  SequenceController* sequences = controller->getSequenceController();
+  SensorManager* sensors = controller->getSensorManager();
+  CommunicationManager* comm = controller->getCommunicationManager();
+
+  switch (id) {
+    case TUNE_STEP_SCALE:
+      if (sequences) sequences->setStepScale((uint16_t)value);
+      break;
+    case TUNE_LIMIT_DELAY:
+      if (sequences) sequences->setLimitDelayTicks((unsigned long)value);
+      break;
+    case TUNE_SENSOR_CONFIRM:
+      if (sensors) sensors->setConfirmDelayTicks((unsigned long)value);
+      break;
+    case TUNE_PWM_HIGH:
+      if (comm) comm->setIntensityHighPWM((uint8_t)value);
+      break;
+    case TUNE_PWM_LOW:
+      if (comm) comm->setIntensityLowPWM((uint8_t)value);
+      break;
+    case TUNE_PWM_FULL:
+      if (sequences) sequences->setFullIntensityPWM((uint8_t)value);
+      break;
+    case TUNE_LINK_TIMEOUT:
+      if (comm) comm->setLinkTimeout((unsigned long)value);
+      break;
+    case TUNE_LOG_LEVEL:
+      log->setAllLevels((DebugLog::Level)value);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * One reply line, CR LF appended (dropped and counted by the log when full)
+ */
+void ServiceConsole::reply(const char* format, ...) {
+  char text[REPLY_SIZE];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(text, REPLY_SIZE - 2, format, args);
+  va_end(args);
+  if (len < 0) return;
+  if (len > REPLY_SIZE - 3) len = REPLY_SIZE - 3;
+  text[len++] = '\r';
+  text[len++] = '\n';
+  log->enqueue((const uint8_t*)text, len);
+}
+
+void ServiceConsole::startListing(Listing kind) {
+  listing = kind;
+  listLine = 0;
+}
+
+/**
+ * Print pending listing lines while the debug log has room for a full line
+ */
+void ServiceConsole::printListing() {
+  char text[REPLY_SIZE];
+  while (listing != LIST_NONE && log->getFreeBytes() >= REPLY_SIZE) {
+    int len = formatListLine(text, listLine++);
+    if (len < 0) {
+      listing = LIST_NONE;
+    } else if (len > 0) {
+      log->enqueue((const uint8_t*)text, (len < REPLY_SIZE) ? len : REPLY_SIZE - 1);
+    }
+  }
+}
+
+/**
+ * Listing line (0 = nothing on this line, -1 = end of the listing)
+ */
+int ServiceConsole::formatListLine(char* text, uint16_t index) {
+  switch (listing) {
+    case LIST_HELP: return formatHelpLine(text, index);
+    case LIST_TUNABLES: return formatTunableLine(text, index);
+    case LIST_STATS: return formatStatsLine(text, index);
+    case LIST_PROFILE: return formatProfileLine(text, index);
+    default: return -1;
+  }
+}
+
+int ServiceConsole::formatHelpLine(char* text, uint16_t index) const {
+  if (index >= sizeof(HELP) / sizeof(HELP[0])) return -1;
+  return snprintf(text, REPLY_SIZE, "%s\r\n", HELP[index]);
+}
+
+/**
+ * Tunables, then the auto steps that have an override
+ */
+int ServiceConsole::formatTunableLine(char* text, uint16_t index) const {
+  if (index < TUNE_COUNT) {
+    const TunableSpec& spec = TUNABLES[index];
+    return snprintf(text, REPLY_SIZE, "%s = %ld %s\r\n", spec.name, readTunable((Tunable)index), spec.unit);
+  }
+
+  index -= TUNE_COUNT;
+  if (index >= SequenceController::AUTO_STEP_COUNT) return -1;
+  SequenceController* sequences = controller->getSequenceController();
+  uint16_t ticks = sequences ? sequences->getStepTicks(index) : 0;
+  if (ticks == 0) return 0;
+  return snprintf(text, REPLY_SIZE, "step.%u = %u ticks\r\n", index, ticks);
+}
+
+int ServiceConsole::formatStatsLine(char* text, uint16_t index) const {
+  CommunicationManager* comm = controller->getCommunicationManager();
+  TimerManager* timer = controller->getTimerManager();
+  MotorController* motors = controller->getMotorController();
+  int len = 0;
+
+  switch (index) {
+    case 0:
+      len = snprintf(text, REPLY_SIZE, "uptime=%lu ticks loops=%lu\r\n",
+                     timer ? timer->getMasterTicks() : 0UL,
+                     controller->getLoopCounter());
+      break;
+    case 1: {
+      if (!comm) return 0;
+      const CommunicationManager::LinkStats& link = comm->getLinkStats();
+      len = snprintf(text, REPLY_SIZE, "ble rx: binary=%lu bin_err=%lu last_pass=%u in_flight_max=%u\r\n",
+                     (unsigned long)link.binaryFramesIn,
+                     (unsigned long)link.binaryErrors,
+                     comm->getBleFramesLastPass(),
+                     comm->getBleMaxBytesInFlight());
+      break;
+    }
+    case 2:
+      if (!comm) return 0;
+      len = snprintf(text, REPLY_SIZE, "commands: queue_hw=%u drops=%lu fast_stops=%lu latency_max=%lu dup=%lu stale=%lu\r\n",
+                     comm->getCommandQueueHighWater(),
+                     comm->getCommandQueueDrops(),
+                     comm->getFastStops(),
+                     comm->getMaxCommandLatencyTicks(),
+                     comm->getSequenceDuplicates(),
+                     comm->getSequenceStale());
+      break;
+    case 3: {
+      if (!comm) return 0;
+      const BleTxQueue& tx = comm->getTxQueue();
+      len = snprintf(text, REPLY_SIZE, "ble tx: frames=%lu drops=%lu/%lu hw=%u/%u acks=%lu nacks=%lu state=%lu\r\n",
+                     tx.getFramesSent(),
+                     tx.getDrops(BleTxQueue::LANE_CONTROL),
+                     tx.getDrops(BleTxQueue::LANE_BULK),
+                     tx.getHighWater(BleTxQueue::LANE_CONTROL),
+                     tx.getHighWater(BleTxQueue::LANE_BULK),
+                     comm->getAcksSent(),
+                     comm->getNacksSent(),
+                     comm->getTelemetryFramesSent());
+      break;
+    }
+    case 4:
+      if (!comm) return 0;
+      len = snprintf(text, REPLY_SIZE, "link: %s supervised=%u timeout=%lu unit=0x%02X\r\n",
+                     comm->isLinkUp() ? "up" : "down",
+                     comm->isLinkSupervised() ? 1 : 0,
+                     comm->getLinkTimeout(),
+                     comm->getBoardAddress().getUnit());
+      break;
+    case 5: {
+      if (!comm) return 0;
+      const CommunicationManager::LinkStats& link = comm->getLinkStats();
+      len = snprintf(text, REPLY_SIZE, "link io: in=%lu/%lu out=%lu/%lu (frames/bytes)\r\n",
+                     (unsigned long)link.framesIn,
+                     (unsigned long)link.bytesIn,
+                     (unsigned long)link.framesOut,
+                     (unsigned long)link.bytesOut);
+      break;
+    }
+    case 6: {
+      if (!comm) return 0;
+      const CommunicationManager::LinkStats& link = comm->getLinkStats();
+      len = snprintf(text, REPLY_SIZE, "link err: cks=%lu len=%lu fmt=%lu ovf=%lu addr=%lu dup=%lu uart=%lu\r\n",
+                     (unsigned long)link.checksumErrors,
+                     (unsigned long)link.lengthErrors,
+                     (unsigned long)link.formatErrors,
+                     (unsigned long)link.overflowErrors,
+                     (unsigned long)link.addressMismatches,
+                     (unsigned long)link.duplicates,
+                     (unsigned long)link.uartOverruns);
+      break;
+    }
+    case 7:
+      if (!motors) return 0;
+      len = snprintf(text, REPLY_SIZE, "motors: lease_expiries=%lu\r\n", motors->getLeaseExpiries());
+      break;
+    case 8:
+      len = snprintf(text, REPLY_SIZE, "log: pending=%u hw=%u dropped=%lu bytes / %lu lines\r\n",
+                     log->getPendingBytes(),
+                     log->getHighWater(),
+                     log->getDroppedBytes(),
+                     log->getDroppedLines());
+      break;
+    default:
+      return -1;
+  }
+  return len;
+}
+
+/**
+ * Profile report: header, one line per phase, footer
+ */
+int ServiceConsole::formatProfileLine(char* text, uint16_t index) const {
+  if (index == 0) {
+    return snprintf(text, REPLY_SIZE, "=== PROFILE (us, p99 = bucket bound) ===\r\n");
+  }
+  if (index <= PHASE_COUNT) {
+    Phase phase = (Phase)(index - 1);
+    return LatencyProbe::formatLine(text, getPhaseName(phase), profile[phase]);
+  }
+  if (index == PHASE_COUNT + 1) {
+    return snprintf(text, REPLY_SIZE, "=== END PROFILE ===\r\n");
+  }
+  return -1;
+}
+
+/**
+ * Profiling capture (micros(): cheap and independent of LATENCY_PROBES)
+ */
+void ServiceConsole::startPass() {
+  passStamp = micros();
+  phaseStamp = passStamp;
+  passOpen = true;
+}
+
+void ServiceConsole::recordPhase(Phase phase) {
+  if (!passOpen) return;
+  uint32_t now = micros();
+  profile[phase].add(now - phaseStamp);
+  phaseStamp = now;
+}
+
+void ServiceConsole::finishPass() {
+  if (!passOpen) return;
+  passOpen = false;
+  profile[PHASE_PASS].add(micros() - passStamp);
+  if (--profileRemaining == 0) {
+    profileReady = true;
+  }
+}
+
+/**
+ * Number in decimal or 0x hex
+ */
+bool ServiceConsole::parseNumber(const char* text, long& value) {
+  char* end;
+  value = strtol(text, &end, 0);
+  return end != text && *end == '\0';
+}
+
+const char* ServiceConsole::getPhaseName(Phase phase) {
+  switch (phase) {
+    case PHASE_COMMUNICATION: return "COMMUNICATION";
+    case PHASE_COMMANDS: return "COMMANDS";
+    case PHASE_SENSORS: return "SENSORS";
+    case PHASE_SEQUENCES: return "SEQUENCES";
+    case PHASE_SAFETY: return "SAFETY";
+    case PHASE_MOTORS: return "MOTORS";
+    case PHASE_TELEMETRY: return "TELEMETRY";
+    case PHASE_PASS: return "PASS (total)";
+    default: return "?";
+  }
+}